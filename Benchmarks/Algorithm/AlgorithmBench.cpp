@@ -0,0 +1,128 @@
+#include "../../cpp/Algorithm.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <stdlib.h>
+#include <benchmark/benchmark.h>
+
+static hsd::vector<hsd::i32> random_values(hsd::usize size)
+{
+    hsd::vector<hsd::i32> values(size);
+    srand(1);
+
+    for(auto& value : values)
+        value = rand();
+
+    return values;
+}
+
+static void hsdSort(benchmark::State& state)
+{
+    auto source = random_values(static_cast<hsd::usize>(state.range(0)));
+
+    for(auto _ : state)
+    {
+        state.PauseTiming();
+        auto values = source;
+        state.ResumeTiming();
+        hsd::sort(values.begin(), values.end());
+        benchmark::DoNotOptimize(values.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void stdSort(benchmark::State& state)
+{
+    auto source = random_values(static_cast<hsd::usize>(state.range(0)));
+
+    for(auto _ : state)
+    {
+        state.PauseTiming();
+        auto values = source;
+        state.ResumeTiming();
+        std::sort(values.begin(), values.end());
+        benchmark::DoNotOptimize(values.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Scales with the cores of the host, the global pool has one worker per CPU
+static void hsdSortPar(benchmark::State& state)
+{
+    auto source = random_values(static_cast<hsd::usize>(state.range(0)));
+
+    for(auto _ : state)
+    {
+        state.PauseTiming();
+        auto values = source;
+        state.ResumeTiming();
+        hsd::sort(hsd::execution::par, values.begin(), values.end());
+        benchmark::DoNotOptimize(values.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void hsdStableSort(benchmark::State& state)
+{
+    auto source = random_values(static_cast<hsd::usize>(state.range(0)));
+
+    for(auto _ : state)
+    {
+        state.PauseTiming();
+        auto values = source;
+        state.ResumeTiming();
+        hsd::stable_sort(values.begin(), values.end());
+        benchmark::DoNotOptimize(values.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void stdStableSort(benchmark::State& state)
+{
+    auto source = random_values(static_cast<hsd::usize>(state.range(0)));
+
+    for(auto _ : state)
+    {
+        state.PauseTiming();
+        auto values = source;
+        state.ResumeTiming();
+        std::stable_sort(values.begin(), values.end());
+        benchmark::DoNotOptimize(values.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void hsdReducePar(benchmark::State& state)
+{
+    hsd::vector<hsd::u64> values(static_cast<hsd::usize>(state.range(0)));
+
+    for(auto _ : state)
+        benchmark::DoNotOptimize(hsd::reduce(hsd::execution::par, values.begin(), values.end(), hsd::u64{0}));
+
+    state.SetBytesProcessed(state.iterations() * state.range(0) * 8);
+}
+
+static void stdAccumulate(benchmark::State& state)
+{
+    hsd::vector<hsd::u64> values(static_cast<hsd::usize>(state.range(0)));
+
+    for(auto _ : state)
+        benchmark::DoNotOptimize(std::accumulate(values.begin(), values.end(), hsd::u64{0}));
+
+    state.SetBytesProcessed(state.iterations() * state.range(0) * 8);
+}
+
+BENCHMARK(hsdSort)->Arg(1 << 20);
+BENCHMARK(stdSort)->Arg(1 << 20);
+BENCHMARK(hsdSortPar)->Arg(1 << 20)->UseRealTime();
+BENCHMARK(hsdStableSort)->Arg(1 << 20);
+BENCHMARK(stdStableSort)->Arg(1 << 20);
+BENCHMARK(hsdReducePar)->Arg(1 << 22)->UseRealTime();
+BENCHMARK(stdAccumulate)->Arg(1 << 22);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,137 @@
+#include "../../cpp/BTree.hpp"
+
+#include <map>
+#include <stdlib.h>
+#include <benchmark/benchmark.h>
+
+static hsd::vector<hsd::i64> random_keys(hsd::usize size)
+{
+    hsd::vector<hsd::i64> keys(size);
+    srand(1);
+
+    for(auto& key : keys)
+        key = (static_cast<hsd::i64>(rand()) << 31) | rand();
+
+    return keys;
+}
+
+static void hsdInsert(benchmark::State& state)
+{
+    auto keys = random_keys(static_cast<hsd::usize>(state.range(0)));
+
+    for(auto _ : state)
+    {
+        hsd::btree_map<hsd::i64, hsd::i64> map;
+
+        for(auto key : keys)
+            map.emplace(key, key);
+
+        benchmark::DoNotOptimize(map.size());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void stdInsert(benchmark::State& state)
+{
+    auto keys = random_keys(static_cast<hsd::usize>(state.range(0)));
+
+    for(auto _ : state)
+    {
+        std::map<hsd::i64, hsd::i64> map;
+
+        for(auto key : keys)
+            map.emplace(key, key);
+
+        benchmark::DoNotOptimize(map.size());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void hsdFind(benchmark::State& state)
+{
+    auto keys = random_keys(static_cast<hsd::usize>(state.range(0)));
+    hsd::btree_map<hsd::i64, hsd::i64> map;
+
+    for(auto key : keys)
+        map.emplace(key, key);
+
+    for(auto _ : state)
+    {
+        for(auto key : keys)
+            benchmark::DoNotOptimize(map.find(key));
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void stdFind(benchmark::State& state)
+{
+    auto keys = random_keys(static_cast<hsd::usize>(state.range(0)));
+    std::map<hsd::i64, hsd::i64> map;
+
+    for(auto key : keys)
+        map.emplace(key, key);
+
+    for(auto _ : state)
+    {
+        for(auto key : keys)
+            benchmark::DoNotOptimize(map.find(key));
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Sums every value, the access pattern of a time-series range query
+static void hsdScan(benchmark::State& state)
+{
+    hsd::vector<hsd::pair<hsd::i64, hsd::i64>> sorted;
+
+    for(hsd::i64 key = 0; key < state.range(0); key++)
+        sorted.push_back({key, key});
+
+    hsd::btree_map<hsd::i64, hsd::i64> map;
+    map.bulk_load(sorted.begin(), sorted.end());
+
+    for(auto _ : state)
+    {
+        hsd::i64 total = 0;
+
+        for(auto _it = map.begin(); _it != map.end(); ++_it)
+            total += _it.value();
+
+        benchmark::DoNotOptimize(total);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void stdScan(benchmark::State& state)
+{
+    std::map<hsd::i64, hsd::i64> map;
+
+    for(hsd::i64 key = 0; key < state.range(0); key++)
+        map.emplace_hint(map.end(), key, key);
+
+    for(auto _ : state)
+    {
+        hsd::i64 total = 0;
+
+        for(auto& entry : map)
+            total += entry.second;
+
+        benchmark::DoNotOptimize(total);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(hsdInsert)->Arg(1 << 20);
+BENCHMARK(stdInsert)->Arg(1 << 20);
+BENCHMARK(hsdFind)->Arg(1 << 20);
+BENCHMARK(stdFind)->Arg(1 << 20);
+BENCHMARK(hsdScan)->Arg(1 << 22);
+BENCHMARK(stdScan)->Arg(1 << 22);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,220 @@
+#include "../../cpp/Bitset.hpp"
+
+#include <bitset>
+#include <vector>
+#include <memory>
+#include <stdlib.h>
+#include <benchmark/benchmark.h>
+
+// 1M bits, 128 KiB per set: two of them stay in L2
+static constexpr hsd::usize bits = 1 << 20;
+
+static hsd::dynamic_bitset random_bits(hsd::u32 seed, hsd::i32 one_in)
+{
+    hsd::dynamic_bitset result(bits);
+    srand(seed);
+
+    for(hsd::usize index = 0; index < bits; index++)
+        result.set(index, rand() % one_in == 0);
+
+    return result;
+}
+
+template <typename Std>
+static Std to_std(const hsd::dynamic_bitset& source)
+{
+    Std result;
+
+    if constexpr(requires { result.resize(bits); })
+        result.resize(bits);
+
+    for(hsd::usize index = 0; index < bits; index++)
+        result[index] = source[index];
+
+    return result;
+}
+
+static void countHsd(benchmark::State& state)
+{
+    auto set = random_bits(1, 2);
+
+    for(auto _ : state)
+        benchmark::DoNotOptimize(set.count());
+
+    state.SetBytesProcessed(static_cast<hsd::i64>(state.iterations() * bits / 8));
+}
+
+static void countStdBitset(benchmark::State& state)
+{
+    auto set = std::make_unique<std::bitset<bits>>(to_std<std::bitset<bits>>(random_bits(1, 2)));
+
+    for(auto _ : state)
+        benchmark::DoNotOptimize(set->count());
+
+    state.SetBytesProcessed(static_cast<hsd::i64>(state.iterations() * bits / 8));
+}
+
+static void andHsd(benchmark::State& state)
+{
+    auto lhs = random_bits(1, 2), rhs = random_bits(2, 2);
+
+    for(auto _ : state)
+    {
+        lhs &= rhs;
+        lhs |= rhs;
+        benchmark::ClobberMemory();
+    }
+
+    state.SetBytesProcessed(static_cast<hsd::i64>(state.iterations() * bits / 4));
+}
+
+static void andStdBitset(benchmark::State& state)
+{
+    auto lhs = std::make_unique<std::bitset<bits>>(to_std<std::bitset<bits>>(random_bits(1, 2)));
+    auto rhs = std::make_unique<std::bitset<bits>>(to_std<std::bitset<bits>>(random_bits(2, 2)));
+
+    for(auto _ : state)
+    {
+        *lhs &= *rhs;
+        *lhs |= *rhs;
+        benchmark::ClobberMemory();
+    }
+
+    state.SetBytesProcessed(static_cast<hsd::i64>(state.iterations() * bits / 4));
+}
+
+static void intersectCountHsd(benchmark::State& state)
+{
+    auto lhs = random_bits(1, 2), rhs = random_bits(2, 2);
+
+    for(auto _ : state)
+        benchmark::DoNotOptimize(lhs.intersect_count(rhs));
+
+    state.SetBytesProcessed(static_cast<hsd::i64>(state.iterations() * bits / 4));
+}
+
+static void intersectCountStdBitset(benchmark::State& state)
+{
+    auto lhs = std::make_unique<std::bitset<bits>>(to_std<std::bitset<bits>>(random_bits(1, 2)));
+    auto rhs = std::make_unique<std::bitset<bits>>(to_std<std::bitset<bits>>(random_bits(2, 2)));
+
+    for(auto _ : state)
+        benchmark::DoNotOptimize((*lhs & *rhs).count());
+
+    state.SetBytesProcessed(static_cast<hsd::i64>(state.iterations() * bits / 4));
+}
+
+// Sparse set, one bit in 64: walking the ones against testing every bit
+static void onesHsd(benchmark::State& state)
+{
+    auto set = random_bits(3, 64);
+
+    for(auto _ : state)
+    {
+        hsd::usize sum = 0;
+
+        for(auto index : set.ones())
+            sum += index;
+
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(static_cast<hsd::i64>(state.iterations() * bits));
+}
+
+static void onesVectorBool(benchmark::State& state)
+{
+    auto set = to_std<std::vector<bool>>(random_bits(3, 64));
+
+    for(auto _ : state)
+    {
+        hsd::usize sum = 0;
+
+        for(hsd::usize index = 0; index < bits; index++)
+        {
+            if(set[index])
+                sum += index;
+        }
+
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(static_cast<hsd::i64>(state.iterations() * bits));
+}
+
+static hsd::vector<hsd::usize> random_queries(hsd::usize limit)
+{
+    hsd::vector<hsd::usize> queries;
+    srand(4);
+
+    for(hsd::usize index = 0; index < 4096; index++)
+        queries.push_back(static_cast<hsd::usize>(rand()) % limit);
+
+    return queries;
+}
+
+static void rankHsd(benchmark::State& state)
+{
+    auto set = random_bits(5, 2);
+    hsd::rank_select index(set);
+    auto queries = random_queries(bits);
+
+    for(auto _ : state)
+    {
+        for(auto query : queries)
+            benchmark::DoNotOptimize(index.rank1(query));
+    }
+
+    state.SetItemsProcessed(static_cast<hsd::i64>(state.iterations() * queries.size()));
+}
+
+// Rank without an index, a popcount of every word up to the position
+static void rankScan(benchmark::State& state)
+{
+    auto set = random_bits(5, 2);
+    auto queries = random_queries(bits);
+
+    for(auto _ : state)
+    {
+        for(auto query : queries)
+        {
+            hsd::usize rank = hsd::bitset_detail::count(set.words(), query / 64);
+
+            if(query % 64 != 0)
+                rank += hsd::bitset_detail::popcount(set.words()[query / 64] & ((hsd::u64{1} << (query % 64)) - 1));
+
+            benchmark::DoNotOptimize(rank);
+        }
+    }
+
+    state.SetItemsProcessed(static_cast<hsd::i64>(state.iterations() * queries.size()));
+}
+
+static void selectHsd(benchmark::State& state)
+{
+    auto set = random_bits(5, static_cast<hsd::i32>(state.range(0)));
+    hsd::rank_select index(set);
+    auto queries = random_queries(index.count());
+
+    for(auto _ : state)
+    {
+        for(auto query : queries)
+            benchmark::DoNotOptimize(index.select1(query));
+    }
+
+    state.SetItemsProcessed(static_cast<hsd::i64>(state.iterations() * queries.size()));
+}
+
+BENCHMARK(countHsd);
+BENCHMARK(countStdBitset);
+BENCHMARK(andHsd);
+BENCHMARK(andStdBitset);
+BENCHMARK(intersectCountHsd);
+BENCHMARK(intersectCountStdBitset);
+BENCHMARK(onesHsd);
+BENCHMARK(onesVectorBool);
+BENCHMARK(rankHsd);
+BENCHMARK(rankScan);
+BENCHMARK(selectHsd)->Arg(2)->Arg(64);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,148 @@
+#include "../../cpp/BloomFilter.hpp"
+
+#include <unordered_set>
+#include <benchmark/benchmark.h>
+
+// 16M keys at 1%: about 20 MiB of bits, well past L2
+static constexpr hsd::u64 keys = 1 << 24;
+static constexpr hsd::usize lookups = 1 << 16;
+
+/// Textbook filter for comparison: the same number of bits and hashes,
+/// but every bit anywhere in the array, so each probe is its own miss
+class classic_filter
+{
+private:
+    hsd::vector<hsd::u64> _words;
+    hsd::u32 _hashes;
+
+public:
+    classic_filter(hsd::usize bits, hsd::u32 hashes)
+        : _words(bits / 64), _hashes{hashes}
+    {}
+
+    void insert(hsd::u64 key)
+    {
+        hsd::u64 hash = hsd::hash<hsd::u64>::get_hash(key);
+        hsd::u64 step = hsd::sketch_detail::remix(hash) | 1;
+
+        for(hsd::u32 index = 0; index < _hashes; index++, hash += step)
+        {
+            hsd::u64 bit = hsd::sketch_detail::reduce(hash, _words.size() * 64);
+            _words[bit / 64] |= hsd::u64{1} << (bit % 64);
+        }
+    }
+
+    bool contains(hsd::u64 key) const
+    {
+        hsd::u64 hash = hsd::hash<hsd::u64>::get_hash(key);
+        hsd::u64 step = hsd::sketch_detail::remix(hash) | 1;
+
+        for(hsd::u32 index = 0; index < _hashes; index++, hash += step)
+        {
+            hsd::u64 bit = hsd::sketch_detail::reduce(hash, _words.size() * 64);
+
+            if((_words[bit / 64] & (hsd::u64{1} << (bit % 64))) == 0)
+                return false;
+        }
+
+        return true;
+    }
+};
+
+// Members check every bit of the key, most other keys stop at the first
+static hsd::vector<hsd::u64> probes(bool members)
+{
+    hsd::vector<hsd::u64> result;
+
+    for(hsd::u64 index = 0; index < lookups; index++)
+        result.push_back(hsd::wyhash::get_hash(index) % keys + (members ? 0 : keys));
+
+    return result;
+}
+
+static void lookupBlocked(benchmark::State& state)
+{
+    hsd::bloom_filter<hsd::u64> filter(keys, 0.01);
+    auto queries = probes(state.range(0) != 0);
+
+    for(hsd::u64 key = 0; key < keys; key++)
+        filter.insert(key);
+
+    for(auto _ : state)
+    {
+        hsd::usize found = 0;
+
+        for(auto query : queries)
+            found += filter.contains(query);
+
+        benchmark::DoNotOptimize(found);
+    }
+
+    state.SetItemsProcessed(static_cast<hsd::i64>(state.iterations() * lookups));
+}
+
+static void lookupClassic(benchmark::State& state)
+{
+    hsd::bloom_filter<hsd::u64> sizing(keys, 0.01);
+    classic_filter filter(sizing.bit_count(), sizing.hash_count());
+    auto queries = probes(state.range(0) != 0);
+
+    for(hsd::u64 key = 0; key < keys; key++)
+        filter.insert(key);
+
+    for(auto _ : state)
+    {
+        hsd::usize found = 0;
+
+        for(auto query : queries)
+            found += filter.contains(query);
+
+        benchmark::DoNotOptimize(found);
+    }
+
+    state.SetItemsProcessed(static_cast<hsd::i64>(state.iterations() * lookups));
+}
+
+// Holding the full key set instead, exact but many times the memory
+static void lookupStdSet(benchmark::State& state)
+{
+    std::unordered_set<hsd::u64> set;
+    auto queries = probes(state.range(0) != 0);
+
+    for(hsd::u64 key = 0; key < keys; key++)
+        set.insert(key);
+
+    for(auto _ : state)
+    {
+        hsd::usize found = 0;
+
+        for(auto query : queries)
+            found += set.count(query);
+
+        benchmark::DoNotOptimize(found);
+    }
+
+    state.SetItemsProcessed(static_cast<hsd::i64>(state.iterations() * lookups));
+}
+
+static void insertBlocked(benchmark::State& state)
+{
+    hsd::bloom_filter<hsd::u64> filter(keys, 0.01);
+
+    for(auto _ : state)
+    {
+        for(hsd::u64 key = 0; key < lookups; key++)
+            filter.insert(hsd::wyhash::get_hash(key));
+
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(static_cast<hsd::i64>(state.iterations() * lookups));
+}
+
+BENCHMARK(lookupBlocked)->Arg(0)->Arg(1);
+BENCHMARK(lookupClassic)->Arg(0)->Arg(1);
+BENCHMARK(lookupStdSet)->Arg(0)->Arg(1);
+BENCHMARK(insertBlocked);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,72 @@
+#include "../../cpp/ConcurrentHashMap.hpp"
+
+#include <mutex>
+#include <unordered_map>
+#include <benchmark/benchmark.h>
+
+static constexpr hsd::u64 key_count = 1 << 16;
+
+static hsd::concurrent_hash_map<hsd::u64, hsd::u64> hsd_map;
+static std::unordered_map<hsd::u64, hsd::u64> std_map;
+static std::mutex std_mutex;
+
+// 90% lookups, 10% updates over a shared key range
+static void hsdConcurrentMap(benchmark::State& state)
+{
+    if(state.thread_index() == 0)
+    {
+        hsd_map.reserve(key_count);
+
+        for(hsd::u64 i = 0; i < key_count; i++)
+            hsd_map.insert_or_assign(i, i);
+    }
+
+    hsd::u64 key = static_cast<hsd::u64>(state.thread_index()) * 7919, value = 0;
+
+    for(auto _ : state)
+    {
+        key = (key * 6364136223846793005ull + 1442695040888963407ull);
+        hsd::u64 index = (key >> 33) % key_count;
+
+        if((key >> 20) % 10 == 0)
+            hsd_map.insert_or_assign(index, key);
+        else
+            benchmark::DoNotOptimize(hsd_map.find(index, value));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void stdMutexMap(benchmark::State& state)
+{
+    if(state.thread_index() == 0)
+    {
+        std::lock_guard guard{std_mutex};
+        std_map.reserve(key_count);
+
+        for(hsd::u64 i = 0; i < key_count; i++)
+            std_map[i] = i;
+    }
+
+    hsd::u64 key = static_cast<hsd::u64>(state.thread_index()) * 7919;
+
+    for(auto _ : state)
+    {
+        key = (key * 6364136223846793005ull + 1442695040888963407ull);
+        hsd::u64 index = (key >> 33) % key_count;
+        std::lock_guard guard{std_mutex};
+
+        if((key >> 20) % 10 == 0)
+            std_map[index] = key;
+        else
+            benchmark::DoNotOptimize(std_map.find(index));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(hsdConcurrentMap)->ThreadRange(1, 64)->UseRealTime();
+
+BENCHMARK(stdMutexMap)->ThreadRange(1, 64)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,112 @@
+#include "../../cpp/ConcurrentQueue.hpp"
+
+#include <thread>
+#include <benchmark/benchmark.h>
+
+static constexpr hsd::u64 item_count = 1 << 20;
+
+// One producer thread against the benchmark thread, items per second
+static void hsdSpscThroughput(benchmark::State& state)
+{
+    for(auto _ : state)
+    {
+        hsd::blocking_queue< hsd::spsc_queue<hsd::u64, 1024> > queue;
+        std::thread producer{[&] {
+            for(hsd::u64 i = 0; i < item_count; i++)
+                queue.push(i);
+        }};
+
+        hsd::u64 value = 0, sum = 0;
+
+        for(hsd::u64 i = 0; i < item_count; i++)
+        {
+            queue.pop(value);
+            sum += value;
+        }
+
+        producer.join();
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * item_count);
+}
+
+static void hsdSpscBatchThroughput(benchmark::State& state)
+{
+    static constexpr hsd::usize batch = 32;
+
+    for(auto _ : state)
+    {
+        hsd::blocking_queue< hsd::spsc_queue<hsd::u64, 1024> > queue;
+        std::thread producer{[&] {
+            hsd::u64 values[batch]{};
+
+            for(hsd::u64 i = 0; i < item_count; i += batch)
+                queue.push_n(values, batch);
+        }};
+
+        hsd::u64 values[batch];
+
+        for(hsd::u64 received = 0; received < item_count;)
+            received += queue.pop_n(values, batch);
+
+        producer.join();
+    }
+
+    state.SetItemsProcessed(state.iterations() * item_count);
+}
+
+// Every benchmark thread pushes and pops on the same queue
+static hsd::mpmc_queue<hsd::u64> shared_queue{1024};
+
+static void hsdMpmcContended(benchmark::State& state)
+{
+    hsd::u64 value = static_cast<hsd::u64>(state.thread_index());
+
+    for(auto _ : state)
+    {
+        while(!shared_queue.try_push(value))
+            hsd::sync_detail::cpu_relax();
+        while(!shared_queue.try_pop(value))
+            hsd::sync_detail::cpu_relax();
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Round trip of one item through two blocking queues
+static void hsdPingPongLatency(benchmark::State& state)
+{
+    hsd::blocking_queue< hsd::spsc_queue<hsd::u64, 2> > ping, pong;
+    std::thread echo{[&] {
+        hsd::u64 value = 1;
+
+        while(value != 0)
+        {
+            ping.pop(value);
+            pong.push(value);
+        }
+    }};
+
+    hsd::u64 value = 0;
+
+    for(auto _ : state)
+    {
+        ping.push(1);
+        pong.pop(value);
+    }
+
+    ping.push(0);
+    pong.pop(value);
+    echo.join();
+}
+
+BENCHMARK(hsdSpscThroughput)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+BENCHMARK(hsdSpscBatchThroughput)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+BENCHMARK(hsdMpmcContended)->ThreadRange(1, 16)->UseRealTime();
+
+BENCHMARK(hsdPingPongLatency)->UseRealTime();
+
+BENCHMARK_MAIN();
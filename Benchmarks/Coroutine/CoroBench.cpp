@@ -0,0 +1,89 @@
+#include "../../cpp/EventLoop.hpp"
+
+#include <benchmark/benchmark.h>
+
+static hsd::task<hsd::i32> leaf(hsd::i32 value)
+{
+    co_return value + 1;
+}
+
+static hsd::task<hsd::i32> chain(hsd::i32 count)
+{
+    hsd::i32 sum = 0;
+
+    // Every await creates and frees a frame, the pool keeps that off malloc
+    for(hsd::i32 i = 0; i < count; i++)
+        sum += co_await leaf(i);
+
+    co_return sum;
+}
+
+static hsd::generator<hsd::i32> counter(hsd::i32 count)
+{
+    for(hsd::i32 i = 0; i < count; i++)
+        co_yield i;
+}
+
+static void hsdTaskAwait(benchmark::State& state)
+{
+    hsd::event_loop loop;
+
+    for(auto _ : state)
+        benchmark::DoNotOptimize(loop.block_on(chain(static_cast<hsd::i32>(state.range(0)))));
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void hsdGenerator(benchmark::State& state)
+{
+    for(auto _ : state)
+    {
+        hsd::i64 sum = 0;
+
+        for(auto value : counter(static_cast<hsd::i32>(state.range(0))))
+            sum += value;
+
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static hsd::task<void> ping_pong(hsd::async_socket& sock, char* buf, hsd::usize rounds, bool first)
+{
+    for(hsd::usize i = 0; i < rounds; i++)
+    {
+        if(first)
+            co_await sock.send(buf, 64);
+
+        co_await sock.recv(buf, 64);
+
+        if(!first)
+            co_await sock.send(buf, 64);
+    }
+}
+
+// Round trips over a socketpair, both ends driven by the same loop
+static void hsdSocketPingPong(benchmark::State& state)
+{
+    hsd::event_loop loop;
+    hsd::i32 fds[2];
+    socketpair(AF_UNIX, SOCK_STREAM, 0, fds);
+    hsd::async_socket left{loop, fds[0]}, right{loop, fds[1]};
+    char left_buf[64]{}, right_buf[64]{};
+
+    for(auto _ : state)
+    {
+        loop.spawn(ping_pong(left, left_buf, 1000, true));
+        loop.spawn(ping_pong(right, right_buf, 1000, false));
+        loop.run();
+    }
+
+    state.SetItemsProcessed(state.iterations() * 1000);
+}
+
+BENCHMARK(hsdTaskAwait)->Arg(1000);
+BENCHMARK(hsdGenerator)->Arg(1000);
+BENCHMARK(hsdSocketPingPong);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,72 @@
+#include "../../cpp/Deque.hpp"
+
+#include <deque>
+#include <benchmark/benchmark.h>
+
+// Sliding window: every push at the back retires the oldest element
+template <typename Deque>
+static void queueWindow(benchmark::State& state)
+{
+    Deque queue;
+
+    for(hsd::i64 index = 0; index < state.range(0); index++)
+        queue.push_back(index);
+
+    hsd::i64 next = state.range(0);
+
+    for(auto _ : state)
+    {
+        queue.push_back(next++);
+        benchmark::DoNotOptimize(queue.front());
+        queue.pop_front();
+    }
+}
+
+template <typename Deque>
+static void pushBoth(benchmark::State& state)
+{
+    for(auto _ : state)
+    {
+        Deque queue;
+
+        for(hsd::i64 index = 0; index < state.range(0); index++)
+        {
+            queue.push_back(index);
+            queue.push_front(index);
+        }
+
+        benchmark::DoNotOptimize(queue.size());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0) * 2);
+}
+
+template <typename Deque>
+static void scan(benchmark::State& state)
+{
+    Deque queue;
+
+    for(hsd::i64 index = 0; index < state.range(0); index++)
+        queue.push_back(index);
+
+    for(auto _ : state)
+    {
+        hsd::i64 total = 0;
+
+        for(auto value : queue)
+            total += value;
+
+        benchmark::DoNotOptimize(total);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_TEMPLATE(queueWindow, hsd::deque<hsd::i64>)->Arg(1 << 12);
+BENCHMARK_TEMPLATE(queueWindow, std::deque<hsd::i64>)->Arg(1 << 12);
+BENCHMARK_TEMPLATE(pushBoth, hsd::deque<hsd::i64>)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(pushBoth, std::deque<hsd::i64>)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(scan, hsd::deque<hsd::i64>)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(scan, std::deque<hsd::i64>)->Arg(1 << 20);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,69 @@
+#include "../../cpp/FlatMap.hpp"
+#include "../../cpp/UnorderedMap.hpp"
+
+#include <stdlib.h>
+#include <benchmark/benchmark.h>
+
+static hsd::vector<hsd::pair<hsd::i32, hsd::i32>> random_entries(hsd::usize size)
+{
+    hsd::vector<hsd::pair<hsd::i32, hsd::i32>> entries;
+    srand(1);
+
+    for(hsd::usize index = 0; index < size; index++)
+        entries.push_back({rand(), static_cast<hsd::i32>(index)});
+
+    return entries;
+}
+
+template <typename Layout>
+static void flatFind(benchmark::State& state)
+{
+    auto entries = random_entries(static_cast<hsd::usize>(state.range(0)));
+    hsd::flat_map<hsd::i32, hsd::i32, hsd::less, Layout> map;
+    map.insert_range(entries.begin(), entries.end());
+    hsd::usize next = 0;
+
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(map.find(entries[next].first));
+        next = next + 1 == entries.size() ? 0 : next + 1;
+    }
+}
+
+static void umapFind(benchmark::State& state)
+{
+    auto entries = random_entries(static_cast<hsd::usize>(state.range(0)));
+    hsd::unordered_map<hsd::i32, hsd::i32> map;
+
+    for(auto& entry : entries)
+        map.emplace(entry.first, entry.second);
+
+    hsd::usize next = 0;
+
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(map.find(entries[next].first));
+        next = next + 1 == entries.size() ? 0 : next + 1;
+    }
+}
+
+static void flatBuild(benchmark::State& state)
+{
+    auto entries = random_entries(static_cast<hsd::usize>(state.range(0)));
+
+    for(auto _ : state)
+    {
+        hsd::flat_map<hsd::i32, hsd::i32> map;
+        map.insert_range(entries.begin(), entries.end());
+        benchmark::DoNotOptimize(map.size());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_TEMPLATE(flatFind, hsd::binary_layout)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 22);
+BENCHMARK_TEMPLATE(flatFind, hsd::eytzinger_layout)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 22);
+BENCHMARK(umapFind)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 22);
+BENCHMARK(flatBuild)->Arg(1 << 16);
+
+BENCHMARK_MAIN();
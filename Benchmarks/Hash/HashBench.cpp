@@ -0,0 +1,74 @@
+#include "../../cpp/Hash.hpp"
+
+#include <string_view>
+#include <functional>
+#include <benchmark/benchmark.h>
+
+static char* make_key(hsd::usize len)
+{
+    static char buf[4097]{};
+
+    for(hsd::usize i = 0; i < len; i++)
+        buf[i] = static_cast<char>('a' + (i * 7) % 26);
+
+    buf[len] = '\0';
+    return buf;
+}
+
+static void hsdFnv1a(benchmark::State& state)
+{
+    const char* key = make_key(static_cast<hsd::usize>(state.range(0)));
+
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(key);
+        benchmark::DoNotOptimize(hsd::fnv1a<hsd::usize>::get_hash(key));
+    }
+
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+static void hsdWyhash(benchmark::State& state)
+{
+    const char* key = make_key(static_cast<hsd::usize>(state.range(0)));
+    hsd::usize len = static_cast<hsd::usize>(state.range(0));
+
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(key);
+        benchmark::DoNotOptimize(hsd::wyhash::get_hash(key, len));
+    }
+
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+static void stdHash(benchmark::State& state)
+{
+    std::string_view key{make_key(static_cast<hsd::usize>(state.range(0)))};
+
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(key);
+        benchmark::DoNotOptimize(std::hash<std::string_view>{}(key));
+    }
+
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+static void hsdIntHash(benchmark::State& state)
+{
+    hsd::u64 key = 0;
+
+    for(auto _ : state)
+        benchmark::DoNotOptimize(hsd::hash<hsd::u64>::get_hash(key++));
+}
+
+BENCHMARK(hsdFnv1a)->RangeMultiplier(4)->Range(4, 4096);
+
+BENCHMARK(hsdWyhash)->RangeMultiplier(4)->Range(4, 4096);
+
+BENCHMARK(stdHash)->RangeMultiplier(4)->Range(4, 4096);
+
+BENCHMARK(hsdIntHash);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,47 @@
+#include "../../cpp/NetworkServer.hpp"
+#include "../../cpp/NetworkClient.hpp"
+
+#include <benchmark/benchmark.h>
+
+static constexpr hsd::u16 bench_port = 54010;
+static constexpr hsd::usize client_threads = 8;
+static constexpr hsd::usize connections_per_thread = 32;
+
+static void connect_batch()
+{
+    for(hsd::usize i = 0; i < connections_per_thread; i++)
+    {
+        hsd::tcp::client client{hsd::net::protocol_type::ipv4, bench_port, "127.0.0.1"};
+        client.respond<"ping">();
+        benchmark::DoNotOptimize(client.receive());
+    }
+}
+
+// Connections per second (connect, one request, one reply, close) by worker count
+static void hsdShardedServer(benchmark::State& state)
+{
+    hsd::tcp::sharded_server server{
+        hsd::net::protocol_type::ipv4, bench_port, "127.0.0.1",
+        [](hsd::tcp::server_detail::connection& conn, const char*, hsd::usize)
+        {
+            conn.respond<"pong">();
+        }, static_cast<hsd::usize>(state.range(0))
+    };
+
+    for(auto _ : state)
+    {
+        hsd::vector<hsd::thread> clients;
+
+        for(hsd::usize i = 0; i < client_threads; i++)
+            clients.emplace_back(connect_batch);
+
+        for(auto& client : clients)
+            client.join();
+    }
+
+    state.SetItemsProcessed(state.iterations() * client_threads * connections_per_thread);
+}
+
+BENCHMARK(hsdShardedServer)->RangeMultiplier(2)->Range(1, 16)->UseRealTime();
+
+BENCHMARK_MAIN();
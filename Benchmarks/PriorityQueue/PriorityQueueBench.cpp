@@ -0,0 +1,121 @@
+#include "../../cpp/PriorityQueue.hpp"
+
+#include <queue>
+#include <stdlib.h>
+#include <benchmark/benchmark.h>
+
+template <typename Queue>
+static void pushPop(benchmark::State& state)
+{
+    srand(1);
+    Queue queue;
+
+    for(hsd::i64 index = 0; index < state.range(0); index++)
+        queue.push(rand());
+
+    for(auto _ : state)
+    {
+        queue.push(rand());
+        benchmark::DoNotOptimize(queue.top());
+        queue.pop();
+    }
+}
+
+struct graph
+{
+    hsd::vector<hsd::vector<hsd::pair<hsd::u32, hsd::i32>>> edges;
+
+    explicit graph(hsd::u32 nodes)
+        : edges(nodes)
+    {
+        srand(2);
+
+        for(auto& list : edges)
+        {
+            for(hsd::i32 count = 0; count < 16; count++)
+                list.push_back({static_cast<hsd::u32>(rand()) % nodes, rand() % 1000 + 1});
+        }
+    }
+};
+
+static void dijkstraDecreaseKey(benchmark::State& state)
+{
+    graph routes(static_cast<hsd::u32>(state.range(0)));
+    hsd::vector<hsd::i32> start(routes.edges.size());
+
+    for(auto& distance : start)
+        distance = hsd::limits<hsd::i32>::max;
+
+    start[0] = 0;
+    hsd::indexed_heap<hsd::i32> heap;
+
+    for(auto _ : state)
+    {
+        auto distances = start;
+        heap.assign(start.begin(), start.end());
+
+        while(!heap.empty() && heap.top() != hsd::limits<hsd::i32>::max)
+        {
+            auto node = heap.top_handle();
+            hsd::i32 distance = heap.top();
+            heap.pop();
+
+            for(auto& [next, weight] : routes.edges[node])
+            {
+                if(distance + weight < distances[next])
+                {
+                    distances[next] = distance + weight;
+                    heap.decrease_key(next, distances[next]);
+                }
+            }
+        }
+
+        benchmark::DoNotOptimize(distances[1]);
+    }
+}
+
+static void dijkstraReinsert(benchmark::State& state)
+{
+    graph routes(static_cast<hsd::u32>(state.range(0)));
+    hsd::vector<hsd::i32> start(routes.edges.size());
+
+    for(auto& distance : start)
+        distance = hsd::limits<hsd::i32>::max;
+
+    start[0] = 0;
+
+    for(auto _ : state)
+    {
+        auto distances = start;
+        std::priority_queue<std::pair<hsd::i32, hsd::u32>, std::vector<std::pair<hsd::i32, hsd::u32>>,
+            std::greater<>> queue;
+        queue.push({0, 0});
+
+        while(!queue.empty())
+        {
+            auto [distance, node] = queue.top();
+            queue.pop();
+
+            if(distance != distances[node])
+                continue;
+
+            for(auto& [next, weight] : routes.edges[node])
+            {
+                if(distance + weight < distances[next])
+                {
+                    distances[next] = distance + weight;
+                    queue.push({distances[next], next});
+                }
+            }
+        }
+
+        benchmark::DoNotOptimize(distances[1]);
+    }
+}
+
+BENCHMARK_TEMPLATE(pushPop, hsd::priority_queue<hsd::i32>)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(pushPop, std::priority_queue<hsd::i32>)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK(dijkstraDecreaseKey)->Arg(1 << 16)->Arg(1 << 20);
+BENCHMARK(dijkstraReinsert)->Arg(1 << 16)->Arg(1 << 20);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,244 @@
+#include "../../cpp/Simd.hpp"
+
+#include <benchmark/benchmark.h>
+
+// 64K floats stay in L2, so the kernels are measured rather than DRAM
+static constexpr hsd::usize size = 1 << 16;
+
+static hsd::vector<hsd::f32> make_values()
+{
+    hsd::vector<hsd::f32> values(size);
+
+    for(hsd::usize i = 0; i < size; i++)
+        values[i] = static_cast<hsd::f32>(i % 1000) * 0.5f;
+
+    return values;
+}
+
+static void set_bytes(benchmark::State& state, hsd::usize arrays)
+{
+    state.SetBytesProcessed(static_cast<hsd::i64>(state.iterations() * size * sizeof(hsd::f32) * arrays));
+}
+
+static void scalarSum(benchmark::State& state)
+{
+    auto values = make_values();
+
+    for(auto _ : state)
+    {
+        hsd::f32 sum = 0;
+
+        for(hsd::usize i = 0; i < size; i++)
+            sum += values[i];
+
+        benchmark::DoNotOptimize(sum);
+    }
+
+    set_bytes(state, 1);
+}
+
+static void simdSum(benchmark::State& state)
+{
+    auto values = make_values();
+
+    for(auto _ : state)
+        benchmark::DoNotOptimize(hsd::simd::sum(values));
+
+    set_bytes(state, 1);
+}
+
+static void scalarDot(benchmark::State& state)
+{
+    auto lhs = make_values(), rhs = make_values();
+
+    for(auto _ : state)
+    {
+        hsd::f32 sum = 0;
+
+        for(hsd::usize i = 0; i < size; i++)
+            sum += lhs[i] * rhs[i];
+
+        benchmark::DoNotOptimize(sum);
+    }
+
+    set_bytes(state, 2);
+}
+
+static void simdDot(benchmark::State& state)
+{
+    auto lhs = make_values(), rhs = make_values();
+
+    for(auto _ : state)
+        benchmark::DoNotOptimize(hsd::simd::dot(lhs, rhs));
+
+    set_bytes(state, 2);
+}
+
+static void scalarMax(benchmark::State& state)
+{
+    auto values = make_values();
+
+    for(auto _ : state)
+    {
+        hsd::f32 result = values[0];
+
+        for(hsd::usize i = 1; i < size; i++)
+            result = values[i] > result ? values[i] : result;
+
+        benchmark::DoNotOptimize(result);
+    }
+
+    set_bytes(state, 1);
+}
+
+static void simdMax(benchmark::State& state)
+{
+    auto values = make_values();
+
+    for(auto _ : state)
+        benchmark::DoNotOptimize(hsd::simd::max(values));
+
+    set_bytes(state, 1);
+}
+
+static void scalarAxpy(benchmark::State& state)
+{
+    auto x = make_values(), y = make_values();
+
+    for(auto _ : state)
+    {
+        for(hsd::usize i = 0; i < size; i++)
+            y[i] = 0.5f * x[i] + y[i];
+
+        benchmark::ClobberMemory();
+    }
+
+    set_bytes(state, 3);
+}
+
+static void simdAxpy(benchmark::State& state)
+{
+    auto x = make_values(), y = make_values();
+
+    for(auto _ : state)
+    {
+        hsd::simd::axpy(0.5f, x, y);
+        benchmark::ClobberMemory();
+    }
+
+    set_bytes(state, 3);
+}
+
+static void scalarPrefixSum(benchmark::State& state)
+{
+    auto values = make_values();
+    hsd::vector<hsd::f32> out(size);
+
+    for(auto _ : state)
+    {
+        hsd::f32 sum = 0;
+
+        for(hsd::usize i = 0; i < size; i++)
+            out[i] = (sum += values[i]);
+
+        benchmark::ClobberMemory();
+    }
+
+    set_bytes(state, 2);
+}
+
+static void simdPrefixSum(benchmark::State& state)
+{
+    auto values = make_values();
+    hsd::vector<hsd::f32> out(size);
+
+    for(auto _ : state)
+    {
+        hsd::simd::prefix_sum(values.data(), out.data(), size);
+        benchmark::ClobberMemory();
+    }
+
+    set_bytes(state, 2);
+}
+
+static void scalarHistogram(benchmark::State& state)
+{
+    auto values = make_values();
+    hsd::vector<hsd::usize> bins(64);
+
+    for(auto _ : state)
+    {
+        for(hsd::usize i = 0; i < size; i++)
+        {
+            hsd::f32 pos = values[i] * (64.0f / 500.0f);
+
+            if(pos >= 0 && pos < 64)
+                bins[static_cast<hsd::usize>(pos)]++;
+        }
+
+        benchmark::ClobberMemory();
+    }
+
+    set_bytes(state, 1);
+}
+
+static void simdHistogram(benchmark::State& state)
+{
+    auto values = make_values();
+    hsd::vector<hsd::usize> bins(64);
+
+    for(auto _ : state)
+    {
+        hsd::simd::histogram(values.data(), size, 0.0f, 500.0f, bins.data(), 64);
+        benchmark::ClobberMemory();
+    }
+
+    set_bytes(state, 1);
+}
+
+static void scalarAdd(benchmark::State& state)
+{
+    auto lhs = make_values(), rhs = make_values();
+    hsd::vector<hsd::f32> out(size);
+
+    for(auto _ : state)
+    {
+        for(hsd::usize i = 0; i < size; i++)
+            out[i] = lhs[i] + rhs[i];
+
+        benchmark::ClobberMemory();
+    }
+
+    set_bytes(state, 3);
+}
+
+static void simdAdd(benchmark::State& state)
+{
+    auto lhs = make_values(), rhs = make_values();
+    hsd::vector<hsd::f32> out(size);
+
+    for(auto _ : state)
+    {
+        hsd::simd::add(lhs.data(), rhs.data(), out.data(), size);
+        benchmark::ClobberMemory();
+    }
+
+    set_bytes(state, 3);
+}
+
+BENCHMARK(scalarSum);
+BENCHMARK(simdSum);
+BENCHMARK(scalarDot);
+BENCHMARK(simdDot);
+BENCHMARK(scalarMax);
+BENCHMARK(simdMax);
+BENCHMARK(scalarAxpy);
+BENCHMARK(simdAxpy);
+BENCHMARK(scalarPrefixSum);
+BENCHMARK(simdPrefixSum);
+BENCHMARK(scalarHistogram);
+BENCHMARK(simdHistogram);
+BENCHMARK(scalarAdd);
+BENCHMARK(simdAdd);
+
+BENCHMARK_MAIN();
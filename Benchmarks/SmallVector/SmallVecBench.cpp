@@ -0,0 +1,36 @@
+#include "../../cpp/SmallVector.hpp"
+#include "../../cpp/StaticVector.hpp"
+#include "../../cpp/Vector.hpp"
+
+#include <benchmark/benchmark.h>
+
+// Builds and sums a short list, the way a request handler would
+template <typename Vec>
+static void shortList(benchmark::State& state)
+{
+    auto count = static_cast<hsd::usize>(state.range(0));
+
+    for(auto _ : state)
+    {
+        Vec list;
+
+        for(hsd::usize index = 0; index < count; index++)
+            list.push_back(static_cast<hsd::i32>(index));
+
+        hsd::i32 total = 0;
+
+        for(auto value : list)
+            total += value;
+
+        benchmark::DoNotOptimize(total);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_TEMPLATE(shortList, hsd::vector<hsd::i32>)->Arg(4)->Arg(8)->Arg(32);
+BENCHMARK_TEMPLATE(shortList, hsd::static_vector<hsd::i32, 32>)->Arg(4)->Arg(8)->Arg(32);
+BENCHMARK_TEMPLATE(shortList, hsd::small_vector<hsd::i32, 8>)->Arg(4)->Arg(8)->Arg(32);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,73 @@
+#include "../../cpp/Sync.hpp"
+#include "../../cpp/Thread.hpp"
+
+#include <pthread.h>
+#include <benchmark/benchmark.h>
+
+static hsd::mutex hsd_mutex;
+static pthread_mutex_t posix_mutex = PTHREAD_MUTEX_INITIALIZER;
+static hsd::shared_mutex hsd_rwlock;
+static pthread_rwlock_t posix_rwlock = PTHREAD_RWLOCK_INITIALIZER;
+static hsd::u64 shared_counter = 0;
+
+// Uncontended at one thread, contended above it
+static void hsdMutex(benchmark::State& state)
+{
+    for(auto _ : state)
+    {
+        hsd_mutex.lock();
+        benchmark::DoNotOptimize(++shared_counter);
+        hsd_mutex.unlock();
+    }
+}
+
+static void pthreadMutex(benchmark::State& state)
+{
+    for(auto _ : state)
+    {
+        pthread_mutex_lock(&posix_mutex);
+        benchmark::DoNotOptimize(++shared_counter);
+        pthread_mutex_unlock(&posix_mutex);
+    }
+}
+
+static void hsdSharedMutexRead(benchmark::State& state)
+{
+    for(auto _ : state)
+    {
+        hsd_rwlock.lock_shared();
+        benchmark::DoNotOptimize(shared_counter);
+        hsd_rwlock.unlock_shared();
+    }
+}
+
+static void pthreadRwlockRead(benchmark::State& state)
+{
+    for(auto _ : state)
+    {
+        pthread_rwlock_rdlock(&posix_rwlock);
+        benchmark::DoNotOptimize(shared_counter);
+        pthread_rwlock_unlock(&posix_rwlock);
+    }
+}
+
+static void hsdThreadStart(benchmark::State& state)
+{
+    for(auto _ : state)
+    {
+        hsd::thread thread{[] {}};
+        thread.join();
+    }
+}
+
+BENCHMARK(hsdMutex)->ThreadRange(1, 8)->UseRealTime();
+
+BENCHMARK(pthreadMutex)->ThreadRange(1, 8)->UseRealTime();
+
+BENCHMARK(hsdSharedMutexRead)->ThreadRange(1, 8)->UseRealTime();
+
+BENCHMARK(pthreadRwlockRead)->ThreadRange(1, 8)->UseRealTime();
+
+BENCHMARK(hsdThreadStart)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -46,8 +46,48 @@ static void stdMap(benchmark::State& state)
     }
 }
 
+static void hsdBulkInsert(benchmark::State& state)
+{
+    for(auto _ : state)
+    {
+        hsd::unordered_map<hsd::u64, hsd::u64> map;
+
+        if(state.range(1))
+            map.reserve(static_cast<hsd::usize>(state.range(0)));
+
+        for(hsd::u64 i = 0; i < static_cast<hsd::u64>(state.range(0)); i++)
+            map.emplace(i * 64, i);
+
+        benchmark::DoNotOptimize(map);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void stdBulkInsert(benchmark::State& state)
+{
+    for(auto _ : state)
+    {
+        std::unordered_map<hsd::u64, hsd::u64> map;
+
+        if(state.range(1))
+            map.reserve(static_cast<hsd::usize>(state.range(0)));
+
+        for(hsd::u64 i = 0; i < static_cast<hsd::u64>(state.range(0)); i++)
+            map.emplace(i * 64, i);
+
+        benchmark::DoNotOptimize(map);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
 BENCHMARK(hsdMap);
 
 BENCHMARK(stdMap);
 
+BENCHMARK(hsdBulkInsert)->Args({1 << 20, 0})->Args({1 << 20, 1});
+
+BENCHMARK(stdBulkInsert)->Args({1 << 20, 0})->Args({1 << 20, 1});
+
 BENCHMARK_MAIN();
\ No newline at end of file
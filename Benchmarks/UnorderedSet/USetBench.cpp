@@ -0,0 +1,143 @@
+#include "../../cpp/UnorderedSet.hpp"
+#include "../../cpp/String.hpp"
+
+#include <string>
+#include <unordered_set>
+#include <stdio.h>
+#include <stdlib.h>
+#include <benchmark/benchmark.h>
+
+// Ingest keys as they come off the wire, a quarter of them repeats
+static hsd::vector<hsd::u8string> ingest_keys(hsd::usize size)
+{
+    hsd::vector<hsd::u8string> keys;
+    char buffer[32];
+    srand(1);
+
+    for(hsd::usize index = 0; index < size; index++)
+    {
+        snprintf(buffer, sizeof(buffer), "sensor-%08d", rand() % static_cast<hsd::i32>(size * 3 / 4));
+        keys.push_back(buffer);
+    }
+
+    return keys;
+}
+
+static hsd::vector<const char*> raw_keys(hsd::vector<hsd::u8string>& keys)
+{
+    hsd::vector<const char*> raw;
+
+    for(auto& key : keys)
+        raw.push_back(key.c_str());
+
+    return raw;
+}
+
+// What dedup used to look like, a map with dummy values probed with strings
+static void dedupMapDummy(benchmark::State& state)
+{
+    auto keys = ingest_keys(static_cast<hsd::usize>(state.range(0)));
+    auto raw = raw_keys(keys);
+
+    for(auto _ : state)
+    {
+        hsd::unordered_map<hsd::u8string, bool> seen;
+
+        for(auto key : raw)
+            seen.emplace(hsd::u8string{key}, true);
+
+        benchmark::DoNotOptimize(seen.size());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void dedupSetInsert(benchmark::State& state)
+{
+    auto keys = ingest_keys(static_cast<hsd::usize>(state.range(0)));
+    auto raw = raw_keys(keys);
+
+    for(auto _ : state)
+    {
+        hsd::unordered_set<hsd::u8string> seen;
+
+        for(auto key : raw)
+            seen.insert(key);
+
+        benchmark::DoNotOptimize(seen.size());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void dedupSetInsertMany(benchmark::State& state)
+{
+    auto keys = ingest_keys(static_cast<hsd::usize>(state.range(0)));
+    auto raw = raw_keys(keys);
+
+    for(auto _ : state)
+    {
+        hsd::unordered_set<hsd::u8string> seen;
+        seen.insert_many(raw.begin(), raw.end());
+        benchmark::DoNotOptimize(seen.size());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void dedupStd(benchmark::State& state)
+{
+    auto keys = ingest_keys(static_cast<hsd::usize>(state.range(0)));
+    auto raw = raw_keys(keys);
+
+    for(auto _ : state)
+    {
+        std::unordered_set<std::string> seen;
+
+        for(auto key : raw)
+            seen.emplace(key);
+
+        benchmark::DoNotOptimize(seen.size());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <bool Batched>
+static void intInsert(benchmark::State& state)
+{
+    hsd::vector<hsd::u64> keys;
+    srand(2);
+
+    for(hsd::i64 index = 0; index < state.range(0); index++)
+        keys.push_back((static_cast<hsd::u64>(rand()) << 31) | rand());
+
+    for(auto _ : state)
+    {
+        hsd::unordered_set<hsd::u64> set;
+        set.reserve(keys.size());
+
+        if constexpr(Batched)
+        {
+            set.insert_many(keys.begin(), keys.end());
+        }
+        else
+        {
+            for(auto key : keys)
+                set.insert(key);
+        }
+
+        benchmark::DoNotOptimize(set.size());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(dedupMapDummy)->Arg(1 << 18);
+BENCHMARK(dedupSetInsert)->Arg(1 << 18);
+BENCHMARK(dedupSetInsertMany)->Arg(1 << 18);
+BENCHMARK(dedupStd)->Arg(1 << 18);
+BENCHMARK_TEMPLATE(intInsert, false)->Arg(1 << 22);
+BENCHMARK_TEMPLATE(intInsert, true)->Arg(1 << 22);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,143 @@
+#include "../../cpp/Algorithm.hpp"
+#include "../../cpp/Io.hpp"
+
+#include <stdlib.h>
+
+struct record
+{
+    hsd::i32 key = 0;
+    hsd::usize order = 0;
+};
+
+template < typename It, typename Comp = hsd::less >
+static bool is_sorted(It first, It last, Comp comp = {})
+{
+    for(It it = first; it + 1 < last; ++it)
+    {
+        if(comp(*(it + 1), *it))
+            return false;
+    }
+
+    return true;
+}
+
+static hsd::vector<hsd::i32> random_values(hsd::usize size, hsd::i32 range)
+{
+    hsd::vector<hsd::i32> values(size);
+
+    for(auto& value : values)
+        value = rand() % range;
+
+    return values;
+}
+
+int main()
+{
+    srand(7);
+    // A small private pool so the parallel paths run even on one CPU
+    hsd::thread_pool pool{3};
+    auto par = hsd::execution::par.on(pool);
+
+    for(hsd::usize size : {0ul, 1ul, 50ul, 1000ul, 300000ul})
+    {
+        auto values = random_values(size, 1000);
+        auto copy = values;
+        hsd::sort(values.begin(), values.end());
+        hsd::sort(par, copy.begin(), copy.end());
+
+        bool same = true;
+
+        for(hsd::usize i = 0; i < size; i++)
+            same &= values[i] == copy[i];
+
+        hsd::io::print<"sort {}: {} {} {}\n">(size, is_sorted(values.begin(), values.end()),
+            is_sorted(copy.begin(), copy.end()), same);
+    }
+
+    // Patterns pdqsort has to survive: sorted, reversed, all equal, organ pipe
+    {
+        hsd::vector<hsd::i32> sorted(100000), reversed(100000), equal(100000), pipe(100000);
+
+        for(hsd::i32 i = 0; i < 100000; i++)
+        {
+            sorted[i] = i;
+            reversed[i] = 100000 - i;
+            equal[i] = 42;
+            pipe[i] = i < 50000 ? i : 100000 - i;
+        }
+
+        hsd::sort(sorted.begin(), sorted.end());
+        hsd::sort(reversed.begin(), reversed.end(), hsd::greater{});
+        hsd::sort(equal.begin(), equal.end());
+        hsd::sort(pipe.begin(), pipe.end());
+
+        hsd::io::print<"patterns: {} {} {} {}\n">(is_sorted(sorted.begin(), sorted.end()),
+            is_sorted(reversed.begin(), reversed.end(), hsd::greater{}),
+            is_sorted(equal.begin(), equal.end()), is_sorted(pipe.begin(), pipe.end()));
+    }
+
+    {
+        hsd::vector<record> records(200000), copy;
+
+        for(hsd::usize i = 0; i < records.size(); i++)
+            records[i] = {rand() % 100, i};
+
+        copy = records;
+        auto by_key = [](const record& lhs, const record& rhs) { return lhs.key < rhs.key; };
+        auto stable = [](const record& lhs, const record& rhs) {
+            return lhs.key < rhs.key || (lhs.key == rhs.key && lhs.order < rhs.order);
+        };
+
+        hsd::stable_sort(records.begin(), records.end(), by_key);
+        hsd::stable_sort(par, copy.begin(), copy.end(), by_key);
+        hsd::io::print<"stable_sort: {} {}\n">(is_sorted(records.begin(), records.end(), stable),
+            is_sorted(copy.begin(), copy.end(), stable));
+    }
+
+    {
+        auto values = random_values(500000, 1000);
+        auto is_small = [](hsd::i32 value) { return value < 300; };
+        auto mid = hsd::partition(par, values.begin(), values.end(), is_small);
+        bool ok = true;
+
+        for(auto it = values.begin(); it != values.end(); ++it)
+            ok &= is_small(*it) == (it < mid);
+
+        hsd::io::print<"partition: {}\n">(ok);
+    }
+
+    {
+        auto values = random_values(400000, 100000);
+        auto copy = values;
+        auto sorted = values;
+        hsd::sort(sorted.begin(), sorted.end());
+
+        hsd::usize nth = 123456;
+        hsd::nth_element(values.begin(), values.begin() + nth, values.end());
+        hsd::nth_element(par, copy.begin(), copy.begin() + nth, copy.end());
+        hsd::io::print<"nth_element: {} {}\n">(values[nth] == sorted[nth], copy[nth] == sorted[nth]);
+    }
+
+    {
+        hsd::vector<hsd::u64> values(1000000);
+
+        for(hsd::usize i = 0; i < values.size(); i++)
+            values[i] = i + 1;
+
+        hsd::io::print<"reduce: {} {}\n">(hsd::reduce(values.begin(), values.end(), hsd::u64{0}),
+            hsd::reduce(par, values.begin(), values.end(), hsd::u64{0}));
+
+        hsd::vector<hsd::u64> scanned(values.size());
+        hsd::inclusive_scan(par, values.begin(), values.end(), scanned.begin());
+        hsd::io::print<"inclusive_scan: {} {}\n">(scanned[999], scanned[999999]);
+
+        hsd::vector<hsd::u64> doubled(values.size());
+        hsd::transform(par, values.begin(), values.end(), doubled.begin(), [](hsd::u64 value) { return value * 2; });
+        hsd::for_each(par, doubled.begin(), doubled.end(), [](hsd::u64& value) { value += 1; });
+        hsd::io::print<"transform + for_each: {} {}\n">(doubled[0], doubled[999999]);
+
+        auto found = hsd::find_if(par, values.begin(), values.end(), [](hsd::u64 value) { return value % 777777 == 0; });
+        auto missing = hsd::find_if(par, values.begin(), values.end(), [](hsd::u64 value) { return value == 0; });
+        hsd::io::print<"find_if: {} {}\n">(*found, missing == values.end());
+    }
+}
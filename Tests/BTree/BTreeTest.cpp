@@ -0,0 +1,135 @@
+#include "../../cpp/BTree.hpp"
+#include "../../cpp/String.hpp"
+
+#include <map>
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+
+// Large enough that nodes hold only a few entries, so the tree gets tall
+struct wide_key
+{
+    hsd::i64 value;
+    char padding[120];
+
+    wide_key(hsd::i64 val = 0) : value{val} {}
+
+    friend bool operator<(const wide_key& lhs, const wide_key& rhs)
+    {
+        return lhs.value < rhs.value;
+    }
+};
+
+template <typename Map>
+static void check_same(Map& map, std::map<hsd::i64, hsd::i64>& expected)
+{
+    assert(map.size() == expected.size());
+    auto _it = map.begin();
+
+    for(auto& [key, value] : expected)
+    {
+        assert(_it != map.end());
+        assert(static_cast<hsd::i64>(_it.key().value) == key && _it.value() == value);
+        ++_it;
+    }
+
+    assert(_it == map.end());
+
+    for(auto _rit = expected.rbegin(); _rit != expected.rend(); ++_rit)
+    {
+        --_it;
+        assert(_it.key().value == _rit->first);
+    }
+}
+
+int main()
+{
+    {
+        hsd::btree_map<wide_key, hsd::i64> map;
+        std::map<hsd::i64, hsd::i64> expected;
+        srand(7);
+
+        for(hsd::i32 round = 0; round < 20000; round++)
+        {
+            hsd::i64 key = rand() % 2000;
+
+            if(rand() % 3 != 0)
+            {
+                map[key] = key * 2;
+                expected[key] = key * 2;
+            }
+            else
+            {
+                assert(map.erase(wide_key{key}) == (expected.erase(key) == 1));
+            }
+        }
+
+        check_same(map, expected);
+
+        for(hsd::i64 key = -1; key <= 2000; key++)
+        {
+            auto lower = map.lower_bound(wide_key{key});
+            auto upper = map.upper_bound(wide_key{key});
+            auto exp_lower = expected.lower_bound(key);
+            auto exp_upper = expected.upper_bound(key);
+
+            assert((lower == map.end()) == (exp_lower == expected.end()));
+            assert((upper == map.end()) == (exp_upper == expected.end()));
+            assert(lower == map.end() || lower.key().value == exp_lower->first);
+            assert(upper == map.end() || upper.key().value == exp_upper->first);
+        }
+
+        auto copy = map;
+        check_same(copy, expected);
+
+        for(auto _it = copy.begin(); _it != copy.end();)
+            _it = copy.erase(_it);
+
+        assert(copy.empty() && copy.height() == 0);
+        printf("random: %zu keys, height %zu\n", map.size(), map.height());
+    }
+    {
+        hsd::vector<hsd::pair<hsd::i64, hsd::i64>> sorted;
+
+        for(hsd::i64 key = 0; key < 100000; key++)
+            sorted.push_back({key * 10, key});
+
+        hsd::btree_map<hsd::i64, hsd::i64> index;
+        index.bulk_load(sorted.begin(), sorted.end());
+        assert(index.size() == 100000 && index.at(500) == 50);
+
+        // Range scan over [1000, 2000)
+        hsd::i64 total = 0;
+
+        for(auto _it = index.lower_bound(1000); _it != index.end() && _it->first < 2000; ++_it)
+            total += _it->second;
+
+        index.emplace(5, 99);
+        index.erase(0);
+        printf("bulk: height %zu, range sum %lld, first %lld\n", index.height(), total, index.begin()->first);
+
+        // Unsorted input throws and leaves the tree empty
+        sorted[50].first = -1;
+        bool threw = false;
+
+        try
+        {
+            index.bulk_load(sorted.begin(), sorted.end());
+        }
+        catch(const std::runtime_error&)
+        {
+            threw = true;
+        }
+
+        assert(threw && index.size() == 0 && index.begin() == index.end());
+    }
+    {
+        hsd::btree_set<hsd::u8string> names = {"delta", "alpha", "charlie", "bravo"};
+        names.insert("alpha");
+
+        for(auto& name : names)
+            printf("%s ", name.c_str());
+
+        printf("| %zu names\n", names.size());
+    }
+}
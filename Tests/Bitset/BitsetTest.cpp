@@ -0,0 +1,204 @@
+#include "../../cpp/Bitset.hpp"
+
+#include <bitset>
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+
+template <hsd::usize N>
+static void check_fixed()
+{
+    hsd::bitset<N> bits, other;
+    std::bitset<N> expected, expected_other;
+
+    for(hsd::usize round = 0; round < 4 * N; round++)
+    {
+        hsd::usize index = static_cast<hsd::usize>(rand()) % N;
+        bits.flip(index);
+        expected.flip(index);
+
+        index = static_cast<hsd::usize>(rand()) % N;
+        other.set(index);
+        expected_other.set(index);
+    }
+
+    auto same = [](const hsd::bitset<N>& lhs, const std::bitset<N>& rhs)
+    {
+        if(lhs.count() != rhs.count() || lhs.any() != rhs.any() || lhs.all() != rhs.all())
+            return false;
+
+        for(hsd::usize index = 0; index < N; index++)
+        {
+            if(lhs[index] != rhs[index])
+                return false;
+        }
+
+        return true;
+    };
+
+    assert(same(bits, expected));
+    assert(same(bits & other, expected & expected_other));
+    assert(same(bits | other, expected | expected_other));
+    assert(same(bits ^ other, expected ^ expected_other));
+    assert(same(~bits, ~expected));
+    assert(same(hsd::bitset<N>{bits}.and_not(other), expected & ~expected_other));
+
+    for(hsd::usize shift : {0ul, 1ul, 63ul, 64ul, 65ul, N / 2, N - 1, N, N + 7})
+    {
+        assert(same(bits << shift, expected << shift));
+        assert(same(bits >> shift, expected >> shift));
+    }
+
+    hsd::usize visited = 0;
+    hsd::usize next = bits.find_first();
+
+    for(auto index : bits.ones())
+    {
+        assert(expected[index] && index == next);
+        next = bits.find_next(index);
+        visited++;
+    }
+
+    assert(next == bits.npos && visited == expected.count());
+    assert(same(hsd::bitset<N>{}.set(), std::bitset<N>{}.set()));
+    assert(hsd::bitset<N>{}.none() && bits == bits && bits != ~bits);
+}
+
+static void check_rank_select(const hsd::dynamic_bitset& bits)
+{
+    hsd::rank_select index(bits);
+    hsd::usize ones = 0;
+
+    for(hsd::usize pos = 0; pos < bits.size(); pos++)
+    {
+        assert(index.rank1(pos) == ones);
+
+        if(bits[pos])
+        {
+            assert(index.select1(ones) == pos);
+            ones++;
+        }
+    }
+
+    assert(index.rank1(bits.size()) == ones && index.count() == ones);
+    assert(index.rank0(bits.size()) == bits.size() - ones);
+}
+
+int main()
+{
+    srand(11);
+
+    check_fixed<1>();
+    check_fixed<64>();
+    check_fixed<100>();
+    check_fixed<1000>();
+
+    constexpr hsd::bitset<70> compile_time = hsd::bitset<70>{0b1011} << 64;
+    static_assert(compile_time.count() == 3 && compile_time[64] && !compile_time[66]);
+
+    auto best = hsd::simd::detected();
+
+    for(auto target : {hsd::simd::level::scalar, hsd::simd::level::sse,
+        hsd::simd::level::avx2, hsd::simd::level::avx512})
+    {
+        if(target > best)
+            break;
+
+        hsd::simd::set_level(target);
+
+        // Odd sizes leave a partial last word and vector loop tails
+        hsd::usize size = 10007;
+        hsd::dynamic_bitset lhs(size), rhs(size, true);
+        std::vector<bool> expected_lhs(size), expected_rhs(size, true);
+
+        for(hsd::usize round = 0; round < size; round++)
+        {
+            hsd::usize index = static_cast<hsd::usize>(rand()) % size;
+            lhs.set(index);
+            expected_lhs[index] = true;
+
+            index = static_cast<hsd::usize>(rand()) % size;
+            rhs.reset(index);
+            expected_rhs[index] = false;
+        }
+
+        auto matches = [&](const hsd::dynamic_bitset& bits, auto&& expect)
+        {
+            hsd::usize expected_count = 0;
+
+            for(hsd::usize index = 0; index < size; index++)
+            {
+                if(bits[index] != expect(index))
+                    return false;
+
+                expected_count += expect(index);
+            }
+
+            return bits.count() == expected_count;
+        };
+
+        assert(matches(lhs, [&](hsd::usize i) { return expected_lhs[i]; }));
+        assert(matches(lhs & rhs, [&](hsd::usize i) { return expected_lhs[i] && expected_rhs[i]; }));
+        assert(matches(lhs | rhs, [&](hsd::usize i) { return expected_lhs[i] || expected_rhs[i]; }));
+        assert(matches(lhs ^ rhs, [&](hsd::usize i) { return expected_lhs[i] != expected_rhs[i]; }));
+        assert(matches(hsd::dynamic_bitset{lhs}.and_not(rhs), [&](hsd::usize i) { return expected_lhs[i] && !expected_rhs[i]; }));
+        assert(lhs.intersect_count(rhs) == (lhs & rhs).count());
+
+        bool threw = false;
+
+        try
+        {
+            lhs &= hsd::dynamic_bitset(size + 1);
+        }
+        catch(const std::runtime_error&)
+        {
+            threw = true;
+        }
+
+        assert(threw);
+        check_rank_select(lhs);
+    }
+
+    hsd::dynamic_bitset grown;
+
+    for(hsd::usize index = 0; index < 200; index++)
+        grown.push_back(index % 3 == 0);
+
+    assert(grown.size() == 200 && grown.count() == 67);
+    grown.resize(300, true);
+    assert(grown.count() == 167 && grown.all() == false);
+    grown.resize(130);
+    assert(grown.count() == 44 && grown.find_next(129) == grown.npos);
+
+    while(grown.size() > 64)
+        grown.pop_back();
+
+    assert(grown.count() == 22 && grown.word_count() == 1);
+
+    // Sparse and dense, so select crosses both empty blocks and many hints
+    hsd::dynamic_bitset sparse(200000), dense(50000);
+
+    for(hsd::usize index = 0; index < sparse.size(); index += 997)
+        sparse.set(index);
+    for(hsd::usize index = 0; index < dense.size(); index++)
+        dense.set(index, rand() % 8 != 0);
+
+    check_rank_select(sparse);
+    check_rank_select(dense);
+    check_rank_select(hsd::dynamic_bitset{});
+
+    bool threw = false;
+
+    try
+    {
+        (void)grown.at(64);
+    }
+    catch(const std::out_of_range&)
+    {
+        threw = true;
+    }
+
+    assert(threw);
+    puts("bitset, dynamic_bitset and rank_select match std::bitset, std::vector<bool> and brute force");
+}
@@ -0,0 +1,93 @@
+#include "../../cpp/BloomFilter.hpp"
+#include "../../cpp/Thread.hpp"
+#include "../../cpp/String.hpp"
+
+#include <algorithm>
+#include <stdio.h>
+#include <assert.h>
+
+int main()
+{
+    constexpr hsd::u64 keys = 100000;
+    constexpr hsd::u64 workers = 4;
+    hsd::bloom_filter<hsd::u64> merged(keys, 0.01);
+
+    // Each thread fills its own filter, they're merged once all are done
+    {
+        hsd::vector<hsd::bloom_filter<hsd::u64>> locals;
+        hsd::vector<hsd::thread> threads;
+
+        for(hsd::u64 worker = 0; worker < workers; worker++)
+            locals.push_back(hsd::bloom_filter<hsd::u64>(keys, 0.01));
+
+        for(hsd::u64 worker = 0; worker < workers; worker++)
+        {
+            threads.emplace_back([&locals, worker]
+            {
+                for(hsd::u64 key = worker; key < keys; key += workers)
+                    locals[worker].insert(key);
+            });
+        }
+
+        for(auto& thread : threads)
+            thread.join();
+        for(auto& local : locals)
+            merged.merge(local);
+    }
+
+    for(hsd::u64 key = 0; key < keys; key++)
+        assert(merged.contains(key));
+
+    hsd::u64 false_positives = 0;
+
+    for(hsd::u64 key = keys; key < 11 * keys; key++)
+        false_positives += merged.contains(key);
+
+    // The sizing accounts for blocking, so the target holds at full load
+    hsd::f64 rate = static_cast<hsd::f64>(false_positives) / static_cast<hsd::f64>(10 * keys);
+    assert(rate < 0.01);
+    assert(merged.false_positive_rate() < 0.01);
+
+    auto bytes = merged.serialize();
+    auto restored = hsd::bloom_filter<hsd::u64>::deserialize(bytes);
+    auto reserialized = restored.serialize();
+    assert(std::equal(reserialized.begin(), reserialized.end(), bytes.begin(), bytes.end()));
+    assert(restored.contains(keys - 1) && restored.hash_count() == merged.hash_count());
+
+    bool threw = false;
+
+    try
+    {
+        bytes.pop_back();
+        (void)hsd::bloom_filter<hsd::u64>::deserialize(bytes);
+    }
+    catch(const std::runtime_error&)
+    {
+        threw = true;
+    }
+
+    assert(threw);
+    threw = false;
+
+    try
+    {
+        merged.merge(hsd::bloom_filter<hsd::u64>(keys * 2, 0.01));
+    }
+    catch(const std::runtime_error&)
+    {
+        threw = true;
+    }
+
+    assert(threw);
+
+    // Strings, views and C strings hash alike, so any of them can probe
+    hsd::bloom_filter<hsd::u8string> names(1000, 0.001);
+    names.insert(hsd::u8string{"edge-node-17"});
+    assert(names.contains("edge-node-17") && names.contains(hsd::u8string_view{"edge-node-17"}));
+
+    names.clear();
+    assert(!names.contains("edge-node-17"));
+
+    printf("bloom filter: %u hashes, %zu bits, false positive rate %.4f\n",
+        merged.hash_count(), merged.bit_count(), rate);
+}
@@ -0,0 +1,44 @@
+#include "../../cpp/ConcurrentHashMap.hpp"
+#include "../../cpp/Thread.hpp"
+#include "../../cpp/Io.hpp"
+
+static hsd::concurrent_hash_map<hsd::u64, hsd::u64> map;
+
+static void worker(hsd::u64 id)
+{
+    // Disjoint inserts per thread, shared counters through compute
+    for(hsd::u64 i = 0; i < 10000; i++)
+    {
+        map.insert_or_assign(id * 1'000'000 + i, i);
+        map.compute(i % 16, [](hsd::u64& value, bool) { return ++value; });
+    }
+    for(hsd::u64 i = 0; i < 10000; i += 2)
+        map.erase(id * 1'000'000 + i);
+}
+
+int main()
+{
+    hsd::thread threads[4];
+
+    for(hsd::u64 i = 0; i < 4; i++)
+        threads[i] = hsd::thread{worker, i + 1};
+
+    for(auto& thread : threads)
+        thread.join();
+
+    hsd::u64 counter = 0, value = 0;
+    hsd::u64 total = 0;
+
+    for(hsd::u64 i = 0; i < 16; i++)
+    {
+        map.find(i, counter);
+        total += counter;
+    }
+
+    hsd::io::print<"size: {}\n">(map.size());
+    hsd::io::print<"counter total: {}\n">(total);
+    hsd::io::print<"odd key kept: {}, even key erased: {}\n">(
+        map.find(2'000'001, value) && value == 1, !map.contains(2'000'002)
+    );
+    hsd::io::print<"assign existing inserts: {}\n">(map.insert_or_assign(2'000'001, 7));
+}
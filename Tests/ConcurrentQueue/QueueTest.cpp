@@ -0,0 +1,86 @@
+#include "../../cpp/ConcurrentQueue.hpp"
+#include "../../cpp/Thread.hpp"
+#include "../../cpp/Io.hpp"
+
+static constexpr hsd::u64 item_count = 100000;
+
+static hsd::blocking_queue< hsd::spsc_queue<hsd::u64, 256> > stage1;
+static hsd::blocking_queue< hsd::mpmc_queue<hsd::u64> > stage2{64};
+
+// Two stage pipeline: one producer, one relay, two consumers
+static void produce()
+{
+    hsd::u64 batch[16];
+
+    for(hsd::u64 i = 0; i < item_count; i += 16)
+    {
+        for(hsd::u64 j = 0; j < 16; j++)
+            batch[j] = i + j + 1;
+
+        stage1.push_n(batch, 16);
+    }
+
+    stage1.push(0);
+}
+
+static void relay()
+{
+    hsd::u64 value = 0;
+
+    do
+    {
+        stage1.pop(value);
+        stage2.push(value);
+    } while(value != 0);
+
+    // One end marker per consumer
+    stage2.push(0);
+}
+
+static void consume(hsd::u64* sum)
+{
+    hsd::u64 values[8];
+
+    while(true)
+    {
+        hsd::usize count = stage2.pop_n(values, 8);
+
+        for(hsd::usize i = 0; i < count; i++)
+        {
+            if(values[i] == 0)
+            {
+                // Leave the rest of the batch to the other consumer
+                stage2.push_n(values + i + 1, count - i - 1);
+                return;
+            }
+
+            *sum += values[i];
+        }
+    }
+}
+
+int main()
+{
+    hsd::spsc_queue<hsd::i32, 4> small;
+    hsd::i32 items[] = {1, 2, 3, 4, 5};
+    hsd::i32 out[8]{};
+
+    hsd::io::print<"pushed {} of 5\n">(small.try_push_n(items, 5));
+    hsd::io::print<"full: {}\n">(!small.try_push(6));
+    hsd::io::print<"popped {}, first {}\n">(small.try_pop_n(out, 8), out[0]);
+
+    hsd::mpmc_queue<hsd::i32> shared{3};
+    hsd::io::print<"capacity rounded to {}\n">(shared.capacity());
+
+    hsd::u64 sums[2]{};
+    hsd::thread threads[4];
+    threads[0] = hsd::thread{consume, &sums[0]};
+    threads[1] = hsd::thread{consume, &sums[1]};
+    threads[2] = hsd::thread{relay};
+    threads[3] = hsd::thread{produce};
+
+    for(auto& thread : threads)
+        thread.join();
+
+    hsd::io::print<"sum: {}, expected {}\n">(sums[0] + sums[1], item_count * (item_count + 1) / 2);
+}
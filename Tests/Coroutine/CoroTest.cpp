@@ -0,0 +1,133 @@
+#include "../../cpp/EventLoop.hpp"
+#include "../../cpp/Io.hpp"
+
+static hsd::generator<hsd::u64> fibonacci(hsd::usize count)
+{
+    hsd::u64 a = 0, b = 1;
+
+    for(hsd::usize i = 0; i < count; i++)
+    {
+        co_yield a;
+        a = hsd::exchange(b, a + b);
+    }
+}
+
+static hsd::task<hsd::i32> square(hsd::i32 value)
+{
+    co_return value * value;
+}
+
+static hsd::task<hsd::i32> sum_of_squares(hsd::i32 count)
+{
+    hsd::i32 sum = 0;
+
+    for(hsd::i32 i = 1; i <= count; i++)
+        sum += co_await square(i);
+
+    co_return sum;
+}
+
+static hsd::task<void> handle_client(hsd::async_socket client)
+{
+    char buf[256];
+
+    while(true)
+    {
+        hsd::isize received = co_await client.recv(buf);
+
+        if(received <= 0)
+            co_return;
+
+        co_await client.send_all(buf, static_cast<hsd::usize>(received));
+    }
+}
+
+static hsd::task<void> serve(hsd::event_loop& loop, hsd::async_socket& listener, hsd::usize clients)
+{
+    for(hsd::usize i = 0; i < clients; i++)
+    {
+        hsd::async_socket client = co_await listener.accept();
+
+        if(client.is_valid())
+            loop.spawn(handle_client(hsd::move(client)));
+    }
+}
+
+static hsd::usize echoed = 0;
+
+static hsd::task<void> client(hsd::event_loop& loop, hsd::u16 port, hsd::i32 id)
+{
+    hsd::async_socket sock = co_await hsd::async_socket::connect(loop, "127.0.0.1", port);
+
+    if(!sock.is_valid())
+        co_return;
+
+    for(hsd::i32 round = 0; round < 3; round++)
+    {
+        char message[32], reply[32];
+        hsd::i32 len = snprintf(message, sizeof(message), "client %d round %d", id, round);
+
+        co_await sock.send_all(message, static_cast<hsd::usize>(len));
+
+        hsd::isize got = 0;
+
+        while(got < len)
+        {
+            hsd::isize received = co_await sock.recv(reply + got, static_cast<hsd::usize>(len - got));
+
+            if(received <= 0)
+                co_return;
+
+            got += received;
+        }
+
+        if(memcmp(message, reply, static_cast<hsd::usize>(len)) == 0)
+            echoed++;
+    }
+}
+
+static hsd::task<void> read_one(hsd::async_socket& sock, hsd::isize& result)
+{
+    char buf[8];
+    result = co_await sock.recv(buf);
+}
+
+static hsd::task<void> write_one(hsd::async_socket& sock)
+{
+    co_await sock.send("x", 1);
+}
+
+int main()
+{
+    for(auto value : fibonacci(10))
+        hsd::io::print<"{} ">(value);
+
+    hsd::io::print<"\n">();
+
+    hsd::event_loop loop;
+    hsd::io::print<"sum of squares: {}\n">(loop.block_on(sum_of_squares(1000)));
+
+    constexpr hsd::usize clients = 200;
+    constexpr hsd::u16 port = 54329;
+    hsd::async_socket listener = hsd::async_socket::listen(loop, port, "127.0.0.1");
+
+    loop.spawn(serve(loop, listener, clients));
+
+    for(hsd::usize i = 0; i < clients; i++)
+        loop.spawn(client(loop, port, static_cast<hsd::i32>(i)));
+
+    loop.run();
+    hsd::io::print<"echoed {} of {} messages\n">(echoed, clients * 3);
+
+    // Only one task can wait per direction, the second reader is turned away
+    hsd::i32 fds[2];
+    socketpair(AF_UNIX, SOCK_STREAM, 0, fds);
+    hsd::async_socket left{loop, fds[0]}, right{loop, fds[1]};
+    hsd::isize first = 0, second = 0;
+
+    loop.spawn(read_one(left, first));
+    loop.spawn(read_one(left, second));
+    loop.spawn(write_one(right));
+    loop.run();
+    hsd::io::print<"first reader: {}, second reader busy: {}\n">(first, second == -EBUSY);
+}
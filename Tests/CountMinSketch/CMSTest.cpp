@@ -0,0 +1,84 @@
+#include "../../cpp/CountMinSketch.hpp"
+#include "../../cpp/Thread.hpp"
+
+#include <algorithm>
+#include <stdio.h>
+#include <assert.h>
+
+int main()
+{
+    // Zipf-like stream: key k shows up about 10000 / (k + 1) times
+    constexpr hsd::u64 distinct = 5000;
+    constexpr hsd::f64 epsilon = 0.001;
+    hsd::vector<hsd::u32> exact(distinct);
+    hsd::vector<hsd::count_min_sketch<hsd::u64>> locals;
+    hsd::vector<hsd::thread> threads;
+
+    for(hsd::u64 key = 0; key < distinct; key++)
+        exact[key] = static_cast<hsd::u32>(10000 / (key + 1)) + 1;
+    for(hsd::u64 worker = 0; worker < 2; worker++)
+        locals.push_back(hsd::count_min_sketch<hsd::u64>(epsilon, 0.001));
+
+    // Each thread counts half the keys in its own sketch
+    for(hsd::u64 worker = 0; worker < 2; worker++)
+    {
+        threads.emplace_back([&locals, &exact, worker]
+        {
+            for(hsd::u64 key = worker; key < distinct; key += 2)
+            {
+                for(hsd::u32 round = 0; round < exact[key]; round++)
+                    locals[worker].add(key);
+            }
+        });
+    }
+
+    for(auto& thread : threads)
+        thread.join();
+
+    auto merged = locals[0];
+    merged.merge(locals[1]);
+
+    hsd::u64 total = 0;
+
+    for(auto count : exact)
+        total += count;
+
+    assert(merged.total() == total);
+
+    hsd::u64 over_bound = 0;
+
+    for(hsd::u64 key = 0; key < distinct; key++)
+    {
+        hsd::u32 estimate = merged.estimate(key);
+        assert(estimate >= exact[key]);
+        over_bound += estimate - exact[key] > epsilon * static_cast<hsd::f64>(total);
+    }
+
+    assert(over_bound == 0);
+
+    auto bytes = merged.serialize();
+    auto restored = hsd::count_min_sketch<hsd::u64>::deserialize(bytes);
+    auto reserialized = restored.serialize();
+    assert(std::equal(reserialized.begin(), reserialized.end(), bytes.begin(), bytes.end()));
+    assert(restored.estimate(0) == merged.estimate(0));
+    assert(restored.total() == total);
+
+    bool threw = false;
+
+    try
+    {
+        bytes[0] = 'X';
+        (void)hsd::count_min_sketch<hsd::u64>::deserialize(bytes);
+    }
+    catch(const std::runtime_error&)
+    {
+        threw = true;
+    }
+
+    assert(threw);
+    merged.clear();
+    assert(merged.total() == 0 && merged.estimate(0) == 0);
+
+    printf("count-min sketch: %zu x %u counters, %zu bytes serialized\n",
+        restored.width(), restored.depth(), bytes.size());
+}
@@ -0,0 +1,88 @@
+#include "../../cpp/Deque.hpp"
+#include "../../cpp/String.hpp"
+
+#include <deque>
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+
+int main()
+{
+    {
+        hsd::deque<hsd::i32> queue;
+        std::deque<hsd::i32> expected;
+        srand(5);
+
+        // Random walk so the contents drift across many chunks both ways
+        for(hsd::i32 round = 0; round < 200000; round++)
+        {
+            hsd::i32 op = expected.empty() ? rand() % 2 : rand() % 5;
+
+            if(op == 0 || op == 2)
+            {
+                queue.push_front(round);
+                expected.push_front(round);
+            }
+            else if(op == 1)
+            {
+                queue.push_back(round);
+                expected.push_back(round);
+            }
+            else if(op == 3)
+            {
+                queue.pop_front();
+                expected.pop_front();
+            }
+            else
+            {
+                queue.pop_back();
+                expected.pop_back();
+            }
+        }
+
+        assert(queue.size() == expected.size());
+
+        for(hsd::usize index = 0; index < expected.size(); index++)
+            assert(queue[index] == expected[index]);
+
+        hsd::usize index = 0;
+
+        for(auto value : queue)
+            assert(value == expected[index++]);
+
+        for(auto _it = queue.end(); _it != queue.begin();)
+            assert(*--_it == expected[--index]);
+
+        auto copy = queue;
+        assert(copy.size() == queue.size() && (copy.begin() + 100)[5] == expected[105]);
+        printf("random: %zu elements, front %d, back %d\n", queue.size(), queue.front(), queue.back());
+    }
+    {
+        // Ends exactly on chunk boundaries, 512 i64 per chunk
+        hsd::deque<hsd::i64> queue;
+
+        for(hsd::i64 index = 0; index < 512 * 3; index++)
+            queue.push_back(index);
+
+        hsd::i64 count = 0;
+
+        for(auto _it = queue.begin(); _it != queue.end(); ++_it)
+            assert(*_it == count++);
+
+        assert(count == 512 * 3 && queue.end() - queue.begin() == count);
+        assert(*(queue.end() - 1) == count - 1 && (queue.begin() + 700)[1] == 701);
+    }
+    {
+        hsd::deque<hsd::u8string> jobs = {"b", "c"};
+        jobs.emplace_front("a");
+        jobs.emplace_back("d");
+        auto moved = hsd::move(jobs);
+        moved.pop_front();
+
+        for(auto& job : moved)
+            printf("%s ", job.c_str());
+
+        moved.clear();
+        printf("| empty %d\n", moved.empty());
+    }
+}
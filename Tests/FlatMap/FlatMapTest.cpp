@@ -0,0 +1,104 @@
+#include "../../cpp/FlatMap.hpp"
+#include "../../cpp/String.hpp"
+
+#include <map>
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <stdexcept>
+
+// Refuses negative values, to check emplace leaves the map as it was
+struct positive
+{
+    hsd::i32 value = 0;
+
+    positive() = default;
+
+    positive(hsd::i32 init)
+        : value{init}
+    {
+        if(init < 0)
+            throw std::invalid_argument("negative");
+    }
+};
+
+template <typename Layout>
+static void check_layout(const char* name)
+{
+    hsd::flat_map<hsd::i32, hsd::i32, hsd::less, Layout> map;
+    std::map<hsd::i32, hsd::i32> expected;
+    hsd::vector<hsd::pair<hsd::i32, hsd::i32>> batch;
+    srand(3);
+
+    for(hsd::i32 round = 0; round < 5; round++)
+    {
+        batch.clear();
+
+        for(hsd::i32 index = 0; index < 1000; index++)
+        {
+            hsd::i32 key = rand() % 4000;
+            batch.push_back({key, round});
+            expected.emplace(key, round);
+        }
+
+        map.insert_range(batch.begin(), batch.end());
+    }
+
+    for(hsd::i32 key = 0; key < 4000; key += 7)
+    {
+        assert(map.erase(key) == (expected.erase(key) == 1));
+        map[key + 1] = -1;
+        expected[key + 1] = -1;
+    }
+
+    assert(map.size() == expected.size());
+    auto _it = map.begin();
+
+    for(auto& [key, value] : expected)
+    {
+        assert(_it->first == key && _it->second == value);
+        ++_it;
+    }
+
+    for(hsd::i32 key = -1; key <= 4001; key++)
+    {
+        auto lower = map.lower_bound(key);
+        auto upper = map.upper_bound(key);
+        auto exp_lower = expected.lower_bound(key);
+        auto exp_upper = expected.upper_bound(key);
+
+        assert(lower == map.end() ? exp_lower == expected.end() : lower.key() == exp_lower->first);
+        assert(upper == map.end() ? exp_upper == expected.end() : upper.key() == exp_upper->first);
+        assert(map.contains(key) == (expected.count(key) == 1));
+    }
+
+    printf("%s: %zu entries, at(%d) = %d\n", name, map.size(), map.begin()->first, map.at(map.begin()->first));
+}
+
+int main()
+{
+    check_layout<hsd::binary_layout>("binary");
+    check_layout<hsd::eytzinger_layout>("eytzinger");
+
+    hsd::flat_set<hsd::u8string, hsd::less, hsd::eytzinger_layout> words = {"pear", "apple", "fig", "apple"};
+    words.insert("banana");
+    words.erase(hsd::u8string{"fig"});
+
+    for(auto& word : words)
+        printf("%s ", word.c_str());
+
+    printf("| %zu words, has pear: %d\n", words.size(), words.contains(hsd::u8string{"pear"}));
+
+    hsd::flat_map<hsd::i32, positive> guarded;
+    guarded.emplace(1, 1);
+
+    try
+    {
+        guarded.emplace(2, -1);
+    }
+    catch(const std::invalid_argument&)
+    {}
+
+    guarded.emplace(3, 3);
+    assert(guarded.size() == 2 && !guarded.contains(2) && guarded.at(3).value == 3);
+}
@@ -0,0 +1,44 @@
+#include "../../cpp/Hash.hpp"
+#include "../../cpp/String.hpp"
+#include "../../cpp/Tuple.hpp"
+#include "../../cpp/Io.hpp"
+
+// Hashing of literals and integers is usable in constant expressions
+static_assert(hsd::wyhash::get_hash("hello") == hsd::wyhash::get_hash("hello", 5));
+static_assert(hsd::wyhash::get_hash("hello") != hsd::wyhash::get_hash("hellp"));
+static_assert(hsd::hash<hsd::i32>::get_hash(1) != hsd::hash<hsd::i32>::get_hash(2));
+static_assert(hsd::hash<hsd::f64>::get_hash(0.0) == hsd::hash<hsd::f64>::get_hash(-0.0));
+
+int main()
+{
+    // Every key length path: empty, 1-3, 4-16, 17-48 and the 48 byte rounds
+    const char* text = "The quick brown fox jumps over the lazy dog, then the dog "
+        "wakes up and chases the fox all the way back into the forest.";
+
+    for(hsd::usize len : {0, 1, 3, 4, 8, 16, 17, 48, 49, 100})
+        hsd::io::print<"len {}: {}\n">(len, hsd::wyhash::get_hash(text, len));
+
+    // Sequential integers land in distinct low bits, unlike an identity hash
+    constexpr hsd::usize buckets = 64;
+    bool used[buckets]{};
+    hsd::usize distinct = 0;
+
+    for(hsd::u64 key = 0; key < buckets; key++)
+    {
+        hsd::usize slot = hsd::hash<hsd::u64>::get_hash(key * buckets) & (buckets - 1);
+        distinct += !used[slot];
+        used[slot] = true;
+    }
+
+    hsd::io::print<"{} of {} buckets used by multiples of {}\n">(distinct, buckets, buckets);
+
+    hsd::u8string str = "composite";
+    auto tup = hsd::make_tuple(1, 2.5, hsd::u8string{"three"});
+
+    hsd::io::print<"string: {}\n">(hsd::hash<hsd::u8string>{}(str) == hsd::wyhash::get_hash("composite"));
+    hsd::io::print<"pair order matters: {}\n">(
+        hsd::hash<hsd::pair<int, int>>::get_hash({1, 2}) != hsd::hash<hsd::pair<int, int>>::get_hash({2, 1})
+    );
+    hsd::io::print<"tuple: {}\n">(hsd::hash<decltype(tup)>::get_hash(tup));
+    hsd::io::print<"pointer: {}\n">(hsd::hash<hsd::usize*>::get_hash(&distinct) != 0);
+}
@@ -0,0 +1,82 @@
+#include "../../cpp/HyperLogLog.hpp"
+#include "../../cpp/Thread.hpp"
+
+#include <algorithm>
+#include <stdio.h>
+#include <math.h>
+#include <assert.h>
+
+int main()
+{
+    hsd::hyperloglog<hsd::u64> empty;
+    assert(empty.estimate() == 0);
+
+    // Small counts, where the original estimator needs linear counting
+    for(hsd::u64 size : {1ul, 10ul, 100ul, 1000ul, 10000ul, 100000ul, 1000000ul})
+    {
+        hsd::hyperloglog<hsd::u64> sketch;
+
+        for(hsd::u64 key = 0; key < size; key++)
+        {
+            sketch.add(key);
+            // Repeats don't count
+            sketch.add(key / 2);
+        }
+
+        hsd::f64 error = fabs(sketch.estimate() - static_cast<hsd::f64>(size)) / static_cast<hsd::f64>(size);
+        printf("%8llu distinct: estimate %.1f, error %.3f%%\n", size, sketch.estimate(), error * 100);
+        // Five standard errors
+        assert(error < 0.05);
+    }
+
+    // Threads count overlapping ranges, the merge counts the union
+    constexpr hsd::u64 per_thread = 200000;
+    hsd::vector<hsd::hyperloglog<hsd::u64>> locals;
+    hsd::vector<hsd::thread> threads;
+
+    for(hsd::u64 worker = 0; worker < 4; worker++)
+        locals.push_back(hsd::hyperloglog<hsd::u64>(12));
+
+    for(hsd::u64 worker = 0; worker < 4; worker++)
+    {
+        threads.emplace_back([&locals, worker]
+        {
+            for(hsd::u64 key = worker * per_thread / 2; key < worker * per_thread / 2 + per_thread; key++)
+                locals[worker].add(key);
+        });
+    }
+
+    for(auto& thread : threads)
+        thread.join();
+
+    auto merged = locals[0];
+
+    for(hsd::u64 worker = 1; worker < 4; worker++)
+        merged.merge(locals[worker]);
+
+    // [0, 2.5 * per_thread)
+    hsd::f64 expected = 2.5 * per_thread;
+    assert(fabs(merged.estimate() - expected) / expected < 0.1);
+
+    auto bytes = merged.serialize();
+    assert(bytes.size() == 6 + (1 << 12) * 3 / 4);
+
+    auto restored = hsd::hyperloglog<hsd::u64>::deserialize(bytes);
+    auto reserialized = restored.serialize();
+    assert(restored.estimate() == merged.estimate());
+    assert(std::equal(reserialized.begin(), reserialized.end(), bytes.begin(), bytes.end()));
+
+    bool threw = false;
+
+    try
+    {
+        merged.merge(hsd::hyperloglog<hsd::u64>(14));
+    }
+    catch(const std::runtime_error&)
+    {
+        threw = true;
+    }
+
+    assert(threw);
+    printf("merged estimate %.1f of %.0f, %zu bytes serialized\n", merged.estimate(), expected, bytes.size());
+}
@@ -0,0 +1,65 @@
+#include "../../../cpp/NetworkServer.hpp"
+#include "../../../cpp/NetworkClient.hpp"
+#include "../../../cpp/Thread.hpp"
+
+static void echo_server()
+{
+    hsd::tcp::server_detail::socket2 sock{hsd::net::protocol_type::ipv4, 54001, "127.0.0.1"};
+    char buf[4096];
+
+    while(true)
+    {
+        hsd::isize len = recv(sock.get_sock(), buf, sizeof(buf), 0);
+
+        if(len <= 0)
+            break;
+
+        send(sock.get_sock(), buf, len, 0);
+    }
+}
+
+int main()
+{
+    hsd::thread server{echo_server};
+    hsd::tcp::client_pool pool;
+
+    {
+        auto client = pool.acquire(hsd::net::protocol_type::ipv4, 54001, "127.0.0.1", 1000);
+
+        while(!client->is_connected())
+            client->reconnect({hsd::net::protocol_type::ipv4, 54001, "127.0.0.1"}, 1000);
+
+        client->set_no_delay();
+        client->set_send_buffer(1 << 16);
+
+        // Pipeline all requests before reading any reply
+        client->send_frame("first", 5);
+        client->send_frame("second", 6);
+        client->send_frame(hsd::u8string("third"));
+
+        for(int i = 0; i < 3; i++)
+        {
+            auto [frame, code] = client->receive_frame();
+
+            if(code != hsd::net::received_state::ok)
+                break;
+
+            hsd::io::print<"SERVER> {} ({} bytes)\n">(
+                hsd::u8string(frame.data, frame.size), frame.size
+            );
+        }
+    }
+
+    hsd::io::print<"idle connections: {}\n">(
+        pool.idle_count(hsd::net::protocol_type::ipv4, 54001, "127.0.0.1")
+    );
+
+    {
+        // Reuses the connection returned above
+        auto client = pool.acquire(hsd::net::protocol_type::ipv4, 54001, "127.0.0.1");
+        hsd::io::print<"reused: {}\n">(pool.idle_count(hsd::net::protocol_type::ipv4, 54001, "127.0.0.1") == 0 ? "yes" : "no");
+    }
+
+    pool = hsd::tcp::client_pool{};
+    server.join();
+}
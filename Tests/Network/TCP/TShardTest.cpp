@@ -0,0 +1,27 @@
+#include "../../../cpp/NetworkServer.hpp"
+#include "../../../cpp/NetworkClient.hpp"
+
+int main()
+{
+    hsd::tcp::sharded_server server{
+        hsd::net::protocol_type::ipv4, 54002, "127.0.0.1",
+        [](hsd::tcp::server_detail::connection& conn, const char*, hsd::usize size)
+        {
+            conn.respond<"worker {} got {} bytes\n">(gettid(), size);
+        }, 4
+    };
+
+    hsd::io::print<"workers: {}\n">(server.worker_count());
+
+    for(int i = 0; i < 8; i++)
+    {
+        hsd::tcp::client client{hsd::net::protocol_type::ipv4, 54002, "127.0.0.1"};
+        client.respond<"request {}">(i);
+        auto [buf, code] = client.receive();
+
+        if(code == hsd::net::received_state::ok)
+            hsd::io::print<"SERVER> {}">(buf.data());
+    }
+
+    server.stop();
+}
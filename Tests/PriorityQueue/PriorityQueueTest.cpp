@@ -0,0 +1,203 @@
+#include "../../cpp/PriorityQueue.hpp"
+#include "../../cpp/String.hpp"
+
+#include <queue>
+#include <map>
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+
+int main()
+{
+    {
+        srand(7);
+        hsd::vector<hsd::i32> initial;
+
+        for(hsd::i32 index = 0; index < 1000; index++)
+            initial.push_back(rand() % 5000);
+
+        hsd::priority_queue<hsd::i32> queue(initial.begin(), initial.end());
+        std::priority_queue<hsd::i32> expected(initial.begin(), initial.end());
+
+        for(hsd::i32 round = 0; round < 100000; round++)
+        {
+            if(rand() % 3 != 0 || expected.empty())
+            {
+                hsd::i32 value = rand() % 5000;
+                queue.push(value);
+                expected.push(value);
+            }
+            else
+            {
+                assert(queue.top() == expected.top());
+                queue.pop();
+                expected.pop();
+            }
+        }
+
+        initial.clear();
+
+        for(hsd::i32 index = 0; index < 50000; index++)
+            initial.push_back(rand() % 5000);
+
+        queue.push_range(initial.begin(), initial.end());
+
+        for(auto value : initial)
+            expected.push(value);
+
+        assert(queue.size() == expected.size());
+
+        while(!expected.empty())
+        {
+            assert(queue.top() == expected.top());
+            queue.pop();
+            expected.pop();
+        }
+
+        hsd::priority_queue<hsd::u8string, hsd::greater> words = {"pear", "fig", "apple"};
+        words.emplace("banana");
+        printf("queue ok, smallest word: %s\n", words.top().c_str());
+    }
+    {
+        // Checked against a handle -> key map, pushes outweigh removals so it grows
+        hsd::indexed_heap<hsd::i32> heap;
+        std::map<hsd::u32, hsd::i32> live;
+        srand(11);
+
+        for(hsd::i32 round = 0; round < 40000; round++)
+        {
+            hsd::i32 op = live.empty() ? 0 : rand() % 7 - 2;
+
+            if(op <= 0)
+            {
+                hsd::i32 key = rand() % 100000;
+                auto handle = heap.push(key);
+                assert(live.count(handle) == 0);
+                live[handle] = key;
+            }
+            else
+            {
+                auto entry = live.begin();
+                std::advance(entry, rand() % live.size());
+
+                if(op == 1)
+                {
+                    hsd::i32 key = entry->second - rand() % 100;
+                    heap.decrease_key(entry->first, key);
+                    entry->second = key;
+                }
+                else if(op == 2)
+                {
+                    hsd::i32 key = rand() % 100000;
+                    heap.update(entry->first, key);
+                    entry->second = key;
+                }
+                else if(op == 3)
+                {
+                    heap.erase(entry->first);
+                    live.erase(entry);
+                }
+                else
+                {
+                    hsd::i32 least = live.begin()->second;
+
+                    for(auto& item : live)
+                        least = item.second < least ? item.second : least;
+
+                    assert(heap.top() == least && live[heap.top_handle()] == least);
+                    live.erase(heap.top_handle());
+                    heap.pop();
+                }
+            }
+
+            assert(heap.size() == live.size());
+        }
+
+        for(auto& item : live)
+            assert(heap.contains(item.first) && heap[item.first] == item.second);
+
+        bool threw = false;
+
+        try
+        {
+            auto handle = heap.top_handle();
+            heap.decrease_key(handle, heap[handle] + 1);
+        }
+        catch(const std::runtime_error&)
+        {
+            threw = true;
+        }
+
+        assert(threw);
+        printf("indexed heap ok, %zu live\n", heap.size());
+    }
+    {
+        // Dijkstra with decrease_key against the usual reinsert-and-skip
+        const hsd::u32 nodes = 2000;
+        hsd::vector<hsd::vector<hsd::pair<hsd::u32, hsd::i32>>> edges(nodes);
+        srand(13);
+
+        for(hsd::u32 from = 0; from < nodes; from++)
+        {
+            for(hsd::i32 count = 0; count < 8; count++)
+                edges[from].push_back({static_cast<hsd::u32>(rand() % nodes), rand() % 1000 + 1});
+        }
+
+        hsd::vector<hsd::i32> start(nodes);
+
+        for(auto& distance : start)
+            distance = hsd::limits<hsd::i32>::max;
+
+        start[0] = 0;
+        hsd::indexed_heap<hsd::i32> heap;
+        heap.assign(start.begin(), start.end());
+        hsd::vector<hsd::i32> distances = start;
+
+        while(!heap.empty())
+        {
+            auto node = heap.top_handle();
+            hsd::i32 distance = heap.top();
+            heap.pop();
+
+            if(distance == hsd::limits<hsd::i32>::max)
+                break;
+
+            for(auto& [next, weight] : edges[node])
+            {
+                if(heap.contains(next) && distance + weight < distances[next])
+                {
+                    distances[next] = distance + weight;
+                    heap.decrease_key(next, distances[next]);
+                }
+            }
+        }
+
+        hsd::vector<hsd::i32> expected = start;
+        std::priority_queue<std::pair<hsd::i32, hsd::u32>, std::vector<std::pair<hsd::i32, hsd::u32>>,
+            std::greater<>> lazy;
+        lazy.push({0, 0});
+
+        while(!lazy.empty())
+        {
+            auto [distance, node] = lazy.top();
+            lazy.pop();
+
+            if(distance != expected[node])
+                continue;
+
+            for(auto& [next, weight] : edges[node])
+            {
+                if(distance + weight < expected[next])
+                {
+                    expected[next] = distance + weight;
+                    lazy.push({expected[next], next});
+                }
+            }
+        }
+
+        for(hsd::u32 node = 0; node < nodes; node++)
+            assert(distances[node] == expected[node]);
+
+        printf("dijkstra ok, distance to %u: %d\n", nodes - 1, distances[nodes - 1]);
+    }
+}
@@ -0,0 +1,53 @@
+#include "../../cpp/Io.hpp"
+
+int main()
+{
+    hsd::u8sstream stream{8};
+    hsd::i32 a;
+    hsd::f64 b;
+    hsd::u8string c;
+
+    // Grows past the initial 8 characters
+    stream.append("42 -3.25 ").write(1000000).append(" word");
+    hsd::io::print<"buffer: {}\n">(stream.c_str());
+
+    stream.set_data(a, b);
+    hsd::io::print<"{} {}\n">(a, b);
+
+    // The cursor continues after set_data
+    hsd::i64 d;
+    stream.read(d);
+    stream.read(c);
+    hsd::io::print<"{} {} eof: {}\n">(d, c, stream.eof() ? "yes" : "no");
+
+    // Streaming: drop what was read and keep appending
+    stream.compact();
+    stream.append("7 8 9");
+
+    while(stream.read(a))
+        hsd::io::print<"{} ">(a);
+
+    hsd::io::print<"\nparsed whole: {}\n">(stream.parse<hsd::i32>());
+
+    // Out of range and malformed integers are rejected, floats round trip
+    hsd::u8sstream checked{64};
+    checked.append("99999999999");
+    bool overflow = checked.read(a);
+    checked.clear();
+    checked.append("12abc");
+    bool trailing = checked.read(a);
+    checked.clear();
+    checked.write(0.1);
+    checked.read(b);
+    hsd::io::print<"overflow read: {}, 12abc read: {}, 0.1 round trip: {}\n">(
+        overflow, trailing, b == 0.1);
+
+    try
+    {
+        stream.set_data(a, b, c, d);
+    }
+    catch(const std::runtime_error& err)
+    {
+        hsd::io::print<"error: {}\n">(err.what());
+    }
+}
@@ -0,0 +1,75 @@
+#include "../../cpp/Simd.hpp"
+#include "../../cpp/Io.hpp"
+
+template < typename T >
+static bool check_level()
+{
+    // Odd sizes exercise the scalar tails after the vector loops
+    constexpr hsd::usize size = 1003;
+    hsd::vector<T> a(size), b(size), out(size);
+    T sum = 0, dot = 0, low = 1000, high = -1000;
+
+    for(hsd::usize i = 0; i < size; i++)
+    {
+        a[i] = static_cast<T>(static_cast<hsd::i64>(i * 7 % 101) - 50);
+        b[i] = static_cast<T>(i % 13 + 1);
+        sum += a[i];
+        dot += a[i] * b[i];
+        low = a[i] < low ? a[i] : low;
+        high = a[i] > high ? a[i] : high;
+    }
+
+    bool ok = hsd::simd::sum(a) == sum && hsd::simd::dot(a, b) == dot &&
+        hsd::simd::min(a) == low && hsd::simd::max(a) == high;
+
+    hsd::simd::add(a.data(), b.data(), out.data(), size);
+    ok &= out[size - 1] == a[size - 1] + b[size - 1];
+    hsd::simd::sub(a.data(), b.data(), out.data(), size);
+    ok &= out[500] == a[500] - b[500];
+    hsd::simd::mul(a.data(), b.data(), out.data(), size);
+    ok &= out[17] == a[17] * b[17];
+    hsd::simd::div(a.data(), b.data(), out.data(), size);
+    ok &= out[999] == a[999] / b[999];
+
+    auto y = b;
+    hsd::simd::axpy(T(3), a, y);
+    ok &= y[123] == 3 * a[123] + b[123];
+
+    hsd::vector<T> scanned(size);
+    hsd::simd::prefix_sum(a.data(), scanned.data(), size);
+    ok &= scanned[size - 1] == sum;
+
+    T running = 0;
+
+    for(hsd::usize i = 0; i < size; i++)
+        ok &= scanned[i] == (running += a[i]);
+
+    // 10 bins over [-50, 50): a value of 50 falls outside
+    auto bins = hsd::simd::histogram(a, T(-50), T(50), 10);
+    hsd::usize counted = 0, expected = 0;
+
+    for(auto count : bins)
+        counted += count;
+    for(auto value : a)
+        expected += value < 50;
+
+    ok &= counted == expected;
+    return ok;
+}
+
+int main()
+{
+    auto best = hsd::simd::detected();
+    hsd::io::print<"detected: {}\n">(hsd::simd::level_name(best));
+
+    for(auto target : {hsd::simd::level::scalar, hsd::simd::level::sse,
+        hsd::simd::level::avx2, hsd::simd::level::avx512})
+    {
+        if(target > best)
+            break;
+
+        hsd::simd::set_level(target);
+        hsd::io::print<"{}: f32 {} f64 {} i32 {} i64 {}\n">(hsd::simd::level_name(target),
+            check_level<hsd::f32>(), check_level<hsd::f64>(), check_level<hsd::i32>(), check_level<hsd::i64>());
+    }
+}
@@ -0,0 +1,49 @@
+#include "../../cpp/SmallVector.hpp"
+#include "../../cpp/String.hpp"
+
+#include <cstdio>
+#include <cassert>
+
+int main()
+{
+    {
+        hsd::small_vector<int, 4> vec = {1, 2, 3};
+        assert(vec.is_inline());
+
+        for (int i = 4; i <= 10; i++)
+            vec.push_back(i);
+
+        assert(!vec.is_inline());
+
+        for (auto val : vec)
+            std::printf("%d ", val);
+
+        std::printf("| size %zu of %zu\n", vec.size(), vec.capacity());
+
+        vec.resize(3);
+        vec.shrink_to_fit();
+        assert(vec.is_inline() && vec.back() == 3);
+    }
+    {
+        hsd::small_vector<hsd::u8string, 2> names;
+        names.emplace_back("first");
+        names.emplace_back("second");
+        // Refers into the inline buffer while it spills
+        names.push_back(names[0]);
+
+        hsd::small_vector<hsd::u8string, 2> inline_names;
+        inline_names.emplace_back("inline");
+
+        auto copy = names;
+        auto moved = hsd::move(names);
+        auto moved_inline = hsd::move(inline_names);
+        assert(names.size() == 0 && names.is_inline());
+        assert(moved_inline.is_inline() && moved_inline[0] == "inline");
+
+        moved = hsd::move(moved_inline);
+        assert(moved.size() == 1 && moved.is_inline());
+
+        for (auto& name : copy)
+            std::printf("%s\n", name.c_str());
+    }
+}
@@ -0,0 +1,42 @@
+#include "../../cpp/StaticMap.hpp"
+#include "../../cpp/Io.hpp"
+
+using methods = hsd::static_map<
+    "GET", "HEAD", "POST", "PUT", "DELETE",
+    "CONNECT", "OPTIONS", "TRACE", "PATCH"
+>;
+
+using ports = hsd::static_map<20, 21, 22, 23, 25, 53, 80, 110, 143, 443, 993, 995, 8080>;
+
+// Lookups fold away at compile time
+static_assert(methods::find("GET") == 0);
+static_assert(methods::find("PATCH") == 8);
+static_assert(methods::find("PATCHES") == methods::npos);
+static_assert(methods::find("") == methods::npos);
+static_assert(ports::find(443) == 9);
+static_assert(!ports::contains(444));
+// Keys that don't fit the key type aren't narrowed onto one that is there
+static_assert(ports::find(0x1000001BBull) == ports::npos);
+static_assert(ports::find(-1) == ports::npos);
+
+int main()
+{
+    const char* requests[] = {"POST", "GET", "TRACE", "BREW", "OPTIONS", "get"};
+
+    for(auto* request : requests)
+    {
+        hsd::usize index = methods::find(request);
+
+        if(index != methods::npos)
+            hsd::io::print<"{} -> {}\n">(request, index);
+        else
+            hsd::io::print<"{} -> unknown\n">(request);
+    }
+
+    hsd::i32 probes[] = {22, 80, 81, 8080, 3306};
+
+    for(auto probe : probes)
+        hsd::io::print<"port {}: {}\n">(probe, ports::contains(probe) ? "known" : "unknown");
+
+    hsd::io::print<"{} methods, {} ports\n">(methods::size(), ports::size());
+}
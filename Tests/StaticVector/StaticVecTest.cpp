@@ -0,0 +1,49 @@
+#include "../../cpp/StaticVector.hpp"
+#include "../../cpp/String.hpp"
+
+#include <cstdio>
+#include <cassert>
+
+int main()
+{
+    {
+        hsd::static_vector<int, 8> vec = {1, 2, 3};
+        vec.push_back(4);
+        vec.emplace_back(5);
+
+        for (auto val : vec)
+            std::printf("%d ", val);
+
+        std::printf("| size %zu of %zu\n", vec.size(), vec.capacity());
+    }
+    {
+        hsd::static_vector<hsd::u8string, 4> names;
+        names.emplace_back("first");
+        names.emplace_back("second");
+
+        auto copy = names;
+        auto moved = hsd::move(names);
+        assert(names.size() == 0 && moved.size() == 2 && copy.size() == 2);
+
+        moved.resize(4);
+        assert(moved.full());
+
+        try
+        {
+            moved.emplace_back("fifth");
+            assert(false);
+        }
+        catch (std::out_of_range& err)
+        {
+            std::printf("%s\n", err.what());
+        }
+
+        moved.pop_back();
+        moved.resize(1);
+
+        for (auto& name : copy)
+            std::printf("%s\n", name.c_str());
+
+        std::printf("%s %zu\n", moved.front().c_str(), moved.size());
+    }
+}
@@ -0,0 +1,89 @@
+#include "../../cpp/Sync.hpp"
+#include "../../cpp/Thread.hpp"
+#include "../../cpp/Io.hpp"
+
+static hsd::mutex counter_mutex;
+static hsd::u64 counter = 0;
+
+static hsd::shared_mutex table_mutex;
+static hsd::u64 table[4]{};
+
+static hsd::mutex queue_mutex;
+static hsd::condition_variable queue_cv;
+static hsd::i32 queued = 0;
+
+static hsd::latch started{4};
+static hsd::barrier phase_barrier{4};
+static hsd::semaphore slots{2};
+static hsd::u32 in_slot = 0, over_limit = 0;
+
+static void worker(hsd::u64 id)
+{
+    started.count_down();
+    started.wait();
+
+    for(hsd::i32 round = 0; round < 3; round++)
+    {
+        for(hsd::i32 i = 0; i < 10000; i++)
+        {
+            hsd::lock_guard guard{counter_mutex};
+            counter++;
+        }
+
+        {
+            hsd::lock_guard guard{table_mutex};
+            table[id]++;
+        }
+
+        // Everyone finishes the round before the next one starts
+        phase_barrier.arrive_and_wait();
+
+        hsd::u64 sum = 0;
+        {
+            hsd::shared_lock guard{table_mutex};
+
+            for(auto value : table)
+                sum += value;
+        }
+
+        if(sum < static_cast<hsd::u64>(round + 1) * 4)
+            hsd::io::print<"barrier let a thread through early\n">();
+
+        phase_barrier.arrive_and_wait();
+    }
+
+    slots.acquire();
+    hsd::u32 inside = __atomic_add_fetch(&in_slot, 1u, __ATOMIC_SEQ_CST);
+
+    // At most two threads hold the semaphore at once
+    if(inside > 2)
+        __atomic_store_n(&over_limit, inside, __ATOMIC_SEQ_CST);
+
+    __atomic_sub_fetch(&in_slot, 1u, __ATOMIC_SEQ_CST);
+    slots.release();
+
+    hsd::lock_guard guard{queue_mutex};
+    queued++;
+    queue_cv.notify_one();
+}
+
+int main()
+{
+    hsd::thread threads[4];
+
+    for(hsd::u64 i = 0; i < 4; i++)
+        threads[i] = hsd::thread{worker, i};
+
+    {
+        queue_mutex.lock();
+        queue_cv.wait(queue_mutex, [] { return queued == 4; });
+        queue_mutex.unlock();
+    }
+
+    for(auto& thread : threads)
+        thread.join();
+
+    hsd::io::print<"counter: {}\n">(counter);
+    hsd::io::print<"table: {} {} {} {}\n">(table[0], table[1], table[2], table[3]);
+    hsd::io::print<"semaphore over limit: {}\n">(over_limit);
+}
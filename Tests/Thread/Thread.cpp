@@ -6,8 +6,44 @@ void foo(int a, float b)
 	hsd::io::print<"{} {}\n">(a, b);
 }
 
+void report() 
+{
+	char name[16]{};
+	pthread_getname_np(pthread_self(), name, sizeof(name));
+
+	pthread_attr_t attr;
+	hsd::usize stack_size = 0;
+	pthread_getattr_np(pthread_self(), &attr);
+	pthread_attr_getstacksize(&attr, &stack_size);
+	pthread_attr_destroy(&attr);
+
+	cpu_set_t cpus;
+	pthread_getaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+
+	hsd::io::print<"name: {}, small stack: {}, cpus: {}, on cpu 0: {}\n">(
+		static_cast<const char*>(name), stack_size <= 64 * 1024,
+		CPU_COUNT(&cpus), CPU_ISSET(0, &cpus) != 0
+	);
+}
+
 int main() 
 {
 	hsd::thread t{foo, 1, 2.3f};
 	t.join();
+
+	auto opts = hsd::thread::options{}
+		.name("worker-0")
+		.stack_size(64 * 1024)
+		.guard_size(4096)
+		.cpu(0)
+		.priority(5);
+
+	hsd::thread worker{opts, report};
+	worker.join();
+
+	hsd::thread numa{hsd::thread::options{}.numa_node(0), [] {
+		hsd::io::print<"pinned to node 0: {}\n">(hsd::this_thread::pin_to(0));
+	}};
+	hsd::io::print<"prefers node 0 memory: {}\n">(numa.prefers_node());
+	numa.join();
 }
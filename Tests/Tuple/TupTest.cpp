@@ -9,4 +9,18 @@ int main()
     constexpr auto t2 = hsd::make_tuple(-1, (hsd::u64)-1, 'c');
     constexpr auto t3 = t + t2 + hsd::make_tuple(L'ă', -1.32f, L"柴尻保存会");
     hsd::io::print<L"this tuple contains: {}\n">(t3);
+
+    // get returns a reference, nothing is copied
+    hsd::tuple<hsd::u8string, hsd::i32> t4{"text", 1};
+    t4.get<0>() += " changed";
+    hsd::get<1>(t4)++;
+    hsd::io::print<L"{} {}\n">(t4.get<0>(), t4.get<1>());
+
+    struct empty {};
+    static_assert(sizeof(hsd::tuple<empty, hsd::i32>) == sizeof(hsd::i32));
+
+    auto t5 = hsd::tuple_cat(hsd::move(t4), hsd::make_tuple('x'), hsd::tuple{2.5});
+    hsd::apply([](hsd::u8string& str, hsd::i32 num, char c, hsd::f64 f) {
+        hsd::io::print<L"{} {} {} {}\n">(str, num, c, f);
+    }, t5);
 }
\ No newline at end of file
@@ -1,6 +1,15 @@
 #include "../../cpp/UnorderedMap.hpp"
 #include <stdio.h>
 
+// Sends every key to the same bucket, entries must still be told apart
+struct colliding_hash
+{
+    static constexpr hsd::usize get_hash(hsd::i32)
+    {
+        return 42;
+    }
+};
+
 int main()
 {
     hsd::unordered_map map = {
@@ -21,4 +30,42 @@ int main()
 
     for(auto _it : map)
         printf("%s\n", _it.first);
-}
\ No newline at end of file
+
+    hsd::unordered_map<hsd::i32, hsd::i32, colliding_hash> same_hash;
+
+    for(hsd::i32 i = 0; i < 10; i++)
+        same_hash[i] = i * i;
+
+    printf("colliding: size %zu, at(7) = %d\n", same_hash.size(), same_hash.at(7));
+
+    for(hsd::i32 i = 0; i < 10; i += 3)
+        same_hash.erase(i);
+
+    printf("after erase: size %zu, has 3: %d, at(8) = %d\n",
+        same_hash.size(), same_hash.contains(3), same_hash.at(8));
+
+    hsd::unordered_map<hsd::u64, hsd::u64> bulk;
+    bulk.reserve(100000);
+    hsd::usize buckets = bulk.bucket_count();
+
+    for(hsd::u64 i = 0; i < 100000; i++)
+        bulk.emplace(i << 20, i);
+
+    printf(
+        "bulk: size %zu, buckets %zu, grew: %s, load %.3f, at(5 << 20) = %zu\n",
+        bulk.size(), bulk.bucket_count(), buckets != bulk.bucket_count() ? "yes" : "no",
+        bulk.load_factor(), static_cast<hsd::usize>(bulk.at(5ull << 20))
+    );
+
+    bulk.rehash(1 << 20);
+    printf("rehash: buckets %zu, contains(99999 << 20): %d\n",
+        bulk.bucket_count(), bulk.contains(99999ull << 20));
+
+    // Arithmetic keys of another type only match a key they equal exactly
+    hsd::unordered_map<hsd::u8, hsd::i32> small{hsd::pair{hsd::u8{1}, 1}};
+    hsd::unordered_map<hsd::u32, hsd::i32> wide{hsd::pair{5u, 5}};
+    wide.emplace(5.0, 6);
+
+    printf("exact keys: %d %d %d %d %d, size %zu\n", small.contains(1), small.contains(257),
+        wide.contains(5.0), wide.contains(5.5), wide.contains(-4294967291ll), wide.size());
+}
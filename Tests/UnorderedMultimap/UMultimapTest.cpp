@@ -0,0 +1,78 @@
+#include "../../cpp/UnorderedMultimap.hpp"
+#include "../../cpp/String.hpp"
+
+#include <unordered_map>
+#include <algorithm>
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+
+int main()
+{
+    {
+        hsd::unordered_multimap<hsd::i32, hsd::i32> map;
+        std::unordered_multimap<hsd::i32, hsd::i32> expected;
+        srand(4);
+
+        for(hsd::i32 round = 0; round < 50000; round++)
+        {
+            hsd::i32 key = rand() % 500;
+
+            if(rand() % 8 != 0)
+            {
+                map.emplace(key, round);
+                expected.emplace(key, round);
+            }
+            else
+            {
+                assert(map.erase(key) == expected.erase(key));
+            }
+        }
+
+        assert(map.size() == expected.size());
+
+        for(hsd::i32 key = 0; key < 500; key++)
+        {
+            std::vector<hsd::i32> values, expected_values;
+            auto [first, last] = map.equal_range(key);
+
+            for(; first != last; ++first)
+                values.push_back(first->second);
+
+            auto range = expected.equal_range(key);
+
+            for(; range.first != range.second; ++range.first)
+                expected_values.push_back(range.first->second);
+
+            // Newest first
+            assert(std::is_sorted(values.rbegin(), values.rend()));
+            std::sort(values.begin(), values.end());
+            std::sort(expected_values.begin(), expected_values.end());
+            assert(values == expected_values && map.count(key) == values.size());
+        }
+
+        hsd::usize total = 0;
+
+        for(auto& entry : map)
+            total += static_cast<hsd::usize>(map.contains(entry.first));
+
+        assert(total == map.size());
+        printf("ints: %zu entries\n", map.size());
+    }
+    {
+        hsd::unordered_multimap<hsd::u8string, hsd::i32> tags = {
+            {"red", 1}, {"blue", 2}, {"red", 3}
+        };
+
+        hsd::pair<const char*, hsd::i32> batch[] = {{"blue", 4}, {"red", 5}, {"green", 6}};
+        tags.insert_many(batch, batch + 3);
+
+        printf("red:");
+
+        for(auto [first, last] = tags.equal_range("red"); first != last; ++first)
+            printf(" %d", first->second);
+
+        printf(" | erased blue %zu, %zu left\n", tags.erase(hsd::u8string_view{"blue"}), tags.size());
+    }
+}
@@ -0,0 +1,82 @@
+#include "../../cpp/UnorderedSet.hpp"
+#include "../../cpp/String.hpp"
+
+#include <unordered_set>
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+
+// Counts heap allocations, lookups by C string or view must not make any
+static hsd::usize allocations = 0;
+
+void* operator new(hsd::usize size)
+{
+    allocations++;
+    return malloc(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete(void* ptr, hsd::usize) noexcept
+{
+    free(ptr);
+}
+
+int main()
+{
+    {
+        hsd::unordered_set<hsd::i32> set;
+        std::unordered_set<hsd::i32> expected;
+        hsd::vector<hsd::i32> batch;
+        srand(9);
+
+        for(hsd::i32 round = 0; round < 20; round++)
+        {
+            batch.clear();
+
+            for(hsd::i32 index = 0; index < 2000; index++)
+                batch.push_back(rand() % 30000);
+
+            set.insert_many(batch.begin(), batch.end());
+            expected.insert(batch.begin(), batch.end());
+
+            for(hsd::i32 index = 0; index < 500; index++)
+            {
+                hsd::i32 key = rand() % 30000;
+                assert(set.erase(key) == (expected.erase(key) == 1));
+            }
+        }
+
+        assert(set.size() == expected.size());
+
+        for(auto key : set)
+            assert(expected.count(key) == 1);
+
+        for(hsd::i32 key = 0; key < 30000; key++)
+            assert(set.contains(key) == (expected.count(key) == 1));
+
+        printf("ints: %zu keys, %zu buckets\n", set.size(), set.bucket_count());
+    }
+    {
+        hsd::unordered_set<hsd::u8string> words = {"pear", "fig"};
+        const char* ingest[] = {"apple", "pear", "apple", "kiwi", "fig", "kiwi"};
+        words.insert_many(ingest, ingest + 6);
+
+        const char* line = "kiwi,plum";
+        hsd::usize before = allocations;
+        bool found = words.contains("apple") && words.contains(hsd::u8string_view{line, 4}) &&
+            !words.contains(hsd::u8string_view{line + 5, 4}) && words.find("fig") != words.end();
+        assert(found && allocations == before);
+
+        words.insert(hsd::u8string_view{line + 5, 4});
+        words.erase("pear");
+
+        for(auto& word : words)
+            printf("%s ", word.c_str());
+
+        printf("| %zu words\n", words.size());
+    }
+}
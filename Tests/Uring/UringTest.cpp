@@ -0,0 +1,69 @@
+#include "../../cpp/Uring.hpp"
+#include "../../cpp/Io.hpp"
+
+#include <fcntl.h>
+#include <netinet/in.h>
+
+static void run_backend(bool force_epoll)
+{
+    hsd::uring ring{64, force_epoll};
+    hsd::io::print<"io_uring backend: {}\n">(ring.uses_io_uring() ? "yes" : "no (epoll)");
+
+    // Many reads of the same file in flight at once
+    hsd::i32 file_fd = open("../Io/test.txt", O_RDONLY);
+    char file_bufs[16][8]{};
+    hsd::usize total_read = 0;
+
+    for(hsd::usize i = 0; i < 16; i++)
+    {
+        ring.read(file_fd, file_bufs[i], 4, i * 4, [&total_read](hsd::isize res) {
+            total_read += res > 0 ? res : 0;
+        });
+    }
+
+    ring.submit();
+    ring.run();
+    hsd::io::print<"read {} bytes, first chunk: {}\n">(total_read, static_cast<const char*>(file_bufs[0]));
+    close(file_fd);
+
+    // Loopback accept, send and recv through the same queue
+    hsd::i32 listener = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    bind(listener, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+    listen(listener, 4);
+    socklen_t addr_len = sizeof(addr);
+    getsockname(listener, reinterpret_cast<sockaddr*>(&addr), &addr_len);
+
+    hsd::i32 client = socket(AF_INET, SOCK_STREAM, 0);
+    hsd::i32 peer = -1;
+    char recv_buf[32]{};
+
+    ring.accept(listener, [&](hsd::isize fd) {
+        peer = static_cast<hsd::i32>(fd);
+
+        ring.recv(peer, recv_buf, sizeof(recv_buf) - 1, [&](hsd::isize res) {
+            hsd::io::print<"server received {} bytes: {}\n">(res, static_cast<const char*>(recv_buf));
+        });
+    });
+
+    ring.submit();
+    connect(client, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+    ring.wait(1);
+
+    ring.send(client, "hello ring", 10, [](hsd::isize res) {
+        hsd::io::print<"client sent {} bytes\n">(res);
+    });
+
+    ring.run();
+    close(peer);
+    close(client);
+    close(listener);
+}
+
+int main()
+{
+    run_backend(false);
+    run_backend(true);
+}
@@ -101,4 +101,26 @@ int main()
             auto verb3 = hsd::move(verb); // move
         }
     }
-}
\ No newline at end of file
+
+    std::puts("==========");
+    {
+        hsd::aligned_vector<float, 64> aligned;
+
+        for (int i = 0; i < 1000; i++)
+        {
+            aligned.push_back(static_cast<float>(i));
+            assert(reinterpret_cast<uintptr_t>(aligned.data()) % 64 == 0);
+        }
+
+        auto copy = aligned;
+        copy.shrink_to_fit();
+        assert(reinterpret_cast<uintptr_t>(copy.data()) % 64 == 0);
+        assert(copy[999] == 999.0f);
+
+        hsd::huge_vector<double> huge(1 << 20);
+        assert(reinterpret_cast<uintptr_t>(huge.data()) % (2 * 1024 * 1024) == 0);
+        huge.resize(16);
+        huge.shrink_to_fit();
+        std::printf("%zu aligned floats, huge buffer shrunk to %zu\n", copy.size(), huge.capacity());
+    }
+}
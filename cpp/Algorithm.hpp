@@ -0,0 +1,1045 @@
+#pragma once
+
+#include "ThreadPool.hpp"
+#include "Functional.hpp"
+
+namespace hsd
+{
+    namespace execution
+    {
+        struct sequenced_policy {};
+
+        /// Runs on the global pool unless another one is given with `on`
+        struct parallel_policy
+        {
+            thread_pool* pool = nullptr;
+
+            constexpr parallel_policy on(thread_pool& target) const
+            {
+                return {&target};
+            }
+
+            thread_pool& get_pool() const
+            {
+                return pool != nullptr ? *pool : thread_pool::global();
+            }
+        };
+
+        inline constexpr sequenced_policy seq{};
+        inline constexpr parallel_policy par{};
+    } // namespace execution
+
+    namespace algorithm_detail
+    {
+        static constexpr usize insertion_threshold = 24;
+        static constexpr usize ninther_threshold = 128;
+        static constexpr usize partial_insertion_limit = 8;
+
+        // Parallel overloads don't split ranges below this many elements per chunk
+        static constexpr usize grain = 1 << 14;
+
+        template < typename It >
+        using value_type = decay_t<decltype(*std::declval<It>())>;
+
+        // Splits `size` elements into chunks of at least `min_size`, a few
+        // per thread, or a single one when the caller would work alone
+        static inline usize chunk_count(thread_pool& pool, usize size, usize min_size = grain)
+        {
+            if(pool.concurrency() == 1)
+                return 1;
+
+            return max(usize(1), min(size / min_size, pool.concurrency() * 4));
+        }
+
+        static inline usize chunk_begin(usize size, usize chunks, usize index)
+        {
+            return static_cast<usize>(static_cast<unsigned __int128>(size) * index / chunks);
+        }
+
+        template < typename It >
+        static constexpr void iter_swap(It lhs, It rhs)
+        {
+            hsd::swap(*lhs, *rhs);
+        }
+
+        template < typename It, typename Comp >
+        static constexpr void sort2(It lhs, It rhs, Comp& comp)
+        {
+            if(comp(*rhs, *lhs))
+                algorithm_detail::iter_swap(lhs, rhs);
+        }
+
+        template < typename It, typename Comp >
+        static constexpr void sort3(It first, It second, It third, Comp& comp)
+        {
+            sort2(first, second, comp);
+            sort2(second, third, comp);
+            sort2(first, second, comp);
+        }
+
+        template < typename It, typename Comp >
+        static constexpr void insertion_sort(It first, It last, Comp& comp)
+        {
+            if(first == last)
+                return;
+
+            for(It _cur = first + 1; _cur != last; ++_cur)
+            {
+                It _sift = _cur;
+                It _prev = _cur - 1;
+
+                if(comp(*_sift, *_prev))
+                {
+                    auto _tmp = hsd::move(*_sift);
+
+                    do
+                    {
+                        *_sift-- = hsd::move(*_prev);
+                    } while(_sift != first && comp(_tmp, *--_prev));
+
+                    *_sift = hsd::move(_tmp);
+                }
+            }
+        }
+
+        // Like insertion_sort but relies on an element before `first` that
+        // no element of the range is smaller than, so it skips the bound check
+        template < typename It, typename Comp >
+        static constexpr void unguarded_insertion_sort(It first, It last, Comp& comp)
+        {
+            if(first == last)
+                return;
+
+            for(It _cur = first + 1; _cur != last; ++_cur)
+            {
+                It _sift = _cur;
+                It _prev = _cur - 1;
+
+                if(comp(*_sift, *_prev))
+                {
+                    auto _tmp = hsd::move(*_sift);
+
+                    do
+                    {
+                        *_sift-- = hsd::move(*_prev);
+                    } while(comp(_tmp, *--_prev));
+
+                    *_sift = hsd::move(_tmp);
+                }
+            }
+        }
+
+        // Gives up (returning false) once too many elements had to move
+        template < typename It, typename Comp >
+        static constexpr bool partial_insertion_sort(It first, It last, Comp& comp)
+        {
+            if(first == last)
+                return true;
+
+            usize _moved = 0;
+
+            for(It _cur = first + 1; _cur != last; ++_cur)
+            {
+                It _sift = _cur;
+                It _prev = _cur - 1;
+
+                if(comp(*_sift, *_prev))
+                {
+                    auto _tmp = hsd::move(*_sift);
+
+                    do
+                    {
+                        *_sift-- = hsd::move(*_prev);
+                    } while(_sift != first && comp(_tmp, *--_prev));
+
+                    *_sift = hsd::move(_tmp);
+                    _moved += static_cast<usize>(_cur - _sift);
+                }
+                if(_moved > partial_insertion_limit)
+                    return false;
+            }
+
+            return true;
+        }
+
+        template < typename It, typename Comp >
+        static constexpr void sift_down(It first, usize size, usize root, Comp& comp)
+        {
+            auto _value = hsd::move(first[root]);
+
+            for(usize _child; (_child = 2 * root + 1) < size; root = _child)
+            {
+                if(_child + 1 < size && comp(first[_child], first[_child + 1]))
+                    _child++;
+                if(!comp(_value, first[_child]))
+                    break;
+
+                first[root] = hsd::move(first[_child]);
+            }
+
+            first[root] = hsd::move(_value);
+        }
+
+        template < typename It, typename Comp >
+        static constexpr void heap_sort(It first, It last, Comp& comp)
+        {
+            usize _size = static_cast<usize>(last - first);
+
+            for(usize _index = _size / 2; _index-- > 0;)
+                sift_down(first, _size, _index, comp);
+
+            while(_size > 1)
+            {
+                algorithm_detail::iter_swap(first, first + --_size);
+                sift_down(first, _size, 0, comp);
+            }
+        }
+
+        // Partitions around the pivot at `first`, elements equal to it go
+        // right. Returns the pivot's final place and whether the range was
+        // already partitioned
+        template < typename It, typename Comp >
+        static constexpr pair<It, bool> partition_right(It first, It last, Comp& comp)
+        {
+            auto _pivot = hsd::move(*first);
+            It _left = first;
+            It _right = last;
+
+            while(comp(*++_left, _pivot));
+
+            // Nothing before was smaller, so guard the scan from the right
+            if(_left - 1 == first)
+            {
+                while(_left < _right && !comp(*--_right, _pivot));
+            }
+            else
+            {
+                while(!comp(*--_right, _pivot));
+            }
+
+            bool _already_partitioned = _left >= _right;
+
+            while(_left < _right)
+            {
+                algorithm_detail::iter_swap(_left, _right);
+                while(comp(*++_left, _pivot));
+                while(!comp(*--_right, _pivot));
+            }
+
+            It _pivot_pos = _left - 1;
+            *first = hsd::move(*_pivot_pos);
+            *_pivot_pos = hsd::move(_pivot);
+            return {_pivot_pos, _already_partitioned};
+        }
+
+        // Elements equal to the pivot go left. Used when the element before
+        // the range equals the pivot: the whole run of equal keys is then
+        // done in one linear pass instead of shrinking by one per round
+        template < typename It, typename Comp >
+        static constexpr It partition_left(It first, It last, Comp& comp)
+        {
+            auto _pivot = hsd::move(*first);
+            It _left = first;
+            It _right = last;
+
+            while(comp(_pivot, *--_right));
+
+            if(_right + 1 == last)
+            {
+                while(_left < _right && !comp(_pivot, *++_left));
+            }
+            else
+            {
+                while(!comp(_pivot, *++_left));
+            }
+            while(_left < _right)
+            {
+                algorithm_detail::iter_swap(_left, _right);
+                while(comp(_pivot, *--_right));
+                while(!comp(_pivot, *++_left));
+            }
+
+            *first = hsd::move(*_right);
+            *_right = hsd::move(_pivot);
+            return _right;
+        }
+
+        // Moves the chosen pivot to `first`: median of three, or the
+        // pseudomedian of nine for larger ranges
+        template < typename It, typename Comp >
+        static constexpr void choose_pivot(It first, It last, Comp& comp)
+        {
+            usize _size = static_cast<usize>(last - first);
+            usize _half = _size / 2;
+
+            if(_size > ninther_threshold)
+            {
+                sort3(first, first + _half, last - 1, comp);
+                sort3(first + 1, first + (_half - 1), last - 2, comp);
+                sort3(first + 2, first + (_half + 1), last - 3, comp);
+                sort3(first + (_half - 1), first + _half, first + (_half + 1), comp);
+                algorithm_detail::iter_swap(first, first + _half);
+            }
+            else
+            {
+                sort3(first + _half, first, last - 1, comp);
+            }
+        }
+
+        static constexpr i32 log2(usize value)
+        {
+            i32 _log = 0;
+
+            while(value >>= 1)
+                _log++;
+
+            return _log;
+        }
+
+        /// Pattern-defeating quicksort (Orson Peters): introsort that spots
+        /// sorted and equal-key runs in linear time, shuffles to break
+        /// adversarial patterns and falls back to heapsort when unlucky
+        template < typename It, typename Comp >
+        static constexpr void pdqsort(It first, It last, Comp& comp, i32 bad_allowed, bool leftmost)
+        {
+            while(true)
+            {
+                usize _size = static_cast<usize>(last - first);
+
+                if(_size < insertion_threshold)
+                {
+                    if(leftmost)
+                        insertion_sort(first, last, comp);
+                    else
+                        unguarded_insertion_sort(first, last, comp);
+
+                    return;
+                }
+
+                choose_pivot(first, last, comp);
+
+                // The pivot equals an element left of the range: no smaller
+                // keys remain, put every copy of it in place at once
+                if(!leftmost && !comp(*(first - 1), *first))
+                {
+                    first = partition_left(first, last, comp) + 1;
+                    continue;
+                }
+
+                auto [_pivot_pos, _already_partitioned] = partition_right(first, last, comp);
+                usize _left_size = static_cast<usize>(_pivot_pos - first);
+                usize _right_size = static_cast<usize>(last - (_pivot_pos + 1));
+
+                if(_left_size < _size / 8 || _right_size < _size / 8)
+                {
+                    if(--bad_allowed == 0)
+                    {
+                        heap_sort(first, last, comp);
+                        return;
+                    }
+                    if(_left_size >= insertion_threshold)
+                    {
+                        algorithm_detail::iter_swap(first, first + _left_size / 4);
+                        algorithm_detail::iter_swap(_pivot_pos - 1, _pivot_pos - _left_size / 4);
+
+                        if(_left_size > ninther_threshold)
+                        {
+                            algorithm_detail::iter_swap(first + 1, first + (_left_size / 4 + 1));
+                            algorithm_detail::iter_swap(first + 2, first + (_left_size / 4 + 2));
+                            algorithm_detail::iter_swap(_pivot_pos - 2, _pivot_pos - (_left_size / 4 + 1));
+                            algorithm_detail::iter_swap(_pivot_pos - 3, _pivot_pos - (_left_size / 4 + 2));
+                        }
+                    }
+                    if(_right_size >= insertion_threshold)
+                    {
+                        algorithm_detail::iter_swap(_pivot_pos + 1, _pivot_pos + (1 + _right_size / 4));
+                        algorithm_detail::iter_swap(last - 1, last - _right_size / 4);
+
+                        if(_right_size > ninther_threshold)
+                        {
+                            algorithm_detail::iter_swap(_pivot_pos + 2, _pivot_pos + (2 + _right_size / 4));
+                            algorithm_detail::iter_swap(_pivot_pos + 3, _pivot_pos + (3 + _right_size / 4));
+                            algorithm_detail::iter_swap(last - 2, last - (1 + _right_size / 4));
+                            algorithm_detail::iter_swap(last - 3, last - (2 + _right_size / 4));
+                        }
+                    }
+                }
+                else if(_already_partitioned && partial_insertion_sort(first, _pivot_pos, comp) &&
+                    partial_insertion_sort(_pivot_pos + 1, last, comp))
+                {
+                    return;
+                }
+
+                pdqsort(first, _pivot_pos, comp, bad_allowed, leftmost);
+                first = _pivot_pos + 1;
+                leftmost = false;
+            }
+        }
+
+        template < typename It, typename Comp >
+        static constexpr void sort(It first, It last, Comp& comp)
+        {
+            if(last - first > 1)
+                pdqsort(first, last, comp, log2(static_cast<usize>(last - first)), true);
+        }
+
+        template < typename It, typename Comp >
+        static constexpr void nth_element(It first, It nth, It last, Comp& comp)
+        {
+            i32 _bad_allowed = log2(static_cast<usize>(last - first)) + 1;
+            bool _leftmost = true;
+
+            while(static_cast<usize>(last - first) >= insertion_threshold)
+            {
+                choose_pivot(first, last, comp);
+
+                if(!_leftmost && !comp(*(first - 1), *first))
+                {
+                    It _equal_end = partition_left(first, last, comp) + 1;
+
+                    if(nth < _equal_end)
+                        return;
+
+                    first = _equal_end;
+                    continue;
+                }
+
+                usize _size = static_cast<usize>(last - first);
+                It _pivot_pos = partition_right(first, last, comp).first;
+
+                if(_pivot_pos == nth)
+                    return;
+
+                // Repeatedly lopsided splits: finish with a guaranteed n log n
+                if(static_cast<usize>(min(_pivot_pos - first, last - _pivot_pos)) < _size / 8 &&
+                    --_bad_allowed == 0)
+                {
+                    algorithm_detail::sort(first, last, comp);
+                    return;
+                }
+                if(nth < _pivot_pos)
+                {
+                    last = _pivot_pos;
+                }
+                else
+                {
+                    first = _pivot_pos + 1;
+                    _leftmost = false;
+                }
+            }
+
+            insertion_sort(first, last, comp);
+        }
+
+        template < typename InIt, typename OutIt, typename Comp >
+        static constexpr OutIt merge_move(InIt lhs, InIt lhs_end, InIt rhs, InIt rhs_end, OutIt dest, Comp& comp)
+        {
+            while(lhs != lhs_end && rhs != rhs_end)
+            {
+                // Ties take the left run first, which keeps the sort stable
+                if(comp(*rhs, *lhs))
+                    *dest++ = hsd::move(*rhs++);
+                else
+                    *dest++ = hsd::move(*lhs++);
+            }
+
+            dest = hsd::move(lhs, lhs_end, dest);
+            return hsd::move(rhs, rhs_end, dest);
+        }
+
+        /// Bottom-up merge sort: insertion sorted runs, then merge rounds
+        /// bouncing between the range and `buffer` (as big as the range)
+        template < typename It, typename Buf, typename Comp >
+        static constexpr void stable_sort(It first, It last, Buf buffer, Comp& comp)
+        {
+            constexpr usize _run = 32;
+            usize _size = static_cast<usize>(last - first);
+
+            for(usize _begin = 0; _begin < _size; _begin += _run)
+                insertion_sort(first + _begin, first + min(_begin + _run, _size), comp);
+
+            bool _in_buffer = false;
+
+            for(usize _width = _run; _width < _size; _width *= 2)
+            {
+                auto _round = [&](auto src, auto dest)
+                {
+                    for(usize _begin = 0; _begin < _size; _begin += 2 * _width)
+                    {
+                        usize _mid = min(_begin + _width, _size);
+                        usize _end = min(_begin + 2 * _width, _size);
+                        merge_move(src + _begin, src + _mid, src + _mid, src + _end, dest + _begin, comp);
+                    }
+                };
+
+                if(_in_buffer)
+                    _round(buffer, first);
+                else
+                    _round(first, buffer);
+
+                _in_buffer = !_in_buffer;
+            }
+
+            if(_in_buffer)
+                hsd::move(buffer, buffer + _size, first);
+        }
+
+        template < typename It, typename Pred >
+        static constexpr It partition(It first, It last, Pred& pred)
+        {
+            while(true)
+            {
+                while(first != last && pred(*first))
+                    ++first;
+
+                if(first == last)
+                    return first;
+
+                do
+                {
+                    if(first == --last)
+                        return first;
+                } while(!pred(*last));
+
+                algorithm_detail::iter_swap(first, last);
+                ++first;
+            }
+        }
+
+        // How many of the first `diagonal` merged elements come from `lhs`
+        template < typename It, typename Comp >
+        static usize co_rank(It lhs, usize lhs_size, It rhs, usize rhs_size, usize diagonal, Comp& comp)
+        {
+            usize _low = diagonal > rhs_size ? diagonal - rhs_size : 0;
+            usize _high = min(diagonal, lhs_size);
+
+            while(_low < _high)
+            {
+                usize _mid = (_low + _high) / 2;
+
+                // lhs[_mid] precedes rhs[diagonal - _mid - 1], so take more of lhs
+                if(!comp(rhs[diagonal - _mid - 1], lhs[_mid]))
+                    _low = _mid + 1;
+                else
+                    _high = _mid;
+            }
+
+            return _low;
+        }
+
+        /// Sorts chunks in parallel with `sort_chunk`, then merges them in
+        /// rounds. Each merge is cut into pieces by co-ranking the output,
+        /// so every round keeps the whole pool busy, not just the first ones
+        template < typename It, typename Comp, typename SortChunk >
+        static void parallel_merge_sort(thread_pool& pool, It first, It last, Comp& comp, SortChunk&& sort_chunk)
+        {
+            usize _size = static_cast<usize>(last - first);
+            usize _chunks = min(chunk_count(pool, _size), pool.concurrency());
+
+            if(_chunks <= 1)
+            {
+                sort_chunk(first, last);
+                return;
+            }
+
+            vector<usize> _bounds;
+            _bounds.reserve(_chunks + 1);
+
+            for(usize _index = 0; _index <= _chunks; _index++)
+                _bounds.push_back(chunk_begin(_size, _chunks, _index));
+
+            pool.run(_chunks, [&](usize index) {
+                sort_chunk(first + _bounds[index], first + _bounds[index + 1]);
+            });
+
+            vector<value_type<It>> _buffer(_size);
+            auto* _buf = _buffer.data();
+            bool _in_buffer = false;
+
+            while(_bounds.size() > 2)
+            {
+                usize _runs = _bounds.size() - 1;
+                usize _pairs = (_runs + 1) / 2;
+                usize _parts = max(usize(1), (pool.concurrency() * 2 + _pairs - 1) / _pairs);
+
+                auto _round = [&](auto src, auto dest)
+                {
+                    pool.run(_pairs * _parts, [&](usize task) {
+                        usize _pair = task / _parts;
+                        usize _part = task % _parts;
+                        usize _begin = _bounds[2 * _pair];
+                        usize _mid = _bounds[min(2 * _pair + 1, _runs)];
+                        usize _end = _bounds[min(2 * _pair + 2, _runs)];
+                        usize _total = _end - _begin;
+                        usize _from = chunk_begin(_total, _parts, _part);
+                        usize _to = chunk_begin(_total, _parts, _part + 1);
+
+                        auto _lhs = src + _begin;
+                        auto _rhs = src + _mid;
+                        usize _lhs_size = _mid - _begin;
+                        usize _rhs_size = _end - _mid;
+                        usize _lhs_from = co_rank(_lhs, _lhs_size, _rhs, _rhs_size, _from, comp);
+                        usize _lhs_to = co_rank(_lhs, _lhs_size, _rhs, _rhs_size, _to, comp);
+
+                        merge_move(_lhs + _lhs_from, _lhs + _lhs_to, _rhs + (_from - _lhs_from),
+                            _rhs + (_to - _lhs_to), dest + (_begin + _from), comp);
+                    });
+                };
+
+                if(_in_buffer)
+                    _round(_buf, first);
+                else
+                    _round(first, _buf);
+
+                _in_buffer = !_in_buffer;
+                usize _kept = 0;
+
+                for(usize _index = 0; _index < _bounds.size(); _index += 2)
+                    _bounds[_kept++] = _bounds[_index];
+
+                if(_runs % 2 == 1)
+                    _bounds[_kept++] = _size;
+
+                _bounds.resize(_kept);
+            }
+
+            if(_in_buffer)
+            {
+                pool.run(_chunks, [&](usize index) {
+                    hsd::move(_buf + chunk_begin(_size, _chunks, index),
+                        _buf + chunk_begin(_size, _chunks, index + 1),
+                        first + chunk_begin(_size, _chunks, index));
+                });
+            }
+        }
+
+        template < typename It, typename Pred >
+        static It parallel_partition(thread_pool& pool, It first, It last, Pred& pred)
+        {
+            usize _size = static_cast<usize>(last - first);
+            usize _chunks = chunk_count(pool, _size);
+
+            if(_chunks <= 1)
+                return algorithm_detail::partition(first, last, pred);
+
+            vector<usize> _mids(_chunks);
+
+            pool.run(_chunks, [&](usize index) {
+                It _begin = first + chunk_begin(_size, _chunks, index);
+                It _end = first + chunk_begin(_size, _chunks, index + 1);
+                _mids[index] = static_cast<usize>(algorithm_detail::partition(_begin, _end, pred) - first);
+            });
+
+            usize _split = 0;
+
+            for(usize _index = 0; _index < _chunks; _index++)
+                _split += _mids[_index] - chunk_begin(_size, _chunks, _index);
+
+            // Each chunk is now [true..., false...]; the falses left of the
+            // split and the trues right of it are misplaced, equally many
+            vector<pair<usize, usize>> _wrong_false, _wrong_true;
+            usize _misplaced = 0;
+
+            for(usize _index = 0; _index < _chunks; _index++)
+            {
+                usize _begin = chunk_begin(_size, _chunks, _index);
+                usize _end = chunk_begin(_size, _chunks, _index + 1);
+
+                if(_mids[_index] < _split && _mids[_index] < _end)
+                {
+                    _wrong_false.push_back({_mids[_index], min(_end, _split)});
+                    _misplaced += min(_end, _split) - _mids[_index];
+                }
+                if(_begin < _mids[_index] && _mids[_index] > _split)
+                    _wrong_true.push_back({max(_begin, _split), _mids[_index]});
+            }
+
+            usize _parts = max(usize(1), min(_misplaced / grain, pool.concurrency()));
+
+            // Advances to the `skip`th position of a list of ranges
+            auto _locate = [](vector<pair<usize, usize>>& ranges, usize skip, usize& range) {
+                range = 0;
+
+                while(skip >= ranges[range].second - ranges[range].first)
+                {
+                    skip -= ranges[range].second - ranges[range].first;
+                    range++;
+                }
+
+                return ranges[range].first + skip;
+            };
+
+            if(_misplaced != 0)
+            {
+                pool.run(_parts, [&](usize part) {
+                    usize _from = chunk_begin(_misplaced, _parts, part);
+                    usize _count = chunk_begin(_misplaced, _parts, part + 1) - _from;
+                    usize _lhs_range, _rhs_range;
+                    usize _lhs = _locate(_wrong_false, _from, _lhs_range);
+                    usize _rhs = _locate(_wrong_true, _from, _rhs_range);
+
+                    while(_count-- != 0)
+                    {
+                        algorithm_detail::iter_swap(first + _lhs++, first + _rhs++);
+
+                        if(_count != 0 && _lhs == _wrong_false[_lhs_range].second)
+                            _lhs = _wrong_false[++_lhs_range].first;
+                        if(_count != 0 && _rhs == _wrong_true[_rhs_range].second)
+                            _rhs = _wrong_true[++_rhs_range].first;
+                    }
+                });
+            }
+
+            return first + _split;
+        }
+
+        // Runs `func(begin, end, chunk)` on contiguous pieces of [0, size)
+        template < typename Func >
+        static void for_chunks(thread_pool& pool, usize size, usize chunks, Func&& func)
+        {
+            pool.run(chunks, [&](usize index) {
+                func(chunk_begin(size, chunks, index), chunk_begin(size, chunks, index + 1), index);
+            });
+        }
+    } // namespace algorithm_detail
+
+    /// Unstable sort (pdqsort), the parallel overload sorts chunks with
+    /// pdqsort and merges them through a temporary buffer, which needs a
+    /// default constructible value type
+    template < typename It, typename Comp = less >
+    static constexpr void sort(It first, It last, Comp comp = {})
+    {
+        algorithm_detail::sort(first, last, comp);
+    }
+
+    template < typename It, typename Comp = less >
+    static constexpr void sort(const execution::sequenced_policy&, It first, It last, Comp comp = {})
+    {
+        algorithm_detail::sort(first, last, comp);
+    }
+
+    template < typename It, typename Comp = less >
+    static void sort(const execution::parallel_policy& policy, It first, It last, Comp comp = {})
+    {
+        algorithm_detail::parallel_merge_sort(policy.get_pool(), first, last, comp,
+            [&](It begin, It end) { algorithm_detail::sort(begin, end, comp); });
+    }
+
+    /// Merge sort keeping equal elements in their original order, uses a
+    /// buffer as big as the range
+    template < typename It, typename Comp = less >
+    static void stable_sort(It first, It last, Comp comp = {})
+    {
+        vector<algorithm_detail::value_type<It>> _buffer(static_cast<usize>(last - first));
+        algorithm_detail::stable_sort(first, last, _buffer.data(), comp);
+    }
+
+    template < typename It, typename Comp = less >
+    static void stable_sort(const execution::sequenced_policy&, It first, It last, Comp comp = {})
+    {
+        hsd::stable_sort(first, last, comp);
+    }
+
+    template < typename It, typename Comp = less >
+    static void stable_sort(const execution::parallel_policy& policy, It first, It last, Comp comp = {})
+    {
+        algorithm_detail::parallel_merge_sort(policy.get_pool(), first, last, comp,
+            [&](It begin, It end) { hsd::stable_sort(begin, end, comp); });
+    }
+
+    /// Moves the elements satisfying `pred` before the others, returns the
+    /// first of the others. Relative order isn't kept
+    template < typename It, typename Pred >
+    static constexpr It partition(It first, It last, Pred pred)
+    {
+        return algorithm_detail::partition(first, last, pred);
+    }
+
+    template < typename It, typename Pred >
+    static constexpr It partition(const execution::sequenced_policy&, It first, It last, Pred pred)
+    {
+        return algorithm_detail::partition(first, last, pred);
+    }
+
+    template < typename It, typename Pred >
+    static It partition(const execution::parallel_policy& policy, It first, It last, Pred pred)
+    {
+        return algorithm_detail::parallel_partition(policy.get_pool(), first, last, pred);
+    }
+
+    /// Puts the element that belongs at `nth` there, with nothing greater
+    /// before it and nothing smaller after it
+    template < typename It, typename Comp = less >
+    static constexpr void nth_element(It first, It nth, It last, Comp comp = {})
+    {
+        if(nth != last)
+            algorithm_detail::nth_element(first, nth, last, comp);
+    }
+
+    template < typename It, typename Comp = less >
+    static constexpr void nth_element(const execution::sequenced_policy&, It first, It nth, It last, Comp comp = {})
+    {
+        hsd::nth_element(first, nth, last, comp);
+    }
+
+    /// Narrows the range with parallel three-way partitions until it is
+    /// small, then finishes sequentially
+    template < typename It, typename Comp = less >
+    static void nth_element(const execution::parallel_policy& policy, It first, It nth, It last, Comp comp = {})
+    {
+        if(nth == last)
+            return;
+
+        thread_pool& _pool = policy.get_pool();
+
+        while(static_cast<usize>(last - first) > algorithm_detail::grain * 4 && _pool.concurrency() > 1)
+        {
+            usize _size = static_cast<usize>(last - first);
+            algorithm_detail::sort3(first, first + _size / 2, last - 1, comp);
+            auto _pivot = first[_size / 2];
+
+            auto _less = [&](const auto& value) { return comp(value, _pivot); };
+            It _mid = algorithm_detail::parallel_partition(_pool, first, last, _less);
+
+            if(nth < _mid)
+            {
+                last = _mid;
+                continue;
+            }
+
+            // The pivot is in [_mid, last), so this part is never empty
+            auto _not_greater = [&](const auto& value) { return !comp(_pivot, value); };
+            It _equal_end = algorithm_detail::parallel_partition(_pool, _mid, last, _not_greater);
+
+            if(nth < _equal_end)
+                return;
+
+            first = _equal_end;
+        }
+
+        algorithm_detail::nth_element(first, nth, last, comp);
+    }
+
+    /// Folds the range into `init`. The parallel overload folds each chunk
+    /// separately and combines the results in order, so `op` has to be
+    /// associative but not commutative
+    template < typename It, typename T, typename Op = plus >
+    static constexpr T reduce(It first, It last, T init, Op op = {})
+    {
+        for(; first != last; ++first)
+            init = op(hsd::move(init), *first);
+
+        return init;
+    }
+
+    template < typename It, typename T, typename Op = plus >
+    static constexpr T reduce(const execution::sequenced_policy&, It first, It last, T init, Op op = {})
+    {
+        return hsd::reduce(first, last, hsd::move(init), op);
+    }
+
+    template < typename It, typename T, typename Op = plus >
+    static T reduce(const execution::parallel_policy& policy, It first, It last, T init, Op op = {})
+    {
+        thread_pool& _pool = policy.get_pool();
+        usize _size = static_cast<usize>(last - first);
+        usize _chunks = algorithm_detail::chunk_count(_pool, _size);
+
+        if(_chunks <= 1)
+            return hsd::reduce(first, last, hsd::move(init), op);
+
+        vector<T> _partials(_chunks);
+
+        algorithm_detail::for_chunks(_pool, _size, _chunks, [&](usize begin, usize end, usize index) {
+            T _sum = first[begin];
+
+            for(usize _index = begin + 1; _index < end; _index++)
+                _sum = op(hsd::move(_sum), first[_index]);
+
+            _partials[index] = hsd::move(_sum);
+        });
+
+        for(auto& _partial : _partials)
+            init = op(hsd::move(init), _partial);
+
+        return init;
+    }
+
+    template < typename InIt, typename OutIt, typename Op >
+    static constexpr OutIt transform(InIt first, InIt last, OutIt dest, Op op)
+    {
+        for(; first != last; ++first, ++dest)
+            *dest = op(*first);
+
+        return dest;
+    }
+
+    template < typename InIt, typename OutIt, typename Op >
+    static constexpr OutIt transform(const execution::sequenced_policy&, InIt first, InIt last, OutIt dest, Op op)
+    {
+        return hsd::transform(first, last, dest, op);
+    }
+
+    template < typename InIt, typename OutIt, typename Op >
+    static OutIt transform(const execution::parallel_policy& policy, InIt first, InIt last, OutIt dest, Op op)
+    {
+        thread_pool& _pool = policy.get_pool();
+        usize _size = static_cast<usize>(last - first);
+
+        algorithm_detail::for_chunks(_pool, _size, algorithm_detail::chunk_count(_pool, _size),
+            [&](usize begin, usize end, usize) { hsd::transform(first + begin, first + end, dest + begin, op); });
+
+        return dest + _size;
+    }
+
+    template < typename It, typename Func >
+    static constexpr void for_each(It first, It last, Func func)
+    {
+        for(; first != last; ++first)
+            func(*first);
+    }
+
+    template < typename It, typename Func >
+    static constexpr void for_each(const execution::sequenced_policy&, It first, It last, Func func)
+    {
+        hsd::for_each(first, last, func);
+    }
+
+    template < typename It, typename Func >
+    static void for_each(const execution::parallel_policy& policy, It first, It last, Func func)
+    {
+        thread_pool& _pool = policy.get_pool();
+        usize _size = static_cast<usize>(last - first);
+
+        algorithm_detail::for_chunks(_pool, _size, algorithm_detail::chunk_count(_pool, _size),
+            [&](usize begin, usize end, usize) { hsd::for_each(first + begin, first + end, func); });
+    }
+
+    /// Writes the running fold of the range to `dest`, may be done in place
+    template < typename InIt, typename OutIt, typename Op = plus >
+    static constexpr OutIt inclusive_scan(InIt first, InIt last, OutIt dest, Op op = {})
+    {
+        if(first == last)
+            return dest;
+
+        algorithm_detail::value_type<InIt> _sum = *first;
+        *dest = _sum;
+
+        for(++first, ++dest; first != last; ++first, ++dest)
+        {
+            _sum = op(hsd::move(_sum), *first);
+            *dest = _sum;
+        }
+
+        return dest;
+    }
+
+    template < typename InIt, typename OutIt, typename Op = plus >
+    static constexpr OutIt inclusive_scan(const execution::sequenced_policy&, InIt first, InIt last, OutIt dest, Op op = {})
+    {
+        return hsd::inclusive_scan(first, last, dest, op);
+    }
+
+    /// Two passes: chunk totals, then every chunk is scanned again
+    /// starting from the sum of the chunks before it
+    template < typename InIt, typename OutIt, typename Op = plus >
+    static OutIt inclusive_scan(const execution::parallel_policy& policy, InIt first, InIt last, OutIt dest, Op op = {})
+    {
+        using value_type = algorithm_detail::value_type<InIt>;
+
+        thread_pool& _pool = policy.get_pool();
+        usize _size = static_cast<usize>(last - first);
+        usize _chunks = algorithm_detail::chunk_count(_pool, _size);
+
+        if(_chunks <= 1)
+            return hsd::inclusive_scan(first, last, dest, op);
+
+        vector<value_type> _totals(_chunks);
+
+        algorithm_detail::for_chunks(_pool, _size, _chunks, [&](usize begin, usize end, usize index) {
+            value_type _sum = first[begin];
+
+            for(usize _index = begin + 1; _index < end; _index++)
+                _sum = op(hsd::move(_sum), first[_index]);
+
+            _totals[index] = hsd::move(_sum);
+        });
+
+        for(usize _index = 1; _index < _chunks; _index++)
+            _totals[_index] = op(_totals[_index - 1], _totals[_index]);
+
+        algorithm_detail::for_chunks(_pool, _size, _chunks, [&](usize begin, usize end, usize index) {
+            if(index == 0)
+            {
+                hsd::inclusive_scan(first + begin, first + end, dest + begin, op);
+                return;
+            }
+
+            value_type _sum = _totals[index - 1];
+
+            for(usize _index = begin; _index < end; _index++)
+            {
+                _sum = op(hsd::move(_sum), first[_index]);
+                dest[_index] = _sum;
+            }
+        });
+
+        return dest + _size;
+    }
+
+    template < typename It, typename Pred >
+    static constexpr It find_if(It first, It last, Pred pred)
+    {
+        for(; first != last; ++first)
+        {
+            if(pred(*first))
+                return first;
+        }
+
+        return last;
+    }
+
+    template < typename It, typename Pred >
+    static constexpr It find_if(const execution::sequenced_policy&, It first, It last, Pred pred)
+    {
+        return hsd::find_if(first, last, pred);
+    }
+
+    /// Blocks are handed out front to back and skipped once a match
+    /// before them is known, so an early hit stops the search early
+    template < typename It, typename Pred >
+    static It find_if(const execution::parallel_policy& policy, It first, It last, Pred pred)
+    {
+        thread_pool& _pool = policy.get_pool();
+        usize _size = static_cast<usize>(last - first);
+        usize _found = _size;
+
+        if(_pool.concurrency() == 1 || _size < algorithm_detail::grain * 2)
+            return hsd::find_if(first, last, pred);
+
+        usize _blocks = (_size + algorithm_detail::grain - 1) / algorithm_detail::grain;
+
+        _pool.run(_blocks, [&](usize block) {
+            usize _begin = block * algorithm_detail::grain;
+            usize _end = min(_begin + algorithm_detail::grain, _size);
+
+            if(_begin >= __atomic_load_n(&_found, __ATOMIC_RELAXED))
+                return;
+
+            for(usize _index = _begin; _index < _end; _index++)
+            {
+                if(pred(first[_index]))
+                {
+                    usize _current = __atomic_load_n(&_found, __ATOMIC_RELAXED);
+
+                    while(_index < _current && !__atomic_compare_exchange_n(&_found, &_current,
+                        _index, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+                    return;
+                }
+            }
+        });
+
+        return first + _found;
+    }
+} // namespace hsd
@@ -0,0 +1,1182 @@
+#pragma once
+
+#include <new>
+#include <stdexcept>
+#include <initializer_list>
+
+#include "Pair.hpp"
+#include "Vector.hpp"
+#include "Functional.hpp"
+#include "AlignedStorage.hpp"
+
+namespace hsd
+{
+    namespace btree_detail
+    {
+        // Eight cache lines: a lookup touches a few nodes, a scan mostly
+        // reads keys that sit next to each other
+        inline constexpr usize node_bytes = 512;
+        inline constexpr usize cache_line = 64;
+        inline constexpr usize max_depth = 64;
+
+        struct empty {};
+
+        /// Uninitialized room for `N` objects, the owning node knows which
+        /// of them are alive
+        template <typename T, usize N>
+        struct slots
+        {
+            typename aligned_storage<sizeof(T), alignof(T)>::type _data[N];
+
+            T& operator[](usize index)
+            {
+                return reinterpret_cast<T&>(_data[index]);
+            }
+
+            const T& operator[](usize index) const
+            {
+                return reinterpret_cast<const T&>(_data[index]);
+            }
+
+            const T* data() const
+            {
+                return reinterpret_cast<const T*>(_data);
+            }
+
+            template <typename... Args>
+            void construct(usize index, Args&&... args)
+            {
+                new (&_data[index]) T(hsd::forward<Args>(args)...);
+            }
+
+            void destroy(usize index)
+            {
+                (*this)[index].~T();
+            }
+        };
+
+        // Moves `count` live objects from `src` into the free slots at
+        // `dst`, the two ranges may overlap
+        template <typename T>
+        static void relocate(T* src, T* dst, usize count)
+        {
+            if constexpr (std::is_trivially_copyable_v<T>)
+            {
+                __builtin_memmove(static_cast<void*>(dst), static_cast<const void*>(src), count * sizeof(T));
+            }
+            else if (dst < src)
+            {
+                for (usize _index = 0; _index < count; ++_index)
+                {
+                    new (dst + _index) T(hsd::move(src[_index]));
+                    src[_index].~T();
+                }
+            }
+            else
+            {
+                for (usize _index = count; _index > 0; --_index)
+                {
+                    new (dst + _index - 1) T(hsd::move(src[_index - 1]));
+                    src[_index - 1].~T();
+                }
+            }
+        }
+
+        template <typename Key, typename T, bool IsMap>
+        struct alignas(cache_line) leaf_node
+        {
+            using key_type = Key;
+            using mapped_type = T;
+
+            static constexpr usize _entry = sizeof(Key) + (IsMap ? sizeof(T) : 0);
+            static constexpr usize _fit = (node_bytes - 3 * sizeof(void*)) / _entry;
+            static constexpr usize capacity = _fit < 4 ? 4 : _fit;
+
+            u32 count = 0;
+            leaf_node* prev = nullptr;
+            leaf_node* next = nullptr;
+            slots<Key, capacity> keys;
+            [[no_unique_address]] typename conditional<IsMap, slots<T, capacity>, empty>::type values;
+        };
+
+        /// Holds `count` separators and `count + 1` children, every key in
+        /// `children[i]` is below `keys[i]` and every key in `children[i + 1]`
+        /// is not
+        template <typename Key>
+        struct alignas(cache_line) inner_node
+        {
+            static constexpr usize _fit = (node_bytes - 2 * sizeof(void*)) / (sizeof(Key) + sizeof(void*));
+            static constexpr usize capacity = _fit < 4 ? 4 : _fit;
+
+            u32 count = 0;
+            slots<Key, capacity> keys;
+            void* children[capacity + 1];
+        };
+
+        /// Hands out nodes from chunks that double in size, freed nodes are
+        /// kept for reuse and the memory goes back all at once
+        template <typename Node>
+        class node_pool
+        {
+        private:
+            static constexpr usize _first_chunk = 4;
+            static constexpr usize _max_chunk = 256;
+
+            struct free_node
+            {
+                free_node* next;
+            };
+
+            vector<void*> _chunks;
+            free_node* _free = nullptr;
+            char* _cursor = nullptr;
+            usize _left = 0;
+            usize _next_chunk = _first_chunk;
+
+        public:
+            node_pool() = default;
+            node_pool(const node_pool&) = delete;
+            node_pool& operator=(const node_pool&) = delete;
+
+            node_pool(node_pool&& other)
+                : _chunks{hsd::move(other._chunks)}, _free{hsd::exchange(other._free, nullptr)},
+                  _cursor{hsd::exchange(other._cursor, nullptr)}, _left{hsd::exchange(other._left, 0)},
+                  _next_chunk{hsd::exchange(other._next_chunk, _first_chunk)}
+            {}
+
+            node_pool& operator=(node_pool&& other)
+            {
+                release();
+                hsd::swap(_chunks, other._chunks);
+                hsd::swap(_free, other._free);
+                hsd::swap(_cursor, other._cursor);
+                hsd::swap(_left, other._left);
+                hsd::swap(_next_chunk, other._next_chunk);
+                return *this;
+            }
+
+            ~node_pool()
+            {
+                release();
+            }
+
+            Node* allocate()
+            {
+                if (_free != nullptr)
+                    return new (hsd::exchange(_free, _free->next)) Node;
+
+                if (_left == 0)
+                {
+                    _cursor = static_cast<char*>(::operator new(_next_chunk * sizeof(Node),
+                        std::align_val_t{alignof(Node)}));
+                    _chunks.push_back(_cursor);
+                    _left = _next_chunk;
+                    _next_chunk = _next_chunk < _max_chunk ? _next_chunk * 2 : _max_chunk;
+                }
+
+                _left--;
+                return new (hsd::exchange(_cursor, _cursor + sizeof(Node))) Node;
+            }
+
+            void deallocate(Node* node)
+            {
+                _free = new (static_cast<void*>(node)) free_node{_free};
+            }
+
+            void release()
+            {
+                for (auto* _chunk : _chunks)
+                    ::operator delete(_chunk, std::align_val_t{alignof(Node)});
+
+                _chunks.clear();
+                _free = nullptr;
+                _cursor = nullptr;
+                _left = 0;
+                _next_chunk = _first_chunk;
+            }
+        };
+
+        template <typename Ref>
+        struct arrow_proxy
+        {
+            Ref ref;
+
+            Ref* operator->()
+            {
+                return &ref;
+            }
+        };
+
+        template <typename Key, typename T, typename Compare, bool IsMap>
+        class btree;
+
+        /// Position in a leaf, map iterators yield `pair<const Key&, T&>`
+        /// since keys and values are stored apart
+        template <typename Leaf, bool IsMap, bool Const>
+        class iterator
+        {
+        private:
+            using key_type = typename Leaf::key_type;
+            using mapped_type = typename conditional<Const,
+                const typename Leaf::mapped_type, typename Leaf::mapped_type>::type;
+
+            template <typename, typename, typename, bool>
+            friend class btree;
+
+            Leaf* _leaf = nullptr;
+            usize _index = 0;
+
+        public:
+            using reference = typename conditional<IsMap,
+                pair<const key_type&, mapped_type&>, const key_type&>::type;
+
+            iterator() = default;
+
+            iterator(Leaf* leaf, usize index)
+                : _leaf{leaf}, _index{index}
+            {}
+
+            operator iterator<Leaf, IsMap, true>() const
+            {
+                return {_leaf, _index};
+            }
+
+            reference operator*() const
+            {
+                if constexpr (IsMap)
+                {
+                    return {_leaf->keys[_index], _leaf->values[_index]};
+                }
+                else
+                {
+                    return _leaf->keys[_index];
+                }
+            }
+
+            auto operator->() const
+            {
+                if constexpr (IsMap)
+                {
+                    return arrow_proxy<reference>{**this};
+                }
+                else
+                {
+                    return &_leaf->keys[_index];
+                }
+            }
+
+            const key_type& key() const
+            {
+                return _leaf->keys[_index];
+            }
+
+            mapped_type& value() const requires IsMap
+            {
+                return _leaf->values[_index];
+            }
+
+            iterator& operator++()
+            {
+                if (++_index == _leaf->count && _leaf->next != nullptr)
+                {
+                    _leaf = _leaf->next;
+                    _index = 0;
+                }
+
+                return *this;
+            }
+
+            iterator& operator--()
+            {
+                if (_index == 0)
+                {
+                    _leaf = _leaf->prev;
+                    _index = _leaf->count;
+                }
+
+                _index--;
+                return *this;
+            }
+
+            iterator operator++(i32)
+            {
+                iterator _tmp = *this;
+                operator++();
+                return _tmp;
+            }
+
+            iterator operator--(i32)
+            {
+                iterator _tmp = *this;
+                operator--();
+                return _tmp;
+            }
+
+            friend bool operator==(const iterator& lhs, const iterator& rhs)
+            {
+                return lhs._leaf == rhs._leaf && lhs._index == rhs._index;
+            }
+
+            friend bool operator!=(const iterator& lhs, const iterator& rhs)
+            {
+                return !(lhs == rhs);
+            }
+        };
+
+        /// B+ tree shared by `btree_map` and `btree_set`. Entries live only
+        /// in the leaves, which are linked both ways so iteration never
+        /// climbs the tree. Separators are copies of keys, nodes are cache
+        /// line aligned and come from per-tree pools
+        template <typename Key, typename T, typename Compare, bool IsMap>
+        class btree
+        {
+        protected:
+            using leaf_type = leaf_node<Key, T, IsMap>;
+            using inner_type = inner_node<Key>;
+
+            static constexpr usize _leaf_min = leaf_type::capacity / 2;
+            static constexpr usize _inner_min = inner_type::capacity / 2;
+
+            struct path_entry
+            {
+                inner_type* node;
+                usize index;
+            };
+
+            void* _root = nullptr;
+            leaf_type* _first = nullptr;
+            leaf_type* _last = nullptr;
+            usize _size = 0;
+            usize _height = 0;
+            node_pool<leaf_type> _leaves;
+            node_pool<inner_type> _inners;
+            [[no_unique_address]] Compare _comp;
+
+        public:
+            using iterator = btree_detail::iterator<leaf_type, IsMap, false>;
+            using const_iterator = btree_detail::iterator<leaf_type, IsMap, true>;
+
+        protected:
+            // Index of the first key not below `key`
+            template <typename NewKey>
+            usize _lower(const Key* keys, usize count, const NewKey& key) const
+            {
+                if (count == 0)
+                    return 0;
+
+                const Key* _base = keys;
+
+                while (count > 1)
+                {
+                    usize _half = count / 2;
+                    _base = _comp(_base[_half], key) ? _base + _half : _base;
+                    count -= _half;
+                }
+
+                return static_cast<usize>(_base - keys) + _comp(*_base, key);
+            }
+
+            // Index of the first key above `key`
+            template <typename NewKey>
+            usize _upper(const Key* keys, usize count, const NewKey& key) const
+            {
+                if (count == 0)
+                    return 0;
+
+                const Key* _base = keys;
+
+                while (count > 1)
+                {
+                    usize _half = count / 2;
+                    _base = _comp(key, _base[_half]) ? _base : _base + _half;
+                    count -= _half;
+                }
+
+                return static_cast<usize>(_base - keys) + !_comp(key, *_base);
+            }
+
+            template <typename NewKey>
+            leaf_type* _descend(const NewKey& key, path_entry* path) const
+            {
+                void* _node = _root;
+
+                for (usize _level = 0; _level < _height; ++_level)
+                {
+                    auto* _inner = static_cast<inner_type*>(_node);
+                    usize _index = _upper(_inner->keys.data(), _inner->count, key);
+
+                    if (path != nullptr)
+                        path[_level] = {_inner, _index};
+
+                    _node = _inner->children[_index];
+                }
+
+                return static_cast<leaf_type*>(_node);
+            }
+
+            // Steps past the end of a leaf onto the next one
+            iterator _at(leaf_type* leaf, usize index) const
+            {
+                if (index == leaf->count && leaf->next != nullptr)
+                    return {leaf->next, 0};
+
+                return {leaf, index};
+            }
+
+            static void _move_entries(leaf_type* src, usize from, leaf_type* dst, usize to, usize count)
+            {
+                relocate(&src->keys[from], &dst->keys[to], count);
+
+                if constexpr (IsMap)
+                    relocate(&src->values[from], &dst->values[to], count);
+            }
+
+            static void _destroy_entry(leaf_type* leaf, usize index)
+            {
+                leaf->keys.destroy(index);
+
+                if constexpr (IsMap)
+                    leaf->values.destroy(index);
+            }
+
+            void _destroy(void* node, usize level)
+            {
+                if (level == _height)
+                {
+                    auto* _leaf = static_cast<leaf_type*>(node);
+
+                    for (usize _index = 0; _index < _leaf->count; ++_index)
+                        _destroy_entry(_leaf, _index);
+                }
+                else
+                {
+                    auto* _inner = static_cast<inner_type*>(node);
+
+                    for (usize _index = 0; _index < _inner->count; ++_index)
+                        _inner->keys.destroy(_index);
+                    for (usize _index = 0; _index <= _inner->count; ++_index)
+                        _destroy(_inner->children[_index], level + 1);
+                }
+            }
+
+            leaf_type* _append_leaf()
+            {
+                leaf_type* _leaf = _leaves.allocate();
+                _leaf->prev = _last;
+
+                if (_last != nullptr)
+                    _last->next = _leaf;
+                else
+                    _first = _leaf;
+
+                _last = _leaf;
+                return _leaf;
+            }
+
+            static void _inner_insert(inner_type* node, usize index, const Key& sep, void* child)
+            {
+                relocate(&node->keys[index], &node->keys[index + 1], node->count - index);
+                relocate(&node->children[index + 1], &node->children[index + 2], node->count - index);
+                node->keys.construct(index, sep);
+                node->children[index + 1] = child;
+                node->count++;
+            }
+
+            // Drops separator `index` and the child to its right
+            void _remove_child(inner_type* node, usize index)
+            {
+                node->keys.destroy(index);
+                relocate(&node->keys[index + 1], &node->keys[index], node->count - index - 1);
+                relocate(&node->children[index + 2], &node->children[index + 1], node->count - index - 1);
+                node->count--;
+            }
+
+            // Hangs `right` next to `left`, which sits at depth `level`
+            void _insert_parent(path_entry* path, usize level, void* left, const Key& sep, void* right)
+            {
+                if (level == 0)
+                {
+                    inner_type* _new_root = _inners.allocate();
+                    _new_root->keys.construct(0, sep);
+                    _new_root->children[0] = left;
+                    _new_root->children[1] = right;
+                    _new_root->count = 1;
+                    _root = _new_root;
+                    _height++;
+                    return;
+                }
+
+                auto [_parent, _index] = path[level - 1];
+
+                if (_parent->count < inner_type::capacity)
+                {
+                    _inner_insert(_parent, _index, sep, right);
+                    return;
+                }
+
+                // Split so both halves keep at least `_inner_min` separators
+                // counting the one being added, the middle one moves up
+                constexpr usize _half = inner_type::capacity / 2;
+                constexpr usize _count = inner_type::capacity;
+                inner_type* _sibling = _inners.allocate();
+
+                if (_index < _half)
+                {
+                    relocate(&_parent->keys[_half], &_sibling->keys[0], _count - _half);
+                    relocate(&_parent->children[_half], &_sibling->children[0], _count - _half + 1);
+                    _sibling->count = _count - _half;
+
+                    Key _up = hsd::move(_parent->keys[_half - 1]);
+                    _parent->keys.destroy(_half - 1);
+                    _parent->count = _half - 1;
+                    _inner_insert(_parent, _index, sep, right);
+                    _insert_parent(path, level - 1, _parent, _up, _sibling);
+                }
+                else if (_index == _half)
+                {
+                    relocate(&_parent->keys[_half], &_sibling->keys[0], _count - _half);
+                    relocate(&_parent->children[_half + 1], &_sibling->children[1], _count - _half);
+                    _sibling->children[0] = right;
+                    _sibling->count = _count - _half;
+                    _parent->count = _half;
+                    _insert_parent(path, level - 1, _parent, sep, _sibling);
+                }
+                else
+                {
+                    relocate(&_parent->keys[_half + 1], &_sibling->keys[0], _count - _half - 1);
+                    relocate(&_parent->children[_half + 1], &_sibling->children[0], _count - _half);
+                    _sibling->count = _count - _half - 1;
+
+                    Key _up = hsd::move(_parent->keys[_half]);
+                    _parent->keys.destroy(_half);
+                    _parent->count = _half;
+                    _inner_insert(_sibling, _index - _half - 1, sep, right);
+                    _insert_parent(path, level - 1, _parent, _up, _sibling);
+                }
+            }
+
+            leaf_type* _split_leaf(leaf_type* leaf, path_entry* path)
+            {
+                leaf_type* _right = _leaves.allocate();
+                usize _moved = leaf->count / 2;
+                usize _kept = leaf->count - _moved;
+
+                _move_entries(leaf, _kept, _right, 0, _moved);
+                leaf->count = static_cast<u32>(_kept);
+                _right->count = static_cast<u32>(_moved);
+
+                _right->prev = leaf;
+                _right->next = leaf->next;
+
+                if (leaf->next != nullptr)
+                    leaf->next->prev = _right;
+                else
+                    _last = _right;
+
+                leaf->next = _right;
+                _insert_parent(path, _height, leaf, _right->keys[0], _right);
+                return _right;
+            }
+
+            void _free_leaf(leaf_type* leaf)
+            {
+                if (leaf->prev != nullptr)
+                    leaf->prev->next = leaf->next;
+                else
+                    _first = leaf->next;
+
+                if (leaf->next != nullptr)
+                    leaf->next->prev = leaf->prev;
+                else
+                    _last = leaf->prev;
+
+                _leaves.deallocate(leaf);
+            }
+
+            // Refills the inner node at depth `level` after it lost a child
+            void _fix_inner(path_entry* path, usize level)
+            {
+                inner_type* _node = path[level].node;
+
+                if (level == 0)
+                {
+                    if (_node->count == 0)
+                    {
+                        _root = _node->children[0];
+                        _height--;
+                        _inners.deallocate(_node);
+                    }
+
+                    return;
+                }
+                if (_node->count >= _inner_min)
+                    return;
+
+                auto [_parent, _index] = path[level - 1];
+                auto* _left = _index > 0 ? static_cast<inner_type*>(_parent->children[_index - 1]) : nullptr;
+                auto* _right = _index < _parent->count ? static_cast<inner_type*>(_parent->children[_index + 1]) : nullptr;
+
+                if (_left != nullptr && _left->count > _inner_min)
+                {
+                    // Rotate through the parent: its separator comes down,
+                    // the last key of the left sibling goes up
+                    relocate(&_node->keys[0], &_node->keys[1], _node->count);
+                    relocate(&_node->children[0], &_node->children[1], _node->count + 1);
+                    _node->keys.construct(0, hsd::move(_parent->keys[_index - 1]));
+                    _node->children[0] = _left->children[_left->count];
+                    _node->count++;
+
+                    _parent->keys[_index - 1] = hsd::move(_left->keys[_left->count - 1]);
+                    _left->keys.destroy(_left->count - 1);
+                    _left->count--;
+                }
+                else if (_right != nullptr && _right->count > _inner_min)
+                {
+                    _node->keys.construct(_node->count, hsd::move(_parent->keys[_index]));
+                    _node->children[_node->count + 1] = _right->children[0];
+                    _node->count++;
+
+                    _parent->keys[_index] = hsd::move(_right->keys[0]);
+                    _right->keys.destroy(0);
+                    relocate(&_right->keys[1], &_right->keys[0], _right->count - 1);
+                    relocate(&_right->children[1], &_right->children[0], _right->count);
+                    _right->count--;
+                }
+                else
+                {
+                    // Merge with a sibling, the separator between them comes down
+                    usize _sep = _left != nullptr ? _index - 1 : _index;
+                    inner_type* _into = _left != nullptr ? _left : _node;
+                    inner_type* _from = _left != nullptr ? _node : _right;
+
+                    _into->keys.construct(_into->count, hsd::move(_parent->keys[_sep]));
+                    relocate(&_from->keys[0], &_into->keys[_into->count + 1], _from->count);
+                    relocate(&_from->children[0], &_into->children[_into->count + 1], _from->count + 1);
+                    _into->count += _from->count + 1;
+
+                    _inners.deallocate(_from);
+                    _remove_child(_parent, _sep);
+                    _fix_inner(path, level - 1);
+                }
+            }
+
+            void _fix_leaf(leaf_type* leaf, path_entry* path)
+            {
+                auto [_parent, _index] = path[_height - 1];
+                auto* _left = _index > 0 ? static_cast<leaf_type*>(_parent->children[_index - 1]) : nullptr;
+                auto* _right = _index < _parent->count ? static_cast<leaf_type*>(_parent->children[_index + 1]) : nullptr;
+
+                if (_left != nullptr && _left->count > _leaf_min)
+                {
+                    _move_entries(leaf, 0, leaf, 1, leaf->count);
+                    _move_entries(_left, _left->count - 1, leaf, 0, 1);
+                    _left->count--;
+                    leaf->count++;
+                    _parent->keys[_index - 1] = leaf->keys[0];
+                }
+                else if (_right != nullptr && _right->count > _leaf_min)
+                {
+                    _move_entries(_right, 0, leaf, leaf->count, 1);
+                    _move_entries(_right, 1, _right, 0, _right->count - 1);
+                    _right->count--;
+                    leaf->count++;
+                    _parent->keys[_index] = _right->keys[0];
+                }
+                else
+                {
+                    usize _sep = _left != nullptr ? _index - 1 : _index;
+                    leaf_type* _into = _left != nullptr ? _left : leaf;
+                    leaf_type* _from = _left != nullptr ? leaf : _right;
+
+                    _move_entries(_from, 0, _into, _into->count, _from->count);
+                    _into->count += _from->count;
+
+                    _free_leaf(_from);
+                    _remove_child(_parent, _sep);
+                    _fix_inner(path, _height - 1);
+                }
+            }
+
+            template <typename NewKey, typename... Args>
+            pair<iterator, bool> _emplace(NewKey&& key, Args&&... args)
+            {
+                if (_root == nullptr)
+                    _root = _append_leaf();
+
+                path_entry _path[max_depth];
+                leaf_type* _leaf = _descend(key, _path);
+                usize _index = _lower(_leaf->keys.data(), _leaf->count, key);
+
+                if (_index < _leaf->count && !_comp(key, _leaf->keys[_index]))
+                    return {iterator{_leaf, _index}, false};
+
+                if (_leaf->count == leaf_type::capacity)
+                {
+                    leaf_type* _right = _split_leaf(_leaf, _path);
+
+                    if (_index > _leaf->count)
+                    {
+                        _index -= _leaf->count;
+                        _leaf = _right;
+                    }
+                }
+
+                _move_entries(_leaf, _index, _leaf, _index + 1, _leaf->count - _index);
+                _leaf->keys.construct(_index, hsd::forward<NewKey>(key));
+
+                if constexpr (IsMap)
+                    _leaf->values.construct(_index, hsd::forward<Args>(args)...);
+
+                _leaf->count++;
+                _size++;
+                return {iterator{_leaf, _index}, true};
+            }
+
+            template <typename Elem>
+            static const auto& _key_of(const Elem& elem)
+            {
+                if constexpr (IsMap)
+                {
+                    return elem.first;
+                }
+                else
+                {
+                    return elem;
+                }
+            }
+
+            // Fills the leaf chain, then stacks inner levels on it
+            template <typename It>
+            void _bulk_build(It first, It last, vector<inner_type*>& built)
+            {
+                vector<pair<void*, const Key*>> _level;
+
+                for (; first != last; ++first)
+                {
+                    auto&& _elem = *first;
+                    const auto& _key = _key_of(_elem);
+
+                    if (_size != 0)
+                    {
+                        const Key& _prev = _last->keys[_last->count - 1];
+
+                        if (!_comp(_prev, _key))
+                        {
+                            if (_comp(_key, _prev))
+                                throw std::runtime_error("bulk_load input is not sorted");
+
+                            continue;
+                        }
+                    }
+                    if (_last == nullptr || _last->count == leaf_type::capacity)
+                        _level.push_back({_append_leaf(), nullptr});
+
+                    if constexpr (IsMap)
+                    {
+                        _last->keys.construct(_last->count, _elem.first);
+                        _last->values.construct(_last->count, _elem.second);
+                    }
+                    else
+                    {
+                        _last->keys.construct(_last->count, _elem);
+                    }
+
+                    _last->count++;
+                    _size++;
+                }
+
+                if (_last == nullptr)
+                    return;
+
+                // Top up the last leaf from its neighbour
+                if (_last->prev != nullptr && _last->count < _leaf_min)
+                {
+                    leaf_type* _prev = _last->prev;
+                    usize _moved = (_prev->count + _last->count) / 2 - _last->count;
+
+                    _move_entries(_last, 0, _last, _moved, _last->count);
+                    _move_entries(_prev, _prev->count - _moved, _last, 0, _moved);
+                    _prev->count -= static_cast<u32>(_moved);
+                    _last->count += static_cast<u32>(_moved);
+                }
+
+                for (auto& _entry : _level)
+                    _entry.second = &static_cast<leaf_type*>(_entry.first)->keys[0];
+
+                while (_level.size() > 1)
+                {
+                    constexpr usize _fanout = inner_type::capacity + 1;
+                    usize _children = _level.size();
+                    usize _nodes = (_children + _fanout - 1) / _fanout;
+                    usize _next = 0;
+                    vector<pair<void*, const Key*>> _parents;
+                    _parents.reserve(_nodes);
+
+                    for (usize _node = 0; _node < _nodes; ++_node)
+                    {
+                        // Spread evenly so no node ends up under half full
+                        usize _take = (_children - _next) / (_nodes - _node);
+                        inner_type* _inner = _inners.allocate();
+                        built.push_back(_inner);
+                        _inner->children[0] = _level[_next].first;
+
+                        // Counted as they are built, so a throw destroys just these
+                        for (usize _child = 1; _child < _take; ++_child)
+                        {
+                            _inner->keys.construct(_child - 1, *_level[_next + _child].second);
+                            _inner->children[_child] = _level[_next + _child].first;
+                            _inner->count = static_cast<u32>(_child);
+                        }
+
+                        _parents.push_back({_inner, _level[_next].second});
+                        _next += _take;
+                    }
+
+                    _level = hsd::move(_parents);
+                    _height++;
+                }
+
+                _root = _level[0].first;
+            }
+
+        public:
+            btree() = default;
+
+            btree(const btree& other)
+                : _comp{other._comp}
+            {
+                bulk_load(other.begin(), other.end());
+            }
+
+            btree(btree&& other)
+                : _root{hsd::exchange(other._root, nullptr)}, _first{hsd::exchange(other._first, nullptr)},
+                  _last{hsd::exchange(other._last, nullptr)}, _size{hsd::exchange(other._size, 0)},
+                  _height{hsd::exchange(other._height, 0)}, _leaves{hsd::move(other._leaves)},
+                  _inners{hsd::move(other._inners)}, _comp{other._comp}
+            {}
+
+            btree& operator=(const btree& other)
+            {
+                if (this != &other)
+                {
+                    _comp = other._comp;
+                    bulk_load(other.begin(), other.end());
+                }
+
+                return *this;
+            }
+
+            btree& operator=(btree&& other)
+            {
+                if (this != &other)
+                {
+                    clear();
+                    _root = hsd::exchange(other._root, nullptr);
+                    _first = hsd::exchange(other._first, nullptr);
+                    _last = hsd::exchange(other._last, nullptr);
+                    _size = hsd::exchange(other._size, 0);
+                    _height = hsd::exchange(other._height, 0);
+                    _leaves = hsd::move(other._leaves);
+                    _inners = hsd::move(other._inners);
+                    _comp = other._comp;
+                }
+
+                return *this;
+            }
+
+            ~btree()
+            {
+                clear();
+            }
+
+            /// Replaces the contents with the ascending range [`first`, `last`),
+            /// building the tree bottom up with full leaves. Repeated keys
+            /// keep their first entry, descending ones throw and leave the
+            /// tree empty
+            template <typename It>
+            void bulk_load(It first, It last)
+            {
+                clear();
+                // Inner nodes aren't reachable from `_root` until the end,
+                // so a throw tears down what was built from these
+                vector<inner_type*> _built;
+
+                try
+                {
+                    _bulk_build(first, last, _built);
+                }
+                catch (...)
+                {
+                    for (leaf_type* _leaf = _first; _leaf != nullptr; _leaf = _leaf->next)
+                    {
+                        for (usize _index = 0; _index < _leaf->count; ++_index)
+                            _destroy_entry(_leaf, _index);
+                    }
+                    for (auto* _inner : _built)
+                    {
+                        for (usize _index = 0; _index < _inner->count; ++_index)
+                            _inner->keys.destroy(_index);
+                    }
+
+                    _root = nullptr;
+                    clear();
+                    throw;
+                }
+            }
+
+            template <typename NewKey>
+            iterator find(const NewKey& key)
+            {
+                if (_root == nullptr)
+                    return end();
+
+                leaf_type* _leaf = _descend(key, nullptr);
+                usize _index = _lower(_leaf->keys.data(), _leaf->count, key);
+
+                if (_index < _leaf->count && !_comp(key, _leaf->keys[_index]))
+                    return {_leaf, _index};
+
+                return end();
+            }
+
+            template <typename NewKey>
+            const_iterator find(const NewKey& key) const
+            {
+                return const_cast<btree*>(this)->find(key);
+            }
+
+            template <typename NewKey>
+            bool contains(const NewKey& key) const
+            {
+                return find(key) != end();
+            }
+
+            /// First entry whose key is not below `key`
+            template <typename NewKey>
+            iterator lower_bound(const NewKey& key)
+            {
+                if (_root == nullptr)
+                    return end();
+
+                leaf_type* _leaf = _descend(key, nullptr);
+                return _at(_leaf, _lower(_leaf->keys.data(), _leaf->count, key));
+            }
+
+            template <typename NewKey>
+            const_iterator lower_bound(const NewKey& key) const
+            {
+                return const_cast<btree*>(this)->lower_bound(key);
+            }
+
+            /// First entry whose key is above `key`
+            template <typename NewKey>
+            iterator upper_bound(const NewKey& key)
+            {
+                if (_root == nullptr)
+                    return end();
+
+                leaf_type* _leaf = _descend(key, nullptr);
+                return _at(_leaf, _upper(_leaf->keys.data(), _leaf->count, key));
+            }
+
+            template <typename NewKey>
+            const_iterator upper_bound(const NewKey& key) const
+            {
+                return const_cast<btree*>(this)->upper_bound(key);
+            }
+
+            template <typename NewKey>
+            bool erase(const NewKey& key)
+            {
+                if (_root == nullptr)
+                    return false;
+
+                path_entry _path[max_depth];
+                leaf_type* _leaf = _descend(key, _path);
+                usize _index = _lower(_leaf->keys.data(), _leaf->count, key);
+
+                if (_index == _leaf->count || _comp(key, _leaf->keys[_index]))
+                    return false;
+
+                _destroy_entry(_leaf, _index);
+                _move_entries(_leaf, _index + 1, _leaf, _index, _leaf->count - _index - 1);
+                _leaf->count--;
+                _size--;
+
+                if (_height != 0 && _leaf->count < _leaf_min)
+                    _fix_leaf(_leaf, _path);
+
+                return true;
+            }
+
+            /// Removes the entry at `pos`, returns the one that followed it
+            iterator erase(const_iterator pos)
+            {
+                Key _key = pos.key();
+                erase(_key);
+                return lower_bound(_key);
+            }
+
+            iterator erase(iterator pos)
+            {
+                return erase(const_iterator{pos});
+            }
+
+            void clear()
+            {
+                if (_root != nullptr)
+                    _destroy(_root, 0);
+
+                _leaves.release();
+                _inners.release();
+                _root = nullptr;
+                _first = _last = nullptr;
+                _size = 0;
+                _height = 0;
+            }
+
+            usize size() const
+            {
+                return _size;
+            }
+
+            bool empty() const
+            {
+                return _size == 0;
+            }
+
+            /// Levels of inner nodes above the leaves
+            usize height() const
+            {
+                return _height;
+            }
+
+            iterator begin()
+            {
+                return {_first, 0};
+            }
+
+            iterator end()
+            {
+                return {_last, _last != nullptr ? _last->count : 0u};
+            }
+
+            const_iterator begin() const
+            {
+                return {_first, 0};
+            }
+
+            const_iterator end() const
+            {
+                return {_last, _last != nullptr ? _last->count : 0u};
+            }
+
+            const_iterator cbegin() const
+            {
+                return begin();
+            }
+
+            const_iterator cend() const
+            {
+                return end();
+            }
+        };
+    } // namespace btree_detail
+
+    /// Ordered map for large key sets and range scans, see `btree_detail::btree`
+    template <typename Key, typename T, typename Compare = less>
+    class btree_map : public btree_detail::btree<Key, T, Compare, true>
+    {
+    private:
+        using base_type = btree_detail::btree<Key, T, Compare, true>;
+
+    public:
+        using iterator = typename base_type::iterator;
+        using const_iterator = typename base_type::const_iterator;
+
+        btree_map() = default;
+
+        btree_map(std::initializer_list<pair<Key, T>> list)
+        {
+            for (auto& _value : list)
+                emplace(_value.first, _value.second);
+        }
+
+        template <typename... Args>
+        pair<iterator, bool> emplace(const Key& key, Args&&... args)
+        {
+            return this->_emplace(key, hsd::forward<Args>(args)...);
+        }
+
+        template <typename... Args>
+        pair<iterator, bool> emplace(Key&& key, Args&&... args)
+        {
+            return this->_emplace(hsd::move(key), hsd::forward<Args>(args)...);
+        }
+
+        pair<iterator, bool> insert(const pair<Key, T>& value)
+        {
+            return this->_emplace(value.first, value.second);
+        }
+
+        pair<iterator, bool> insert(pair<Key, T>&& value)
+        {
+            return this->_emplace(hsd::move(value.first), hsd::move(value.second));
+        }
+
+        T& operator[](const Key& key)
+        {
+            return emplace(key).first.value();
+        }
+
+        T& at(const Key& key)
+        {
+            auto _it = this->find(key);
+
+            if (_it == this->end())
+                throw std::out_of_range("Key not found in btree_map");
+
+            return _it.value();
+        }
+
+        const T& at(const Key& key) const
+        {
+            auto _it = this->find(key);
+
+            if (_it == this->end())
+                throw std::out_of_range("Key not found in btree_map");
+
+            return _it.value();
+        }
+    };
+
+    /// Ordered set for large key sets and range scans, see `btree_detail::btree`
+    template <typename Key, typename Compare = less>
+    class btree_set : public btree_detail::btree<Key, btree_detail::empty, Compare, false>
+    {
+    private:
+        using base_type = btree_detail::btree<Key, btree_detail::empty, Compare, false>;
+
+    public:
+        using iterator = typename base_type::iterator;
+        using const_iterator = typename base_type::const_iterator;
+
+        btree_set() = default;
+
+        btree_set(std::initializer_list<Key> list)
+        {
+            for (auto& _value : list)
+                insert(_value);
+        }
+
+        pair<iterator, bool> insert(const Key& key)
+        {
+            return this->_emplace(key);
+        }
+
+        pair<iterator, bool> insert(Key&& key)
+        {
+            return this->_emplace(hsd::move(key));
+        }
+    };
+} // namespace hsd
@@ -0,0 +1,1026 @@
+#pragma once
+
+#include <stdexcept>
+#include <type_traits>
+
+#include "Simd.hpp"
+#include "Limits.hpp"
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+// Same as in Simd.hpp, the kernels' vectors never cross a call boundary
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+namespace hsd
+{
+    namespace bitset_detail
+    {
+        static constexpr usize npos = limits<usize>::max;
+
+        static constexpr usize words_for(usize bits)
+        {
+            return (bits + 63) / 64;
+        }
+
+        // Mask of the bits in use in the last word
+        static constexpr u64 tail_mask(usize bits)
+        {
+            return bits % 64 ? (u64{1} << (bits % 64)) - 1 : ~u64{0};
+        }
+
+        /// One `popcnt` when the build targets it, otherwise the SWAR count,
+        /// which beats the libgcc call `__builtin_popcountll` becomes there
+        static constexpr u32 popcount(u64 word)
+        {
+            #if defined(__POPCNT__)
+            return static_cast<u32>(__builtin_popcountll(word));
+            #else
+            word = word - ((word >> 1) & 0x5555555555555555);
+            word = (word & 0x3333333333333333) + ((word >> 2) & 0x3333333333333333);
+            word = (word + (word >> 4)) & 0x0f0f0f0f0f0f0f0f;
+            return static_cast<u32>((word * 0x0101010101010101) >> 56);
+            #endif
+        }
+
+        /// Position of the set bit of rank `rank` in `word`, which must have
+        /// more than `rank` set bits. `pdep` + `tzcnt` with BMI2, otherwise
+        /// the byte holding it is found from the byte prefix counts
+        static constexpr u32 select_in_word(u64 word, u32 rank)
+        {
+            #if defined(__BMI2__)
+            if (!std::is_constant_evaluated())
+                return static_cast<u32>(__builtin_ctzll(_pdep_u64(u64{1} << rank, word)));
+            #endif
+
+            u64 _bytes = word - ((word >> 1) & 0x5555555555555555);
+            _bytes = (_bytes & 0x3333333333333333) + ((_bytes >> 2) & 0x3333333333333333);
+            _bytes = (_bytes + (_bytes >> 4)) & 0x0f0f0f0f0f0f0f0f;
+            // Byte i holds the count of bytes 0..i
+            u64 _prefix = _bytes * 0x0101010101010101;
+            u32 _byte = 0;
+
+            while (((_prefix >> (_byte * 8)) & 0xff) <= rank)
+                _byte++;
+
+            if (_byte != 0)
+                rank -= static_cast<u32>((_prefix >> (_byte * 8 - 8)) & 0xff);
+
+            u64 _bits = (word >> (_byte * 8)) & 0xff;
+
+            for (; rank != 0; rank--)
+                _bits &= _bits - 1;
+
+            return _byte * 8 + static_cast<u32>(__builtin_ctzll(_bits));
+        }
+
+        // First set bit at or after `from`, `npos` if there is none
+        static constexpr usize find_from(const u64* words, usize count, usize from)
+        {
+            usize _word = from / 64;
+
+            if (_word >= count)
+                return npos;
+
+            u64 _bits = words[_word] & (~u64{0} << (from % 64));
+
+            while (_bits == 0)
+            {
+                if (++_word == count)
+                    return npos;
+
+                _bits = words[_word];
+            }
+
+            return _word * 64 + static_cast<usize>(__builtin_ctzll(_bits));
+        }
+
+        // Moves every bit `shift` places towards the higher indices
+        static constexpr void shift_up(u64* words, usize count, usize shift)
+        {
+            usize _skip = shift / 64;
+            usize _bits = shift % 64;
+
+            for (usize _index = count; _index-- > 0;)
+            {
+                u64 _value = 0;
+
+                if (_index >= _skip)
+                {
+                    _value = words[_index - _skip] << _bits;
+
+                    if (_bits != 0 && _index > _skip)
+                        _value |= words[_index - _skip - 1] >> (64 - _bits);
+                }
+
+                words[_index] = _value;
+            }
+        }
+
+        static constexpr void shift_down(u64* words, usize count, usize shift)
+        {
+            usize _skip = shift / 64;
+            usize _bits = shift % 64;
+
+            for (usize _index = 0; _index < count; _index++)
+            {
+                u64 _value = 0;
+
+                if (_index + _skip < count)
+                {
+                    _value = words[_index + _skip] >> _bits;
+
+                    if (_bits != 0 && _index + _skip + 1 < count)
+                        _value |= words[_index + _skip + 1] << (64 - _bits);
+                }
+
+                words[_index] = _value;
+            }
+        }
+
+        // Only the single lane batch runs without popcnt
+        template <typename B>
+        static u64 kernel_popcount(u64 word)
+        {
+            if constexpr (sizeof(B) == sizeof(u64))
+                return popcount(word);
+            else
+                return static_cast<u64>(__builtin_popcountll(word));
+        }
+
+        struct count_kernel
+        {
+            // Four counts in flight keep popcnt's port busy
+            template <typename B, typename T>
+            static u64 run(const T* words, usize count)
+            {
+                u64 _acc0 = 0, _acc1 = 0, _acc2 = 0, _acc3 = 0;
+                usize _index = 0;
+
+                for (; _index + 4 <= count; _index += 4)
+                {
+                    _acc0 += kernel_popcount<B>(words[_index]);
+                    _acc1 += kernel_popcount<B>(words[_index + 1]);
+                    _acc2 += kernel_popcount<B>(words[_index + 2]);
+                    _acc3 += kernel_popcount<B>(words[_index + 3]);
+                }
+                for (; _index < count; _index++)
+                    _acc0 += kernel_popcount<B>(words[_index]);
+
+                return (_acc0 + _acc1) + (_acc2 + _acc3);
+            }
+        };
+
+        /// Popcount of `lhs & rhs` without storing the intersection
+        struct intersect_count_kernel
+        {
+            template <typename B, typename T>
+            static u64 run(const T* lhs, const T* rhs, usize count)
+            {
+                u64 _acc0 = 0, _acc1 = 0, _acc2 = 0, _acc3 = 0;
+                usize _index = 0;
+
+                for (; _index + 4 <= count; _index += 4)
+                {
+                    _acc0 += kernel_popcount<B>(lhs[_index] & rhs[_index]);
+                    _acc1 += kernel_popcount<B>(lhs[_index + 1] & rhs[_index + 1]);
+                    _acc2 += kernel_popcount<B>(lhs[_index + 2] & rhs[_index + 2]);
+                    _acc3 += kernel_popcount<B>(lhs[_index + 3] & rhs[_index + 3]);
+                }
+                for (; _index < count; _index++)
+                    _acc0 += kernel_popcount<B>(lhs[_index] & rhs[_index]);
+
+                return (_acc0 + _acc1) + (_acc2 + _acc3);
+            }
+        };
+
+        /// `lhs = lhs op rhs` a register at a time, '-' is and-not
+        template <char Op>
+        struct word_kernel
+        {
+            // In place, so no vector is returned by value
+            template <typename V>
+            static constexpr void apply(V& lhs, const V& rhs)
+            {
+                if constexpr (Op == '&')
+                    lhs &= rhs;
+                else if constexpr (Op == '|')
+                    lhs |= rhs;
+                else if constexpr (Op == '^')
+                    lhs ^= rhs;
+                else
+                    lhs &= ~rhs;
+            }
+
+            template <typename B, typename T>
+            static void run(T* lhs, const T* rhs, usize count)
+            {
+                constexpr usize _lanes = B::lanes;
+                usize _index = 0;
+
+                for (; _index + 2 * _lanes <= count; _index += 2 * _lanes)
+                {
+                    B _first = B::load(lhs + _index);
+                    B _second = B::load(lhs + _index + _lanes);
+                    apply(_first.value, B::load(rhs + _index).value);
+                    apply(_second.value, B::load(rhs + _index + _lanes).value);
+                    _first.store(lhs + _index);
+                    _second.store(lhs + _index + _lanes);
+                }
+                for (; _index < count; _index++)
+                    apply(lhs[_index], rhs[_index]);
+            }
+        };
+
+        static constexpr u64 count(const u64* words, usize count)
+        {
+            if (std::is_constant_evaluated())
+            {
+                u64 _total = 0;
+
+                for (usize _index = 0; _index < count; _index++)
+                    _total += popcount(words[_index]);
+
+                return _total;
+            }
+
+            return simd::dispatch<count_kernel, u64>(words, count);
+        }
+
+        template <char Op>
+        static constexpr void apply(u64* lhs, const u64* rhs, usize count)
+        {
+            if (std::is_constant_evaluated())
+            {
+                for (usize _index = 0; _index < count; _index++)
+                    word_kernel<Op>::apply(lhs[_index], rhs[_index]);
+            }
+            else
+            {
+                simd::dispatch<word_kernel<Op>, u64>(lhs, rhs, count);
+            }
+        }
+
+        /// Indices of the set bits in increasing order, each step clears
+        /// the lowest bit of the current word and takes its `tzcnt`
+        class ones_iterator
+        {
+        private:
+            const u64* _words = nullptr;
+            usize _count = 0;
+            usize _word = 0;
+            u64 _bits = 0;
+
+            constexpr void _skip_empty()
+            {
+                while (_bits == 0 && ++_word < _count)
+                    _bits = _words[_word];
+            }
+
+        public:
+            constexpr ones_iterator() = default;
+
+            constexpr ones_iterator(const u64* words, usize count, usize word)
+                : _words{words}, _count{count}, _word{word}
+            {
+                if (_word < _count)
+                {
+                    _bits = _words[_word];
+                    _skip_empty();
+                }
+            }
+
+            constexpr usize operator*() const
+            {
+                return _word * 64 + static_cast<usize>(__builtin_ctzll(_bits));
+            }
+
+            constexpr ones_iterator& operator++()
+            {
+                _bits &= _bits - 1;
+                _skip_empty();
+                return *this;
+            }
+
+            constexpr ones_iterator operator++(i32)
+            {
+                ones_iterator _tmp = *this;
+                operator++();
+                return _tmp;
+            }
+
+            constexpr friend bool operator==(const ones_iterator& lhs, const ones_iterator& rhs)
+            {
+                return lhs._word == rhs._word && lhs._bits == rhs._bits;
+            }
+
+            constexpr friend bool operator!=(const ones_iterator& lhs, const ones_iterator& rhs)
+            {
+                return !(lhs == rhs);
+            }
+        };
+
+        struct ones_range
+        {
+            const u64* _words;
+            usize _count;
+
+            constexpr ones_iterator begin() const
+            {
+                return {_words, _count, 0};
+            }
+
+            constexpr ones_iterator end() const
+            {
+                return {_words, _count, _count};
+            }
+        };
+    } // namespace bitset_detail
+
+    /// Fixed size set of `N` bits packed into 64 bit words, the unused bits
+    /// of the last word are always zero so counts and compares need no mask
+    template <usize N>
+    class bitset
+    {
+    private:
+        static_assert(N > 0, "bitset needs at least one bit");
+
+        static constexpr usize _count = bitset_detail::words_for(N);
+        static constexpr u64 _tail = bitset_detail::tail_mask(N);
+        u64 _words[_count] = {};
+
+        constexpr void _trim()
+        {
+            _words[_count - 1] &= _tail;
+        }
+
+    public:
+        static constexpr usize npos = bitset_detail::npos;
+
+        constexpr bitset() = default;
+
+        /// The low bits of `value` become the first bits of the set
+        constexpr bitset(u64 value)
+        {
+            _words[0] = value;
+            _trim();
+        }
+
+        constexpr bool test(usize index) const
+        {
+            return (_words[index / 64] >> (index % 64)) & 1;
+        }
+
+        constexpr bool operator[](usize index) const
+        {
+            return test(index);
+        }
+
+        constexpr bool at(usize index) const
+        {
+            if (index >= N)
+                throw std::out_of_range("Accessed bit out of range");
+
+            return test(index);
+        }
+
+        constexpr bitset& set(usize index, bool value = true)
+        {
+            u64 _bit = u64{1} << (index % 64);
+            _words[index / 64] = value ? _words[index / 64] | _bit : _words[index / 64] & ~_bit;
+            return *this;
+        }
+
+        constexpr bitset& set()
+        {
+            for (usize _index = 0; _index < _count; _index++)
+                _words[_index] = ~u64{0};
+
+            _trim();
+            return *this;
+        }
+
+        constexpr bitset& reset(usize index)
+        {
+            return set(index, false);
+        }
+
+        constexpr bitset& reset()
+        {
+            for (usize _index = 0; _index < _count; _index++)
+                _words[_index] = 0;
+
+            return *this;
+        }
+
+        constexpr bitset& flip(usize index)
+        {
+            _words[index / 64] ^= u64{1} << (index % 64);
+            return *this;
+        }
+
+        constexpr bitset& flip()
+        {
+            for (usize _index = 0; _index < _count; _index++)
+                _words[_index] = ~_words[_index];
+
+            _trim();
+            return *this;
+        }
+
+        constexpr usize count() const
+        {
+            return static_cast<usize>(bitset_detail::count(_words, _count));
+        }
+
+        constexpr bool any() const
+        {
+            for (usize _index = 0; _index < _count; _index++)
+            {
+                if (_words[_index] != 0)
+                    return true;
+            }
+
+            return false;
+        }
+
+        constexpr bool none() const
+        {
+            return !any();
+        }
+
+        constexpr bool all() const
+        {
+            for (usize _index = 0; _index + 1 < _count; _index++)
+            {
+                if (_words[_index] != ~u64{0})
+                    return false;
+            }
+
+            return _words[_count - 1] == _tail;
+        }
+
+        static constexpr usize size()
+        {
+            return N;
+        }
+
+        /// First set bit, `npos` if there is none
+        constexpr usize find_first() const
+        {
+            return bitset_detail::find_from(_words, _count, 0);
+        }
+
+        /// First set bit after `index`, `npos` if there is none
+        constexpr usize find_next(usize index) const
+        {
+            return index + 1 >= N ? npos : bitset_detail::find_from(_words, _count, index + 1);
+        }
+
+        /// Range over the indices of the set bits
+        constexpr bitset_detail::ones_range ones() const
+        {
+            return {_words, _count};
+        }
+
+        constexpr const u64* words() const
+        {
+            return _words;
+        }
+
+        static constexpr usize word_count()
+        {
+            return _count;
+        }
+
+        constexpr bitset& operator&=(const bitset& rhs)
+        {
+            bitset_detail::apply<'&'>(_words, rhs._words, _count);
+            return *this;
+        }
+
+        constexpr bitset& operator|=(const bitset& rhs)
+        {
+            bitset_detail::apply<'|'>(_words, rhs._words, _count);
+            return *this;
+        }
+
+        constexpr bitset& operator^=(const bitset& rhs)
+        {
+            bitset_detail::apply<'^'>(_words, rhs._words, _count);
+            return *this;
+        }
+
+        /// Clears every bit that is set in `rhs`
+        constexpr bitset& and_not(const bitset& rhs)
+        {
+            bitset_detail::apply<'-'>(_words, rhs._words, _count);
+            return *this;
+        }
+
+        constexpr bitset& operator<<=(usize shift)
+        {
+            bitset_detail::shift_up(_words, _count, shift);
+            _trim();
+            return *this;
+        }
+
+        constexpr bitset& operator>>=(usize shift)
+        {
+            bitset_detail::shift_down(_words, _count, shift);
+            return *this;
+        }
+
+        constexpr bitset operator~() const
+        {
+            return bitset{*this}.flip();
+        }
+
+        constexpr bitset operator<<(usize shift) const
+        {
+            return bitset{*this} <<= shift;
+        }
+
+        constexpr bitset operator>>(usize shift) const
+        {
+            return bitset{*this} >>= shift;
+        }
+
+        constexpr friend bitset operator&(const bitset& lhs, const bitset& rhs)
+        {
+            return bitset{lhs} &= rhs;
+        }
+
+        constexpr friend bitset operator|(const bitset& lhs, const bitset& rhs)
+        {
+            return bitset{lhs} |= rhs;
+        }
+
+        constexpr friend bitset operator^(const bitset& lhs, const bitset& rhs)
+        {
+            return bitset{lhs} ^= rhs;
+        }
+
+        constexpr friend bool operator==(const bitset& lhs, const bitset& rhs)
+        {
+            for (usize _index = 0; _index < _count; _index++)
+            {
+                if (lhs._words[_index] != rhs._words[_index])
+                    return false;
+            }
+
+            return true;
+        }
+
+        constexpr friend bool operator!=(const bitset& lhs, const bitset& rhs)
+        {
+            return !(lhs == rhs);
+        }
+    };
+
+    /// Resizable bitset over cache line aligned words. The word loops of
+    /// `count` and the bulk operators go through `simd::dispatch`, so they
+    /// use popcnt and the widest registers the CPU has even when the build
+    /// targets a baseline x86-64. Bulk operators need equal sizes
+    class dynamic_bitset
+    {
+    private:
+        vector<u64, vector_detail::cache_line> _words;
+        usize _size = 0;
+
+        void _trim()
+        {
+            if (_words.size() != 0)
+                _words.back() &= bitset_detail::tail_mask(_size);
+        }
+
+        void _check_size(const dynamic_bitset& rhs) const
+        {
+            if (rhs._size != _size)
+                throw std::runtime_error("dynamic_bitset sizes don't match");
+        }
+
+        template <char Op>
+        dynamic_bitset& _apply(const dynamic_bitset& rhs)
+        {
+            _check_size(rhs);
+            bitset_detail::apply<Op>(_words.data(), rhs._words.cbegin(), _words.size());
+            return *this;
+        }
+
+    public:
+        static constexpr usize npos = bitset_detail::npos;
+
+        dynamic_bitset() = default;
+
+        explicit dynamic_bitset(usize size, bool value = false)
+        {
+            resize(size, value);
+        }
+
+        bool test(usize index) const
+        {
+            return (_words[index / 64] >> (index % 64)) & 1;
+        }
+
+        bool operator[](usize index) const
+        {
+            return test(index);
+        }
+
+        bool at(usize index) const
+        {
+            if (index >= _size)
+                throw std::out_of_range("Accessed bit out of range");
+
+            return test(index);
+        }
+
+        dynamic_bitset& set(usize index, bool value = true)
+        {
+            u64 _bit = u64{1} << (index % 64);
+            _words[index / 64] = value ? _words[index / 64] | _bit : _words[index / 64] & ~_bit;
+            return *this;
+        }
+
+        dynamic_bitset& set()
+        {
+            for (auto& _word : _words)
+                _word = ~u64{0};
+
+            _trim();
+            return *this;
+        }
+
+        dynamic_bitset& reset(usize index)
+        {
+            return set(index, false);
+        }
+
+        dynamic_bitset& reset()
+        {
+            for (auto& _word : _words)
+                _word = 0;
+
+            return *this;
+        }
+
+        dynamic_bitset& flip(usize index)
+        {
+            _words[index / 64] ^= u64{1} << (index % 64);
+            return *this;
+        }
+
+        dynamic_bitset& flip()
+        {
+            for (auto& _word : _words)
+                _word = ~_word;
+
+            _trim();
+            return *this;
+        }
+
+        /// New bits take `value`, existing ones are kept
+        void resize(usize size, bool value = false)
+        {
+            usize _old = _size;
+            _words.resize(bitset_detail::words_for(size));
+            _size = size;
+
+            if (value && size > _old)
+            {
+                if (_old % 64 != 0)
+                    _words[_old / 64] |= ~u64{0} << (_old % 64);
+
+                for (usize _index = bitset_detail::words_for(_old); _index < _words.size(); _index++)
+                    _words[_index] = ~u64{0};
+            }
+
+            _trim();
+        }
+
+        void push_back(bool value)
+        {
+            if (_size % 64 == 0)
+                _words.push_back(0);
+
+            _words.back() |= static_cast<u64>(value) << (_size % 64);
+            _size++;
+        }
+
+        void pop_back()
+        {
+            _size--;
+
+            if (_size % 64 == 0)
+                _words.pop_back();
+            else
+                _trim();
+        }
+
+        void reserve(usize bits)
+        {
+            _words.reserve(bitset_detail::words_for(bits));
+        }
+
+        void clear()
+        {
+            _words.clear();
+            _size = 0;
+        }
+
+        usize size() const
+        {
+            return _size;
+        }
+
+        bool empty() const
+        {
+            return _size == 0;
+        }
+
+        usize count() const
+        {
+            return static_cast<usize>(bitset_detail::count(_words.cbegin(), _words.size()));
+        }
+
+        /// `(*this & rhs).count()` in one pass and without a temporary
+        usize intersect_count(const dynamic_bitset& rhs) const
+        {
+            _check_size(rhs);
+            return static_cast<usize>(simd::dispatch<bitset_detail::intersect_count_kernel, u64>(
+                _words.cbegin(), rhs._words.cbegin(), _words.size()
+            ));
+        }
+
+        bool any() const
+        {
+            for (usize _index = 0; _index < _words.size(); _index++)
+            {
+                if (_words[_index] != 0)
+                    return true;
+            }
+
+            return false;
+        }
+
+        bool none() const
+        {
+            return !any();
+        }
+
+        bool all() const
+        {
+            return count() == _size;
+        }
+
+        /// First set bit, `npos` if there is none
+        usize find_first() const
+        {
+            return bitset_detail::find_from(_words.cbegin(), _words.size(), 0);
+        }
+
+        /// First set bit after `index`, `npos` if there is none
+        usize find_next(usize index) const
+        {
+            return index + 1 >= _size ? npos :
+                bitset_detail::find_from(_words.cbegin(), _words.size(), index + 1);
+        }
+
+        /// Range over the indices of the set bits
+        bitset_detail::ones_range ones() const
+        {
+            return {_words.cbegin(), _words.size()};
+        }
+
+        const u64* words() const
+        {
+            return _words.cbegin();
+        }
+
+        usize word_count() const
+        {
+            return _words.size();
+        }
+
+        dynamic_bitset& operator&=(const dynamic_bitset& rhs)
+        {
+            return _apply<'&'>(rhs);
+        }
+
+        dynamic_bitset& operator|=(const dynamic_bitset& rhs)
+        {
+            return _apply<'|'>(rhs);
+        }
+
+        dynamic_bitset& operator^=(const dynamic_bitset& rhs)
+        {
+            return _apply<'^'>(rhs);
+        }
+
+        /// Clears every bit that is set in `rhs`
+        dynamic_bitset& and_not(const dynamic_bitset& rhs)
+        {
+            return _apply<'-'>(rhs);
+        }
+
+        dynamic_bitset& operator<<=(usize shift)
+        {
+            bitset_detail::shift_up(_words.data(), _words.size(), shift);
+            _trim();
+            return *this;
+        }
+
+        dynamic_bitset& operator>>=(usize shift)
+        {
+            bitset_detail::shift_down(_words.data(), _words.size(), shift);
+            return *this;
+        }
+
+        dynamic_bitset operator~() const
+        {
+            return dynamic_bitset{*this}.flip();
+        }
+
+        friend dynamic_bitset operator&(const dynamic_bitset& lhs, const dynamic_bitset& rhs)
+        {
+            return dynamic_bitset{lhs} &= rhs;
+        }
+
+        friend dynamic_bitset operator|(const dynamic_bitset& lhs, const dynamic_bitset& rhs)
+        {
+            return dynamic_bitset{lhs} |= rhs;
+        }
+
+        friend dynamic_bitset operator^(const dynamic_bitset& lhs, const dynamic_bitset& rhs)
+        {
+            return dynamic_bitset{lhs} ^= rhs;
+        }
+
+        friend bool operator==(const dynamic_bitset& lhs, const dynamic_bitset& rhs)
+        {
+            if (lhs._size != rhs._size)
+                return false;
+
+            for (usize _index = 0; _index < lhs._words.size(); _index++)
+            {
+                if (lhs._words[_index] != rhs._words[_index])
+                    return false;
+            }
+
+            return true;
+        }
+
+        friend bool operator!=(const dynamic_bitset& lhs, const dynamic_bitset& rhs)
+        {
+            return !(lhs == rhs);
+        }
+    };
+
+    /// Constant time rank and near constant time select over the words of
+    /// a bitset, for about 25% extra space (rank9 layout). Each 512 bit
+    /// block stores the ones before it plus, packed in 9 bits each, the
+    /// ones before each of its words; select starts from a hint kept every
+    /// `hint_every` ones. The bitset is not copied, it must outlive this
+    /// and must not change, or the structure has to be rebuilt
+    class rank_select
+    {
+    private:
+        static constexpr usize _block_words = 8;
+        static constexpr u64 _field = 0x1ff;
+
+        const u64* _words = nullptr;
+        usize _size = 0;
+        usize _ones = 0;
+        // Two per block: ones before the block, then the packed counts
+        vector<u64> _counts;
+        // Block holding the one of rank `i * hint_every`
+        vector<usize> _hints;
+
+        u64 _in_block(usize block, usize word) const
+        {
+            return word == 0 ? 0 : (_counts[2 * block + 1] >> (9 * (word - 1))) & _field;
+        }
+
+        void _build()
+        {
+            usize _count = bitset_detail::words_for(_size);
+            // One extra block so rank(size()) never reads past the end
+            usize _blocks = _count / _block_words + 1;
+            u64 _total = 0;
+
+            _counts.resize(2 * _blocks);
+
+            for (usize _block = 0; _block < _blocks; _block++)
+            {
+                u64 _packed = 0;
+                u64 _in = 0;
+
+                for (usize _word = 0; _word < _block_words; _word++)
+                {
+                    if (_word != 0)
+                        _packed |= _in << (9 * (_word - 1));
+
+                    if (_block * _block_words + _word < _count)
+                        _in += bitset_detail::popcount(_words[_block * _block_words + _word]);
+                }
+
+                _counts[2 * _block] = _total;
+                _counts[2 * _block + 1] = _packed;
+
+                while (_hints.size() * hint_every < _total + _in)
+                    _hints.push_back(_block);
+
+                _total += _in;
+            }
+
+            _ones = static_cast<usize>(_total);
+        }
+
+    public:
+        static constexpr usize hint_every = 4096;
+
+        rank_select() = default;
+
+        /// `words` holds `size` bits, the bits past them must be zero
+        rank_select(const u64* words, usize size)
+            : _words{words}, _size{size}
+        {
+            _build();
+        }
+
+        template <usize N>
+        explicit rank_select(const bitset<N>& bits)
+            : rank_select(bits.words(), N)
+        {}
+
+        explicit rank_select(const dynamic_bitset& bits)
+            : rank_select(bits.words(), bits.size())
+        {}
+
+        /// Ones in [0, index), `index` may be `size()`
+        usize rank1(usize index) const
+        {
+            usize _word = index / 64;
+            usize _block = _word / _block_words;
+            u64 _rank = _counts[2 * _block] + _in_block(_block, _word % _block_words);
+
+            if (index % 64 != 0)
+                _rank += bitset_detail::popcount(_words[_word] & ((u64{1} << (index % 64)) - 1));
+
+            return static_cast<usize>(_rank);
+        }
+
+        /// Zeros in [0, index)
+        usize rank0(usize index) const
+        {
+            return index - rank1(index);
+        }
+
+        /// Position of the one of rank `rank` (counting from 0), which must
+        /// be less than `count()`
+        usize select1(usize rank) const
+        {
+            usize _hint = rank / hint_every;
+            usize _low = _hints[_hint];
+            usize _high = _hint + 1 < _hints.size() ? _hints[_hint + 1] + 1 : _counts.size() / 2;
+
+            // Last block with at most `rank` ones before it
+            while (_high - _low > 1)
+            {
+                usize _mid = (_low + _high) / 2;
+
+                if (_counts[2 * _mid] <= rank)
+                    _low = _mid;
+                else
+                    _high = _mid;
+            }
+
+            u64 _left = rank - _counts[2 * _low];
+            usize _word = 0;
+
+            while (_word + 1 < _block_words && _in_block(_low, _word + 1) <= _left)
+                _word++;
+
+            _left -= _in_block(_low, _word);
+            usize _index = _low * _block_words + _word;
+
+            return _index * 64 + bitset_detail::select_in_word(_words[_index], static_cast<u32>(_left));
+        }
+
+        /// Ones in the whole bitset
+        usize count() const
+        {
+            return _ones;
+        }
+
+        usize size() const
+        {
+            return _size;
+        }
+    };
+} // namespace hsd
+
+#pragma GCC diagnostic pop
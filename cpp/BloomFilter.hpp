@@ -0,0 +1,229 @@
+#pragma once
+
+#include <math.h>
+
+#include "Bitset.hpp"
+#include "_SketchDetail.hpp"
+
+namespace hsd
+{
+    namespace bloom_detail
+    {
+        static constexpr usize block_bits = 512;
+        static constexpr usize block_words = block_bits / 64;
+        static constexpr u32 max_hashes = 16;
+
+        /// False positive rate of a blocked filter: the keys a block gets are
+        /// Poisson distributed, and a crowded block answers yes more often
+        /// than the average fill suggests, so it needs more bits per key
+        /// than the classic formula gives
+        static inline f64 blocked_fpp(f64 bits_per_key, u32 hashes)
+        {
+            f64 _mean = static_cast<f64>(block_bits) / bits_per_key;
+            f64 _pmf = exp(-_mean);
+            f64 _fpp = 0;
+            usize _limit = static_cast<usize>(_mean + 12 * sqrt(_mean) + 12);
+
+            for (usize _keys = 0; _keys <= _limit; _keys++)
+            {
+                if (_keys != 0)
+                    _pmf *= _mean / static_cast<f64>(_keys);
+
+                f64 _fill = 1 - pow(1 - 1.0 / block_bits, static_cast<f64>(_keys * hashes));
+                _fpp += _pmf * pow(_fill, hashes);
+            }
+
+            return _fpp;
+        }
+    } // namespace bloom_detail
+
+    /// Blocked Bloom filter: a key's bits all fall in one 512 bit block,
+    /// a single cache line, so a lookup costs one cache miss however many
+    /// hashes it checks. The block comes from the high bits of the hash
+    /// and the bits inside it from a remix of the hash. Filters of the
+    /// same shape merge with a word-wise or
+    template <typename Key, typename Hasher = hash<Key>>
+    class bloom_filter
+    {
+    private:
+        static constexpr usize _block_words = bloom_detail::block_words;
+        static constexpr char _tag[5] = "HBLM";
+
+        vector<u64, vector_detail::cache_line> _words;
+        usize _blocks = 0;
+        u32 _hashes = 0;
+
+        bloom_filter() = default;
+
+        // Walks the key's bits in its block, 9 bits of a remixed hash per
+        // position and a fresh remix every 7 positions, so positions are
+        // independent and keys sharing a block don't share bit patterns
+        template <typename F>
+        void _for_bits(u64 hash, F&& func) const
+        {
+            u64 _seed = sketch_detail::remix(hash);
+            u64 _bits = _seed;
+
+            for (u32 _index = 0; _index < _hashes; _index++, _bits >>= 9)
+            {
+                if (_index % 7 == 0 && _index != 0)
+                    _bits = _seed = sketch_detail::remix(_seed);
+
+                if (!func(static_cast<u32>(_bits) & 511))
+                    return;
+            }
+        }
+
+        void _check_shape(const bloom_filter& other) const
+        {
+            if (other._blocks != _blocks || other._hashes != _hashes)
+                throw std::runtime_error("Bloom filters of different shapes can't be merged");
+        }
+
+    public:
+        /// Sized so that `expected` keys give at most `fpp` false positives
+        explicit bloom_filter(usize expected, f64 fpp = 0.01)
+        {
+            if (!(fpp > 0 && fpp < 1))
+                throw std::runtime_error("Bloom filter false positive rate must be in (0, 1)");
+
+            // Start from the classic size and grow until some hash count
+            // meets the target once the blocking is accounted for
+            f64 _bits = -log(fpp) / (M_LN2 * M_LN2);
+
+            while (_hashes == 0)
+            {
+                for (u32 _count = 1; _count <= bloom_detail::max_hashes; _count++)
+                {
+                    if (bloom_detail::blocked_fpp(_bits, _count) <= fpp)
+                    {
+                        _hashes = _count;
+                        break;
+                    }
+                }
+
+                _bits *= 1.02;
+            }
+
+            f64 _total = ceil(static_cast<f64>(expected ? expected : 1) * _bits / bloom_detail::block_bits);
+            _blocks = static_cast<usize>(_total);
+            _words.resize(_blocks * _block_words);
+        }
+
+        template <typename NewKey>
+        void insert(const NewKey& key)
+        {
+            insert_hashed(static_cast<u64>(Hasher::get_hash(key)));
+        }
+
+        /// `insert` with the hash of the key already known
+        void insert_hashed(u64 hash)
+        {
+            u64* _block = _words.data() + sketch_detail::reduce(hash, _blocks) * _block_words;
+
+            _for_bits(hash, [_block](u32 pos)
+            {
+                _block[pos / 64] |= u64{1} << (pos % 64);
+                return true;
+            });
+        }
+
+        /// False for keys never inserted, except at the false positive rate
+        template <typename NewKey>
+        bool contains(const NewKey& key) const
+        {
+            return contains_hashed(static_cast<u64>(Hasher::get_hash(key)));
+        }
+
+        bool contains_hashed(u64 hash) const
+        {
+            const u64* _block = _words.cbegin() + sketch_detail::reduce(hash, _blocks) * _block_words;
+            bool _found = true;
+
+            _for_bits(hash, [_block, &_found](u32 pos)
+            {
+                return _found = (_block[pos / 64] >> (pos % 64)) & 1;
+            });
+
+            return _found;
+        }
+
+        /// Adds every key of `other`, which must have the same shape
+        void merge(const bloom_filter& other)
+        {
+            _check_shape(other);
+            bitset_detail::apply<'|'>(_words.data(), other._words.cbegin(), _words.size());
+        }
+
+        /// False positive rate at the current fill, assuming evenly filled
+        /// blocks, so a little under the true rate
+        f64 false_positive_rate() const
+        {
+            f64 _fill = static_cast<f64>(bitset_detail::count(_words.cbegin(), _words.size())) /
+                static_cast<f64>(bit_count());
+
+            return pow(_fill, _hashes);
+        }
+
+        void clear()
+        {
+            for (auto& _word : _words)
+                _word = 0;
+        }
+
+        usize bit_count() const
+        {
+            return _blocks * bloom_detail::block_bits;
+        }
+
+        u32 hash_count() const
+        {
+            return _hashes;
+        }
+
+        /// Tag, version, shape and the raw bits, little endian
+        vector<u8> serialize() const
+        {
+            vector<u8> _bytes;
+            _bytes.reserve(17 + _words.size() * 8);
+            sketch_detail::byte_writer _writer{_bytes};
+
+            _writer.put_header(_tag);
+            _writer.put(_blocks, 8);
+            _writer.put(_hashes, 4);
+
+            for (usize _index = 0; _index < _words.size(); _index++)
+                _writer.put(_words[_index], 8);
+
+            return _bytes;
+        }
+
+        /// Throws `runtime_error` if the buffer isn't a serialized filter
+        static bloom_filter deserialize(const u8* data, usize size)
+        {
+            sketch_detail::byte_reader _reader{data, size};
+            bloom_filter _filter;
+
+            _reader.get_header(_tag);
+            _filter._blocks = static_cast<usize>(_reader.get(8));
+            _filter._hashes = static_cast<u32>(_reader.get(4));
+
+            if (_filter._blocks == 0 || _filter._hashes == 0 || _filter._hashes > bloom_detail::max_hashes ||
+                _reader.remaining() / (_block_words * 8) != _filter._blocks)
+                throw std::runtime_error("Bloom filter buffer has a bad shape");
+
+            _filter._words.resize(_filter._blocks * _block_words);
+
+            for (usize _index = 0; _index < _filter._words.size(); _index++)
+                _filter._words[_index] = _reader.get(8);
+
+            _reader.finish();
+            return _filter;
+        }
+
+        static bloom_filter deserialize(const vector<u8>& bytes)
+        {
+            return deserialize(bytes.cbegin(), bytes.size());
+        }
+    };
+} // namespace hsd
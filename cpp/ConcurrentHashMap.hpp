@@ -0,0 +1,282 @@
+#pragma once
+
+#include "UnorderedMap.hpp"
+#include "_SyncDetail.hpp"
+
+namespace hsd
+{
+    namespace concurrent_detail
+    {
+        /// Reader/writer spinlock in one word: the top bit marks a writer,
+        /// the next one a writer waiting for readers to drain and the rest
+        /// counts readers. New readers back off while a writer waits, so a
+        /// steady stream of them can't starve writers. Waiters yield after
+        /// a short spin so oversubscribed hosts still make progress
+        class shared_spinlock
+        {
+        private:
+            static constexpr u32 _writer = 1u << 31;
+            static constexpr u32 _pending = 1u << 30;
+            static constexpr u32 _spin_limit = 64;
+            u32 _state = 0;
+
+            static void _backoff(u32& spins)
+            {
+                if(++spins < _spin_limit)
+                {
+                    sync_detail::cpu_relax();
+                }
+                else
+                {
+                    spins = 0;
+                    sched_yield();
+                }
+            }
+
+        public:
+            void lock()
+            {
+                u32 _spins = 0;
+
+                while(true)
+                {
+                    u32 _current = __atomic_load_n(&_state, __ATOMIC_RELAXED);
+
+                    // Taking the lock clears the pending bit, other waiting
+                    // writers set it again on their next try
+                    if((_current & ~_pending) == 0)
+                    {
+                        if(__atomic_compare_exchange_n(&_state, &_current, _writer,
+                            true, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+                            return;
+                    }
+                    else if(!(_current & _pending))
+                    {
+                        __atomic_compare_exchange_n(&_state, &_current, _current | _pending,
+                            true, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+                    }
+
+                    _backoff(_spins);
+                }
+            }
+
+            void unlock()
+            {
+                // Keeps a pending bit set meanwhile, so the waiting writer
+                // goes before new readers
+                __atomic_fetch_and(&_state, ~_writer, __ATOMIC_RELEASE);
+            }
+
+            void lock_shared()
+            {
+                u32 _spins = 0;
+
+                while(true)
+                {
+                    u32 _current = __atomic_load_n(&_state, __ATOMIC_RELAXED);
+
+                    if(!(_current & (_writer | _pending)) && __atomic_compare_exchange_n(&_state,
+                        &_current, _current + 1, true, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+                        return;
+
+                    _backoff(_spins);
+                }
+            }
+
+            void unlock_shared()
+            {
+                __atomic_fetch_sub(&_state, 1u, __ATOMIC_RELEASE);
+            }
+        };
+
+        template <typename Lock>
+        class unique_guard
+        {
+        private:
+            Lock& _lock;
+
+        public:
+            explicit unique_guard(Lock& lock)
+                : _lock{lock}
+            {
+                _lock.lock();
+            }
+
+            ~unique_guard()
+            {
+                _lock.unlock();
+            }
+        };
+
+        template <typename Lock>
+        class shared_guard
+        {
+        private:
+            Lock& _lock;
+
+        public:
+            explicit shared_guard(Lock& lock)
+                : _lock{lock}
+            {
+                _lock.lock_shared();
+            }
+
+            ~shared_guard()
+            {
+                _lock.unlock_shared();
+            }
+        };
+    } // namespace concurrent_detail
+
+    /// Hash map split into `Shards` independent `unordered_map`s, each on
+    /// its own cache line with a reader/writer spinlock. Readers of a shard
+    /// run in parallel and writers only block the one shard they touch.
+    /// Lookups take the shard lock shared rather than reading optimistically
+    /// under a sequence counter: a writer growing, rehashing or clearing
+    /// the inner map frees its entry vector and index, and nothing here
+    /// delays that until readers are done, so an optimistic reader could
+    /// probe memory already returned to the allocator
+    template < typename Key, typename T, typename Hasher = hash<Key>, usize Shards = 64 >
+    class concurrent_hash_map
+    {
+    private:
+        static_assert(Shards > 0 && (Shards & (Shards - 1)) == 0, "Shards must be a power of two");
+
+        using lock_type = concurrent_detail::shared_spinlock;
+        using write_guard = concurrent_detail::unique_guard<lock_type>;
+        using read_guard = concurrent_detail::shared_guard<lock_type>;
+
+        struct alignas(sync_detail::cache_line) shard
+        {
+            mutable lock_type lock;
+            // Mutable so const readers can use `find`, they never modify it
+            mutable unordered_map<Key, T, Hasher> map;
+        };
+
+        shard _shards[Shards];
+
+        // The inner maps index with the low bits, shards use the top ones
+        static constexpr usize _shard_shift = sizeof(usize) * 8 - __builtin_ctzll(Shards);
+
+        static constexpr usize _shard_index(usize hash)
+        {
+            if constexpr(Shards == 1)
+                return 0;
+            else
+                return hash >> _shard_shift;
+        }
+
+        template < typename NewKey >
+        shard& _shard_for(const NewKey& key)
+        {
+            return _shards[_shard_index(static_cast<usize>(Hasher::get_hash(key)))];
+        }
+
+        template < typename NewKey >
+        const shard& _shard_for(const NewKey& key) const
+        {
+            return _shards[_shard_index(static_cast<usize>(Hasher::get_hash(key)))];
+        }
+
+    public:
+        concurrent_hash_map() = default;
+        concurrent_hash_map(const concurrent_hash_map&) = delete;
+        concurrent_hash_map& operator=(const concurrent_hash_map&) = delete;
+
+        /// Copies the value of `key` into `value`, returns false if absent
+        template < typename NewKey >
+        bool find(const NewKey& key, T& value) const
+        {
+            // Shards are picked by hash, so only hash keys `Key` holds exactly
+            if(!_detail::holds_exactly<Key>(key))
+                return false;
+
+            const shard& _shard = _shard_for(key);
+            read_guard _guard{_shard.lock};
+            auto _it = _shard.map.find(key);
+
+            if(_it == _shard.map.end())
+                return false;
+
+            value = _it->second;
+            return true;
+        }
+
+        template < typename NewKey >
+        bool contains(const NewKey& key) const
+        {
+            if(!_detail::holds_exactly<Key>(key))
+                return false;
+
+            const shard& _shard = _shard_for(key);
+            read_guard _guard{_shard.lock};
+            return _shard.map.contains(key);
+        }
+
+        /// Returns true if `key` was inserted, false if an existing value was replaced
+        template < typename NewKey, typename NewValue >
+        bool insert_or_assign(NewKey&& key, NewValue&& value)
+        {
+            shard& _shard = _shard_for(key);
+            write_guard _guard{_shard.lock};
+            auto [_it, _inserted] = _shard.map.emplace(forward<NewKey>(key));
+            _it->second = forward<NewValue>(value);
+            return _inserted;
+        }
+
+        template < typename NewKey >
+        bool erase(const NewKey& key)
+        {
+            if(!_detail::holds_exactly<Key>(key))
+                return false;
+
+            shard& _shard = _shard_for(key);
+            write_guard _guard{_shard.lock};
+            return _shard.map.erase(key);
+        }
+
+        /// Runs `func(value, inserted)` on the value of `key` while holding
+        /// the shard exclusively, a default constructed value is inserted
+        /// first if the key is missing. Returns whatever `func` returns
+        template < typename NewKey, typename Func >
+        decltype(auto) compute(NewKey&& key, Func&& func)
+        {
+            shard& _shard = _shard_for(key);
+            write_guard _guard{_shard.lock};
+            auto [_it, _inserted] = _shard.map.emplace(forward<NewKey>(key));
+            return forward<Func>(func)(_it->second, _inserted);
+        }
+
+        usize size() const
+        {
+            usize _size = 0;
+
+            for(auto& _shard : _shards)
+            {
+                read_guard _guard{_shard.lock};
+                _size += _shard.map.size();
+            }
+
+            return _size;
+        }
+
+        void clear()
+        {
+            for(auto& _shard : _shards)
+            {
+                write_guard _guard{_shard.lock};
+                _shard.map.clear();
+            }
+        }
+
+        /// Grows every shard so `count` evenly spread keys fit without rehashing
+        void reserve(usize count)
+        {
+            for(auto& _shard : _shards)
+            {
+                write_guard _guard{_shard.lock};
+                _shard.map.reserve(count / Shards + 1);
+            }
+        }
+    };
+} // namespace hsd
@@ -0,0 +1,424 @@
+#pragma once
+
+#include "Utility.hpp"
+#include "AlignedStorage.hpp"
+#include "_SyncDetail.hpp"
+
+namespace hsd
+{
+    /// Bounded single producer, single consumer ring of `N` (a power of
+    /// two) elements. Each side keeps a private copy of the other side's
+    /// index and only re-reads the shared one when the ring looks full or
+    /// empty, so in steady state the two threads don't share cache lines
+    template < typename T, usize N >
+    class spsc_queue
+    {
+    private:
+        static_assert(N >= 2 && (N & (N - 1)) == 0, "Capacity must be a power of two");
+
+        using storage_type = typename aligned_storage<sizeof(T), alignof(T)>::type;
+        static constexpr usize _mask = N - 1;
+
+        alignas(sync_detail::cache_line) usize _head = 0;
+        usize _cached_tail = 0;
+        alignas(sync_detail::cache_line) usize _tail = 0;
+        usize _cached_head = 0;
+        alignas(sync_detail::cache_line) storage_type _buffer[N];
+
+        T& _at(usize pos)
+        {
+            return *reinterpret_cast<T*>(&_buffer[pos & _mask]);
+        }
+
+        // Free slots seen by the producer, refreshes the cached head if short
+        usize _free(usize tail, usize wanted)
+        {
+            if(N - (tail - _cached_head) < wanted)
+                _cached_head = __atomic_load_n(&_head, __ATOMIC_ACQUIRE);
+
+            return N - (tail - _cached_head);
+        }
+
+        usize _ready(usize head, usize wanted)
+        {
+            if(_cached_tail - head < wanted)
+                _cached_tail = __atomic_load_n(&_tail, __ATOMIC_ACQUIRE);
+
+            return _cached_tail - head;
+        }
+
+    public:
+        spsc_queue() = default;
+        spsc_queue(const spsc_queue&) = delete;
+        spsc_queue& operator=(const spsc_queue&) = delete;
+
+        ~spsc_queue()
+        {
+            for(usize _pos = _head; _pos != _tail; _pos++)
+                _at(_pos).~T();
+        }
+
+        template < typename... Args >
+        bool try_emplace(Args&&... args)
+        {
+            usize _pos = __atomic_load_n(&_tail, __ATOMIC_RELAXED);
+
+            if(_free(_pos, 1) == 0)
+                return false;
+
+            new (&_at(_pos)) T(forward<Args>(args)...);
+            __atomic_store_n(&_tail, _pos + 1, __ATOMIC_RELEASE);
+            return true;
+        }
+
+        template < typename U >
+        bool try_push(U&& value)
+        {
+            return try_emplace(forward<U>(value));
+        }
+
+        bool try_pop(T& value)
+        {
+            usize _pos = __atomic_load_n(&_head, __ATOMIC_RELAXED);
+
+            if(_ready(_pos, 1) == 0)
+                return false;
+
+            value = move(_at(_pos));
+            _at(_pos).~T();
+            __atomic_store_n(&_head, _pos + 1, __ATOMIC_RELEASE);
+            return true;
+        }
+
+        /// Copies up to `count` items with a single publish, returns how many fit
+        usize try_push_n(const T* items, usize count)
+        {
+            usize _pos = __atomic_load_n(&_tail, __ATOMIC_RELAXED);
+            usize _count = min(count, _free(_pos, count));
+
+            for(usize _index = 0; _index < _count; _index++)
+                new (&_at(_pos + _index)) T(items[_index]);
+
+            __atomic_store_n(&_tail, _pos + _count, __ATOMIC_RELEASE);
+            return _count;
+        }
+
+        /// Moves up to `count` items into `out` with a single release
+        usize try_pop_n(T* out, usize count)
+        {
+            usize _pos = __atomic_load_n(&_head, __ATOMIC_RELAXED);
+            usize _count = min(count, _ready(_pos, count));
+
+            for(usize _index = 0; _index < _count; _index++)
+            {
+                out[_index] = move(_at(_pos + _index));
+                _at(_pos + _index).~T();
+            }
+
+            __atomic_store_n(&_head, _pos + _count, __ATOMIC_RELEASE);
+            return _count;
+        }
+
+        usize size() const
+        {
+            return __atomic_load_n(&_tail, __ATOMIC_ACQUIRE) - __atomic_load_n(&_head, __ATOMIC_ACQUIRE);
+        }
+
+        bool empty() const
+        {
+            return size() == 0;
+        }
+
+        static constexpr usize capacity()
+        {
+            return N;
+        }
+    };
+
+    /// Bounded multi producer, multi consumer queue (Dmitry Vyukov's
+    /// design): every cell carries a sequence number telling producers and
+    /// consumers whose turn it is, so a slot is claimed with one CAS on the
+    /// shared position and no thread ever waits on another mid-operation
+    template < typename T >
+    class mpmc_queue
+    {
+    private:
+        using storage_type = typename aligned_storage<sizeof(T), alignof(T)>::type;
+
+        struct cell
+        {
+            usize sequence;
+            storage_type storage;
+
+            T& value()
+            {
+                return *reinterpret_cast<T*>(&storage);
+            }
+        };
+
+        alignas(sync_detail::cache_line) cell* _cells = nullptr;
+        usize _mask = 0;
+        alignas(sync_detail::cache_line) usize _enqueue_pos = 0;
+        alignas(sync_detail::cache_line) usize _dequeue_pos = 0;
+
+        static usize _round_capacity(usize capacity)
+        {
+            usize _capacity = 2;
+
+            while(_capacity < capacity)
+                _capacity <<= 1;
+
+            return _capacity;
+        }
+
+        // Claims up to `count` consecutive cells whose sequence equals
+        // their position plus `offset`, returns the first position
+        usize _claim(usize& position, usize offset, usize count, usize& claimed)
+        {
+            usize _pos = __atomic_load_n(&position, __ATOMIC_RELAXED);
+
+            while(true)
+            {
+                usize _count = 0;
+
+                while(_count < count && __atomic_load_n(
+                    &_cells[(_pos + _count) & _mask].sequence, __ATOMIC_ACQUIRE) == _pos + _count + offset)
+                {
+                    _count++;
+                }
+
+                if(_count == 0)
+                {
+                    usize _seq = __atomic_load_n(&_cells[_pos & _mask].sequence, __ATOMIC_ACQUIRE);
+
+                    // Behind our position means the cell wasn't released yet: full or empty
+                    if(static_cast<isize>(_seq - (_pos + offset)) < 0)
+                    {
+                        claimed = 0;
+                        return _pos;
+                    }
+
+                    _pos = __atomic_load_n(&position, __ATOMIC_RELAXED);
+                    continue;
+                }
+
+                if(__atomic_compare_exchange_n(&position, &_pos, _pos + _count,
+                    true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+                {
+                    claimed = _count;
+                    return _pos;
+                }
+            }
+        }
+
+    public:
+        explicit mpmc_queue(usize capacity)
+            : _mask{_round_capacity(capacity) - 1}
+        {
+            _cells = new cell[_mask + 1];
+
+            for(usize _index = 0; _index <= _mask; _index++)
+                _cells[_index].sequence = _index;
+        }
+
+        mpmc_queue(const mpmc_queue&) = delete;
+        mpmc_queue& operator=(const mpmc_queue&) = delete;
+
+        ~mpmc_queue()
+        {
+            for(usize _pos = _dequeue_pos; _pos != _enqueue_pos; _pos++)
+                _cells[_pos & _mask].value().~T();
+
+            delete[] _cells;
+        }
+
+        template < typename... Args >
+        bool try_emplace(Args&&... args)
+        {
+            usize _claimed = 0;
+            usize _pos = _claim(_enqueue_pos, 0, 1, _claimed);
+
+            if(_claimed == 0)
+                return false;
+
+            cell& _cell = _cells[_pos & _mask];
+            new (&_cell.value()) T(forward<Args>(args)...);
+            __atomic_store_n(&_cell.sequence, _pos + 1, __ATOMIC_RELEASE);
+            return true;
+        }
+
+        template < typename U >
+        bool try_push(U&& value)
+        {
+            return try_emplace(forward<U>(value));
+        }
+
+        bool try_pop(T& value)
+        {
+            return try_pop_n(&value, 1) == 1;
+        }
+
+        /// Claims a run of free cells with one CAS and copies `items` into
+        /// them, returns how many were pushed
+        usize try_push_n(const T* items, usize count)
+        {
+            usize _claimed = 0;
+            usize _pos = _claim(_enqueue_pos, 0, count, _claimed);
+
+            for(usize _index = 0; _index < _claimed; _index++)
+            {
+                cell& _cell = _cells[(_pos + _index) & _mask];
+                new (&_cell.value()) T(items[_index]);
+                __atomic_store_n(&_cell.sequence, _pos + _index + 1, __ATOMIC_RELEASE);
+            }
+
+            return _claimed;
+        }
+
+        usize try_pop_n(T* out, usize count)
+        {
+            usize _claimed = 0;
+            usize _pos = _claim(_dequeue_pos, 1, count, _claimed);
+
+            for(usize _index = 0; _index < _claimed; _index++)
+            {
+                cell& _cell = _cells[(_pos + _index) & _mask];
+                out[_index] = move(_cell.value());
+                _cell.value().~T();
+                __atomic_store_n(&_cell.sequence, _pos + _index + _mask + 1, __ATOMIC_RELEASE);
+            }
+
+            return _claimed;
+        }
+
+        /// Approximate while other threads are active
+        usize size() const
+        {
+            usize _tail = __atomic_load_n(&_enqueue_pos, __ATOMIC_ACQUIRE);
+            usize _head = __atomic_load_n(&_dequeue_pos, __ATOMIC_ACQUIRE);
+            return _tail > _head ? _tail - _head : 0;
+        }
+
+        bool empty() const
+        {
+            return size() == 0;
+        }
+
+        usize capacity() const
+        {
+            return _mask + 1;
+        }
+    };
+
+    /// Adds blocking `push`/`pop` to `spsc_queue` or `mpmc_queue`: callers
+    /// spin briefly, then sleep on a futex until the other side signals.
+    /// Signals are skipped when nobody sleeps, so the fast path stays a
+    /// fence and a load on top of the wrapped queue
+    template < typename Queue >
+    class blocking_queue
+    {
+    private:
+        static constexpr usize _spin_limit = 128;
+
+        Queue _queue;
+        alignas(sync_detail::cache_line) sync_detail::event_count _not_empty;
+        alignas(sync_detail::cache_line) sync_detail::event_count _not_full;
+
+        template < typename Func >
+        static void _until(sync_detail::event_count& event, Func&& attempt)
+        {
+            for(usize _spin = 0; _spin < _spin_limit; _spin++)
+            {
+                if(attempt())
+                    return;
+
+                sync_detail::cpu_relax();
+            }
+            while(true)
+            {
+                u32 _key = event.prepare_wait();
+
+                if(attempt())
+                {
+                    event.cancel_wait();
+                    return;
+                }
+
+                event.wait(_key);
+            }
+        }
+
+    public:
+        template < typename... Args >
+        explicit blocking_queue(Args&&... args)
+            : _queue(forward<Args>(args)...)
+        {}
+
+        template < typename U >
+        void push(U&& value)
+        {
+            // A failed attempt doesn't construct anything, so `value` is intact
+            _until(_not_full, [&] { return _queue.try_push(forward<U>(value)); });
+            _not_empty.notify_one();
+        }
+
+        template < typename U >
+        bool try_push(U&& value)
+        {
+            if(!_queue.try_push(forward<U>(value)))
+                return false;
+
+            _not_empty.notify_one();
+            return true;
+        }
+
+        void pop(auto& value)
+        {
+            _until(_not_empty, [&] { return _queue.try_pop(value); });
+            _not_full.notify_one();
+        }
+
+        bool try_pop(auto& value)
+        {
+            if(!_queue.try_pop(value))
+                return false;
+
+            _not_full.notify_one();
+            return true;
+        }
+
+        /// Pushes all `count` items, blocking while the queue is full
+        template < typename T >
+        void push_n(const T* items, usize count)
+        {
+            while(count != 0)
+            {
+                usize _pushed = 0;
+                _until(_not_full, [&] { return (_pushed = _queue.try_push_n(items, count)) != 0; });
+                _not_empty.notify_all();
+                items += _pushed;
+                count -= _pushed;
+            }
+        }
+
+        /// Waits for at least one item, then takes up to `count`
+        template < typename T >
+        usize pop_n(T* out, usize count)
+        {
+            usize _popped = 0;
+            _until(_not_empty, [&] { return (_popped = _queue.try_pop_n(out, count)) != 0; });
+            _not_full.notify_all();
+            return _popped;
+        }
+
+        Queue& get()
+        {
+            return _queue;
+        }
+
+        usize size() const
+        {
+            return _queue.size();
+        }
+    };
+} // namespace hsd
@@ -0,0 +1,386 @@
+#pragma once
+
+#include "Utility.hpp"
+
+#include <new>
+#include <coroutine>
+#include <exception>
+
+namespace hsd
+{
+    class event_loop;
+
+    namespace coroutine_detail
+    {
+        /// Per-thread free lists of coroutine frames in 64 byte size
+        /// classes, a finished task hands its frame to the next one started
+        /// on the same thread instead of going back to malloc
+        class frame_pool
+        {
+        private:
+            static constexpr usize _granularity = 64;
+            static constexpr usize _classes = 32;
+
+            struct node
+            {
+                node* next;
+            };
+
+            node* _free[_classes]{};
+
+        public:
+            frame_pool() = default;
+            frame_pool(const frame_pool&) = delete;
+            frame_pool& operator=(const frame_pool&) = delete;
+
+            ~frame_pool()
+            {
+                for(auto* _head : _free)
+                {
+                    while(_head != nullptr)
+                        ::operator delete(hsd::exchange(_head, _head->next));
+                }
+            }
+
+            static frame_pool& local()
+            {
+                static thread_local frame_pool _pool;
+                return _pool;
+            }
+
+            void* allocate(usize size)
+            {
+                usize _class = (size + _granularity - 1) / _granularity;
+
+                if(_class > _classes)
+                    return ::operator new(size);
+
+                if(node* _node = _free[_class - 1]; _node != nullptr)
+                {
+                    _free[_class - 1] = _node->next;
+                    return _node;
+                }
+
+                return ::operator new(_class * _granularity);
+            }
+
+            void deallocate(void* ptr, usize size)
+            {
+                usize _class = (size + _granularity - 1) / _granularity;
+
+                if(_class > _classes)
+                {
+                    ::operator delete(ptr);
+                    return;
+                }
+
+                _free[_class - 1] = new (ptr) node{_free[_class - 1]};
+            }
+        };
+
+        struct pooled_promise
+        {
+            static void* operator new(usize size)
+            {
+                return frame_pool::local().allocate(size);
+            }
+
+            static void operator delete(void* ptr, usize size)
+            {
+                frame_pool::local().deallocate(ptr, size);
+            }
+        };
+
+        template < typename T >
+        class task_result
+        {
+        private:
+            alignas(T) unsigned char _storage[sizeof(T)];
+            bool _has_value = false;
+
+        public:
+            ~task_result()
+            {
+                if(_has_value)
+                    reinterpret_cast<T*>(_storage)->~T();
+            }
+
+            template < typename U >
+            void return_value(U&& value)
+            {
+                new (_storage) T(hsd::forward<U>(value));
+                _has_value = true;
+            }
+
+            T take()
+            {
+                return hsd::move(*reinterpret_cast<T*>(_storage));
+            }
+        };
+
+        template <>
+        class task_result<void>
+        {
+        public:
+            void return_void() {}
+            void take() {}
+        };
+    } // namespace coroutine_detail
+
+    /// Lazily started coroutine producing a `T`. Awaiting it starts it and
+    /// resumes the awaiter through symmetric transfer when it finishes, so
+    /// in optimized builds (where the transfer is a tail call) long chains
+    /// of tasks don't grow the stack
+    template < typename T = void >
+    class task
+    {
+    public:
+        struct promise_type
+            : coroutine_detail::pooled_promise, coroutine_detail::task_result<T>
+        {
+            std::coroutine_handle<> continuation = nullptr;
+            std::exception_ptr exception = nullptr;
+            usize* live_counter = nullptr;
+
+            task get_return_object()
+            {
+                return task{std::coroutine_handle<promise_type>::from_promise(*this)};
+            }
+
+            std::suspend_always initial_suspend() noexcept
+            {
+                return {};
+            }
+
+            struct final_awaiter
+            {
+                bool await_ready() noexcept
+                {
+                    return false;
+                }
+
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) noexcept
+                {
+                    promise_type& _promise = handle.promise();
+
+                    if(_promise.continuation)
+                        return _promise.continuation;
+
+                    // Detached: nobody will read the result, clean up here
+                    if(_promise.live_counter != nullptr)
+                    {
+                        if(_promise.exception)
+                            std::terminate();
+
+                        --*_promise.live_counter;
+                        handle.destroy();
+                    }
+
+                    return std::noop_coroutine();
+                }
+
+                void await_resume() noexcept {}
+            };
+
+            final_awaiter final_suspend() noexcept
+            {
+                return {};
+            }
+
+            void unhandled_exception()
+            {
+                exception = std::current_exception();
+            }
+        };
+
+    private:
+        friend class event_loop;
+        std::coroutine_handle<promise_type> _handle = nullptr;
+
+        explicit task(std::coroutine_handle<promise_type> handle)
+            : _handle{handle}
+        {}
+
+        // Hands the frame over to its own final_suspend, returns the handle to start it
+        std::coroutine_handle<> _detach(usize& live_counter)
+        {
+            _handle.promise().live_counter = &live_counter;
+            return hsd::exchange(_handle, nullptr);
+        }
+
+    public:
+        task() = default;
+        task(const task&) = delete;
+        task& operator=(const task&) = delete;
+
+        task(task&& other)
+            : _handle{hsd::exchange(other._handle, nullptr)}
+        {}
+
+        task& operator=(task&& other)
+        {
+            if(_handle)
+                _handle.destroy();
+
+            _handle = hsd::exchange(other._handle, nullptr);
+            return *this;
+        }
+
+        ~task()
+        {
+            if(_handle)
+                _handle.destroy();
+        }
+
+        bool done() const
+        {
+            return !_handle || _handle.done();
+        }
+
+        auto operator co_await() &&
+        {
+            struct awaiter
+            {
+                std::coroutine_handle<promise_type> handle;
+
+                bool await_ready()
+                {
+                    return !handle || handle.done();
+                }
+
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting)
+                {
+                    handle.promise().continuation = awaiting;
+                    return handle;
+                }
+
+                T await_resume()
+                {
+                    if(handle.promise().exception)
+                        std::rethrow_exception(handle.promise().exception);
+
+                    return handle.promise().take();
+                }
+            };
+
+            return awaiter{_handle};
+        }
+    };
+
+    /// Synchronous pull-style sequence, values are produced on demand
+    /// while iterating and referenced in place rather than copied
+    template < typename T >
+    class generator
+    {
+    public:
+        struct promise_type : coroutine_detail::pooled_promise
+        {
+            const T* value = nullptr;
+            std::exception_ptr exception = nullptr;
+
+            generator get_return_object()
+            {
+                return generator{std::coroutine_handle<promise_type>::from_promise(*this)};
+            }
+
+            std::suspend_always initial_suspend() noexcept
+            {
+                return {};
+            }
+
+            std::suspend_always final_suspend() noexcept
+            {
+                return {};
+            }
+
+            // The yielded object lives until the coroutine is resumed
+            std::suspend_always yield_value(const T& yielded) noexcept
+            {
+                value = &yielded;
+                return {};
+            }
+
+            void return_void() {}
+
+            void unhandled_exception()
+            {
+                exception = std::current_exception();
+            }
+        };
+
+        struct sentinel {};
+
+        class iterator
+        {
+        private:
+            std::coroutine_handle<promise_type> _handle;
+
+        public:
+            explicit iterator(std::coroutine_handle<promise_type> handle)
+                : _handle{handle}
+            {}
+
+            iterator& operator++()
+            {
+                _handle.resume();
+
+                if(_handle.promise().exception)
+                    std::rethrow_exception(_handle.promise().exception);
+
+                return *this;
+            }
+
+            const T& operator*() const
+            {
+                return *_handle.promise().value;
+            }
+
+            const T* operator->() const
+            {
+                return _handle.promise().value;
+            }
+
+            friend bool operator==(const iterator& lhs, sentinel)
+            {
+                return lhs._handle.done();
+            }
+
+            friend bool operator!=(const iterator& lhs, sentinel)
+            {
+                return !lhs._handle.done();
+            }
+        };
+
+    private:
+        std::coroutine_handle<promise_type> _handle = nullptr;
+
+        explicit generator(std::coroutine_handle<promise_type> handle)
+            : _handle{handle}
+        {}
+
+    public:
+        generator(const generator&) = delete;
+        generator& operator=(const generator&) = delete;
+
+        generator(generator&& other)
+            : _handle{hsd::exchange(other._handle, nullptr)}
+        {}
+
+        ~generator()
+        {
+            if(_handle)
+                _handle.destroy();
+        }
+
+        iterator begin()
+        {
+            iterator _it{_handle};
+            return ++_it;
+        }
+
+        sentinel end()
+        {
+            return {};
+        }
+    };
+} // namespace hsd
@@ -0,0 +1,188 @@
+#pragma once
+
+#include <math.h>
+
+#include "Limits.hpp"
+#include "_SketchDetail.hpp"
+
+namespace hsd
+{
+    /// Frequency estimates in fixed space: every key adds to one counter
+    /// per row and reads back the least of them, so estimates never fall
+    /// short and overshoot by at most `epsilon` times the total count with
+    /// probability `1 - delta`. Sketches of the same shape merge by adding
+    /// counters
+    template <typename Key, typename Hasher = hash<Key>>
+    class count_min_sketch
+    {
+    private:
+        static constexpr u32 _max = limits<u32>::max;
+        static constexpr u32 _max_depth = 64;
+        static constexpr char _tag[5] = "HCMS";
+
+        // Row after row, `_width` counters each
+        vector<u32> _counters;
+        usize _width = 0;
+        u32 _depth = 0;
+        u64 _total = 0;
+
+        count_min_sketch() = default;
+
+        // Every row gets its own hash of the key, so two keys that share a
+        // column in one row are no more likely to share one in the next
+        usize _column(u64 hash, u32 row) const
+        {
+            return row * _width + static_cast<usize>(sketch_detail::reduce(wyhash::combine(hash, row), _width));
+        }
+
+        // Counters stick at the maximum instead of wrapping to small counts
+        static u32 _saturating_add(u32 lhs, u32 rhs)
+        {
+            u32 _sum = lhs + rhs;
+            return _sum < lhs ? _max : _sum;
+        }
+
+    public:
+        explicit count_min_sketch(f64 epsilon, f64 delta = 0.01)
+        {
+            if (!(epsilon > 0 && epsilon < 1 && delta > 0 && delta < 1))
+                throw std::runtime_error("Count-min sketch bounds must be in (0, 1)");
+
+            _width = static_cast<usize>(ceil(M_E / epsilon));
+            _depth = static_cast<u32>(ceil(log(1 / delta)));
+            _depth = _depth < _max_depth ? _depth : _max_depth;
+            _counters.resize(_width * _depth);
+        }
+
+        template <typename NewKey>
+        void add(const NewKey& key, u32 count = 1)
+        {
+            add_hashed(static_cast<u64>(Hasher::get_hash(key)), count);
+        }
+
+        /// `add` with the hash of the key already known
+        void add_hashed(u64 hash, u32 count = 1)
+        {
+            for (u32 _row = 0; _row < _depth; _row++)
+            {
+                u32& _counter = _counters[_column(hash, _row)];
+                _counter = _saturating_add(_counter, count);
+            }
+
+            _total += count;
+        }
+
+        /// At least the key's count, at most `epsilon * total()` above it
+        /// with probability `1 - delta`
+        template <typename NewKey>
+        u32 estimate(const NewKey& key) const
+        {
+            return estimate_hashed(static_cast<u64>(Hasher::get_hash(key)));
+        }
+
+        u32 estimate_hashed(u64 hash) const
+        {
+            u32 _least = _max;
+
+            for (u32 _row = 0; _row < _depth; _row++)
+            {
+                u32 _counter = _counters[_column(hash, _row)];
+                _least = _counter < _least ? _counter : _least;
+            }
+
+            return _least;
+        }
+
+        /// Adds the counts of `other`, which must have the same shape
+        void merge(const count_min_sketch& other)
+        {
+            if (other._width != _width || other._depth != _depth)
+                throw std::runtime_error("Count-min sketches of different shapes can't be merged");
+
+            for (usize _index = 0; _index < _counters.size(); _index++)
+                _counters[_index] = _saturating_add(_counters[_index], other._counters[_index]);
+
+            _total += other._total;
+        }
+
+        void clear()
+        {
+            for (auto& _counter : _counters)
+                _counter = 0;
+
+            _total = 0;
+        }
+
+        /// Sum of every count added
+        u64 total() const
+        {
+            return _total;
+        }
+
+        usize width() const
+        {
+            return _width;
+        }
+
+        u32 depth() const
+        {
+            return _depth;
+        }
+
+        /// Tag, version, shape, then the counters as varints, which takes
+        /// a byte for most counters of a sparse sketch
+        vector<u8> serialize() const
+        {
+            vector<u8> _bytes;
+            _bytes.reserve(26 + _counters.size());
+            sketch_detail::byte_writer _writer{_bytes};
+
+            _writer.put_header(_tag);
+            _writer.put(_width, 8);
+            _writer.put(_depth, 4);
+            _writer.put_varint(_total);
+
+            for (usize _index = 0; _index < _counters.size(); _index++)
+                _writer.put_varint(_counters[_index]);
+
+            return _bytes;
+        }
+
+        /// Throws `runtime_error` if the buffer isn't a serialized sketch
+        static count_min_sketch deserialize(const u8* data, usize size)
+        {
+            sketch_detail::byte_reader _reader{data, size};
+            count_min_sketch _sketch;
+
+            _reader.get_header(_tag);
+            _sketch._width = static_cast<usize>(_reader.get(8));
+            _sketch._depth = static_cast<u32>(_reader.get(4));
+            _sketch._total = _reader.get_varint();
+
+            // Every counter takes at least a byte
+            if (_sketch._width == 0 || _sketch._depth == 0 || _sketch._depth > _max_depth ||
+                _reader.remaining() / _sketch._depth < _sketch._width)
+                throw std::runtime_error("Count-min sketch buffer has a bad shape");
+
+            _sketch._counters.resize(_sketch._width * _sketch._depth);
+
+            for (usize _index = 0; _index < _sketch._counters.size(); _index++)
+            {
+                u64 _counter = _reader.get_varint();
+
+                if (_counter > _max)
+                    throw std::runtime_error("Count-min sketch buffer has a counter out of range");
+
+                _sketch._counters[_index] = static_cast<u32>(_counter);
+            }
+
+            _reader.finish();
+            return _sketch;
+        }
+
+        static count_min_sketch deserialize(const vector<u8>& bytes)
+        {
+            return deserialize(bytes.cbegin(), bytes.size());
+        }
+    };
+} // namespace hsd
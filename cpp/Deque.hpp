@@ -0,0 +1,559 @@
+#pragma once
+
+#include <stdexcept>
+#include <type_traits>
+#include <initializer_list>
+
+#include "Utility.hpp"
+#include "AlignedStorage.hpp"
+
+namespace hsd
+{
+    template <typename T> class deque;
+
+    namespace deque_detail
+    {
+        // About a page per chunk, rounded down to a power of two elements
+        static constexpr usize chunk_size(usize bytes)
+        {
+            usize _count = 16;
+
+            while (_count * 2 * bytes <= 4096)
+                _count *= 2;
+
+            return _count;
+        }
+
+        /// Random access iterator over the chunks. Stepping only touches the
+        /// chunk map at chunk ends. An end that falls on a chunk boundary
+        /// sits one past the last chunk instead of at the start of a missing
+        /// one, so equality checks the chunk index too since that address
+        /// may belong to another chunk
+        template <typename T, bool Const>
+        class iterator
+        {
+        private:
+            using owner_type = typename conditional<Const, const deque<T>, deque<T>>::type;
+            using value_type = typename conditional<Const, const T, T>::type;
+            static constexpr usize _chunk = chunk_size(sizeof(T));
+
+            template <typename, bool>
+            friend class iterator;
+            friend class deque<T>;
+
+            owner_type* _owner = nullptr;
+            usize _index = 0;
+            value_type* _cur = nullptr;
+            value_type* _chunk_begin = nullptr;
+
+            iterator(owner_type* owner, usize index, value_type* cur, value_type* chunk_begin)
+                : _owner{owner}, _index{index}, _cur{cur}, _chunk_begin{chunk_begin}
+            {}
+
+            usize _position() const
+            {
+                return _index * _chunk + static_cast<usize>(_cur - _chunk_begin) - _owner->_start();
+            }
+
+            void _seek(usize pos)
+            {
+                usize _abs = _owner->_start() + pos;
+                _index = _abs / _chunk;
+
+                if (_index < _owner->_chunks)
+                {
+                    _chunk_begin = _owner->_chunk_at(_index);
+                    _cur = _chunk_begin + _abs % _chunk;
+                }
+                else if (_index != 0)
+                {
+                    _index--;
+                    _chunk_begin = _owner->_chunk_at(_index);
+                    _cur = _chunk_begin + _chunk;
+                }
+                else
+                {
+                    _cur = _chunk_begin = nullptr;
+                }
+            }
+
+        public:
+            iterator() = default;
+
+            operator iterator<T, true>() const
+            {
+                return {_owner, _index, _cur, _chunk_begin};
+            }
+
+            value_type& operator*() const
+            {
+                return *_cur;
+            }
+
+            value_type* operator->() const
+            {
+                return _cur;
+            }
+
+            value_type& operator[](isize offset) const
+            {
+                return *(*this + offset);
+            }
+
+            iterator& operator++()
+            {
+                if (++_cur == _chunk_begin + _chunk && _index + 1 < _owner->_chunks)
+                {
+                    _chunk_begin = _owner->_chunk_at(++_index);
+                    _cur = _chunk_begin;
+                }
+
+                return *this;
+            }
+
+            iterator& operator--()
+            {
+                if (_cur == _chunk_begin)
+                {
+                    _chunk_begin = _owner->_chunk_at(--_index);
+                    _cur = _chunk_begin + _chunk;
+                }
+
+                --_cur;
+                return *this;
+            }
+
+            iterator operator++(i32)
+            {
+                iterator _tmp = *this;
+                operator++();
+                return _tmp;
+            }
+
+            iterator operator--(i32)
+            {
+                iterator _tmp = *this;
+                operator--();
+                return _tmp;
+            }
+
+            iterator& operator+=(isize offset)
+            {
+                _seek(_position() + offset);
+                return *this;
+            }
+
+            iterator& operator-=(isize offset)
+            {
+                return *this += -offset;
+            }
+
+            iterator operator+(isize offset) const
+            {
+                iterator _tmp = *this;
+                return _tmp += offset;
+            }
+
+            iterator operator-(isize offset) const
+            {
+                iterator _tmp = *this;
+                return _tmp += -offset;
+            }
+
+            isize operator-(const iterator& rhs) const
+            {
+                return static_cast<isize>(_position() - rhs._position());
+            }
+
+            friend bool operator==(const iterator& lhs, const iterator& rhs)
+            {
+                return lhs._cur == rhs._cur && lhs._index == rhs._index;
+            }
+
+            friend bool operator!=(const iterator& lhs, const iterator& rhs)
+            {
+                return !(lhs == rhs);
+            }
+
+            friend bool operator<(const iterator& lhs, const iterator& rhs)
+            {
+                return lhs._position() < rhs._position();
+            }
+        };
+    } // namespace deque_detail
+
+    /// Double ended queue over fixed size chunks. The chunks are listed in
+    /// a circular map, so growing at either end never moves elements and
+    /// only reallocates the map once it's full. Both ends keep a cursor
+    /// into their chunk, so pushes and pops skip the map until a chunk
+    /// fills or empties. Emptied chunks are kept for reuse (up to
+    /// `_max_spares`) rather than freed right away
+    template <typename T>
+    class deque
+    {
+    private:
+        using storage_type = typename aligned_storage<sizeof(T), alignof(T)>::type;
+        static constexpr usize _chunk = deque_detail::chunk_size(sizeof(T));
+        static constexpr usize _min_map = 8;
+        static constexpr usize _max_spares = 4;
+
+        template <typename, bool>
+        friend class deque_detail::iterator;
+
+        storage_type** _map = nullptr;
+        usize _map_cap = 0;
+        usize _head = 0;
+        usize _chunks = 0;
+        // First element and the start of its chunk
+        T* _first = nullptr;
+        T* _first_chunk = nullptr;
+        // One past the last element and the end of its chunk
+        T* _last = nullptr;
+        T* _last_end = nullptr;
+        storage_type* _spares[_max_spares]{};
+        usize _spare_count = 0;
+
+        storage_type*& _slot(usize chunk) const
+        {
+            return _map[(_head + chunk) & (_map_cap - 1)];
+        }
+
+        T* _chunk_at(usize chunk) const
+        {
+            return reinterpret_cast<T*>(_slot(chunk));
+        }
+
+        // Offset of the first element in the first chunk
+        usize _start() const
+        {
+            return static_cast<usize>(_first - _first_chunk);
+        }
+
+        storage_type* _take_chunk()
+        {
+            if (_spare_count != 0)
+                return _spares[--_spare_count];
+
+            return new storage_type[_chunk];
+        }
+
+        void _give_chunk(storage_type* chunk)
+        {
+            if (_spare_count < _max_spares)
+                _spares[_spare_count++] = chunk;
+            else
+                delete[] chunk;
+        }
+
+        // Makes room in the map for one more chunk, unwrapping the ring
+        void _reserve_map()
+        {
+            if (_chunks < _map_cap)
+                return;
+
+            usize _new_cap = _map_cap ? _map_cap * 2 : _min_map;
+            auto** _new_map = new storage_type*[_new_cap];
+
+            for (usize _index = 0; _index < _chunks; ++_index)
+                _new_map[_index] = _slot(_index);
+
+            delete[] _map;
+            _map = _new_map;
+            _map_cap = _new_cap;
+            _head = 0;
+        }
+
+        void _reset()
+        {
+            _first = _first_chunk = _last = _last_end = nullptr;
+        }
+
+        void _grow_back()
+        {
+            _reserve_map();
+            _slot(_chunks) = _take_chunk();
+            _last = _chunk_at(_chunks++);
+            _last_end = _last + _chunk;
+
+            if (_chunks == 1)
+                _first = _first_chunk = _last;
+        }
+
+        void _grow_front()
+        {
+            _reserve_map();
+            _head = (_head - 1) & (_map_cap - 1);
+            _slot(0) = _take_chunk();
+            _first_chunk = _chunk_at(0);
+            _first = _first_chunk + _chunk;
+
+            if (_chunks++ == 0)
+                _last = _last_end = _first;
+        }
+
+        T& _at(usize index) const
+        {
+            usize _pos = _start() + index;
+            return _chunk_at(_pos / _chunk)[_pos % _chunk];
+        }
+
+    public:
+        using value_type = T;
+        using iterator = deque_detail::iterator<T, false>;
+        using const_iterator = deque_detail::iterator<T, true>;
+
+        deque() = default;
+
+        deque(std::initializer_list<T> list)
+        {
+            for (auto& _value : list)
+                push_back(_value);
+        }
+
+        deque(const deque& other)
+        {
+            for (auto& _value : other)
+                push_back(_value);
+        }
+
+        deque(deque&& other)
+        {
+            *this = hsd::move(other);
+        }
+
+        deque& operator=(const deque& other)
+        {
+            if (this != &other)
+            {
+                clear();
+
+                for (auto& _value : other)
+                    push_back(_value);
+            }
+
+            return *this;
+        }
+
+        deque& operator=(deque&& other)
+        {
+            if (this != &other)
+            {
+                clear();
+                shrink_to_fit();
+                delete[] _map;
+
+                _map = hsd::exchange(other._map, nullptr);
+                _map_cap = hsd::exchange(other._map_cap, 0);
+                _head = hsd::exchange(other._head, 0);
+                _chunks = hsd::exchange(other._chunks, 0);
+                _first = hsd::exchange(other._first, nullptr);
+                _first_chunk = hsd::exchange(other._first_chunk, nullptr);
+                _last = hsd::exchange(other._last, nullptr);
+                _last_end = hsd::exchange(other._last_end, nullptr);
+                _spare_count = hsd::exchange(other._spare_count, 0);
+
+                for (usize _index = 0; _index < _spare_count; ++_index)
+                    _spares[_index] = other._spares[_index];
+            }
+
+            return *this;
+        }
+
+        ~deque()
+        {
+            clear();
+            shrink_to_fit();
+            delete[] _map;
+        }
+
+        T& operator[](usize index)
+        {
+            return _at(index);
+        }
+
+        const T& operator[](usize index) const
+        {
+            return _at(index);
+        }
+
+        T& at(usize index)
+        {
+            if (index >= size())
+                throw std::out_of_range("Accessed element out of range");
+
+            return _at(index);
+        }
+
+        const T& at(usize index) const
+        {
+            if (index >= size())
+                throw std::out_of_range("Accessed element out of range");
+
+            return _at(index);
+        }
+
+        T& front()
+        {
+            return *_first;
+        }
+
+        const T& front() const
+        {
+            return *_first;
+        }
+
+        T& back()
+        {
+            return _last[-1];
+        }
+
+        const T& back() const
+        {
+            return _last[-1];
+        }
+
+        template <typename... Args>
+        T& emplace_back(Args&&... args)
+        {
+            if (_last == _last_end)
+                _grow_back();
+
+            T* _value = new (_last) T(hsd::forward<Args>(args)...);
+            _last++;
+            return *_value;
+        }
+
+        template <typename... Args>
+        T& emplace_front(Args&&... args)
+        {
+            if (_first == _first_chunk)
+                _grow_front();
+
+            T* _value = new (_first - 1) T(hsd::forward<Args>(args)...);
+            _first--;
+            return *_value;
+        }
+
+        void push_back(const T& value)
+        {
+            emplace_back(value);
+        }
+
+        void push_back(T&& value)
+        {
+            emplace_back(hsd::move(value));
+        }
+
+        void push_front(const T& value)
+        {
+            emplace_front(value);
+        }
+
+        void push_front(T&& value)
+        {
+            emplace_front(hsd::move(value));
+        }
+
+        void pop_back()
+        {
+            (--_last)->~T();
+
+            // The last chunk went empty
+            if (_last == _last_end - _chunk)
+            {
+                _give_chunk(_slot(--_chunks));
+
+                if (_chunks == 0)
+                    return _reset();
+
+                _last = _last_end = _chunk_at(_chunks - 1) + _chunk;
+            }
+        }
+
+        void pop_front()
+        {
+            (_first++)->~T();
+
+            if (_first == _first_chunk + _chunk)
+            {
+                _give_chunk(_slot(0));
+                _head = (_head + 1) & (_map_cap - 1);
+
+                if (--_chunks == 0)
+                    return _reset();
+
+                _first = _first_chunk = _chunk_at(0);
+            }
+        }
+
+        void clear()
+        {
+            if constexpr (!std::is_trivially_destructible_v<T>)
+            {
+                for (auto& _value : *this)
+                    _value.~T();
+            }
+
+            while (_chunks != 0)
+                _give_chunk(_slot(--_chunks));
+
+            _reset();
+        }
+
+        /// Frees the spare chunks
+        void shrink_to_fit()
+        {
+            while (_spare_count != 0)
+                delete[] _spares[--_spare_count];
+        }
+
+        usize size() const
+        {
+            if (_chunks == 0)
+                return 0;
+
+            return _chunks * _chunk - _start() - static_cast<usize>(_last_end - _last);
+        }
+
+        bool empty() const
+        {
+            return size() == 0;
+        }
+
+        iterator begin()
+        {
+            return {this, 0, _first, _first_chunk};
+        }
+
+        iterator end()
+        {
+            if (_chunks == 0)
+                return {this, 0, nullptr, nullptr};
+
+            return {this, _chunks - 1, _last, _last_end - _chunk};
+        }
+
+        const_iterator begin() const
+        {
+            return {this, 0, _first, _first_chunk};
+        }
+
+        const_iterator end() const
+        {
+            if (_chunks == 0)
+                return {this, 0, nullptr, nullptr};
+
+            return {this, _chunks - 1, _last, _last_end - _chunk};
+        }
+
+        const_iterator cbegin() const
+        {
+            return begin();
+        }
+
+        const_iterator cend() const
+        {
+            return end();
+        }
+    };
+} // namespace hsd
@@ -0,0 +1,423 @@
+#pragma once
+
+#include "Coroutine.hpp"
+#include "Vector.hpp"
+#include "_NetworkDetail.hpp"
+
+#ifdef HSD_PLATFORM_LINUX
+
+#include <stdexcept>
+#include <sys/epoll.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <errno.h>
+
+namespace hsd
+{
+    namespace event_loop_detail
+    {
+        // A parked operation, `retry` runs it again once epoll reports the
+        // descriptor ready and returns false if it would still block
+        struct io_waiter
+        {
+            std::coroutine_handle<> handle = nullptr;
+            void* self = nullptr;
+            bool (*retry)(void*) = nullptr;
+        };
+
+        // What epoll reports back for a descriptor: the operations parked
+        // on it, at most one per direction
+        struct io_state
+        {
+            i32 fd = -1;
+            bool registered = false;
+            io_waiter* reader = nullptr;
+            io_waiter* writer = nullptr;
+        };
+    } // namespace event_loop_detail
+
+    /// Single threaded coroutine scheduler. Tasks given to `spawn` run
+    /// until they wait on a socket, `run` retries their operation when
+    /// epoll reports the socket ready and resumes them once it no longer
+    /// would block. Interest is registered one-shot, so a descriptor
+    /// costs nothing while nobody waits on it
+    class event_loop
+    {
+    private:
+        using io_state = event_loop_detail::io_state;
+        using io_waiter = event_loop_detail::io_waiter;
+        static constexpr i32 _max_events = 256;
+
+        i32 _epoll_fd = -1;
+        usize _live = 0;
+        vector<std::coroutine_handle<>> _ready;
+
+        // Ready only means the call won't block, another task can still
+        // drain the socket first, in which case the waiter stays parked
+        void _complete(io_waiter*& waiter)
+        {
+            if(waiter->retry(waiter->self))
+                _ready.push_back(hsd::exchange(waiter, nullptr)->handle);
+        }
+
+    public:
+        event_loop()
+        {
+            _epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+
+            if(_epoll_fd < 0)
+                throw std::runtime_error("Cannot create epoll instance");
+        }
+
+        event_loop(const event_loop&) = delete;
+        event_loop& operator=(const event_loop&) = delete;
+
+        ~event_loop()
+        {
+            ::close(_epoll_fd);
+        }
+
+        /// Takes ownership of `work`, it starts on the next `run`
+        void spawn(task<void>&& work)
+        {
+            _live++;
+            _ready.push_back(work._detach(_live));
+        }
+
+        /// Runs `work` and every spawned task to completion, returns the result of `work`
+        template < typename T >
+        T block_on(task<T>&& work)
+        {
+            if constexpr(is_same<T, void>::value)
+            {
+                spawn([](task<T> inner) -> task<void> { co_await hsd::move(inner); }(hsd::move(work)));
+                run();
+            }
+            else
+            {
+                T _result{};
+                spawn([](task<T> inner, T& out) -> task<void> { out = co_await hsd::move(inner); }(hsd::move(work), _result));
+                run();
+                return _result;
+            }
+        }
+
+        /// Resumes tasks until none are left
+        void run()
+        {
+            epoll_event _events[_max_events];
+            vector<std::coroutine_handle<>> _current;
+
+            while(_live != 0)
+            {
+                while(_ready.size() != 0)
+                {
+                    hsd::swap(_current, _ready);
+
+                    for(auto& _handle : _current)
+                        _handle.resume();
+
+                    _current.clear();
+                }
+
+                if(_live == 0)
+                    break;
+
+                i32 _count = epoll_wait(_epoll_fd, _events, _max_events, -1);
+
+                if(_count < 0)
+                {
+                    if(errno == EINTR)
+                        continue;
+
+                    throw std::runtime_error("epoll_wait failed");
+                }
+
+                for(i32 _index = 0; _index < _count; _index++)
+                {
+                    auto* _state = static_cast<io_state*>(_events[_index].data.ptr);
+                    u32 _flags = _events[_index].events;
+
+                    if(_state->reader && (_flags & (EPOLLIN | EPOLLERR | EPOLLHUP)))
+                        _complete(_state->reader);
+                    if(_state->writer && (_flags & (EPOLLOUT | EPOLLERR | EPOLLHUP)))
+                        _complete(_state->writer);
+
+                    // One-shot disarmed the descriptor, re-arm for whoever still waits
+                    if(_state->reader || _state->writer)
+                        watch(*_state);
+                }
+            }
+        }
+
+        /// Arms epoll for the directions `state` has waiters for
+        void watch(io_state& state)
+        {
+            epoll_event _event{};
+            _event.events = EPOLLONESHOT | EPOLLRDHUP;
+            _event.data.ptr = &state;
+
+            if(state.reader)
+                _event.events |= EPOLLIN;
+            if(state.writer)
+                _event.events |= EPOLLOUT;
+
+            if(state.registered && epoll_ctl(_epoll_fd, EPOLL_CTL_MOD, state.fd, &_event) == 0)
+                return;
+
+            if(epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, state.fd, &_event) != 0 &&
+                (errno != EEXIST || epoll_ctl(_epoll_fd, EPOLL_CTL_MOD, state.fd, &_event) != 0))
+                throw std::runtime_error("Cannot watch descriptor");
+
+            state.registered = true;
+        }
+    };
+
+    /// Non-blocking TCP socket whose operations are awaited from tasks of
+    /// an `event_loop`. Each operation is tried right away and only parks
+    /// the task when the kernel says it would block. Results follow the
+    /// syscalls: a byte count, 0 on disconnect or -errno on failure. One
+    /// task at a time can wait per direction, a second one gets -EBUSY
+    class async_socket
+    {
+    private:
+        using io_state = event_loop_detail::io_state;
+
+        event_loop* _loop = nullptr;
+        io_state _state;
+
+        template < typename Op, bool Write >
+        struct awaiter
+        {
+            async_socket& sock;
+            Op op;
+            isize result = 0;
+            event_loop_detail::io_waiter waiter{};
+
+            static bool _retry(void* self)
+            {
+                auto& _self = *static_cast<awaiter*>(self);
+                _self.result = _self.op(_self.sock._state.fd);
+                return _self.result != -EAGAIN;
+            }
+
+            bool await_ready()
+            {
+                result = op(sock._state.fd);
+                return result != -EAGAIN;
+            }
+
+            bool await_suspend(std::coroutine_handle<> handle)
+            {
+                auto*& _slot = Write ? sock._state.writer : sock._state.reader;
+
+                if(_slot != nullptr)
+                {
+                    result = -EBUSY;
+                    return false;
+                }
+
+                waiter = {handle, this, &_retry};
+                _slot = &waiter;
+                sock._loop->watch(sock._state);
+                return true;
+            }
+
+            isize await_resume()
+            {
+                return result;
+            }
+        };
+
+        template < bool Write, typename Op >
+        awaiter<Op, Write> _await(Op&& op)
+        {
+            return {*this, hsd::forward<Op>(op)};
+        }
+
+        static isize _result(isize value)
+        {
+            return value < 0 ? -errno : value;
+        }
+
+    public:
+        async_socket() = default;
+
+        /// Adopts `fd` and switches it to non-blocking mode
+        async_socket(event_loop& loop, i32 fd)
+            : _loop{&loop}
+        {
+            _state.fd = fd;
+
+            if(fd >= 0)
+                fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        }
+
+        async_socket(const async_socket&) = delete;
+        async_socket& operator=(const async_socket&) = delete;
+
+        // The registration follows the descriptor, `watch` re-points it
+        // at the new state the next time someone waits
+        async_socket(async_socket&& other)
+            : _loop{other._loop}, _state{hsd::exchange(other._state, io_state{})}
+        {}
+
+        async_socket& operator=(async_socket&& other)
+        {
+            close();
+            _loop = other._loop;
+            _state = hsd::exchange(other._state, io_state{});
+            return *this;
+        }
+
+        ~async_socket()
+        {
+            close();
+        }
+
+        /// Opens a listener bound to `ip_addr`:`port`, throws on failure
+        static async_socket listen(event_loop& loop, u16 port,
+            const char* ip_addr = "0.0.0.0", net::protocol_type protocol = net::protocol_type::ipv4)
+        {
+            i32 _fd = ::socket(static_cast<i32>(protocol), SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+            i32 _enable = 1;
+            i32 _rez = -1;
+
+            setsockopt(_fd, SOL_SOCKET, SO_REUSEADDR, &_enable, sizeof(_enable));
+
+            if(protocol == net::protocol_type::ipv4)
+            {
+                sockaddr_in _hintv4{};
+                _hintv4.sin_family = AF_INET;
+                _hintv4.sin_port = htons(port);
+                inet_pton(AF_INET, ip_addr, &_hintv4.sin_addr);
+                _rez = bind(_fd, reinterpret_cast<sockaddr*>(&_hintv4), sizeof(_hintv4));
+            }
+            else
+            {
+                sockaddr_in6 _hintv6{};
+                _hintv6.sin6_family = AF_INET6;
+                _hintv6.sin6_port = htons(port);
+                inet_pton(AF_INET6, ip_addr, &_hintv6.sin6_addr);
+                _rez = bind(_fd, reinterpret_cast<sockaddr*>(&_hintv6), sizeof(_hintv6));
+            }
+            if(_rez != 0 || ::listen(_fd, SOMAXCONN) != 0)
+            {
+                ::close(_fd);
+                throw std::runtime_error("Cannot open listener");
+            }
+
+            return {loop, _fd};
+        }
+
+        /// Connects to `ip_addr`:`port`, the socket is invalid on failure
+        static task<async_socket> connect(event_loop& loop, const char* ip_addr, u16 port)
+        {
+            i32 _fd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+            async_socket _sock{loop, _fd};
+            sockaddr_in _hint{};
+            _hint.sin_family = AF_INET;
+            _hint.sin_port = htons(port);
+            inet_pton(AF_INET, ip_addr, &_hint.sin_addr);
+
+            if(::connect(_fd, reinterpret_cast<sockaddr*>(&_hint), sizeof(_hint)) == 0)
+                co_return hsd::move(_sock);
+            if(errno != EINPROGRESS)
+                co_return async_socket{};
+
+            // Writable means the handshake finished, SO_ERROR tells how
+            isize _error = co_await _sock._await<true>([](i32 fd) -> isize {
+                pollfd _poll{fd, POLLOUT, 0};
+
+                if(::poll(&_poll, 1, 0) == 0)
+                    return -EAGAIN;
+
+                i32 _error = 0;
+                socklen_t _len = sizeof(_error);
+                getsockopt(fd, SOL_SOCKET, SO_ERROR, &_error, &_len);
+                return -_error;
+            });
+
+            if(_error != 0)
+                co_return async_socket{};
+
+            co_return hsd::move(_sock);
+        }
+
+        /// Awaits a connection, the returned socket is invalid on failure
+        auto accept()
+        {
+            struct accept_awaiter : awaiter<isize(*)(i32), false>
+            {
+                async_socket await_resume()
+                {
+                    isize _fd = awaiter<isize(*)(i32), false>::await_resume();
+                    return _fd < 0 ? async_socket{} : async_socket{*this->sock._loop, static_cast<i32>(_fd)};
+                }
+            };
+
+            return accept_awaiter{{*this, [](i32 fd) -> isize {
+                return _result(::accept4(fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC));
+            }}};
+        }
+
+        auto recv(char* buf, usize size)
+        {
+            return _await<false>([buf, size](i32 fd) -> isize {
+                return _result(::recv(fd, buf, size, 0));
+            });
+        }
+
+        template < usize N >
+        auto recv(char (&buf)[N])
+        {
+            return recv(buf, N);
+        }
+
+        auto send(const char* data, usize size)
+        {
+            return _await<true>([data, size](i32 fd) -> isize {
+                return _result(::send(fd, data, size, MSG_NOSIGNAL));
+            });
+        }
+
+        /// Sends everything, returns `size` or the first error
+        task<isize> send_all(const char* data, usize size)
+        {
+            usize _sent = 0;
+
+            while(_sent < size)
+            {
+                isize _rez = co_await send(data + _sent, size - _sent);
+
+                if(_rez <= 0)
+                    co_return _rez;
+
+                _sent += static_cast<usize>(_rez);
+            }
+
+            co_return static_cast<isize>(_sent);
+        }
+
+        bool is_valid() const
+        {
+            return _state.fd >= 0;
+        }
+
+        i32 get_sock() const
+        {
+            return _state.fd;
+        }
+
+        void close()
+        {
+            // Closing the last reference also drops the epoll registration
+            if(_state.fd >= 0)
+                ::close(hsd::exchange(_state.fd, -1));
+
+            _state.registered = false;
+        }
+    };
+} // namespace hsd
+
+#endif
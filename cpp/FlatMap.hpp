@@ -0,0 +1,735 @@
+#pragma once
+
+#include <stdexcept>
+#include <initializer_list>
+
+#include "Pair.hpp"
+#include "Vector.hpp"
+#include "Algorithm.hpp"
+#include "Functional.hpp"
+
+namespace hsd
+{
+    /// Lookups by branchless binary search over the sorted keys
+    struct binary_layout {};
+
+    /// Lookups through a copy of the keys in Eytzinger (BFS) order, the
+    /// first levels of the search share cache lines and later ones are
+    /// prefetched. Costs a copy of the keys and a 4 byte rank per entry
+    struct eytzinger_layout {};
+
+    namespace flat_detail
+    {
+        template <typename Ref>
+        struct arrow_proxy
+        {
+            Ref ref;
+
+            Ref* operator->()
+            {
+                return &ref;
+            }
+        };
+
+        template <typename T, typename... Args>
+        static void insert_at(vector<T>& vec, usize pos, Args&&... args)
+        {
+            T _value(hsd::forward<Args>(args)...);
+            vec.reserve(vec.size() + 1);
+
+            if (pos == vec.size())
+            {
+                vec.push_back(hsd::move(_value));
+                return;
+            }
+
+            vec.push_back(hsd::move(vec.back()));
+
+            for (usize _index = vec.size() - 2; _index > pos; --_index)
+                vec[_index] = hsd::move(vec[_index - 1]);
+
+            vec[pos] = hsd::move(_value);
+        }
+
+        template <typename T>
+        static void erase_at(vector<T>& vec, usize pos)
+        {
+            for (usize _index = pos; _index + 1 < vec.size(); ++_index)
+                vec[_index] = hsd::move(vec[_index + 1]);
+
+            vec.pop_back();
+        }
+
+        template <typename Key, typename Layout>
+        class search_index;
+
+        template <typename Key>
+        class search_index<Key, binary_layout>
+        {
+        public:
+            void rebuild(const vector<Key>&) {}
+
+            template <typename NewKey, typename Compare>
+            usize lower_bound(const vector<Key>& keys, const NewKey& key, const Compare& comp) const
+            {
+                usize _count = keys.size();
+
+                if (_count == 0)
+                    return 0;
+
+                const Key* _base = keys.cbegin();
+
+                while (_count > 1)
+                {
+                    usize _half = _count / 2;
+                    _base = comp(_base[_half], key) ? _base + _half : _base;
+                    _count -= _half;
+                }
+
+                return static_cast<usize>(_base - keys.cbegin()) + comp(*_base, key);
+            }
+
+            template <typename NewKey, typename Compare>
+            usize upper_bound(const vector<Key>& keys, const NewKey& key, const Compare& comp) const
+            {
+                usize _count = keys.size();
+
+                if (_count == 0)
+                    return 0;
+
+                const Key* _base = keys.cbegin();
+
+                while (_count > 1)
+                {
+                    usize _half = _count / 2;
+                    _base = comp(key, _base[_half]) ? _base : _base + _half;
+                    _count -= _half;
+                }
+
+                return static_cast<usize>(_base - keys.cbegin()) + !comp(key, *_base);
+            }
+
+            template <typename NewKey, typename Compare>
+            usize find(const vector<Key>& keys, const NewKey& key, const Compare& comp) const
+            {
+                usize _pos = lower_bound(keys, key, comp);
+                return _pos < keys.size() && !comp(key, keys[_pos]) ? _pos : keys.size();
+            }
+        };
+
+        template <typename Key>
+        class search_index<Key, eytzinger_layout>
+        {
+        private:
+            // Node `k` (1 based) has children `2k` and `2k + 1`, `rank` is
+            // its position in the sorted keys, kept next to the key so the
+            // answer costs no extra cache miss
+            struct node
+            {
+                Key key;
+                u32 rank;
+            };
+
+            vector<node> _tree;
+
+            static void _fill(vector<u32>& ranks, usize index, u32& next)
+            {
+                if (index > ranks.size())
+                    return;
+
+                _fill(ranks, 2 * index, next);
+                ranks[index - 1] = next++;
+                _fill(ranks, 2 * index + 1, next);
+            }
+
+            // The path taken is in the bits of `index`, the last left turn
+            // (the answer) is found by dropping the trailing ones and a zero
+            static usize _resolve(usize index)
+            {
+                return index >> __builtin_ffsll(static_cast<i64>(~index));
+            }
+
+            template <bool Upper, typename NewKey, typename Compare>
+            usize _search(const NewKey& key, const Compare& comp) const
+            {
+                const node* _nodes = _tree.cbegin();
+                usize _count = _tree.size();
+                usize _index = 1;
+
+                while (_index <= _count)
+                {
+                    // Four levels down sit next to each other, prefetching
+                    // past the end is harmless
+                    __builtin_prefetch(reinterpret_cast<const char*>(_nodes) + sizeof(node) * (_index << 4));
+
+                    if constexpr (Upper)
+                        _index = 2 * _index + !comp(key, _nodes[_index - 1].key);
+                    else
+                        _index = 2 * _index + comp(_nodes[_index - 1].key, key);
+                }
+
+                return _resolve(_index);
+            }
+
+        public:
+            void rebuild(const vector<Key>& keys)
+            {
+                if (keys.size() > static_cast<usize>(static_cast<u32>(-1)))
+                    throw std::runtime_error("Too many keys for an Eytzinger index");
+
+                vector<u32> _ranks(keys.size());
+                u32 _next = 0;
+                _fill(_ranks, 1, _next);
+                _tree.clear();
+                _tree.reserve(keys.size());
+
+                for (usize _index = 0; _index < _ranks.size(); ++_index)
+                    _tree.push_back({keys[_ranks[_index]], _ranks[_index]});
+            }
+
+            template <typename NewKey, typename Compare>
+            usize lower_bound(const vector<Key>&, const NewKey& key, const Compare& comp) const
+            {
+                usize _index = _search<false>(key, comp);
+                return _index == 0 ? _tree.size() : _tree[_index - 1].rank;
+            }
+
+            template <typename NewKey, typename Compare>
+            usize upper_bound(const vector<Key>&, const NewKey& key, const Compare& comp) const
+            {
+                usize _index = _search<true>(key, comp);
+                return _index == 0 ? _tree.size() : _tree[_index - 1].rank;
+            }
+
+            template <typename NewKey, typename Compare>
+            usize find(const vector<Key>&, const NewKey& key, const Compare& comp) const
+            {
+                usize _index = _search<false>(key, comp);
+
+                if (_index == 0 || comp(key, _tree[_index - 1].key))
+                    return _tree.size();
+
+                return _tree[_index - 1].rank;
+            }
+        };
+
+        /// Walks the keys and values of a `flat_map` side by side
+        template <typename Key, typename T>
+        class iterator
+        {
+        private:
+            const Key* _key = nullptr;
+            T* _value = nullptr;
+
+        public:
+            using reference = pair<const Key&, T&>;
+
+            iterator() = default;
+
+            iterator(const Key* key, T* value)
+                : _key{key}, _value{value}
+            {}
+
+            operator iterator<Key, const T>() const
+            {
+                return {_key, _value};
+            }
+
+            reference operator*() const
+            {
+                return {*_key, *_value};
+            }
+
+            arrow_proxy<reference> operator->() const
+            {
+                return {**this};
+            }
+
+            const Key& key() const
+            {
+                return *_key;
+            }
+
+            T& value() const
+            {
+                return *_value;
+            }
+
+            iterator& operator++()
+            {
+                ++_key;
+                ++_value;
+                return *this;
+            }
+
+            iterator& operator--()
+            {
+                --_key;
+                --_value;
+                return *this;
+            }
+
+            iterator operator++(i32)
+            {
+                iterator _tmp = *this;
+                operator++();
+                return _tmp;
+            }
+
+            iterator operator--(i32)
+            {
+                iterator _tmp = *this;
+                operator--();
+                return _tmp;
+            }
+
+            iterator operator+(isize offset) const
+            {
+                return {_key + offset, _value + offset};
+            }
+
+            iterator operator-(isize offset) const
+            {
+                return {_key - offset, _value - offset};
+            }
+
+            isize operator-(const iterator& rhs) const
+            {
+                return _key - rhs._key;
+            }
+
+            friend bool operator==(const iterator& lhs, const iterator& rhs)
+            {
+                return lhs._key == rhs._key;
+            }
+
+            friend bool operator!=(const iterator& lhs, const iterator& rhs)
+            {
+                return lhs._key != rhs._key;
+            }
+        };
+
+        // Stable sort of the positions of `keys`, so the first of equal keys stays first
+        template <typename Key, typename Compare>
+        static vector<u32> sorted_order(const vector<Key>& keys, const Compare& comp)
+        {
+            vector<u32> _order(keys.size());
+
+            for (usize _index = 0; _index < keys.size(); ++_index)
+                _order[_index] = static_cast<u32>(_index);
+
+            hsd::stable_sort(_order.begin(), _order.end(), [&](u32 lhs, u32 rhs) {
+                return comp(keys[lhs], keys[rhs]);
+            });
+
+            return _order;
+        }
+    } // namespace flat_detail
+
+    /// Sorted map over two vectors, keys in one and values in the other,
+    /// for lookup tables that are built once and read a lot. Single
+    /// inserts and erases shift the tail, batches should go through
+    /// `insert_range` which sorts them once and merges
+    template <typename Key, typename T, typename Compare = less, typename Layout = binary_layout>
+    class flat_map
+    {
+    private:
+        vector<Key> _keys;
+        vector<T> _values;
+        flat_detail::search_index<Key, Layout> _index;
+        [[no_unique_address]] Compare _comp;
+
+        template <typename NewKey>
+        usize _lower(const NewKey& key) const
+        {
+            return _index.lower_bound(_keys, key, _comp);
+        }
+
+        template <typename NewKey>
+        usize _find(const NewKey& key) const
+        {
+            return _index.find(_keys, key, _comp);
+        }
+
+    public:
+        using iterator = flat_detail::iterator<Key, T>;
+        using const_iterator = flat_detail::iterator<Key, const T>;
+
+        flat_map() = default;
+
+        flat_map(std::initializer_list<pair<Key, T>> list)
+        {
+            insert_range(list.begin(), list.end());
+        }
+
+        /// Adds the pairs of [`first`, `last`) whose keys aren't present,
+        /// the first of repeated keys wins
+        template <typename It>
+        void insert_range(It first, It last)
+        {
+            vector<Key> _new_keys;
+            vector<T> _new_values;
+
+            for (; first != last; ++first)
+            {
+                auto&& _elem = *first;
+                _new_keys.push_back(_elem.first);
+                _new_values.push_back(_elem.second);
+            }
+
+            vector<u32> _order = flat_detail::sorted_order(_new_keys, _comp);
+            vector<Key> _out_keys;
+            vector<T> _out_values;
+            _out_keys.reserve(_keys.size() + _new_keys.size());
+            _out_values.reserve(_keys.size() + _new_keys.size());
+
+            usize _old = 0;
+            usize _new = 0;
+
+            while (_old < _keys.size() || _new < _order.size())
+            {
+                if (_old == _keys.size() || (_new < _order.size() && _comp(_new_keys[_order[_new]], _keys[_old])))
+                {
+                    // Equal keys already taken from either side win
+                    u32 _from = _order[_new++];
+
+                    if (_out_keys.size() == 0 || _comp(_out_keys.back(), _new_keys[_from]))
+                    {
+                        _out_keys.push_back(hsd::move(_new_keys[_from]));
+                        _out_values.push_back(hsd::move(_new_values[_from]));
+                    }
+                }
+                else
+                {
+                    _out_keys.push_back(hsd::move(_keys[_old]));
+                    _out_values.push_back(hsd::move(_values[_old]));
+                    _old++;
+                }
+            }
+
+            _keys = hsd::move(_out_keys);
+            _values = hsd::move(_out_values);
+            _index.rebuild(_keys);
+        }
+
+        template <typename... Args>
+        pair<iterator, bool> emplace(const Key& key, Args&&... args)
+        {
+            usize _pos = _lower(key);
+
+            if (_pos < _keys.size() && !_comp(key, _keys[_pos]))
+                return {begin() + static_cast<isize>(_pos), false};
+
+            // Build the value and make room in both vectors before touching
+            // either, so a throw leaves the keys and values the same length
+            T _value(hsd::forward<Args>(args)...);
+            _keys.reserve(_keys.size() + 1);
+            _values.reserve(_values.size() + 1);
+
+            flat_detail::insert_at(_keys, _pos, key);
+            flat_detail::insert_at(_values, _pos, hsd::move(_value));
+            _index.rebuild(_keys);
+            return {begin() + static_cast<isize>(_pos), true};
+        }
+
+        pair<iterator, bool> insert(const pair<Key, T>& value)
+        {
+            return emplace(value.first, value.second);
+        }
+
+        template <typename NewKey>
+        bool erase(const NewKey& key)
+        {
+            usize _pos = _find(key);
+
+            if (_pos == _keys.size())
+                return false;
+
+            flat_detail::erase_at(_keys, _pos);
+            flat_detail::erase_at(_values, _pos);
+            _index.rebuild(_keys);
+            return true;
+        }
+
+        /// Removes the entry at `pos`, returns the one that followed it
+        iterator erase(const_iterator pos)
+        {
+            usize _pos = static_cast<usize>(pos - cbegin());
+            flat_detail::erase_at(_keys, _pos);
+            flat_detail::erase_at(_values, _pos);
+            _index.rebuild(_keys);
+            return begin() + static_cast<isize>(_pos);
+        }
+
+        iterator erase(iterator pos)
+        {
+            return erase(const_iterator{pos});
+        }
+
+        T& operator[](const Key& key)
+        {
+            return emplace(key).first.value();
+        }
+
+        T& at(const Key& key)
+        {
+            usize _pos = _find(key);
+
+            if (_pos == _keys.size())
+                throw std::out_of_range("Key not found in flat_map");
+
+            return _values[_pos];
+        }
+
+        const T& at(const Key& key) const
+        {
+            usize _pos = _find(key);
+
+            if (_pos == _keys.size())
+                throw std::out_of_range("Key not found in flat_map");
+
+            return _values[_pos];
+        }
+
+        template <typename NewKey>
+        iterator find(const NewKey& key)
+        {
+            return begin() + static_cast<isize>(_find(key));
+        }
+
+        template <typename NewKey>
+        const_iterator find(const NewKey& key) const
+        {
+            return cbegin() + static_cast<isize>(_find(key));
+        }
+
+        template <typename NewKey>
+        bool contains(const NewKey& key) const
+        {
+            return _find(key) != _keys.size();
+        }
+
+        template <typename NewKey>
+        iterator lower_bound(const NewKey& key)
+        {
+            return begin() + static_cast<isize>(_lower(key));
+        }
+
+        template <typename NewKey>
+        iterator upper_bound(const NewKey& key)
+        {
+            return begin() + static_cast<isize>(_index.upper_bound(_keys, key, _comp));
+        }
+
+        void reserve(usize count)
+        {
+            _keys.reserve(count);
+            _values.reserve(count);
+        }
+
+        void clear()
+        {
+            _keys.clear();
+            _values.clear();
+            _index.rebuild(_keys);
+        }
+
+        usize size() const
+        {
+            return _keys.size();
+        }
+
+        bool empty() const
+        {
+            return _keys.size() == 0;
+        }
+
+        /// The sorted keys, parallel to `values()`
+        const vector<Key>& keys() const
+        {
+            return _keys;
+        }
+
+        vector<T>& values()
+        {
+            return _values;
+        }
+
+        iterator begin()
+        {
+            return {_keys.cbegin(), _values.begin()};
+        }
+
+        iterator end()
+        {
+            return begin() + static_cast<isize>(size());
+        }
+
+        const_iterator cbegin() const
+        {
+            return {_keys.cbegin(), _values.cbegin()};
+        }
+
+        const_iterator cend() const
+        {
+            return cbegin() + static_cast<isize>(size());
+        }
+
+        const_iterator begin() const
+        {
+            return cbegin();
+        }
+
+        const_iterator end() const
+        {
+            return cend();
+        }
+    };
+
+    /// Sorted set over a vector, see `flat_map`
+    template <typename Key, typename Compare = less, typename Layout = binary_layout>
+    class flat_set
+    {
+    private:
+        vector<Key> _keys;
+        flat_detail::search_index<Key, Layout> _index;
+        [[no_unique_address]] Compare _comp;
+
+        template <typename NewKey>
+        usize _find(const NewKey& key) const
+        {
+            return _index.find(_keys, key, _comp);
+        }
+
+    public:
+        using iterator = const Key*;
+        using const_iterator = const Key*;
+
+        flat_set() = default;
+
+        flat_set(std::initializer_list<Key> list)
+        {
+            insert_range(list.begin(), list.end());
+        }
+
+        /// Adds the keys of [`first`, `last`) that aren't present yet
+        template <typename It>
+        void insert_range(It first, It last)
+        {
+            vector<Key> _new_keys;
+
+            for (; first != last; ++first)
+                _new_keys.push_back(*first);
+
+            vector<u32> _order = flat_detail::sorted_order(_new_keys, _comp);
+            vector<Key> _out;
+            _out.reserve(_keys.size() + _new_keys.size());
+
+            usize _old = 0;
+            usize _new = 0;
+
+            while (_old < _keys.size() || _new < _order.size())
+            {
+                if (_old == _keys.size() || (_new < _order.size() && _comp(_new_keys[_order[_new]], _keys[_old])))
+                {
+                    u32 _from = _order[_new++];
+
+                    if (_out.size() == 0 || _comp(_out.back(), _new_keys[_from]))
+                        _out.push_back(hsd::move(_new_keys[_from]));
+                }
+                else
+                {
+                    _out.push_back(hsd::move(_keys[_old++]));
+                }
+            }
+
+            _keys = hsd::move(_out);
+            _index.rebuild(_keys);
+        }
+
+        pair<iterator, bool> insert(const Key& key)
+        {
+            usize _pos = _index.lower_bound(_keys, key, _comp);
+
+            if (_pos < _keys.size() && !_comp(key, _keys[_pos]))
+                return {begin() + _pos, false};
+
+            flat_detail::insert_at(_keys, _pos, key);
+            _index.rebuild(_keys);
+            return {begin() + _pos, true};
+        }
+
+        template <typename NewKey>
+        bool erase(const NewKey& key)
+        {
+            usize _pos = _find(key);
+
+            if (_pos == _keys.size())
+                return false;
+
+            flat_detail::erase_at(_keys, _pos);
+            _index.rebuild(_keys);
+            return true;
+        }
+
+        template <typename NewKey>
+        iterator find(const NewKey& key) const
+        {
+            return begin() + _find(key);
+        }
+
+        template <typename NewKey>
+        bool contains(const NewKey& key) const
+        {
+            return _find(key) != _keys.size();
+        }
+
+        template <typename NewKey>
+        iterator lower_bound(const NewKey& key) const
+        {
+            return begin() + _index.lower_bound(_keys, key, _comp);
+        }
+
+        template <typename NewKey>
+        iterator upper_bound(const NewKey& key) const
+        {
+            return begin() + _index.upper_bound(_keys, key, _comp);
+        }
+
+        void reserve(usize count)
+        {
+            _keys.reserve(count);
+        }
+
+        void clear()
+        {
+            _keys.clear();
+            _index.rebuild(_keys);
+        }
+
+        usize size() const
+        {
+            return _keys.size();
+        }
+
+        bool empty() const
+        {
+            return _keys.size() == 0;
+        }
+
+        const vector<Key>& keys() const
+        {
+            return _keys;
+        }
+
+        iterator begin() const
+        {
+            return _keys.cbegin();
+        }
+
+        iterator end() const
+        {
+            return _keys.cbegin() + _keys.size();
+        }
+    };
+} // namespace hsd
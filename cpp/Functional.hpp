@@ -180,6 +180,35 @@ namespace hsd
         };
     }
 
+    /// Transparent comparison and arithmetic functors, usable across
+    /// mixed argument types like the C++14 `std::less<>`
+    struct less
+    {
+        template < typename T, typename U >
+        constexpr bool operator()(const T& lhs, const U& rhs) const
+        {
+            return lhs < rhs;
+        }
+    };
+
+    struct greater
+    {
+        template < typename T, typename U >
+        constexpr bool operator()(const T& lhs, const U& rhs) const
+        {
+            return rhs < lhs;
+        }
+    };
+
+    struct plus
+    {
+        template < typename T, typename U >
+        constexpr auto operator()(const T& lhs, const U& rhs) const
+        {
+            return lhs + rhs;
+        }
+    };
+
     template < typename Rez, typename... Args > 
         function(Rez(*)(Args...)) -> function<Rez(Args...)>;
     template < typename Func, typename Op = decltype(&Func::operator()) > 
@@ -1,9 +1,15 @@
 #pragma once
 
 #include "Utility.hpp"
+#include "Pair.hpp"
+#include "IntegerSequence.hpp"
 
 namespace hsd
 {
+    template <typename CharT> class string;
+    template <typename CharT> class string_view;
+    template <typename... T> class tuple;
+
     template <typename HashType>
     struct fnv1a
     {
@@ -18,7 +24,7 @@ namespace hsd
                 offset_basis = 14'695'981'039'346'656'037u;
                 prime = 1'099'511'628'211u;
             }
-            else if constexpr(sizeof(HashType) == sizeof(u32)) 
+            else if constexpr(sizeof(HashType) == sizeof(u32))
             {
                 offset_basis = 2'166'136'261u;
                 prime = 16'777'619u;
@@ -26,7 +32,7 @@ namespace hsd
 
             HashType hash = offset_basis;
 
-            while(*begin != '\0') 
+            while(*begin != '\0')
             {
                 hash = (hash ^ static_cast<HashType>(*begin)) * prime;
                 begin++;
@@ -41,4 +47,275 @@ namespace hsd
             return static_cast<HashType>(number);
         }
     };
-} // namespace hsd
\ No newline at end of file
+
+    namespace hash_detail
+    {
+        static constexpr u64 secret[4] = {
+            0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull,
+            0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull
+        };
+
+        // 64x64 -> 128 bit multiply folded back to 64 bits
+        static constexpr u64 mum(u64 lhs, u64 rhs)
+        {
+            unsigned __int128 _product = static_cast<unsigned __int128>(lhs) * rhs;
+            return static_cast<u64>(_product) ^ static_cast<u64>(_product >> 64);
+        }
+
+        template <typename ByteT> requires (sizeof(ByteT) == 1)
+        static constexpr u64 read(const ByteT* data, usize count)
+        {
+            if(std::is_constant_evaluated())
+            {
+                u64 _value = 0;
+
+                for(usize _index = 0; _index < count; _index++)
+                    _value |= static_cast<u64>(static_cast<uchar>(data[_index])) << (_index * 8);
+
+                return _value;
+            }
+            else
+            {
+                u64 _value = 0;
+                __builtin_memcpy(&_value, data, count);
+                return _value;
+            }
+        }
+
+        template <typename ByteT>
+        static constexpr u64 read64(const ByteT* data)
+        {
+            return read(data, 8);
+        }
+
+        template <typename ByteT>
+        static constexpr u64 read32(const ByteT* data)
+        {
+            return read(data, 4);
+        }
+
+        template <typename ByteT>
+        static constexpr u64 read_small(const ByteT* data, usize len)
+        {
+            return (static_cast<u64>(static_cast<uchar>(data[0])) << 16) |
+                (static_cast<u64>(static_cast<uchar>(data[len >> 1])) << 8) |
+                static_cast<u64>(static_cast<uchar>(data[len - 1]));
+        }
+    } // namespace hash_detail
+
+    /// wyhash: consumes 48 bytes per round in three independent lanes,
+    /// keys of up to 16 bytes are covered by two overlapping reads
+    struct wyhash
+    {
+        template <typename ByteT> requires (sizeof(ByteT) == 1)
+        static constexpr u64 get_hash(const ByteT* data, usize len, u64 seed = 0)
+        {
+            using namespace hash_detail;
+            u64 _lhs = 0, _rhs = 0;
+            seed ^= mum(seed ^ secret[0], secret[1]);
+
+            if(len <= 16)
+            {
+                if(len >= 4)
+                {
+                    usize _shift = (len >> 3) << 2;
+                    _lhs = (read32(data) << 32) | read32(data + _shift);
+                    _rhs = (read32(data + len - 4) << 32) | read32(data + len - 4 - _shift);
+                }
+                else if(len > 0)
+                {
+                    _lhs = read_small(data, len);
+                }
+            }
+            else
+            {
+                usize _left = len;
+
+                if(_left > 48)
+                {
+                    u64 _lane1 = seed, _lane2 = seed;
+
+                    do
+                    {
+                        seed = mum(read64(data) ^ secret[1], read64(data + 8) ^ seed);
+                        _lane1 = mum(read64(data + 16) ^ secret[2], read64(data + 24) ^ _lane1);
+                        _lane2 = mum(read64(data + 32) ^ secret[3], read64(data + 40) ^ _lane2);
+                        data += 48;
+                        _left -= 48;
+                    } while(_left > 48);
+
+                    seed ^= _lane1 ^ _lane2;
+                }
+                for(; _left > 16; _left -= 16, data += 16)
+                    seed = mum(read64(data) ^ secret[1], read64(data + 8) ^ seed);
+
+                _lhs = read64(data + _left - 16);
+                _rhs = read64(data + _left - 8);
+            }
+
+            _lhs ^= secret[1];
+            _rhs ^= seed;
+            unsigned __int128 _product = static_cast<unsigned __int128>(_lhs) * _rhs;
+            _lhs = static_cast<u64>(_product);
+            _rhs = static_cast<u64>(_product >> 64);
+            return mum(_lhs ^ secret[0] ^ len, _rhs ^ secret[1]);
+        }
+
+        template <typename T>
+        static constexpr ResolvedType< is_char_pointer<T>, u64 > get_hash(T str)
+        {
+            usize _len = 0;
+
+            while(str[_len] != '\0')
+                _len++;
+
+            if constexpr(sizeof(*str) == 1)
+                return get_hash(str, _len);
+            else
+                return get_hash(reinterpret_cast<const uchar*>(str), _len * sizeof(*str));
+        }
+
+        /// Finalizer for integer keys, two folded 128 bit multiplies so
+        /// every input bit reaches the low bits used for bucket masks
+        template <typename T>
+        static constexpr ResolvedType< std::is_integral<T>, u64 > get_hash(T number)
+        {
+            u64 _value = hash_detail::mum(
+                static_cast<u64>(number) ^ hash_detail::secret[0], hash_detail::secret[1]
+            );
+
+            return hash_detail::mum(_value ^ hash_detail::secret[2], hash_detail::secret[3]);
+        }
+
+        static constexpr u64 combine(u64 seed, u64 value)
+        {
+            return hash_detail::mum(seed ^ hash_detail::secret[2], value ^ hash_detail::secret[3]);
+        }
+    };
+
+    /// Default hasher, `get_hash` is static so it also plugs into
+    /// containers that take a `Hasher` type
+    template <typename T>
+    struct hash
+    {
+        static constexpr usize get_hash(const T& value)
+            requires (std::is_integral_v<T> || std::is_enum_v<T>)
+        {
+            if constexpr(std::is_enum_v<T>)
+                return wyhash::get_hash(static_cast<std::underlying_type_t<T>>(value));
+            else
+                return wyhash::get_hash(value);
+        }
+
+        static constexpr usize get_hash(T value) requires (std::is_floating_point_v<T>)
+        {
+            // +0.0 and -0.0 compare equal so they must hash the same
+            if(value == 0)
+                value = 0;
+
+            if constexpr(sizeof(T) == sizeof(u32))
+                return wyhash::get_hash(__builtin_bit_cast(u32, value));
+            else if constexpr(sizeof(T) == sizeof(u64))
+                return wyhash::get_hash(__builtin_bit_cast(u64, value));
+            else
+                return wyhash::get_hash(static_cast<u64>(value));
+        }
+
+        static constexpr usize get_hash(T value) requires (is_char_pointer<T>::value)
+        {
+            return wyhash::get_hash(value);
+        }
+
+        static usize get_hash(T value)
+            requires (std::is_pointer_v<T> && !is_char_pointer<T>::value)
+        {
+            return wyhash::get_hash(reinterpret_cast<usize>(value));
+        }
+
+        constexpr usize operator()(const T& value) const
+        {
+            return get_hash(value);
+        }
+    };
+
+    /// Strings, views and C strings of the same characters hash alike, so
+    /// string keyed containers can be probed with any of them
+    template <typename CharT>
+    struct hash< string_view<CharT> >
+    {
+        static constexpr usize get_hash(string_view<CharT> value)
+        {
+            if constexpr(sizeof(CharT) == 1)
+            {
+                return wyhash::get_hash(value.data(), value.size());
+            }
+            else
+            {
+                return wyhash::get_hash(
+                    reinterpret_cast<const uchar*>(value.data()), value.size() * sizeof(CharT)
+                );
+            }
+        }
+
+        static constexpr usize get_hash(const CharT* value)
+        {
+            return get_hash(string_view<CharT>{value});
+        }
+
+        constexpr usize operator()(string_view<CharT> value) const
+        {
+            return get_hash(value);
+        }
+    };
+
+    template <typename CharT>
+    struct hash< string<CharT> > : hash< string_view<CharT> >
+    {
+        using hash< string_view<CharT> >::get_hash;
+
+        static constexpr usize get_hash(const string<CharT>& value)
+        {
+            return hash< string_view<CharT> >::get_hash(string_view<CharT>{value});
+        }
+
+        constexpr usize operator()(const string<CharT>& value) const
+        {
+            return get_hash(value);
+        }
+    };
+
+    template <typename T1, typename T2>
+    struct hash< pair<T1, T2> >
+    {
+        static constexpr usize get_hash(const pair<T1, T2>& value)
+        {
+            return wyhash::combine(
+                hash<T1>::get_hash(value.first), hash<T2>::get_hash(value.second)
+            );
+        }
+
+        constexpr usize operator()(const pair<T1, T2>& value) const
+        {
+            return get_hash(value);
+        }
+    };
+
+    template <typename... T>
+    struct hash< tuple<T...> >
+    {
+        static constexpr usize get_hash(const tuple<T...>& value)
+        {
+            return [&]<usize... Ints>(index_sequence<Ints...>)
+            {
+                u64 _seed = hash_detail::secret[0];
+                ((_seed = wyhash::combine(_seed, hash<T>::get_hash(value.template get<Ints>()))), ...);
+                return _seed;
+            }(index_sequence_for<T...>{});
+        }
+
+        constexpr usize operator()(const tuple<T...>& value) const
+        {
+            return get_hash(value);
+        }
+    };
+} // namespace hsd
@@ -0,0 +1,204 @@
+#pragma once
+
+#include <math.h>
+
+#include "_SketchDetail.hpp"
+
+namespace hsd
+{
+    namespace hyperloglog_detail
+    {
+        static constexpr u32 min_precision = 4;
+        static constexpr u32 max_precision = 18;
+
+        // Helper series of Ertl's estimator ("New cardinality estimation
+        // algorithms for HyperLogLog sketches"), summed until they settle
+        static inline f64 sigma(f64 x)
+        {
+            f64 _y = 1;
+            f64 _z = x;
+
+            while (true)
+            {
+                x *= x;
+                f64 _old = _z;
+                _z += x * _y;
+                _y += _y;
+
+                if (_old == _z)
+                    return _z;
+            }
+        }
+
+        static inline f64 tau(f64 x)
+        {
+            if (x == 0 || x == 1)
+                return 0;
+
+            f64 _y = 1;
+            f64 _z = 1 - x;
+
+            while (true)
+            {
+                x = sqrt(x);
+                f64 _old = _z;
+                _y *= 0.5;
+                _z -= (1 - x) * (1 - x) * _y;
+
+                if (_old == _z)
+                    return _z / 3;
+            }
+        }
+    } // namespace hyperloglog_detail
+
+    /// Distinct count estimate in `2^precision` bytes, with a standard
+    /// error of about `1.04 / sqrt(2^precision)`, 0.8% at the default 14.
+    /// The top `precision` bits of a hash pick a register that keeps the
+    /// longest run of leading zeros seen in the rest, so `Hasher` must mix
+    /// into the high bits (the default does). Sketches of the same
+    /// precision merge by taking the larger register
+    template <typename Key, typename Hasher = hash<Key>>
+    class hyperloglog
+    {
+    private:
+        static constexpr char _tag[5] = "HHLL";
+
+        vector<u8> _registers;
+        u32 _precision = 0;
+
+    public:
+        explicit hyperloglog(u32 precision = 14)
+            : _precision{precision}
+        {
+            if (precision < hyperloglog_detail::min_precision || precision > hyperloglog_detail::max_precision)
+                throw std::runtime_error("HyperLogLog precision must be in [4, 18]");
+
+            _registers.resize(usize{1} << precision);
+        }
+
+        template <typename NewKey>
+        void add(const NewKey& key)
+        {
+            add_hashed(static_cast<u64>(Hasher::get_hash(key)));
+        }
+
+        /// `add` with the hash of the key already known
+        void add_hashed(u64 hash)
+        {
+            u64 _rest = hash << _precision;
+            u8 _rank = static_cast<u8>(_rest == 0 ? 65 - _precision : __builtin_clzll(_rest) + 1);
+            u8& _register = _registers[hash >> (64 - _precision)];
+            _register = _rank > _register ? _rank : _register;
+        }
+
+        /// Ertl's improved estimator, accurate from a handful of keys up
+        /// without the bias tables or the switch to linear counting the
+        /// original estimator needs
+        f64 estimate() const
+        {
+            u32 _q = 64 - _precision;
+            usize _counts[66] = {};
+
+            for (usize _index = 0; _index < _registers.size(); _index++)
+                _counts[_registers[_index]]++;
+
+            f64 _m = static_cast<f64>(_registers.size());
+
+            if (_counts[0] == _registers.size())
+                return 0;
+
+            f64 _z = _m * hyperloglog_detail::tau(1 - static_cast<f64>(_counts[_q + 1]) / _m);
+
+            for (u32 _rank = _q; _rank > 0; _rank--)
+                _z = 0.5 * (_z + static_cast<f64>(_counts[_rank]));
+
+            _z += _m * hyperloglog_detail::sigma(static_cast<f64>(_counts[0]) / _m);
+            return 0.5 / M_LN2 * _m * _m / _z;
+        }
+
+        /// Counts the keys of `other` too, it must have the same precision
+        void merge(const hyperloglog& other)
+        {
+            if (other._precision != _precision)
+                throw std::runtime_error("HyperLogLogs of different precisions can't be merged");
+
+            for (usize _index = 0; _index < _registers.size(); _index++)
+            {
+                u8 _other = other._registers[_index];
+                _registers[_index] = _other > _registers[_index] ? _other : _registers[_index];
+            }
+        }
+
+        void clear()
+        {
+            for (auto& _register : _registers)
+                _register = 0;
+        }
+
+        u32 precision() const
+        {
+            return _precision;
+        }
+
+        /// Tag, version, precision and the registers at 6 bits each, so
+        /// 12 KiB at the default precision
+        vector<u8> serialize() const
+        {
+            vector<u8> _bytes;
+            _bytes.reserve(6 + _registers.size() * 3 / 4);
+            sketch_detail::byte_writer _writer{_bytes};
+
+            _writer.put_header(_tag);
+            _writer.put(_precision, 1);
+
+            for (usize _index = 0; _index < _registers.size(); _index += 4)
+            {
+                u64 _packed = 0;
+
+                for (usize _lane = 0; _lane < 4; _lane++)
+                    _packed |= static_cast<u64>(_registers[_index + _lane]) << (_lane * 6);
+
+                _writer.put(_packed, 3);
+            }
+
+            return _bytes;
+        }
+
+        /// Throws `runtime_error` if the buffer isn't a serialized sketch
+        static hyperloglog deserialize(const u8* data, usize size)
+        {
+            sketch_detail::byte_reader _reader{data, size};
+            _reader.get_header(_tag);
+            u32 _precision = static_cast<u32>(_reader.get(1));
+
+            if (_precision < hyperloglog_detail::min_precision || _precision > hyperloglog_detail::max_precision)
+                throw std::runtime_error("HyperLogLog buffer has a bad precision");
+
+            hyperloglog _sketch{_precision};
+            u8 _limit = static_cast<u8>(65 - _precision);
+
+            for (usize _index = 0; _index < _sketch._registers.size(); _index += 4)
+            {
+                u64 _packed = _reader.get(3);
+
+                for (usize _lane = 0; _lane < 4; _lane++)
+                {
+                    u8 _rank = static_cast<u8>((_packed >> (_lane * 6)) & 63);
+
+                    if (_rank > _limit)
+                        throw std::runtime_error("HyperLogLog buffer has a register out of range");
+
+                    _sketch._registers[_index + _lane] = _rank;
+                }
+            }
+
+            _reader.finish();
+            return _sketch;
+        }
+
+        static hyperloglog deserialize(const vector<u8>& bytes)
+        {
+            return deserialize(bytes.cbegin(), bytes.size());
+        }
+    };
+} // namespace hsd
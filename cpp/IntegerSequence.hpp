@@ -22,12 +22,24 @@ namespace hsd
 
     template <usize... Next>
     using index_sequence = integer_sequence<usize, Next...>;
+
+    // The builtins expand the sequence without one instantiation per element
+    #if defined(__has_builtin) && __has_builtin(__make_integer_seq)
+    template <typename T, T Size>
+    using _make_integer_sequence = __make_integer_seq<integer_sequence, T, Size>;
+    #elif defined(HSD_COMPILER_GCC)
+    template <typename T, T Size>
+    using _make_integer_sequence = integer_sequence<T, __integer_pack(Size)...>;
+    #else
+    template <typename T, T Size>
+    using _make_integer_sequence = make_integer_sequence_helper<T, Size>;
+    #endif
     
     template <usize N>
-    using make_index_sequence = make_integer_sequence_helper<usize, N>;
+    using make_index_sequence = _make_integer_sequence<usize, N>;
     
     template <typename T, T Size> requires(Size >= 0)
-    using make_integer_sequence = make_integer_sequence_helper<T, Size>;
+    using make_integer_sequence = _make_integer_sequence<T, Size>;
     
     template <typename... T>
     using index_sequence_for = make_index_sequence<sizeof...(T)>;
@@ -118,8 +118,8 @@ namespace hsd
         static constexpr f64 max = 1.7976931348623157e+308;
         static constexpr bool is_signed = true;
         static constexpr i32 digits = 53;
-        static constexpr i32 digits10 = 6;
-        static constexpr i32 max_digits10 = 15;
+        static constexpr i32 digits10 = 15;
+        static constexpr i32 max_digits10 = 17;
     };
 
     template <>
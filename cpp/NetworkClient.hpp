@@ -1,9 +1,14 @@
 #pragma once
 
 #include "_NetworkDetail.hpp"
+#include "UniquePtr.hpp"
 
 #ifdef HSD_PLATFORM_LINUX
 
+#include <poll.h>
+#include <fcntl.h>
+#include <errno.h>
+
 namespace hsd
 {
     namespace udp
@@ -147,49 +152,17 @@ namespace hsd
                 return {_net_buf, net::received_state::ok};
             }
 
-            template < usize N, typename... Args >
-            net::received_state respond(const char (&fmt)[N], Args&&... args)
+            template < io_detail::string_literal fmt, typename... Args >
+            net::received_state respond(Args&&... args)
             {
-                hsd::vector<hsd::u8string> _fmt_buf = io_detail::split(fmt, N - 1);
-                hsd::vector<hsd::u8string> _args_buf = {
-                    hsd::forward<hsd::u8string>(hsd::u8string::to_string(args))...
-                };
-                hsd::u8string _send_buf;
+                isize _response = net_detail::send_formatted<fmt>(
+                    _sock.get_listening(), _sock.get_hint(), _len, args...
+                );
 
-                if(_args_buf.size() != _fmt_buf.size() && _args_buf.size() + 1 != _fmt_buf.size())
+                if(_response == static_cast<isize>(net::received_state::err))
                 {
-                    throw std::runtime_error("Arguments don\'t match");
-                }
-                else
-                {
-                    usize index = 0;
-
-                    for(; index < _args_buf.size(); index++)
-                    {
-                        _send_buf += _fmt_buf[index] + _args_buf[index];
-                    }
-                    if(_fmt_buf.size() != _args_buf.size())
-                    {
-                        _send_buf += _fmt_buf[index];
-                    }
-
-                    isize _response = 0;
-                    
-                    if(_protocol == net::protocol_type::ipv4)
-                    {
-                        _response = sendto(_sock.get_listening(), _send_buf.data(), 
-                            _send_buf.size(), 0, _sock.get_hint(), _len);
-                    }
-                    else
-                    {
-                        _response = sendto(_sock.get_listening(), _send_buf.data(), 
-                            _send_buf.size(), 0, _sock.get_hint(), _len);
-                    }
-                    if(_response == static_cast<isize>(net::received_state::err))
-                    {
-                        hsd::io::err_print<"Error in sending\n">();
-                        return net::received_state::err;
-                    }
+                    hsd::io::err_print<"Error in sending\n">();
+                    return net::received_state::err;
                 }
 
                 return net::received_state::ok;
@@ -204,33 +177,46 @@ namespace hsd
             class socket
             {
             private:
-                i32 _sock = 0;
-                sockaddr_in6 _hintv6;
-                sockaddr_in _hintv4;
+                i32 _sock = -1;
+                bool _connected = false;
+                sockaddr_in6 _hintv6{};
+                sockaddr_in _hintv4{};
                 net::protocol_type _protocol;
 
-            public:
-                socket(net::protocol_type protocol = net::protocol_type::ipv4, 
-                    u16 port = 54000, const char* ip_addr = "127.0.0.1")
+                bool _connect(sockaddr* addr, socklen_t len, i32 timeout_ms)
                 {
-                    _protocol = protocol;
+                    if(timeout_ms < 0)
+                        return connect(_sock, addr, len) == 0;
 
-                    if(_protocol == net::protocol_type::ipv4)
+                    // Connect in non-blocking mode so a dead endpoint
+                    // can't stall the caller longer than the timeout
+                    i32 _flags = fcntl(_sock, F_GETFL, 0);
+                    fcntl(_sock, F_SETFL, _flags | O_NONBLOCK);
+                    i32 _rez = connect(_sock, addr, len);
+
+                    if(_rez != 0 && errno == EINPROGRESS)
                     {
-                        _sock = ::socket(static_cast<i32>(_protocol), net::socket_type::dgram, 0);
-                        _hintv4.sin_family = static_cast<i32>(_protocol);
-                        _hintv4.sin_port = htons(port);
-                        inet_pton(static_cast<i32>(_protocol), ip_addr, &_hintv4.sin_addr);
-                        connect(_sock, reinterpret_cast<sockaddr*>(&_hintv4), sizeof(_hintv4));
-                    }
-                    else
-                    {
-                        _sock = ::socket(static_cast<i32>(_protocol), net::socket_type::dgram, 0);
-                        _hintv6.sin6_family = static_cast<i32>(_protocol);
-                        _hintv6.sin6_port = htons(port);
-                        inet_pton(static_cast<i32>(_protocol), ip_addr, &_hintv6.sin6_addr);
-                        connect(_sock, reinterpret_cast<sockaddr*>(&_hintv6), sizeof(_hintv6));
+                        pollfd _poll_fd{_sock, POLLOUT, 0};
+                        _rez = -1;
+
+                        if(poll(&_poll_fd, 1, timeout_ms) == 1)
+                        {
+                            i32 _err = 0;
+                            socklen_t _err_len = sizeof(_err);
+                            getsockopt(_sock, SOL_SOCKET, SO_ERROR, &_err, &_err_len);
+                            _rez = (_err == 0) ? 0 : -1;
+                        }
                     }
+
+                    fcntl(_sock, F_SETFL, _flags);
+                    return _rez == 0;
+                }
+
+            public:
+                socket(net::protocol_type protocol = net::protocol_type::ipv4, 
+                    u16 port = 54000, const char* ip_addr = "127.0.0.1", i32 timeout_ms = -1)
+                {
+                    switch_to(protocol, port, ip_addr, timeout_ms);
                 }
 
                 ~socket()
@@ -240,7 +226,11 @@ namespace hsd
 
                 void close()
                 {
-                    ::close(_sock);
+                    if(_sock != -1)
+                        ::close(_sock);
+
+                    _sock = -1;
+                    _connected = false;
                 }
 
                 i32 get_sock()
@@ -248,7 +238,23 @@ namespace hsd
                     return _sock;
                 }
 
-                void switch_to(net::protocol_type protocol, u16 port, const char* ip_addr)
+                bool is_connected()
+                {
+                    return _connected;
+                }
+
+                void set_disconnected()
+                {
+                    _connected = false;
+                }
+
+                bool set_option(i32 level, i32 option, i32 value)
+                {
+                    return setsockopt(_sock, level, option, &value, sizeof(value)) == 0;
+                }
+
+                bool switch_to(net::protocol_type protocol, u16 port, 
+                    const char* ip_addr, i32 timeout_ms = -1)
                 {
                     close();
                     _protocol = protocol;
@@ -259,7 +265,7 @@ namespace hsd
                         _hintv4.sin_family = static_cast<i32>(_protocol);
                         _hintv4.sin_port = htons(port);
                         inet_pton(static_cast<i32>(_protocol), ip_addr, &_hintv4.sin_addr);
-                        connect(_sock, reinterpret_cast<sockaddr*>(&_hintv4), sizeof(_hintv4));
+                        _connected = _connect(reinterpret_cast<sockaddr*>(&_hintv4), sizeof(_hintv4), timeout_ms);
                     }
                     else
                     {
@@ -267,8 +273,64 @@ namespace hsd
                         _hintv6.sin6_family = static_cast<i32>(_protocol);
                         _hintv6.sin6_port = htons(port);
                         inet_pton(static_cast<i32>(_protocol), ip_addr, &_hintv6.sin6_addr);
-                        connect(_sock, reinterpret_cast<sockaddr*>(&_hintv6), sizeof(_hintv6));
+                        _connected = _connect(reinterpret_cast<sockaddr*>(&_hintv6), sizeof(_hintv6), timeout_ms);
+                    }
+
+                    return _connected;
+                }
+            };
+
+            // Growable byte queue used to reassemble frames from the stream
+            class frame_buffer
+            {
+            private:
+                vector<char> _data;
+                usize _begin = 0;
+                usize _end = 0;
+
+            public:
+                char* tail(usize min_free)
+                {
+                    if(_begin != 0 && _data.size() - _end < min_free)
+                    {
+                        memmove(_data.data(), _data.data() + _begin, _end - _begin);
+                        _end -= _begin;
+                        _begin = 0;
                     }
+                    if(_data.size() - _end < min_free)
+                    {
+                        _data.resize(hsd::max(_end + min_free, _data.size() * 2));
+                    }
+
+                    return _data.data() + _end;
+                }
+
+                usize tail_size()
+                {
+                    return _data.size() - _end;
+                }
+
+                void commit(usize size)
+                {
+                    _end += size;
+                }
+
+                const char* head()
+                {
+                    return _data.data() + _begin;
+                }
+
+                usize size()
+                {
+                    return _end - _begin;
+                }
+
+                void consume(usize size)
+                {
+                    _begin += size;
+
+                    if(_begin == _end)
+                        _begin = _end = 0;
                 }
             };
         } // namespace client_detail
@@ -277,80 +339,280 @@ namespace hsd
         {
         private:
             client_detail::socket _sock;
+            client_detail::frame_buffer _frame_buf;
             hsd::u8sstream _net_buf{4095};
+            usize _max_frame = default_max_frame_size;
 
-            void _clear_buf()
+            net::received_state _receive_state(isize response)
             {
-                memset(_net_buf.data(), '\0', 4096);
+                if (response == static_cast<isize>(net::received_state::err))
+                {
+                    hsd::io::err_print<"Error in receiving\n">();
+                    _sock.set_disconnected();
+                    return net::received_state::err;
+                }
+                if (response == static_cast<isize>(net::received_state::disconnected))
+                {
+                    hsd::io::err_print<"Server down\n">();
+                    _sock.set_disconnected();
+                    return net::received_state::disconnected;
+                }
+
+                return net::received_state::ok;
             }
 
         public:
+            static constexpr usize frame_header_size = sizeof(u32);
+            static constexpr usize default_max_frame_size = 16 * 1024 * 1024;
+
             client() = default;
             ~client() = default;
 
-            client(net::protocol_type protocol, u16 port, const char* ip_addr)
-                : _sock{protocol, port, ip_addr}
+            client(net::protocol_type protocol, u16 port, const char* ip_addr, i32 timeout_ms = -1)
+                : _sock{protocol, port, ip_addr, timeout_ms}
             {}
 
+            bool is_connected()
+            {
+                return _sock.is_connected();
+            }
+
+            bool reconnect(const net::endpoint& point, i32 timeout_ms = -1)
+            {
+                _frame_buf.consume(_frame_buf.size());
+                return _sock.switch_to(point.protocol, point.port, point.ip_addr, timeout_ms);
+            }
+
+            // Disables Nagle's algorithm, small pipelined frames go out immediately
+            bool set_no_delay(bool enabled = true)
+            {
+                return _sock.set_option(IPPROTO_TCP, TCP_NODELAY, enabled);
+            }
+
+            bool set_send_buffer(i32 size)
+            {
+                return _sock.set_option(SOL_SOCKET, SO_SNDBUF, size);
+            }
+
+            /// Largest frame `receive_frame` accepts, the length header
+            /// comes from the peer so it bounds what one frame can allocate
+            void set_max_frame_size(usize size)
+            {
+                _max_frame = size;
+            }
+
+            bool set_receive_buffer(i32 size)
+            {
+                return _sock.set_option(SOL_SOCKET, SO_RCVBUF, size);
+            }
+
             hsd::pair< hsd::u8sstream&, net::received_state > receive()
             {
-                _clear_buf();
                 isize _response = recv(_sock.get_sock(), 
-                    _net_buf.data(), 4096, 0);
+                    _net_buf.data(), _net_buf.size(), 0);
 
-                if (_response == static_cast<isize>(net::received_state::err))
+                auto _state = _receive_state(_response);
+
+                if(_state != net::received_state::ok)
                 {
-                    hsd::io::err_print<"Error in receiving\n">();
-                    _clear_buf();
-                    return {_net_buf, net::received_state::err};
+                    _net_buf.reset_data();
+                    return {_net_buf, _state};
                 }
-                if (_response == static_cast<isize>(net::received_state::disconnected))
+
+                _net_buf.data()[_response] = '\0';
+                return {_net_buf, net::received_state::ok};
+            }
+
+            template < io_detail::string_literal fmt, typename... Args >
+            net::received_state respond(Args&&... args)
+            {
+                isize _response = net_detail::send_formatted<fmt>(
+                    _sock.get_sock(), nullptr, 0, args...
+                );
+
+                if(_response == static_cast<isize>(net::received_state::err))
                 {
-                    hsd::io::err_print<"Server down\n">();
-                    _clear_buf();
-                    return {_net_buf, net::received_state::disconnected};
+                    hsd::io::err_print<"Error in sending\n">();
+                    return net::received_state::err;
                 }
 
-                return {_net_buf, net::received_state::ok};
+                return net::received_state::ok;
             }
 
-            template< usize N, typename... Args >
-            net::received_state respond(const char (&fmt)[N], Args&&... args)
+            /// Sends `data` prefixed with its length as a 32-bit big-endian
+            /// integer. Frames may be sent back to back without waiting
+            /// for replies, `receive_frame` splits the replies again.
+            net::received_state send_frame(const char* data, usize size)
             {
-                hsd::vector<hsd::u8string> _fmt_buf = io_detail::split(fmt, N - 1);
-                hsd::vector<hsd::u8string> _args_buf = {
-                    hsd::forward<hsd::u8string>(hsd::u8string::to_string(args))...
+                u32 _header = htonl(static_cast<u32>(size));
+                iovec _iov[2] = {
+                    {&_header, frame_header_size},
+                    {const_cast<char*>(data), size}
                 };
-                hsd::u8string _send_buf;
 
-                if(_args_buf.size() != _fmt_buf.size() && _args_buf.size() + 1 != _fmt_buf.size())
+                if(net_detail::send_all(_sock.get_sock(), _iov, 2) < 0)
                 {
-                    throw std::runtime_error("Arguments don\'t match");
+                    hsd::io::err_print<"Error in sending\n">();
+                    _sock.set_disconnected();
+                    return net::received_state::err;
                 }
-                else
-                {
-                    hsd::usize index = 0;
 
-                    for(; index < _args_buf.size(); index++)
-                    {
-                        _send_buf += _fmt_buf[index] + _args_buf[index];
-                    }
-                    if(_fmt_buf.size() != _args_buf.size())
-                    {
-                        _send_buf += _fmt_buf[index];
-                    }
+                return net::received_state::ok;
+            }
 
-                    isize _response = send(_sock.get_sock(), 
-                        _send_buf.data(), _send_buf.size(), 0);
+            net::received_state send_frame(const u8string& data)
+            {
+                return send_frame(data.c_str(), data.size());
+            }
+
+            /// Returns the next length-prefixed frame, the view stays
+            /// valid until the next call to `receive_frame`
+            hsd::pair< net::frame, net::received_state > receive_frame()
+            {
+                usize _needed = frame_header_size;
 
-                    if(_response == static_cast<isize>(net::received_state::err))
+                while(true)
+                {
+                    if(_frame_buf.size() >= frame_header_size)
                     {
-                        hsd::io::err_print<"Error in sending\n">();
-                        return net::received_state::err;
+                        u32 _header = 0;
+                        memcpy(&_header, _frame_buf.head(), frame_header_size);
+                        usize _length = ntohl(_header);
+
+                        if(_length > _max_frame)
+                        {
+                            hsd::io::err_print<"Frame exceeds the maximum size\n">();
+                            _sock.set_disconnected();
+                            return {net::frame{}, net::received_state::err};
+                        }
+
+                        _needed = frame_header_size + _length;
+
+                        if(_frame_buf.size() >= _needed)
+                        {
+                            net::frame _frame{_frame_buf.head() + frame_header_size, _needed - frame_header_size};
+                            _frame_buf.consume(_needed);
+                            return {_frame, net::received_state::ok};
+                        }
                     }
+
+                    char* _tail = _frame_buf.tail(hsd::max<usize>(_needed - _frame_buf.size(), 4096));
+                    isize _response = recv(_sock.get_sock(), _tail, _frame_buf.tail_size(), 0);
+                    auto _state = _receive_state(_response);
+
+                    if(_state != net::received_state::ok)
+                        return {net::frame{}, _state};
+
+                    _frame_buf.commit(static_cast<usize>(_response));
                 }
+            }
+        };
 
-                return net::received_state::ok;
+        /// Keeps idle connected clients per endpoint so repeated calls
+        /// to the same service reuse a connection instead of reconnecting
+        class client_pool
+        {
+        private:
+            struct entry
+            {
+                net::endpoint point;
+                vector< unique_ptr<client> > idle;
+            };
+
+            vector<entry> _entries;
+            usize _max_idle = 8;
+
+            entry& _get_entry(const net::endpoint& point)
+            {
+                for(auto& _entry : _entries)
+                {
+                    if(_entry.point == point)
+                        return _entry;
+                }
+
+                _entries.emplace_back(point, vector< unique_ptr<client> >{});
+                return _entries.back();
+            }
+
+        public:
+            class lease
+            {
+            private:
+                client_pool* _pool = nullptr;
+                net::endpoint _point;
+                unique_ptr<client> _client;
+
+            public:
+                lease(client_pool* pool, const net::endpoint& point, unique_ptr<client>&& value)
+                    : _pool{pool}, _point{point}, _client{move(value)}
+                {}
+
+                lease(const lease&) = delete;
+
+                lease(lease&& other)
+                    : _pool{other._pool}, _point{other._point}, _client{move(other._client)}
+                {
+                    other._pool = nullptr;
+                }
+
+                ~lease()
+                {
+                    if(_pool != nullptr && _client != nullptr)
+                        _pool->release(_point, move(_client));
+                }
+
+                client* operator->()
+                {
+                    return _client.get();
+                }
+
+                client& operator*()
+                {
+                    return *_client.get();
+                }
+
+                client* get()
+                {
+                    return _client.get();
+                }
+            };
+
+            client_pool() = default;
+
+            client_pool(usize max_idle)
+                : _max_idle{max_idle}
+            {}
+
+            lease acquire(net::protocol_type protocol, u16 port, 
+                const char* ip_addr, i32 timeout_ms = -1)
+            {
+                net::endpoint _point{protocol, port, ip_addr};
+                auto& _idle = _get_entry(_point).idle;
+
+                while(_idle.size() != 0)
+                {
+                    unique_ptr<client> _client = move(_idle.back());
+                    _idle.pop_back();
+
+                    if(_client->is_connected())
+                        return lease{this, _point, move(_client)};
+                }
+
+                return lease{this, _point, make_unique<client>(protocol, port, ip_addr, timeout_ms)};
+            }
+
+            void release(const net::endpoint& point, unique_ptr<client>&& value)
+            {
+                auto& _idle = _get_entry(point).idle;
+
+                // Broken connections are dropped instead of handed out again
+                if(value->is_connected() && _idle.size() < _max_idle)
+                    _idle.emplace_back(move(value));
+            }
+
+            usize idle_count(net::protocol_type protocol, u16 port, const char* ip_addr)
+            {
+                return _get_entry({protocol, port, ip_addr}).idle.size();
             }
         };
     } // namespace tcp
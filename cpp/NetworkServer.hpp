@@ -2,9 +2,14 @@
 
 #include "_NetworkDetail.hpp"
 #include "Io.hpp"
+#include "Thread.hpp"
 
 #ifdef HSD_PLATFORM_LINUX
 
+#include <poll.h>
+#include <errno.h>
+#include <sys/eventfd.h>
+
 namespace hsd
 {
     namespace udp
@@ -90,7 +95,7 @@ namespace hsd
             
             ~server()
             {
-                respond("");
+                respond<"">();
             }
 
             server(net::protocol_type protocol, uint16_t port, const char* ip_addr)
@@ -131,49 +136,25 @@ namespace hsd
                 return {_net_buf, net::received_state::ok};
             }
 
-            template< usize N, typename... Args >
-            net::received_state respond(const char (&fmt)[N], Args&&... args)
+            template < io_detail::string_literal fmt, typename... Args >
+            net::received_state respond(Args&&... args)
             {
-                hsd::vector<hsd::u8string> _fmt_buf = io_detail::split(fmt, N - 1);
-                hsd::vector<hsd::u8string> _args_buf = {
-                    hsd::forward<hsd::u8string>(hsd::u8string::to_string(args))...
-                };
-                hsd::u8string _send_buf;
+                isize _response = 0;
 
-                if(_args_buf.size() != _fmt_buf.size() && _args_buf.size() + 1 != _fmt_buf.size())
+                if(_protocol == net::protocol_type::ipv4)
                 {
-                    throw std::runtime_error("Arguments don\'t match");
+                    _response = net_detail::send_formatted<fmt>(_sock.get_listening(), 
+                        reinterpret_cast<sockaddr*>(&_hintv4), _len, args...);
                 }
                 else
                 {
-                    usize index = 0;
-
-                    for(; index < _args_buf.size(); index++)
-                    {
-                        _send_buf += _fmt_buf[index] + _args_buf[index];
-                    }
-                    if(_fmt_buf.size() != _args_buf.size())
-                    {
-                        _send_buf += _fmt_buf[index];
-                    }
-
-                    isize _response = 0;
-
-                    if(_protocol == net::protocol_type::ipv4)
-                    {
-                        _response = sendto(_sock.get_listening(), _send_buf.data(), 
-                            _send_buf.size(), 0, reinterpret_cast<sockaddr*>(&_hintv4), _len);
-                    }
-                    else
-                    {
-                        _response = sendto(_sock.get_listening(), _send_buf.data(), 
-                            _send_buf.size(), 0, reinterpret_cast<sockaddr*>(&_hintv6), _len);
-                    }
-                    if(_response == static_cast<isize>(net::received_state::err))
-                    {
-                        hsd::io::err_print<"Error in sending\n">();
-                        return net::received_state::err;
-                    }
+                    _response = net_detail::send_formatted<fmt>(_sock.get_listening(), 
+                        reinterpret_cast<sockaddr*>(&_hintv6), _len, args...);
+                }
+                if(_response == static_cast<isize>(net::received_state::err))
+                {
+                    hsd::io::err_print<"Error in sending\n">();
+                    return net::received_state::err;
                 }
 
                 return net::received_state::ok;
@@ -324,6 +305,87 @@ namespace hsd
                     _sock.close();
                 }
             };
+
+            // An accepted socket handed to the handlers of `sharded_server`
+            class connection
+            {
+            private:
+                i32 _sock = -1;
+
+            public:
+                connection(i32 sock)
+                    : _sock{sock}
+                {}
+
+                i32 get_sock()
+                {
+                    return _sock;
+                }
+
+                net::received_state send(const char* data, usize size)
+                {
+                    iovec _iov{const_cast<char*>(data), size};
+
+                    if(net_detail::send_all(_sock, &_iov, 1) < 0)
+                    {
+                        hsd::io::err_print<"Error in sending\n">();
+                        return net::received_state::err;
+                    }
+
+                    return net::received_state::ok;
+                }
+
+                template < io_detail::string_literal fmt, typename... Args >
+                net::received_state respond(Args&&... args)
+                {
+                    isize _response = net_detail::send_formatted<fmt>(_sock, nullptr, 0, args...);
+
+                    if(_response == static_cast<isize>(net::received_state::err))
+                    {
+                        hsd::io::err_print<"Error in sending\n">();
+                        return net::received_state::err;
+                    }
+
+                    return net::received_state::ok;
+                }
+            };
+
+            /// Opens a non-blocking listener with SO_REUSEPORT set, the kernel
+            /// then balances incoming connections between all such listeners
+            static inline i32 open_shared_listener(net::protocol_type protocol, u16 port, const char* ip_addr)
+            {
+                i32 _listening = ::socket(static_cast<i32>(protocol), 
+                    net::socket_type::stream | net::socket_type::no_block | net::socket_type::clo_exec, 0);
+                i32 _enable = 1;
+                i32 _rez = -1;
+
+                setsockopt(_listening, SOL_SOCKET, SO_REUSEADDR, &_enable, sizeof(_enable));
+                setsockopt(_listening, SOL_SOCKET, SO_REUSEPORT, &_enable, sizeof(_enable));
+
+                if(protocol == net::protocol_type::ipv4)
+                {
+                    sockaddr_in _hintv4{};
+                    _hintv4.sin_family = static_cast<i32>(protocol);
+                    _hintv4.sin_port = htons(port);
+                    inet_pton(static_cast<i32>(protocol), ip_addr, &_hintv4.sin_addr);
+                    _rez = bind(_listening, reinterpret_cast<sockaddr*>(&_hintv4), sizeof(_hintv4));
+                }
+                else
+                {
+                    sockaddr_in6 _hintv6{};
+                    _hintv6.sin6_family = static_cast<i32>(protocol);
+                    _hintv6.sin6_port = htons(port);
+                    inet_pton(static_cast<i32>(protocol), ip_addr, &_hintv6.sin6_addr);
+                    _rez = bind(_listening, reinterpret_cast<sockaddr*>(&_hintv6), sizeof(_hintv6));
+                }
+                if(_rez != 0 || listen(_listening, SOMAXCONN) != 0)
+                {
+                    ::close(_listening);
+                    throw std::runtime_error("Cannot open listener");
+                }
+
+                return _listening;
+            }
         } // namespace server_detail
 
         class server
@@ -367,43 +429,169 @@ namespace hsd
                 return {_net_buf, net::received_state::ok};
             }
 
-            template < usize N, typename... Args >
-            net::received_state respond(const char (&fmt)[N], Args&&... args)
+            template < io_detail::string_literal fmt, typename... Args >
+            net::received_state respond(Args&&... args)
             {
-                hsd::vector<hsd::u8string> _fmt_buf = io_detail::split(fmt, N - 1);
-                hsd::vector<hsd::u8string> _args_buf = {
-                    hsd::forward<hsd::u8string>(hsd::u8string::to_string(args))...
-                };
-                hsd::u8string _send_buf;
+                isize _response = net_detail::send_formatted<fmt>(
+                    _sock.get_sock(), nullptr, 0, args...
+                );
 
-                if(_args_buf.size() != _fmt_buf.size() && _args_buf.size() + 1 != _fmt_buf.size())
+                if(_response == static_cast<isize>(net::received_state::err))
                 {
-                    throw std::runtime_error("Arguments don\'t match");
+                    hsd::io::err_print<"Error in sending\n">();
+                    return net::received_state::err;
                 }
-                else
+
+                return net::received_state::ok;
+            }
+        };
+        /// Runs one SO_REUSEPORT listener and poll loop per worker thread.
+        /// `handler(connection&, const char* data, usize size)` is copied
+        /// into every worker and called for each chunk a client sends.
+        class sharded_server
+        {
+        private:
+            vector<thread> _workers;
+            i32 _stop_fd = -1;
+
+            template <typename Handler>
+            static void _run_worker(i32 stop_fd, i32 listening, isize cpu, Handler handler)
+            {
+                if(cpu >= 0)
+                    this_thread::pin_to(static_cast<usize>(cpu));
+
+                // The first two entries are the stop signal and the listener
+                vector<pollfd> _fds;
+                _fds.emplace_back(stop_fd, POLLIN, 0);
+                _fds.emplace_back(listening, POLLIN, 0);
+                char _buf[4096];
+
+                while(true)
                 {
-                    usize index = 0;
+                    if(poll(_fds.data(), _fds.size(), -1) < 0 && errno != EINTR)
+                        break;
+
+                    if(_fds[0].revents != 0)
+                        break;
 
-                    for(; index < _args_buf.size(); index++)
+                    if(_fds[1].revents & POLLIN)
                     {
-                        _send_buf += _fmt_buf[index] + _args_buf[index];
+                        i32 _client = 0;
+
+                        while((_client = accept4(listening, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0)
+                            _fds.emplace_back(_client, POLLIN, 0);
                     }
-                    if(_fmt_buf.size() != _args_buf.size())
+                    for(usize _index = 2; _index < _fds.size();)
                     {
-                        _send_buf += _fmt_buf[index];
+                        if(_fds[_index].revents == 0)
+                        {
+                            _index++;
+                            continue;
+                        }
+
+                        isize _response = recv(_fds[_index].fd, _buf, sizeof(_buf), 0);
+
+                        if(_response > 0)
+                        {
+                            server_detail::connection _conn{_fds[_index].fd};
+                            handler(_conn, static_cast<const char*>(_buf), static_cast<usize>(_response));
+                            _fds[_index].revents = 0;
+                            _index++;
+                        }
+                        else if(_response < 0 && errno == EAGAIN)
+                        {
+                            _index++;
+                        }
+                        else
+                        {
+                            // Disconnected, swap the last socket into this slot
+                            ::close(_fds[_index].fd);
+                            _fds[_index] = _fds.back();
+                            _fds.pop_back();
+                        }
                     }
+                }
 
-                    isize _response = send(_sock.get_sock(), 
-                        _send_buf.data(), _send_buf.size(), 0);
+                for(usize _index = 2; _index < _fds.size(); _index++)
+                    ::close(_fds[_index].fd);
 
-                    if(_response == static_cast<isize>(net::received_state::err))
+                ::close(listening);
+            }
+
+        public:
+            template <typename Handler>
+            sharded_server(net::protocol_type protocol, u16 port, const char* ip_addr, 
+                Handler&& handler, usize workers = 0, bool pin_workers = true)
+            {
+                usize _cpu_count = thread::hardware_concurrency();
+
+                if(workers == 0)
+                    workers = _cpu_count != 0 ? _cpu_count : 1;
+
+                _stop_fd = eventfd(0, EFD_CLOEXEC);
+
+                if(_stop_fd == -1)
+                    throw std::runtime_error("Cannot create the stop eventfd");
+
+                _workers.reserve(workers);
+
+                // The destructor doesn't run for a half built server, so the
+                // workers already started are stopped here before rethrowing
+                try
+                {
+                    for(usize _index = 0; _index < workers; _index++)
                     {
-                        hsd::io::err_print<"Error in sending\n">();
-                        return net::received_state::err;
+                        i32 _listening = server_detail::open_shared_listener(protocol, port, ip_addr);
+                        isize _cpu = (pin_workers && _cpu_count != 0) ? 
+                            static_cast<isize>(_index % _cpu_count) : -1;
+
+                        try
+                        {
+                            _workers.emplace_back(
+                                _run_worker<decay_t<Handler>>, _stop_fd, _listening, _cpu, handler
+                            );
+                        }
+                        catch(...)
+                        {
+                            ::close(_listening);
+                            throw;
+                        }
                     }
                 }
+                catch(...)
+                {
+                    stop();
+                    throw;
+                }
+            }
 
-                return net::received_state::ok;
+            sharded_server(const sharded_server&) = delete;
+
+            ~sharded_server()
+            {
+                stop();
+            }
+
+            // Wakes every worker through the shared eventfd and waits for them
+            void stop()
+            {
+                if(_stop_fd == -1)
+                    return;
+
+                u64 _signal = 1;
+                write(_stop_fd, &_signal, sizeof(_signal));
+
+                for(auto& _worker : _workers)
+                    _worker.join();
+
+                _workers.clear();
+                ::close(_stop_fd);
+                _stop_fd = -1;
+            }
+
+            usize worker_count()
+            {
+                return _workers.size();
             }
         };
     } // namespace tcp
@@ -0,0 +1,443 @@
+#pragma once
+
+#include <stdexcept>
+
+#include "Vector.hpp"
+#include "Functional.hpp"
+#include "Limits.hpp"
+
+namespace hsd
+{
+    /// Binary heap over `hsd::vector`. Like `std::priority_queue`, `top()`
+    /// is the greatest element under `Compare`, so `greater` gives a min heap
+    template <typename T, typename Compare = less>
+    class priority_queue
+    {
+    private:
+        vector<T> _data;
+        Compare _comp;
+
+        void _sift_up(usize index, T value)
+        {
+            while (index > 0)
+            {
+                usize _parent = (index - 1) / 2;
+
+                if (!_comp(_data[_parent], value))
+                    break;
+
+                _data[index] = hsd::move(_data[_parent]);
+                index = _parent;
+            }
+
+            _data[index] = hsd::move(value);
+        }
+
+        void _sift_down(usize index, T value)
+        {
+            usize _size = _data.size();
+
+            for (usize _child; (_child = 2 * index + 1) < _size; index = _child)
+            {
+                if (_child + 1 < _size && _comp(_data[_child], _data[_child + 1]))
+                    _child++;
+                if (!_comp(value, _data[_child]))
+                    break;
+
+                _data[index] = hsd::move(_data[_child]);
+            }
+
+            _data[index] = hsd::move(value);
+        }
+
+        // Floyd's pop: the replacement almost always belongs near the
+        // bottom, so walk the hole down to a leaf without comparing against
+        // it and then sift it back up, which saves a compare per level
+        void _pop_hole(T value)
+        {
+            usize _size = _data.size();
+            usize _index = 0;
+
+            for (usize _child; (_child = 2 * _index + 1) < _size; _index = _child)
+            {
+                if (_child + 1 < _size && _comp(_data[_child], _data[_child + 1]))
+                    _child++;
+
+                _data[_index] = hsd::move(_data[_child]);
+            }
+
+            _sift_up(_index, hsd::move(value));
+        }
+
+        void _make_heap()
+        {
+            for (usize _index = _data.size() / 2; _index-- > 0;)
+                _sift_down(_index, hsd::move(_data[_index]));
+        }
+
+    public:
+        priority_queue() = default;
+
+        explicit priority_queue(const Compare& comp)
+            : _comp{comp}
+        {}
+
+        /// Heapifies the whole range at once, O(n) rather than O(n log n)
+        template <typename It>
+        priority_queue(It first, It last, const Compare& comp = {})
+            : _comp{comp}
+        {
+            for (; first != last; ++first)
+                _data.emplace_back(*first);
+
+            _make_heap();
+        }
+
+        priority_queue(std::initializer_list<T> list, const Compare& comp = {})
+            : priority_queue(list.begin(), list.end(), comp)
+        {}
+
+        const T& top() const
+        {
+            return _data[0];
+        }
+
+        void push(const T& value)
+        {
+            emplace(value);
+        }
+
+        void push(T&& value)
+        {
+            emplace(hsd::move(value));
+        }
+
+        template <typename... Args>
+        void emplace(Args&&... args)
+        {
+            T _value(hsd::forward<Args>(args)...);
+            _data.emplace_back(hsd::move(_value));
+            _sift_up(_data.size() - 1, hsd::move(_data.back()));
+        }
+
+        /// Adds a batch and reheapifies once when it outweighs the heap
+        template <typename It>
+        void push_range(It first, It last)
+        {
+            usize _old_size = _data.size();
+
+            for (; first != last; ++first)
+                _data.emplace_back(*first);
+
+            if (_data.size() - _old_size > _old_size)
+            {
+                _make_heap();
+            }
+            else
+            {
+                for (usize _index = _old_size; _index < _data.size(); ++_index)
+                    _sift_up(_index, hsd::move(_data[_index]));
+            }
+        }
+
+        void pop()
+        {
+            if (_data.size() > 1)
+            {
+                T _last = hsd::move(_data.back());
+                _data.pop_back();
+                _pop_hole(hsd::move(_last));
+            }
+            else
+            {
+                _data.pop_back();
+            }
+        }
+
+        void reserve(usize capacity)
+        {
+            _data.reserve(capacity);
+        }
+
+        void clear()
+        {
+            _data.clear();
+        }
+
+        usize size() const
+        {
+            return _data.size();
+        }
+
+        bool empty() const
+        {
+            return _data.size() == 0;
+        }
+    };
+
+    /// Min heap of arity `Arity` (4 by default) that hands out a handle per
+    /// element, so an element can be re-keyed or erased in O(log n) without
+    /// searching for it. `top()` is the least element under `Compare`. A
+    /// handle stays valid until its element is popped or erased, and is
+    /// reused by later pushes after that
+    template <typename T, typename Compare = less, usize Arity = 4>
+    class indexed_heap
+    {
+    private:
+        static_assert(Arity >= 2, "indexed_heap needs at least two children per node");
+
+    public:
+        using handle_type = u32;
+        static constexpr handle_type npos = limits<handle_type>::max;
+
+    private:
+        // Heap order, values and their handles kept side by side so the
+        // child scans only read the values
+        vector<T> _values;
+        vector<handle_type> _handles;
+        // Handle -> heap position, `npos` for handles that are free
+        vector<handle_type> _positions;
+        vector<handle_type> _free;
+        Compare _comp;
+
+        void _place(usize index, T&& value, handle_type handle)
+        {
+            _values[index] = hsd::move(value);
+            _handles[index] = handle;
+            _positions[handle] = static_cast<handle_type>(index);
+        }
+
+        void _move_slot(usize to, usize from)
+        {
+            _place(to, hsd::move(_values[from]), _handles[from]);
+        }
+
+        void _sift_up(usize index, T value, handle_type handle)
+        {
+            while (index > 0)
+            {
+                usize _parent = (index - 1) / Arity;
+
+                if (!_comp(value, _values[_parent]))
+                    break;
+
+                _move_slot(index, _parent);
+                index = _parent;
+            }
+
+            _place(index, hsd::move(value), handle);
+        }
+
+        void _sift_down(usize index, T value, handle_type handle)
+        {
+            usize _size = _values.size();
+
+            while (true)
+            {
+                usize _first = index * Arity + 1;
+
+                if (_first >= _size)
+                    break;
+
+                usize _last = _first + Arity < _size ? _first + Arity : _size;
+                usize _best = _first;
+
+                for (usize _child = _first + 1; _child < _last; ++_child)
+                {
+                    if (_comp(_values[_child], _values[_best]))
+                        _best = _child;
+                }
+
+                if (!_comp(_values[_best], value))
+                    break;
+
+                _move_slot(index, _best);
+                index = _best;
+            }
+
+            _place(index, hsd::move(value), handle);
+        }
+
+        // Puts `value` at `index`, moving it whichever way the heap needs
+        void _reseat(usize index, T value, handle_type handle)
+        {
+            if (index > 0 && _comp(value, _values[(index - 1) / Arity]))
+                _sift_up(index, hsd::move(value), handle);
+            else
+                _sift_down(index, hsd::move(value), handle);
+        }
+
+        // Takes the element at `index` out, filling the gap with the last one
+        void _remove_at(usize index)
+        {
+            handle_type _handle = _handles[index];
+            _positions[_handle] = npos;
+            _free.push_back(_handle);
+
+            usize _last = _values.size() - 1;
+
+            if (index != _last)
+            {
+                T _value = hsd::move(_values[_last]);
+                handle_type _moved = _handles[_last];
+                _values.pop_back();
+                _handles.pop_back();
+                _reseat(index, hsd::move(_value), _moved);
+            }
+            else
+            {
+                _values.pop_back();
+                _handles.pop_back();
+            }
+        }
+
+        usize _position_of(handle_type handle) const
+        {
+            if (!contains(handle))
+                throw std::out_of_range("indexed_heap handle is not in the heap");
+
+            return _positions[handle];
+        }
+
+        handle_type _new_handle()
+        {
+            if (_free.size() != 0)
+            {
+                handle_type _handle = _free.back();
+                _free.pop_back();
+                return _handle;
+            }
+
+            _positions.push_back(npos);
+            return static_cast<handle_type>(_positions.size() - 1);
+        }
+
+    public:
+        indexed_heap() = default;
+
+        explicit indexed_heap(const Compare& comp)
+            : _comp{comp}
+        {}
+
+        /// Replaces the contents with the range in O(n). The elements get
+        /// the handles 0, 1, 2... in range order
+        template <typename It>
+        void assign(It first, It last)
+        {
+            clear();
+            _free.clear();
+            _positions.clear();
+
+            for (handle_type _handle = 0; first != last; ++first, ++_handle)
+            {
+                _values.emplace_back(*first);
+                _handles.push_back(_handle);
+                _positions.push_back(_handle);
+            }
+
+            if (_values.size() < 2)
+                return;
+
+            for (usize _index = (_values.size() - 2) / Arity + 1; _index-- > 0;)
+                _sift_down(_index, hsd::move(_values[_index]), _handles[_index]);
+        }
+
+        const T& top() const
+        {
+            return _values[0];
+        }
+
+        handle_type top_handle() const
+        {
+            return _handles[0];
+        }
+
+        template <typename... Args>
+        handle_type emplace(Args&&... args)
+        {
+            handle_type _handle = _new_handle();
+            _values.emplace_back(hsd::forward<Args>(args)...);
+            _handles.push_back(_handle);
+            usize _index = _values.size() - 1;
+            _sift_up(_index, hsd::move(_values[_index]), _handle);
+            return _handle;
+        }
+
+        handle_type push(const T& value)
+        {
+            return emplace(value);
+        }
+
+        handle_type push(T&& value)
+        {
+            return emplace(hsd::move(value));
+        }
+
+        void pop()
+        {
+            _remove_at(0);
+        }
+
+        /// Lowers the element's key, so it can only move towards the top
+        void decrease_key(handle_type handle, T value)
+        {
+            usize _index = _position_of(handle);
+
+            if (_comp(_values[_index], value))
+                throw std::runtime_error("decrease_key got a greater key");
+
+            _sift_up(_index, hsd::move(value), handle);
+        }
+
+        /// Changes the element's key in either direction
+        void update(handle_type handle, T value)
+        {
+            _reseat(_position_of(handle), hsd::move(value), handle);
+        }
+
+        void erase(handle_type handle)
+        {
+            _remove_at(_position_of(handle));
+        }
+
+        const T& operator[](handle_type handle) const
+        {
+            return _values[_position_of(handle)];
+        }
+
+        bool contains(handle_type handle) const
+        {
+            return handle < _positions.size() && _positions[handle] != npos;
+        }
+
+        void reserve(usize capacity)
+        {
+            _values.reserve(capacity);
+            _handles.reserve(capacity);
+            _positions.reserve(capacity);
+        }
+
+        /// Empties the heap, every handle goes back to the free list
+        void clear()
+        {
+            for (usize _index = 0; _index < _handles.size(); ++_index)
+            {
+                _positions[_handles[_index]] = npos;
+                _free.push_back(_handles[_index]);
+            }
+
+            _values.clear();
+            _handles.clear();
+        }
+
+        usize size() const
+        {
+            return _values.size();
+        }
+
+        bool empty() const
+        {
+            return _values.size() == 0;
+        }
+    };
+} // namespace hsd
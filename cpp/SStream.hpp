@@ -11,16 +11,30 @@ namespace hsd
     private:
         CharT* _data = nullptr;
         usize _size = 0;
-		usize _current_pos = 0;
+        usize _current_pos = 0;
+        usize _length = 0;
+
+        void _grow(usize min_size)
+        {
+            usize _new_size = hsd::max(_size * 2, min_size);
+            CharT* _new_buf = new CharT[_new_size + 1];
+            copy_n(_data, _size + 1, _new_buf);
+            _new_buf[_new_size] = '\0';
+
+            delete[] _data;
+            _data = _new_buf;
+            _size = _new_size;
+        }
 
     public:
-		using iterator = CharT*;
+        using iterator = CharT*;
         using const_iterator = const CharT*;
         sstream(const sstream& other) = delete;
 
         sstream(usize size)
         {
             _data = new CharT[size + 1];
+            _data[0] = '\0';
             _data[size] = '\0';
             _size = size;
         }
@@ -30,44 +44,172 @@ namespace hsd
             delete[] _data;
         }
 
-		template <typename... Args>
-		void set_data(Args&... args)
-		{
-            auto _data_set = sstream_detail::split(_data, _size);
+        /// Reads `args` in order from the start of the buffer, throws if
+        /// the buffer runs out of values or one of them is malformed
+        template <typename... Args>
+        void set_data(Args&... args)
+        {
+            _current_pos = 0;
 
-            if(sizeof...(Args) > _data_set.size())
+            if(!(read(args) && ...))
             {
-                throw std::runtime_error("Input too small");
+                if(eof())
+                    throw std::runtime_error("Input too small");
+
+                throw std::runtime_error("Invalid input");
             }
-            else if(sizeof...(Args) < _data_set.size())
+        }
+
+        /// Reads the next whitespace separated value at the read cursor
+        /// and moves the cursor past it. Arithmetic values and strings
+        /// are scanned in place, other types get the token through a
+        /// `_parse(string<CharT>&, T&)` overload.
+        template <typename T>
+        bool read(T& value)
+        {
+            const CharT* _begin = sstream_detail::skip_space(_data + _current_pos);
+            const CharT* _end = nullptr;
+
+            if(*_begin == '\0')
+                return false;
+
+            if constexpr(sstream_detail::scannable<T>)
             {
-                fprintf(stderr, "Warning");
+                _end = sstream_detail::_scan(_begin, value);
+
+                if(_end == nullptr)
+                    return false;
             }
             else
             {
-                [&]<usize... Ints>(index_sequence<Ints...>)
-                {
-                    (sstream_detail::_parse(_data_set[Ints], args), ...);
-                }(make_index_sequence<sizeof...(Args)>{});
+                using sstream_detail::_parse;
+                _end = sstream_detail::token_end(_begin);
+                string<CharT> _str(_begin, static_cast<usize>(_end - _begin));
+                _parse(_str, value);
             }
-		}
+
+            _current_pos = static_cast<usize>(_end - _data);
+            return true;
+        }
 
         template <typename T>
         T parse()
         {
             T _value{};
-            using sstream_detail::_parse;
-            string<CharT> _str = move(to_string());
-            _parse(_str, _value);
+
+            if constexpr(sstream_detail::scannable<T>)
+            {
+                sstream_detail::_scan(sstream_detail::skip_space(_data), _value);
+            }
+            else
+            {
+                using sstream_detail::_parse;
+                string<CharT> _str = move(to_string());
+                _parse(_str, _value);
+            }
+
             return _value;
         }
 
+        bool eof()
+        {
+            return *sstream_detail::skip_space(_data + _current_pos) == '\0';
+        }
+
+        usize tell()
+        {
+            return _current_pos;
+        }
+
+        void seek(usize pos)
+        {
+            _current_pos = hsd::min(pos, _size);
+        }
+
+        // Makes sure `size` characters fit, growing geometrically
+        void reserve(usize size)
+        {
+            if(size > _size)
+                _grow(size);
+        }
+
+        /// Appends after the data written by the previous appends
+        /// (or from the beginning after `reset_data`)
+        sstream& append(const CharT* str, usize len)
+        {
+            // Picks up data that was written straight into `data()`
+            if(_length == 0)
+                _length = cstring<CharT>::length(_data);
+
+            if(_length + len > _size)
+                _grow(_length + len);
+
+            copy_n(str, len, _data + _length);
+            _length += len;
+            _data[_length] = '\0';
+            return *this;
+        }
+
+        sstream& append(const CharT* str)
+        {
+            return append(str, cstring<CharT>::length(str));
+        }
+
+        sstream& append(const string<CharT>& str)
+        {
+            return append(str.c_str(), str.size());
+        }
+
+        template <typename T>
+        sstream& write(T value)
+        {
+            if constexpr(is_same<T, CharT>::value)
+            {
+                return append(&value, 1);
+            }
+            else if constexpr(std::is_integral_v<T>)
+            {
+                CharT _buf[48];
+                CharT* _end = _buf + 48;
+                CharT* _begin = sstream_detail::_format(_end, value);
+                return append(_begin, static_cast<usize>(_end - _begin));
+            }
+            else if constexpr(std::is_floating_point_v<T>)
+            {
+                char _buf[64];
+                CharT _wide_buf[64];
+                // Enough digits to read back the same value
+                i32 _len = snprintf(_buf, sizeof(_buf), "%.*Lg", limits<T>::max_digits10, static_cast<f128>(value));
+                _len = hsd::min(_len, static_cast<i32>(sizeof(_buf) - 1));
+                copy_n(_buf, static_cast<usize>(_len), _wide_buf);
+                return append(_wide_buf, static_cast<usize>(_len));
+            }
+            else
+            {
+                return append(value);
+            }
+        }
+
+        /// Drops the characters before the read cursor so a long lived
+        /// stream can keep appending without growing without bound
+        void compact()
+        {
+            usize _rest = cstring<CharT>::length(_data + _current_pos);
+
+            for(usize _index = 0; _index < _rest; _index++)
+                _data[_index] = _data[_current_pos + _index];
+
+            _data[_rest] = '\0';
+            _length = _rest;
+            _current_pos = 0;
+        }
+
         string<CharT> to_string()
         {
             return string<CharT>(_data);
         }
 
-		void pop_back()
+        void pop_back()
         {
             _data[--_size] = '\0';
         }
@@ -80,12 +222,15 @@ namespace hsd
             _data = new CharT[1];
             _data[0] = '\0';
             _size = 0;
+            _current_pos = 0;
+            _length = 0;
         }
 
         void reset_data()
         {
             _data[0] = '\0';
             _current_pos = 0;
+            _length = 0;
         }
 
         usize size()
@@ -154,7 +299,7 @@ namespace hsd
         }
     };
     
-	using wsstream = sstream<wchar>;
+    using wsstream = sstream<wchar>;
     using u8sstream = sstream<char>;
     using u16sstream = sstream<char16>;
     using u32sstream = sstream<char32>;
@@ -0,0 +1,645 @@
+#pragma once
+
+#include "Vector.hpp"
+#include "IntegerSequence.hpp"
+
+// Vector values only pass between functions that are all inlined into
+// one target-specific trampoline, the ABI note doesn't apply
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+namespace hsd
+{
+    namespace simd
+    {
+        enum class level : u8
+        {
+            scalar,
+            sse,
+            avx2,
+            avx512
+        };
+
+        /// Portable fixed width register of `T` built on the compiler's
+        /// vector extensions: the same code becomes SSE, AVX2 or AVX-512
+        /// depending on the target of the function it is inlined into.
+        /// `Bytes == sizeof(T)` is a single lane, the scalar fallback
+        template < typename T, usize Bytes >
+        struct batch
+        {
+            typedef T native __attribute__((vector_size(Bytes)));
+            static constexpr usize lanes = Bytes / sizeof(T);
+
+            native value;
+
+            static batch load(const T* ptr)
+            {
+                batch _result;
+                __builtin_memcpy(&_result.value, ptr, sizeof(native));
+                return _result;
+            }
+
+            static batch broadcast(T scalar)
+            {
+                return {native{} + scalar};
+            }
+
+            static batch zero()
+            {
+                return {native{}};
+            }
+
+            void store(T* ptr) const
+            {
+                __builtin_memcpy(ptr, &value, sizeof(native));
+            }
+
+            T operator[](usize index) const
+            {
+                return value[index];
+            }
+
+            friend batch operator+(const batch& lhs, const batch& rhs)
+            {
+                return {lhs.value + rhs.value};
+            }
+
+            friend batch operator-(const batch& lhs, const batch& rhs)
+            {
+                return {lhs.value - rhs.value};
+            }
+
+            friend batch operator*(const batch& lhs, const batch& rhs)
+            {
+                return {lhs.value * rhs.value};
+            }
+
+            friend batch operator/(const batch& lhs, const batch& rhs)
+            {
+                return {lhs.value / rhs.value};
+            }
+
+            batch& operator+=(const batch& rhs)
+            {
+                value += rhs.value;
+                return *this;
+            }
+
+            friend batch min(const batch& lhs, const batch& rhs)
+            {
+                return {lhs.value < rhs.value ? lhs.value : rhs.value};
+            }
+
+            friend batch max(const batch& lhs, const batch& rhs)
+            {
+                return {lhs.value > rhs.value ? lhs.value : rhs.value};
+            }
+
+            /// Moves every lane `Shift` places up, zeros come in at the bottom
+            template < usize Shift >
+            batch shift_up() const
+            {
+                if constexpr(lanes == 1)
+                {
+                    return Shift == 0 ? *this : zero();
+                }
+                else
+                {
+                    return [this]<usize... Ints>(index_sequence<Ints...>) -> batch {
+                        return {__builtin_shufflevector(value, native{},
+                            (Ints >= Shift ? Ints - Shift : lanes)...)};
+                    }(make_index_sequence<lanes>{});
+                }
+            }
+
+            T reduce_add() const
+            {
+                T _sum = value[0];
+
+                for(usize _index = 1; _index < lanes; _index++)
+                    _sum += value[_index];
+
+                return _sum;
+            }
+
+            T reduce_min() const
+            {
+                T _result = value[0];
+
+                for(usize _index = 1; _index < lanes; _index++)
+                    _result = value[_index] < _result ? value[_index] : _result;
+
+                return _result;
+            }
+
+            T reduce_max() const
+            {
+                T _result = value[0];
+
+                for(usize _index = 1; _index < lanes; _index++)
+                    _result = value[_index] > _result ? value[_index] : _result;
+
+                return _result;
+            }
+        };
+    } // namespace simd
+
+    namespace simd_detail
+    {
+        static inline simd::level detect()
+        {
+            #if defined(__x86_64__) || defined(__i386__)
+            __builtin_cpu_init();
+
+            // Every CPU of these levels also has popcnt, and BMI from AVX2 on,
+            // the bit kernels count on them for hardware popcount and tzcnt
+            bool _popcnt = __builtin_cpu_supports("popcnt");
+            bool _bmi = _popcnt && __builtin_cpu_supports("bmi") && __builtin_cpu_supports("bmi2");
+
+            if(__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq") &&
+                __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512vl") && _bmi)
+                return simd::level::avx512;
+            if(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") && _bmi)
+                return simd::level::avx2;
+            if(__builtin_cpu_supports("sse4.2") && _popcnt)
+                return simd::level::sse;
+            #endif
+
+            return simd::level::scalar;
+        }
+
+        static inline simd::level& current()
+        {
+            static simd::level _level = detect();
+            return _level;
+        }
+
+        // One trampoline per level: `flatten` inlines the whole kernel
+        // into it, so the kernel is compiled for that level's target
+        template < typename Kernel, typename T, typename... Args >
+        [[gnu::flatten]] static auto run_scalar(Args... args)
+        {
+            return Kernel::template run<simd::batch<T, sizeof(T)>>(args...);
+        }
+
+        #if defined(__x86_64__) || defined(__i386__)
+        template < typename Kernel, typename T, typename... Args >
+        [[gnu::flatten, gnu::target("sse4.2,popcnt")]] static auto run_sse(Args... args)
+        {
+            return Kernel::template run<simd::batch<T, 16>>(args...);
+        }
+
+        template < typename Kernel, typename T, typename... Args >
+        [[gnu::flatten, gnu::target("avx2,fma,popcnt,bmi,bmi2")]] static auto run_avx2(Args... args)
+        {
+            return Kernel::template run<simd::batch<T, 32>>(args...);
+        }
+
+        template < typename Kernel, typename T, typename... Args >
+        [[gnu::flatten, gnu::target("avx512f,avx512dq,avx512bw,avx512vl,popcnt,bmi,bmi2")]] static auto run_avx512(Args... args)
+        {
+            return Kernel::template run<simd::batch<T, 64>>(args...);
+        }
+        #endif
+
+        template < typename T >
+        static constexpr bool supported = is_same<T, f32>::value || is_same<T, f64>::value ||
+            is_same<T, i32>::value || is_same<T, i64>::value;
+
+        struct sum_kernel
+        {
+            // Four accumulators hide the latency of the adds
+            template < typename B, typename T >
+            static T run(const T* data, usize size)
+            {
+                constexpr usize _lanes = B::lanes;
+                B _acc0 = B::zero(), _acc1 = B::zero(), _acc2 = B::zero(), _acc3 = B::zero();
+                usize _index = 0;
+                // Whole blocks end here, bounding the scalar tail by a block
+                // lets the compiler see the tail loop can't run away
+                usize _end = size - size % _lanes;
+
+                for(; _end - _index >= 4 * _lanes; _index += 4 * _lanes)
+                {
+                    _acc0 += B::load(data + _index);
+                    _acc1 += B::load(data + _index + _lanes);
+                    _acc2 += B::load(data + _index + 2 * _lanes);
+                    _acc3 += B::load(data + _index + 3 * _lanes);
+                }
+                for(; _index != _end; _index += _lanes)
+                    _acc0 += B::load(data + _index);
+
+                T _sum = ((_acc0 + _acc1) + (_acc2 + _acc3)).reduce_add();
+
+                for(; _index < size; _index++)
+                    _sum += data[_index];
+
+                return _sum;
+            }
+        };
+
+        struct dot_kernel
+        {
+            template < typename B, typename T >
+            static T run(const T* lhs, const T* rhs, usize size)
+            {
+                constexpr usize _lanes = B::lanes;
+                B _acc0 = B::zero(), _acc1 = B::zero(), _acc2 = B::zero(), _acc3 = B::zero();
+                usize _index = 0;
+                usize _end = size - size % _lanes;
+
+                for(; _end - _index >= 4 * _lanes; _index += 4 * _lanes)
+                {
+                    _acc0 += B::load(lhs + _index) * B::load(rhs + _index);
+                    _acc1 += B::load(lhs + _index + _lanes) * B::load(rhs + _index + _lanes);
+                    _acc2 += B::load(lhs + _index + 2 * _lanes) * B::load(rhs + _index + 2 * _lanes);
+                    _acc3 += B::load(lhs + _index + 3 * _lanes) * B::load(rhs + _index + 3 * _lanes);
+                }
+                for(; _index != _end; _index += _lanes)
+                    _acc0 += B::load(lhs + _index) * B::load(rhs + _index);
+
+                T _sum = ((_acc0 + _acc1) + (_acc2 + _acc3)).reduce_add();
+
+                for(; _index < size; _index++)
+                    _sum += lhs[_index] * rhs[_index];
+
+                return _sum;
+            }
+        };
+
+        template < bool Max >
+        struct extremum_kernel
+        {
+            template < typename B, typename T >
+            static T run(const T* data, usize size)
+            {
+                constexpr usize _lanes = B::lanes;
+                auto _pick = [](const auto& lhs, const auto& rhs) { return Max ? max(lhs, rhs) : min(lhs, rhs); };
+                T _result = data[0];
+                usize _index = 0;
+
+                if(size >= 2 * _lanes)
+                {
+                    B _acc0 = B::load(data), _acc1 = B::load(data + _lanes);
+                    usize _end = size - size % (2 * _lanes);
+
+                    for(_index = 2 * _lanes; _index != _end; _index += 2 * _lanes)
+                    {
+                        _acc0 = _pick(_acc0, B::load(data + _index));
+                        _acc1 = _pick(_acc1, B::load(data + _index + _lanes));
+                    }
+
+                    B _acc = _pick(_acc0, _acc1);
+                    _result = Max ? _acc.reduce_max() : _acc.reduce_min();
+                }
+                for(; _index < size; _index++)
+                    _result = (Max ? data[_index] > _result : data[_index] < _result) ? data[_index] : _result;
+
+                return _result;
+            }
+        };
+
+        struct axpy_kernel
+        {
+            template < typename B, typename T >
+            static void run(T alpha, const T* x, T* y, usize size)
+            {
+                constexpr usize _lanes = B::lanes;
+                B _alpha = B::broadcast(alpha);
+                usize _index = 0;
+                usize _end = size - size % _lanes;
+
+                for(; _index != _end; _index += _lanes)
+                    (_alpha * B::load(x + _index) + B::load(y + _index)).store(y + _index);
+
+                for(; _index < size; _index++)
+                    y[_index] = alpha * x[_index] + y[_index];
+            }
+        };
+
+        /// In-register scan: log2(lanes) shifted adds turn a block into its
+        /// prefix sums, then the running total of earlier blocks is added
+        struct prefix_sum_kernel
+        {
+            template < typename B, usize Shift = 1 >
+            static B scan(const B& block)
+            {
+                if constexpr(Shift >= B::lanes)
+                    return block;
+                else
+                    return scan<B, Shift * 2>(block + block.template shift_up<Shift>());
+            }
+
+            template < typename B, typename T >
+            static void run(const T* data, T* out, usize size)
+            {
+                constexpr usize _lanes = B::lanes;
+                B _carry = B::zero();
+                usize _index = 0;
+                usize _end = size - size % _lanes;
+
+                for(; _index != _end; _index += _lanes)
+                {
+                    B _block = scan(B::load(data + _index)) + _carry;
+                    _block.store(out + _index);
+                    _carry = B::broadcast(_block[_lanes - 1]);
+                }
+
+                T _total = _carry[0];
+
+                for(; _index < size; _index++)
+                    out[_index] = (_total += data[_index]);
+            }
+        };
+
+        /// Bin indices are computed a register at a time, the counts go to
+        /// four interleaved sub-histograms so consecutive equal values don't
+        /// wait on each other's increment
+        struct histogram_kernel
+        {
+            static constexpr usize _ways = 4;
+            static constexpr usize _block = 256;
+
+            template < typename B, typename T >
+            static void run(const T* data, usize size, T low, T high, usize* bins, usize bin_count)
+            {
+                using real = typename conditional<is_same<T, f32>::value, f32, f64>::type;
+                using index_type = typename conditional<is_same<T, f32>::value, i32, i64>::type;
+                // Capped at 256 bit: the counting is the bottleneck, and
+                // reading lanes back from a fresh 512 bit store stalls
+                constexpr usize _lanes = B::lanes * sizeof(T) > 32 ? 32 / sizeof(T) : B::lanes;
+                using value_batch = simd::batch<T, _lanes * sizeof(T)>;
+                using real_batch = simd::batch<real, _lanes * sizeof(real)>;
+                using index_batch = simd::batch<index_type, _lanes * sizeof(index_type)>;
+
+                vector<usize> _counts(_ways * (bin_count + 1));
+                usize* _way0 = _counts.data();
+                usize* _way1 = _way0 + (bin_count + 1);
+                usize* _way2 = _way1 + (bin_count + 1);
+                usize* _way3 = _way2 + (bin_count + 1);
+                index_type _indices[_block];
+                real _low = static_cast<real>(low);
+                real _scale = static_cast<real>(bin_count) / (static_cast<real>(high) - _low);
+                real_batch _low_v = real_batch::broadcast(_low);
+                real_batch _scale_v = real_batch::broadcast(_scale);
+                real_batch _bins_v = real_batch::broadcast(static_cast<real>(bin_count));
+                usize _index = 0;
+                usize _end = size - size % _block;
+
+                for(; _index != _end; _index += _block)
+                {
+                    for(usize _lane = 0; _lane < _block; _lane += _lanes)
+                    {
+                        real_batch _pos{__builtin_convertvector(value_batch::load(data + _index + _lane).value,
+                            typename real_batch::native)};
+                        _pos = (_pos - _low_v) * _scale_v;
+
+                        // Out of range values go to the extra bin at `bin_count`
+                        _pos = {(_pos.value >= 0) & (_pos.value < _bins_v.value) ? _pos.value : _bins_v.value};
+                        index_batch{__builtin_convertvector(_pos.value, typename index_batch::native)}
+                            .store(_indices + _lane);
+                    }
+                    for(usize _lane = 0; _lane < _block; _lane += _ways)
+                    {
+                        _way0[_indices[_lane]]++;
+                        _way1[_indices[_lane + 1]]++;
+                        _way2[_indices[_lane + 2]]++;
+                        _way3[_indices[_lane + 3]]++;
+                    }
+                }
+                for(; _index < size; _index++)
+                {
+                    real _pos = (static_cast<real>(data[_index]) - _low) * _scale;
+
+                    if(_pos >= 0 && _pos < static_cast<real>(bin_count))
+                        _way0[static_cast<usize>(_pos)]++;
+                }
+                for(usize _way = 0; _way < _ways; _way++)
+                {
+                    for(usize _bin = 0; _bin < bin_count; _bin++)
+                        bins[_bin] += _counts[_way * (bin_count + 1) + _bin];
+                }
+            }
+        };
+
+        template < char Op >
+        struct elementwise_kernel
+        {
+            template < typename V >
+            static V apply(const V& lhs, const V& rhs)
+            {
+                if constexpr(Op == '+')
+                    return lhs + rhs;
+                else if constexpr(Op == '-')
+                    return lhs - rhs;
+                else if constexpr(Op == '*')
+                    return lhs * rhs;
+                else
+                    return lhs / rhs;
+            }
+
+            template < typename B, typename T >
+            static void run(const T* lhs, const T* rhs, T* out, usize size)
+            {
+                constexpr usize _lanes = B::lanes;
+                usize _index = 0;
+                usize _end = size - size % (2 * _lanes);
+
+                for(; _index != _end; _index += 2 * _lanes)
+                {
+                    B _first = apply(B::load(lhs + _index), B::load(rhs + _index));
+                    B _second = apply(B::load(lhs + _index + _lanes), B::load(rhs + _index + _lanes));
+                    _first.store(out + _index);
+                    _second.store(out + _index + _lanes);
+                }
+                for(; _index < size; _index++)
+                    out[_index] = apply(lhs[_index], rhs[_index]);
+            }
+        };
+    } // namespace simd_detail
+
+    namespace simd
+    {
+        /// Best level this CPU supports
+        static inline level detected()
+        {
+            static level _level = simd_detail::detect();
+            return _level;
+        }
+
+        /// Level the kernels currently use
+        static inline level active()
+        {
+            return simd_detail::current();
+        }
+
+        /// Lowers (or restores) the level used by the kernels, requests
+        /// above what the CPU supports are clamped. Not thread safe
+        static inline level set_level(level target)
+        {
+            simd_detail::current() = target > detected() ? detected() : target;
+            return simd_detail::current();
+        }
+
+        static inline const char* level_name(level target)
+        {
+            switch(target)
+            {
+                case level::avx512: return "avx512";
+                case level::avx2: return "avx2";
+                case level::sse: return "sse";
+                default: return "scalar";
+            }
+        }
+
+        /// Runs `Kernel::run<batch<T, width>>(args...)` compiled for the
+        /// active level, the entry point for custom kernels
+        template < typename Kernel, typename T, typename... Args >
+        static auto dispatch(Args... args)
+        {
+            #if defined(__x86_64__) || defined(__i386__)
+            switch(simd_detail::current())
+            {
+                case level::avx512: return simd_detail::run_avx512<Kernel, T>(args...);
+                case level::avx2: return simd_detail::run_avx2<Kernel, T>(args...);
+                case level::sse: return simd_detail::run_sse<Kernel, T>(args...);
+                default: break;
+            }
+            #endif
+
+            return simd_detail::run_scalar<Kernel, T>(args...);
+        }
+
+        template < typename T >
+        static T sum(const T* data, usize size)
+        {
+            static_assert(simd_detail::supported<T>, "Kernels take f32, f64, i32 or i64");
+            return dispatch<simd_detail::sum_kernel, T>(data, size);
+        }
+
+        /// Float results may differ from a sequential loop in the last
+        /// bits: lanes are summed separately and combined at the end
+        template < typename T >
+        static T dot(const T* lhs, const T* rhs, usize size)
+        {
+            static_assert(simd_detail::supported<T>, "Kernels take f32, f64, i32 or i64");
+            return dispatch<simd_detail::dot_kernel, T>(lhs, rhs, size);
+        }
+
+        /// `size` must not be zero
+        template < typename T >
+        static T min(const T* data, usize size)
+        {
+            static_assert(simd_detail::supported<T>, "Kernels take f32, f64, i32 or i64");
+            return dispatch<simd_detail::extremum_kernel<false>, T>(data, size);
+        }
+
+        /// `size` must not be zero
+        template < typename T >
+        static T max(const T* data, usize size)
+        {
+            static_assert(simd_detail::supported<T>, "Kernels take f32, f64, i32 or i64");
+            return dispatch<simd_detail::extremum_kernel<true>, T>(data, size);
+        }
+
+        /// y = alpha * x + y
+        template < typename T >
+        static void axpy(T alpha, const T* x, T* y, usize size)
+        {
+            static_assert(simd_detail::supported<T>, "Kernels take f32, f64, i32 or i64");
+            dispatch<simd_detail::axpy_kernel, T>(alpha, x, y, size);
+        }
+
+        /// Inclusive running sum, `out` may be `data`
+        template < typename T >
+        static void prefix_sum(const T* data, T* out, usize size)
+        {
+            static_assert(simd_detail::supported<T>, "Kernels take f32, f64, i32 or i64");
+            dispatch<simd_detail::prefix_sum_kernel, T>(data, out, size);
+        }
+
+        /// Adds the count of values in each of `bin_count` equal slices of
+        /// [low, high) to `bins`, values outside the range are skipped
+        template < typename T >
+        static void histogram(const T* data, usize size, T low, T high, usize* bins, usize bin_count)
+        {
+            static_assert(simd_detail::supported<T>, "Kernels take f32, f64, i32 or i64");
+            dispatch<simd_detail::histogram_kernel, T>(data, size, low, high, bins, bin_count);
+        }
+
+        template < typename T >
+        static void add(const T* lhs, const T* rhs, T* out, usize size)
+        {
+            static_assert(simd_detail::supported<T>, "Kernels take f32, f64, i32 or i64");
+            dispatch<simd_detail::elementwise_kernel<'+'>, T>(lhs, rhs, out, size);
+        }
+
+        template < typename T >
+        static void sub(const T* lhs, const T* rhs, T* out, usize size)
+        {
+            static_assert(simd_detail::supported<T>, "Kernels take f32, f64, i32 or i64");
+            dispatch<simd_detail::elementwise_kernel<'-'>, T>(lhs, rhs, out, size);
+        }
+
+        template < typename T >
+        static void mul(const T* lhs, const T* rhs, T* out, usize size)
+        {
+            static_assert(simd_detail::supported<T>, "Kernels take f32, f64, i32 or i64");
+            dispatch<simd_detail::elementwise_kernel<'*'>, T>(lhs, rhs, out, size);
+        }
+
+        /// Integer division has no vector instruction, it runs lane by lane
+        template < typename T >
+        static void div(const T* lhs, const T* rhs, T* out, usize size)
+        {
+            static_assert(simd_detail::supported<T>, "Kernels take f32, f64, i32 or i64");
+            dispatch<simd_detail::elementwise_kernel<'/'>, T>(lhs, rhs, out, size);
+        }
+
+        template < typename T, usize Align >
+        static T sum(vector<T, Align>& values)
+        {
+            return sum(values.data(), values.size());
+        }
+
+        template < typename T, usize LhsAlign, usize RhsAlign >
+        static T dot(vector<T, LhsAlign>& lhs, vector<T, RhsAlign>& rhs)
+        {
+            return dot(lhs.data(), rhs.data(), hsd::min(lhs.size(), rhs.size()));
+        }
+
+        template < typename T, usize Align >
+        static T min(vector<T, Align>& values)
+        {
+            return min(values.data(), values.size());
+        }
+
+        template < typename T, usize Align >
+        static T max(vector<T, Align>& values)
+        {
+            return max(values.data(), values.size());
+        }
+
+        template < typename T, usize XAlign, usize YAlign >
+        static void axpy(T alpha, vector<T, XAlign>& x, vector<T, YAlign>& y)
+        {
+            axpy(alpha, x.data(), y.data(), hsd::min(x.size(), y.size()));
+        }
+
+        template < typename T, usize Align >
+        static void prefix_sum(vector<T, Align>& values)
+        {
+            prefix_sum(values.data(), values.data(), values.size());
+        }
+
+        template < typename T, usize Align >
+        static vector<usize> histogram(vector<T, Align>& values, T low, T high, usize bin_count)
+        {
+            vector<usize> _bins(bin_count);
+            histogram(values.data(), values.size(), low, high, _bins.data(), bin_count);
+            return _bins;
+        }
+    } // namespace simd
+} // namespace hsd
+
+#pragma GCC diagnostic pop
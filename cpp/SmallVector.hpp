@@ -0,0 +1,336 @@
+#pragma once
+
+#include <stdexcept>
+#include <initializer_list>
+
+#include "Utility.hpp"
+#include "AlignedStorage.hpp"
+
+namespace hsd
+{
+    /// `vector` that keeps up to `N` elements inline and only moves them to
+    /// the heap once it outgrows that, so short lists never allocate.
+    /// Shrinking back under `N` with `shrink_to_fit` returns them inline
+    template <typename T, usize N>
+    class small_vector
+    {
+        static_assert(N > 0, "small_vector needs room for at least one element");
+
+        using storage_type = typename aligned_storage<sizeof(T), alignof(T)>::type;
+        storage_type* _data = _inline;
+        usize _size = 0;
+        usize _capacity = N;
+        storage_type _inline[N];
+
+        // Moves the elements to `new_buf` which holds `new_cap` of them
+        HSD_CONSTEXPR void _relocate(storage_type* new_buf, usize new_cap)
+        {
+            for (usize _index = 0; _index < _size; ++_index)
+            {
+                auto& _value = at_unchecked(_index);
+                new(&new_buf[_index]) T(hsd::move(_value));
+                _value.~T();
+            }
+
+            if (!is_inline())
+                delete[] _data;
+
+            _data = new_buf;
+            _capacity = new_cap;
+        }
+
+        // Takes the heap buffer of `rhs` or moves its inline elements over
+        HSD_CONSTEXPR void _steal(small_vector& rhs)
+        {
+            if (rhs.is_inline())
+            {
+                for (; _size < rhs._size; ++_size)
+                    new(&_data[_size]) T(hsd::move(rhs[_size]));
+
+                rhs.clear();
+            }
+            else
+            {
+                _data = exchange(rhs._data, rhs._inline);
+                _size = exchange(rhs._size, 0);
+                _capacity = exchange(rhs._capacity, N);
+            }
+        }
+
+    public:
+        using value_type = T;
+        using iterator = T*;
+        using const_iterator = const T*;
+
+        HSD_CONSTEXPR ~small_vector()
+        {
+            clear();
+
+            if (!is_inline())
+                delete[] _data;
+        }
+
+        HSD_CONSTEXPR small_vector(usize size)
+        {
+            resize(size);
+        }
+
+        HSD_CONSTEXPR small_vector() noexcept {}
+
+        HSD_CONSTEXPR small_vector(const small_vector& rhs)
+        {
+            reserve(rhs._size);
+
+            for (; _size < rhs._size; ++_size)
+                new(&_data[_size]) T(rhs[_size]);
+        }
+
+        HSD_CONSTEXPR small_vector(small_vector&& rhs)
+        {
+            _steal(rhs);
+        }
+
+        HSD_CONSTEXPR small_vector(std::initializer_list<T> list)
+        {
+            reserve(list.size());
+
+            for (auto& _value : list)
+                new(&_data[_size++]) T(_value);
+        }
+
+        HSD_CONSTEXPR small_vector& operator=(const small_vector& rhs)
+        {
+            if (this != &rhs)
+            {
+                clear();
+                reserve(rhs._size);
+
+                for (; _size < rhs._size; ++_size)
+                    new(&_data[_size]) T(rhs[_size]);
+            }
+
+            return *this;
+        }
+
+        HSD_CONSTEXPR small_vector& operator=(small_vector&& rhs)
+        {
+            if (this != &rhs)
+            {
+                clear();
+
+                if (!is_inline())
+                {
+                    delete[] _data;
+                    _data = _inline;
+                    _capacity = N;
+                }
+
+                _steal(rhs);
+            }
+
+            return *this;
+        }
+
+        HSD_CONSTEXPR small_vector& operator=(std::initializer_list<T> list)
+        {
+            clear();
+            reserve(list.size());
+
+            for (auto& _value : list)
+                new(&_data[_size++]) T(_value);
+
+            return *this;
+        }
+
+        constexpr T& operator[](usize index) noexcept
+        {
+            return reinterpret_cast<T&>(_data[index]);
+        }
+
+        constexpr const T& operator[](usize index) const noexcept
+        {
+            return reinterpret_cast<const T&>(_data[index]);
+        }
+
+        constexpr T& front() noexcept
+        {
+            return *begin();
+        }
+
+        constexpr const T& front() const noexcept
+        {
+            return *begin();
+        }
+
+        constexpr T& back() noexcept
+        {
+            return *(begin() + size() - 1);
+        }
+
+        constexpr const T& back() const noexcept
+        {
+            return *(begin() + size() - 1);
+        }
+
+        constexpr T& at(usize index)
+        {
+            if(index >= _size)
+                throw std::out_of_range("Accessed element out of range");
+
+            return reinterpret_cast<T&>(_data[index]);
+        }
+
+        constexpr const T& at(usize index) const
+        {
+            if(index >= _size)
+                throw std::out_of_range("Accessed element out of range");
+
+            return reinterpret_cast<const T&>(_data[index]);
+        }
+
+        constexpr T& at_unchecked(usize index) noexcept
+        {
+            return reinterpret_cast<T&>(_data[index]);
+        }
+
+        constexpr const T& at_unchecked(usize index) const noexcept
+        {
+            return reinterpret_cast<const T&>(_data[index]);
+        }
+
+        constexpr void clear() noexcept
+        {
+            for (usize _index = _size; _index > 0; --_index)
+                at_unchecked(_index - 1).~T();
+
+            _size = 0;
+        }
+
+        HSD_CONSTEXPR void reserve(usize new_cap)
+        {
+            if (new_cap > _capacity)
+            {
+                usize _new_capacity = _capacity;
+                while (_new_capacity < new_cap)
+                    _new_capacity += (_new_capacity + 1) / 2;
+
+                _relocate(new storage_type[_new_capacity], _new_capacity);
+            }
+        }
+
+        HSD_CONSTEXPR void shrink_to_fit()
+        {
+            if (is_inline() || _size == _capacity)
+                return;
+
+            if (_size <= N)
+                _relocate(_inline, N);
+            else
+                _relocate(new storage_type[_size], _size);
+        }
+
+        HSD_CONSTEXPR void resize(usize new_size)
+        {
+            reserve(new_size);
+
+            for (; _size < new_size; ++_size)
+                new(&_data[_size]) T();
+
+            for (; _size > new_size; --_size)
+                at_unchecked(_size - 1).~T();
+        }
+
+        HSD_CONSTEXPR void push_back(const T& val)
+        {
+            emplace_back(val);
+        }
+
+        HSD_CONSTEXPR void push_back(T&& val)
+        {
+            emplace_back(hsd::move(val));
+        }
+
+        template <typename... Args>
+        HSD_CONSTEXPR T& emplace_back(Args&&... args)
+        {
+            if (_size == _capacity)
+            {
+                // `args` may refer into the buffer, build the value first
+                T _value(hsd::forward<Args>(args)...);
+                reserve(_size + 1);
+                new(&_data[_size]) T(hsd::move(_value));
+            }
+            else
+            {
+                new(&_data[_size]) T(hsd::forward<Args>(args)...);
+            }
+
+            return at_unchecked(_size++);
+        }
+
+        constexpr void pop_back() noexcept
+        {
+            if(_size > 0)
+            {
+                at_unchecked(_size - 1).~T();
+                _size--;
+            }
+        }
+
+        constexpr usize size() const
+        {
+            return _size;
+        }
+
+        constexpr usize capacity() const
+        {
+            return _capacity;
+        }
+
+        /// True while the elements live in the inline buffer
+        constexpr bool is_inline() const
+        {
+            return _data == _inline;
+        }
+
+        constexpr iterator data()
+        {
+            return reinterpret_cast<iterator>(_data);
+        }
+
+        constexpr const_iterator data() const
+        {
+            return reinterpret_cast<const_iterator>(_data);
+        }
+
+        constexpr iterator begin()
+        {
+            return data();
+        }
+
+        constexpr iterator end()
+        {
+            return begin() + size();
+        }
+
+        constexpr const_iterator begin() const
+        {
+            return data();
+        }
+
+        constexpr const_iterator end() const
+        {
+            return begin() + size();
+        }
+
+        constexpr const_iterator cbegin() const
+        {
+            return data();
+        }
+
+        constexpr const_iterator cend() const
+        {
+            return cbegin() + size();
+        }
+    };
+}
@@ -0,0 +1,304 @@
+#pragma once
+
+#include <stdexcept>
+
+#include "CString.hpp"
+#include "Pair.hpp"
+
+namespace hsd
+{
+    /// Key of a `static_map`, deduced from either a string literal or an integer
+    template <typename T, usize N>
+    struct static_key
+    {
+        T data[N]{};
+
+        consteval static_key(const T (&str)[N])
+        {
+            for(usize _index = 0; _index < N; _index++)
+                data[_index] = str[_index];
+        }
+
+        constexpr pair<const T*, usize> view() const
+        {
+            return {data, N - 1};
+        }
+    };
+
+    template <typename T>
+    struct static_key<T, 0>
+    {
+        T data;
+
+        consteval static_key(T value)
+            : data{value}
+        {}
+
+        constexpr T view() const
+        {
+            return data;
+        }
+    };
+
+    template <typename CharT, usize N>
+    static_key(const CharT (&)[N]) -> static_key<CharT, N>;
+
+    template <typename T> requires (std::is_integral_v<T>)
+    static_key(T) -> static_key<T, 0>;
+
+    namespace static_map_detail
+    {
+        static constexpr u64 mix(u64 value)
+        {
+            value ^= value >> 30;
+            value *= 0xbf58476d1ce4e5b9ull;
+            value ^= value >> 27;
+            value *= 0x94d049bb133111ebull;
+            value ^= value >> 31;
+            return value;
+        }
+
+        template <typename CharT>
+        static constexpr u64 hash(const CharT* str, usize len, u64 seed)
+        {
+            u64 _hash = 14'695'981'039'346'656'037u ^ mix(seed);
+
+            for(usize _index = 0; _index < len; _index++)
+                _hash = (_hash ^ static_cast<u64>(str[_index])) * 1'099'511'628'211u;
+
+            return mix(_hash ^ len);
+        }
+
+        template <typename T> requires (std::is_integral_v<T>)
+        static constexpr u64 hash(T value, u64 seed)
+        {
+            return mix(static_cast<u64>(value) ^ mix(seed + 0x9e3779b97f4a7c15ull));
+        }
+
+        template <auto First, auto...>
+        struct first_key
+        {
+            using type = decltype(First.view());
+        };
+
+        // Displacements with this bit set store the slot of a single-key bucket directly
+        static constexpr u32 direct_flag = 0x8000'0000u;
+
+        template < usize N, usize B >
+        struct table
+        {
+            u32 displacement[B]{};
+            usize slot_key[N]{};
+        };
+
+        /// Hash, displace and compress: keys are grouped into buckets by a
+        /// first hash, then each bucket (largest first) searches for a seed
+        /// that sends all its keys to free slots. Leftover single-key buckets
+        /// take any free slot directly, so the table has no empty slots.
+        template < usize N, usize B, typename HashFn, typename EqualFn >
+        static constexpr table<N, B> build(HashFn hash_key, EqualFn equal_keys)
+        {
+            table<N, B> _table{};
+            usize _bucket_of[N]{};
+            usize _bucket_size[B]{};
+            usize _order[B]{};
+            bool _taken[N]{};
+
+            for(usize _index = 0; _index < N; _index++)
+            {
+                for(usize _other = 0; _other < _index; _other++)
+                {
+                    if(equal_keys(_index, _other))
+                        throw std::runtime_error("Duplicate key in static_map");
+                }
+
+                _bucket_of[_index] = hash_key(_index, 0) % B;
+                _bucket_size[_bucket_of[_index]]++;
+            }
+            for(usize _index = 0; _index < B; _index++)
+                _order[_index] = _index;
+
+            for(usize _index = 1; _index < B; _index++)
+            {
+                usize _bucket = _order[_index];
+                usize _pos = _index;
+
+                for(; _pos > 0 && _bucket_size[_order[_pos - 1]] < _bucket_size[_bucket]; _pos--)
+                    _order[_pos] = _order[_pos - 1];
+
+                _order[_pos] = _bucket;
+            }
+            for(usize _step = 0; _step < B; _step++)
+            {
+                usize _bucket = _order[_step];
+
+                if(_bucket_size[_bucket] == 0)
+                    break;
+
+                if(_bucket_size[_bucket] == 1)
+                {
+                    usize _slot = 0;
+
+                    while(_taken[_slot])
+                        _slot++;
+
+                    for(usize _index = 0; _index < N; _index++)
+                    {
+                        if(_bucket_of[_index] == _bucket)
+                            _table.slot_key[_slot] = _index;
+                    }
+
+                    _taken[_slot] = true;
+                    _table.displacement[_bucket] = direct_flag | static_cast<u32>(_slot);
+                    continue;
+                }
+
+                for(u32 _seed = 1;; _seed++)
+                {
+                    if(_seed == direct_flag)
+                        throw std::runtime_error("Cannot build a perfect hash for the keys");
+
+                    usize _slots[N]{};
+                    usize _used = 0;
+                    bool _fits = true;
+
+                    for(usize _index = 0; _index < N && _fits; _index++)
+                    {
+                        if(_bucket_of[_index] != _bucket)
+                            continue;
+
+                        usize _slot = hash_key(_index, _seed) % N;
+                        _fits = !_taken[_slot];
+
+                        for(usize _prev = 0; _prev < _used && _fits; _prev++)
+                            _fits = _slots[_prev] != _slot;
+
+                        _slots[_used++] = _slot;
+                    }
+                    if(!_fits)
+                        continue;
+
+                    _used = 0;
+
+                    for(usize _index = 0; _index < N; _index++)
+                    {
+                        if(_bucket_of[_index] == _bucket)
+                        {
+                            _table.slot_key[_slots[_used]] = _index;
+                            _taken[_slots[_used++]] = true;
+                        }
+                    }
+
+                    _table.displacement[_bucket] = _seed;
+                    break;
+                }
+            }
+
+            return _table;
+        }
+    } // namespace static_map_detail
+
+    /// Immutable set of keys known at compile time (string literals or
+    /// integers) with a minimal perfect hash built during compilation.
+    /// `find` returns the position of the key in `Keys...` after one table
+    /// probe and one key comparison, or `npos` if it's not in the set.
+    template <static_key... Keys>
+    class static_map
+    {
+    private:
+        static constexpr usize _count = sizeof...(Keys);
+        static constexpr usize _bucket_count = _count / 2 + 1;
+
+        static_assert(_count > 0, "static_map needs at least one key");
+
+        using key_type = typename static_map_detail::first_key<Keys...>::type;
+
+        static_assert((is_same<decltype(Keys.view()), key_type>::value && ...),
+            "All keys of a static_map must have the same type");
+
+        static constexpr key_type _keys[_count] = {Keys.view()...};
+
+        static constexpr u64 _hash(const key_type& key, u64 seed)
+        {
+            if constexpr(std::is_integral_v<key_type>)
+                return static_map_detail::hash(key, seed);
+            else
+                return static_map_detail::hash(key.first, key.second, seed);
+        }
+
+        static constexpr bool _equal(const key_type& lhs, const key_type& rhs)
+        {
+            if constexpr(std::is_integral_v<key_type>)
+            {
+                return lhs == rhs;
+            }
+            else
+            {
+                if(lhs.second != rhs.second)
+                    return false;
+
+                for(usize _index = 0; _index < lhs.second; _index++)
+                {
+                    if(lhs.first[_index] != rhs.first[_index])
+                        return false;
+                }
+
+                return true;
+            }
+        }
+
+        static constexpr auto _table = static_map_detail::build<_count, _bucket_count>(
+            [](usize index, u64 seed) { return _hash(_keys[index], seed); },
+            [](usize lhs, usize rhs) { return _equal(_keys[lhs], _keys[rhs]); }
+        );
+
+        static constexpr usize _find(const key_type& key)
+        {
+            u32 _disp = _table.displacement[_hash(key, 0) % _bucket_count];
+            usize _slot = (_disp & static_map_detail::direct_flag) ?
+                (_disp & ~static_map_detail::direct_flag) : _hash(key, _disp) % _count;
+            usize _index = _table.slot_key[_slot];
+
+            return _equal(_keys[_index], key) ? _index : npos;
+        }
+
+    public:
+        static constexpr usize npos = static_cast<usize>(-1);
+
+        template < typename CharT > requires (!std::is_integral_v<key_type>)
+        static constexpr usize find(const CharT* str, usize len)
+        {
+            return _find({str, len});
+        }
+
+        template < typename CharT > requires (!std::is_integral_v<key_type>)
+        static constexpr usize find(const CharT* str)
+        {
+            return _find({str, cstring<CharT>::length(str)});
+        }
+
+        template < typename T > requires (std::is_integral_v<key_type> && std::is_integral_v<T>)
+        static constexpr usize find(T key)
+        {
+            auto _key = static_cast<key_type>(key);
+
+            // A key that doesn't survive the round trip can't be in the set,
+            // and narrowing it could land on a key that is
+            if(static_cast<T>(_key) != key || (_key < key_type{}) != (key < T{}))
+                return npos;
+
+            return _find(_key);
+        }
+
+        template < typename... Args >
+        static constexpr bool contains(Args... args)
+        {
+            return find(args...) != npos;
+        }
+
+        static constexpr usize size()
+        {
+            return _count;
+        }
+    };
+} // namespace hsd
@@ -0,0 +1,272 @@
+#pragma once
+
+#include <stdexcept>
+#include <initializer_list>
+
+#include "Utility.hpp"
+#include "AlignedStorage.hpp"
+
+namespace hsd
+{
+    /// `vector` with its elements stored inline, up to `N` of them. Unlike
+    /// `stack_array` only the first `size()` slots hold constructed
+    /// objects, growing past `N` throws instead of allocating
+    template <typename T, usize N>
+    class static_vector
+    {
+        static_assert(N > 0, "static_vector needs room for at least one element");
+
+        using storage_type = typename aligned_storage<sizeof(T), alignof(T)>::type;
+        storage_type _data[N];
+        usize _size = 0;
+
+        static constexpr void _check(usize count)
+        {
+            if (count > N)
+                throw std::out_of_range("static_vector capacity exceeded");
+        }
+
+    public:
+        using value_type = T;
+        using iterator = T*;
+        using const_iterator = const T*;
+
+        HSD_CONSTEXPR ~static_vector()
+        {
+            clear();
+        }
+
+        HSD_CONSTEXPR static_vector(usize size)
+        {
+            resize(size);
+        }
+
+        HSD_CONSTEXPR static_vector() noexcept {}
+
+        HSD_CONSTEXPR static_vector(const static_vector& rhs)
+        {
+            for (; _size < rhs._size; ++_size)
+                new(&_data[_size]) T(rhs[_size]);
+        }
+
+        HSD_CONSTEXPR static_vector(static_vector&& rhs)
+        {
+            for (; _size < rhs._size; ++_size)
+                new(&_data[_size]) T(hsd::move(rhs[_size]));
+
+            rhs.clear();
+        }
+
+        HSD_CONSTEXPR static_vector(std::initializer_list<T> list)
+        {
+            _check(list.size());
+
+            for (auto& _value : list)
+                emplace_back(_value);
+        }
+
+        HSD_CONSTEXPR static_vector& operator=(const static_vector& rhs)
+        {
+            if (this != &rhs)
+            {
+                clear();
+
+                for (; _size < rhs._size; ++_size)
+                    new(&_data[_size]) T(rhs[_size]);
+            }
+
+            return *this;
+        }
+
+        HSD_CONSTEXPR static_vector& operator=(static_vector&& rhs)
+        {
+            if (this != &rhs)
+            {
+                clear();
+
+                for (; _size < rhs._size; ++_size)
+                    new(&_data[_size]) T(hsd::move(rhs[_size]));
+
+                rhs.clear();
+            }
+
+            return *this;
+        }
+
+        HSD_CONSTEXPR static_vector& operator=(std::initializer_list<T> list)
+        {
+            _check(list.size());
+            clear();
+
+            for (auto& _value : list)
+                emplace_back(_value);
+
+            return *this;
+        }
+
+        constexpr T& operator[](usize index) noexcept
+        {
+            return reinterpret_cast<T&>(_data[index]);
+        }
+
+        constexpr const T& operator[](usize index) const noexcept
+        {
+            return reinterpret_cast<const T&>(_data[index]);
+        }
+
+        constexpr T& front() noexcept
+        {
+            return *begin();
+        }
+
+        constexpr const T& front() const noexcept
+        {
+            return *begin();
+        }
+
+        constexpr T& back() noexcept
+        {
+            return *(begin() + size() - 1);
+        }
+
+        constexpr const T& back() const noexcept
+        {
+            return *(begin() + size() - 1);
+        }
+
+        constexpr T& at(usize index)
+        {
+            if(index >= _size)
+                throw std::out_of_range("Accessed element out of range");
+
+            return reinterpret_cast<T&>(_data[index]);
+        }
+
+        constexpr const T& at(usize index) const
+        {
+            if(index >= _size)
+                throw std::out_of_range("Accessed element out of range");
+
+            return reinterpret_cast<const T&>(_data[index]);
+        }
+
+        constexpr T& at_unchecked(usize index) noexcept
+        {
+            return reinterpret_cast<T&>(_data[index]);
+        }
+
+        constexpr const T& at_unchecked(usize index) const noexcept
+        {
+            return reinterpret_cast<const T&>(_data[index]);
+        }
+
+        constexpr void clear() noexcept
+        {
+            for (usize _index = _size; _index > 0; --_index)
+                at_unchecked(_index - 1).~T();
+
+            _size = 0;
+        }
+
+        /// Only checks `new_cap` fits, the storage is always there
+        constexpr void reserve(usize new_cap)
+        {
+            _check(new_cap);
+        }
+
+        constexpr void shrink_to_fit() noexcept {}
+
+        HSD_CONSTEXPR void resize(usize new_size)
+        {
+            _check(new_size);
+
+            for (; _size < new_size; ++_size)
+                new(&_data[_size]) T();
+
+            for (; _size > new_size; --_size)
+                at_unchecked(_size - 1).~T();
+        }
+
+        HSD_CONSTEXPR void push_back(const T& val)
+        {
+            emplace_back(val);
+        }
+
+        HSD_CONSTEXPR void push_back(T&& val)
+        {
+            emplace_back(hsd::move(val));
+        }
+
+        template <typename... Args>
+        HSD_CONSTEXPR T& emplace_back(Args&&... args)
+        {
+            _check(_size + 1);
+            new(&_data[_size]) T(hsd::forward<Args>(args)...);
+            return at_unchecked(_size++);
+        }
+
+        constexpr void pop_back() noexcept
+        {
+            if(_size > 0)
+            {
+                at_unchecked(_size - 1).~T();
+                _size--;
+            }
+        }
+
+        constexpr usize size() const
+        {
+            return _size;
+        }
+
+        static constexpr usize capacity()
+        {
+            return N;
+        }
+
+        constexpr bool full() const
+        {
+            return _size == N;
+        }
+
+        constexpr iterator data()
+        {
+            return reinterpret_cast<iterator>(_data);
+        }
+
+        constexpr const_iterator data() const
+        {
+            return reinterpret_cast<const_iterator>(_data);
+        }
+
+        constexpr iterator begin()
+        {
+            return data();
+        }
+
+        constexpr iterator end()
+        {
+            return begin() + size();
+        }
+
+        constexpr const_iterator begin() const
+        {
+            return data();
+        }
+
+        constexpr const_iterator end() const
+        {
+            return begin() + size();
+        }
+
+        constexpr const_iterator cbegin() const
+        {
+            return data();
+        }
+
+        constexpr const_iterator cend() const
+        {
+            return cbegin() + size();
+        }
+    };
+}
@@ -6,6 +6,9 @@
 
 namespace hsd
 {
+    template <typename CharT>
+    class string_view;
+
     template <typename CharT>
     class string
     {
@@ -56,6 +59,10 @@ namespace hsd
             _data[size] = '\0';
         }
 
+        HSD_CONSTEXPR explicit string(string_view<CharT> view)
+            : string(view.data(), view.size())
+        {}
+
         HSD_CONSTEXPR string(const string& other)
         {
             _size = other._size;
@@ -200,41 +207,52 @@ namespace hsd
             return _data[index];
         }
 
-        constexpr bool operator==(const string& rhs)
+        constexpr bool operator==(const string& rhs) const
         {
-            return _str_utils::compare(
-                _data, rhs._data, 
-                hsd::min(_size, rhs._size)
+            return _size == rhs._size && _str_utils::compare(
+                _data, rhs._data, _size
             ) == 0;
         }
 
-        constexpr bool operator!=(const string& rhs)
+        constexpr bool operator!=(const string& rhs) const
         {
             return !operator==(rhs);
         }
 
-        constexpr bool operator<(const string& rhs)
+        // Compares in place, without building a string out of `rhs`
+        constexpr bool operator==(const CharT* rhs) const
         {
-            return _str_utils::compare(
+            usize _index = 0;
+
+            for(; _index < _size && _data[_index] == rhs[_index]; _index++);
+
+            return _index == _size && rhs[_index] == '\0';
+        }
+
+        // Lexicographic, a prefix orders before the longer string
+        constexpr bool operator<(const string& rhs) const
+        {
+            i32 _order = _str_utils::compare(
                 _data, rhs._data, 
                 hsd::min(_size, rhs._size)
-            ) == -1;
+            );
+
+            return _order < 0 || (_order == 0 && _size < rhs._size);
         }
 
-        constexpr bool operator<=(const string& rhs)
+        constexpr bool operator<=(const string& rhs) const
         {
-            return operator<(rhs) && operator==(rhs);
+            return !rhs.operator<(*this);
         }
 
-        constexpr bool operator>(const string& rhs)
+        constexpr bool operator>(const string& rhs) const
         {
-            return _str_utils::compare(_data, rhs._data, 
-                hsd::min(_size, rhs._size)) == 1;
+            return rhs.operator<(*this);
         }
 
-        constexpr bool operator>=(const string& rhs)
+        constexpr bool operator>=(const string& rhs) const
         {
-            return operator>(rhs) && operator==(rhs);
+            return !operator<(rhs);
         }
 
         constexpr CharT& at(usize index)
@@ -496,8 +514,87 @@ namespace hsd
         }
     };
     
+    /// Non-owning run of characters, it lets hashed containers keyed by
+    /// `string` be probed with a slice of a bigger buffer
+    template <typename CharT>
+    class string_view
+    {
+    private:
+        const CharT* _data = nullptr;
+        usize _size = 0;
+
+    public:
+        using iterator = const CharT*;
+
+        constexpr string_view() = default;
+
+        constexpr string_view(const CharT* cstr)
+            : _data{cstr}, _size{cstring<CharT>::length(cstr)}
+        {}
+
+        constexpr string_view(const CharT* cstr, usize size)
+            : _data{cstr}, _size{size}
+        {}
+
+        constexpr string_view(const string<CharT>& str)
+            : _data{str.c_str()}, _size{str.size()}
+        {}
+
+        constexpr const CharT& operator[](usize index) const
+        {
+            return _data[index];
+        }
+
+        // Bounded, `cstring::compare` would read the terminator position
+        friend constexpr bool operator==(string_view lhs, string_view rhs)
+        {
+            if(lhs._size != rhs._size)
+                return false;
+
+            for(usize _index = 0; _index < lhs._size; _index++)
+            {
+                if(lhs._data[_index] != rhs._data[_index])
+                    return false;
+            }
+
+            return true;
+        }
+
+        constexpr const CharT* data() const
+        {
+            return _data;
+        }
+
+        constexpr usize size() const
+        {
+            return _size;
+        }
+
+        constexpr bool empty() const
+        {
+            return _size == 0;
+        }
+
+        constexpr iterator begin() const
+        {
+            return _data;
+        }
+
+        constexpr iterator end() const
+        {
+            return _data + _size;
+        }
+    };
+
+    template <typename CharT>
+    constexpr bool operator==(const string<CharT>& lhs, string_view<CharT> rhs)
+    {
+        return string_view<CharT>{lhs} == rhs;
+    }
+
     using wstring = hsd::string<wchar>;
     using u8string = hsd::string<char>;
     using u16string = hsd::string<char16>;
     using u32string = hsd::string<char32>;
+    using u8string_view = hsd::string_view<char>;
 } // namespace hsd
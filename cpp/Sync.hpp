@@ -0,0 +1,374 @@
+#pragma once
+
+#include "Utility.hpp"
+#include "_SyncDetail.hpp"
+
+namespace hsd
+{
+    /// Three state futex mutex (unlocked, locked, locked with sleepers):
+    /// lock and unlock are a single atomic when uncontended, the kernel is
+    /// only entered when someone actually has to sleep or be woken
+    class mutex
+    {
+    private:
+        static constexpr u32 _spin_limit = 100;
+        u32 _state = 0;
+
+    public:
+        mutex() = default;
+        mutex(const mutex&) = delete;
+        mutex& operator=(const mutex&) = delete;
+
+        bool try_lock()
+        {
+            u32 _expected = 0;
+            return __atomic_compare_exchange_n(&_state, &_expected, 1u,
+                false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+        }
+
+        void lock()
+        {
+            if(try_lock())
+                return;
+
+            for(u32 _spin = 0; _spin < _spin_limit; _spin++)
+            {
+                sync_detail::cpu_relax();
+
+                if(__atomic_load_n(&_state, __ATOMIC_RELAXED) == 0 && try_lock())
+                    return;
+            }
+
+            // Mark the lock contended so the owner's unlock wakes us
+            while(__atomic_exchange_n(&_state, 2u, __ATOMIC_ACQUIRE) != 0)
+                sync_detail::futex_wait(&_state, 2);
+        }
+
+        void unlock()
+        {
+            if(__atomic_exchange_n(&_state, 0u, __ATOMIC_RELEASE) == 2)
+                sync_detail::futex_wake(&_state, 1);
+        }
+    };
+
+    /// Reader/writer lock in one futex word: reader count in the low bits,
+    /// a writer bit, and a bit telling unlockers that someone sleeps
+    class shared_mutex
+    {
+    private:
+        static constexpr u32 _writer = 1u << 31;
+        static constexpr u32 _waiting = 1u << 30;
+        static constexpr u32 _readers = _waiting - 1;
+        static constexpr u32 _spin_limit = 100;
+        u32 _state = 0;
+
+        // Spins on `state` for a while, then flags it and sleeps
+        void _wait(u32 state, u32& spins)
+        {
+            if(++spins < _spin_limit)
+            {
+                sync_detail::cpu_relax();
+                return;
+            }
+            if(!(state & _waiting) && !__atomic_compare_exchange_n(&_state, &state,
+                state | _waiting, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+                return;
+
+            sync_detail::futex_wait(&_state, state | _waiting);
+        }
+
+    public:
+        shared_mutex() = default;
+        shared_mutex(const shared_mutex&) = delete;
+        shared_mutex& operator=(const shared_mutex&) = delete;
+
+        bool try_lock()
+        {
+            u32 _current = __atomic_load_n(&_state, __ATOMIC_RELAXED);
+
+            return !(_current & (_writer | _readers)) && __atomic_compare_exchange_n(&_state,
+                &_current, _current | _writer, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+        }
+
+        void lock()
+        {
+            u32 _spins = 0;
+
+            while(true)
+            {
+                u32 _current = __atomic_load_n(&_state, __ATOMIC_RELAXED);
+
+                if(!(_current & (_writer | _readers)))
+                {
+                    if(__atomic_compare_exchange_n(&_state, &_current, _current | _writer,
+                        true, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+                        return;
+
+                    continue;
+                }
+
+                _wait(_current, _spins);
+            }
+        }
+
+        void unlock()
+        {
+            if(__atomic_exchange_n(&_state, 0u, __ATOMIC_RELEASE) & _waiting)
+                sync_detail::futex_wake(&_state, 0x7fffffff);
+        }
+
+        bool try_lock_shared()
+        {
+            u32 _current = __atomic_load_n(&_state, __ATOMIC_RELAXED);
+
+            return !(_current & _writer) && __atomic_compare_exchange_n(&_state,
+                &_current, _current + 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+        }
+
+        void lock_shared()
+        {
+            u32 _spins = 0;
+
+            while(true)
+            {
+                u32 _current = __atomic_load_n(&_state, __ATOMIC_RELAXED);
+
+                if(!(_current & _writer))
+                {
+                    if(__atomic_compare_exchange_n(&_state, &_current, _current + 1,
+                        true, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+                        return;
+
+                    continue;
+                }
+
+                _wait(_current, _spins);
+            }
+        }
+
+        void unlock_shared()
+        {
+            u32 _current = __atomic_sub_fetch(&_state, 1u, __ATOMIC_RELEASE);
+
+            // The last reader out clears the flag and wakes the sleepers,
+            // if the CAS loses someone else took the lock and will wake them
+            if(_current == _waiting && __atomic_compare_exchange_n(&_state, &_current,
+                0u, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+                sync_detail::futex_wake(&_state, 0x7fffffff);
+        }
+    };
+
+    template < typename Mutex >
+    class lock_guard
+    {
+    private:
+        Mutex& _mutex;
+
+    public:
+        explicit lock_guard(Mutex& mutex)
+            : _mutex{mutex}
+        {
+            _mutex.lock();
+        }
+
+        lock_guard(const lock_guard&) = delete;
+        lock_guard& operator=(const lock_guard&) = delete;
+
+        ~lock_guard()
+        {
+            _mutex.unlock();
+        }
+    };
+
+    template < typename Mutex >
+    class shared_lock
+    {
+    private:
+        Mutex& _mutex;
+
+    public:
+        explicit shared_lock(Mutex& mutex)
+            : _mutex{mutex}
+        {
+            _mutex.lock_shared();
+        }
+
+        shared_lock(const shared_lock&) = delete;
+        shared_lock& operator=(const shared_lock&) = delete;
+
+        ~shared_lock()
+        {
+            _mutex.unlock_shared();
+        }
+    };
+
+    /// Sequence counter futex: waiters sleep on the value they saw before
+    /// releasing the mutex, so a notify between the two is never lost
+    class condition_variable
+    {
+    private:
+        u32 _sequence = 0;
+        u32 _waiters = 0;
+
+        void _notify(i32 count)
+        {
+            __atomic_fetch_add(&_sequence, 1u, __ATOMIC_SEQ_CST);
+
+            if(__atomic_load_n(&_waiters, __ATOMIC_SEQ_CST) != 0)
+                sync_detail::futex_wake(&_sequence, count);
+        }
+
+    public:
+        condition_variable() = default;
+        condition_variable(const condition_variable&) = delete;
+        condition_variable& operator=(const condition_variable&) = delete;
+
+        /// `lock` must be held, it's released while sleeping. May wake spuriously
+        void wait(mutex& lock)
+        {
+            __atomic_fetch_add(&_waiters, 1u, __ATOMIC_SEQ_CST);
+            u32 _seen = __atomic_load_n(&_sequence, __ATOMIC_SEQ_CST);
+
+            lock.unlock();
+            sync_detail::futex_wait(&_sequence, _seen);
+            __atomic_fetch_sub(&_waiters, 1u, __ATOMIC_RELAXED);
+            lock.lock();
+        }
+
+        template < typename Pred >
+        void wait(mutex& lock, Pred&& pred)
+        {
+            while(!pred())
+                wait(lock);
+        }
+
+        void notify_one()
+        {
+            _notify(1);
+        }
+
+        void notify_all()
+        {
+            _notify(0x7fffffff);
+        }
+    };
+
+    /// Single use countdown, `wait` returns once it reaches zero
+    class latch
+    {
+    private:
+        u32 _count;
+
+    public:
+        explicit latch(u32 count)
+            : _count{count}
+        {}
+
+        latch(const latch&) = delete;
+        latch& operator=(const latch&) = delete;
+
+        void count_down(u32 update = 1)
+        {
+            if(__atomic_sub_fetch(&_count, update, __ATOMIC_ACQ_REL) == 0)
+                sync_detail::futex_wake(&_count, 0x7fffffff);
+        }
+
+        bool try_wait() const
+        {
+            return __atomic_load_n(&_count, __ATOMIC_ACQUIRE) == 0;
+        }
+
+        void wait()
+        {
+            for(u32 _current; (_current = __atomic_load_n(&_count, __ATOMIC_ACQUIRE)) != 0;)
+                sync_detail::futex_wait(&_count, _current);
+        }
+
+        void arrive_and_wait(u32 update = 1)
+        {
+            count_down(update);
+            wait();
+        }
+    };
+
+    /// Reusable rendezvous for a fixed number of threads, the last one to
+    /// arrive starts the next phase and wakes the rest
+    class barrier
+    {
+    private:
+        u32 _expected;
+        u32 _arrived = 0;
+        u32 _phase = 0;
+
+    public:
+        explicit barrier(u32 count)
+            : _expected{count}
+        {}
+
+        barrier(const barrier&) = delete;
+        barrier& operator=(const barrier&) = delete;
+
+        void arrive_and_wait()
+        {
+            u32 _current = __atomic_load_n(&_phase, __ATOMIC_ACQUIRE);
+
+            if(__atomic_add_fetch(&_arrived, 1u, __ATOMIC_ACQ_REL) == _expected)
+            {
+                __atomic_store_n(&_arrived, 0u, __ATOMIC_RELAXED);
+                __atomic_add_fetch(&_phase, 1u, __ATOMIC_RELEASE);
+                sync_detail::futex_wake(&_phase, 0x7fffffff);
+                return;
+            }
+
+            while(__atomic_load_n(&_phase, __ATOMIC_ACQUIRE) == _current)
+                sync_detail::futex_wait(&_phase, _current);
+        }
+    };
+
+    class semaphore
+    {
+    private:
+        u32 _count;
+        u32 _waiters = 0;
+
+    public:
+        explicit semaphore(u32 count = 0)
+            : _count{count}
+        {}
+
+        semaphore(const semaphore&) = delete;
+        semaphore& operator=(const semaphore&) = delete;
+
+        bool try_acquire()
+        {
+            u32 _current = __atomic_load_n(&_count, __ATOMIC_RELAXED);
+
+            while(_current != 0)
+            {
+                if(__atomic_compare_exchange_n(&_count, &_current, _current - 1,
+                    true, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+                    return true;
+            }
+
+            return false;
+        }
+
+        void acquire()
+        {
+            while(!try_acquire())
+            {
+                __atomic_fetch_add(&_waiters, 1u, __ATOMIC_SEQ_CST);
+                sync_detail::futex_wait(&_count, 0);
+                __atomic_fetch_sub(&_waiters, 1u, __ATOMIC_RELAXED);
+            }
+        }
+
+        void release(u32 update = 1)
+        {
+            __atomic_fetch_add(&_count, update, __ATOMIC_SEQ_CST);
+
+            if(__atomic_load_n(&_waiters, __ATOMIC_SEQ_CST) != 0)
+                sync_detail::futex_wake(&_count, static_cast<i32>(update));
+        }
+    };
+} // namespace hsd
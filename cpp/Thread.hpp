@@ -2,12 +2,70 @@
 
 #include "Utility.hpp"
 #include "Tuple.hpp" // std::decay_t
+#include "Sync.hpp"
 
 #include <pthread.h>
+#include <unistd.h>
 #include <cstdlib>
+#include <stdexcept>
+#include <stdio.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
 
 namespace hsd 
 {
+	namespace thread_detail
+	{
+		// Reads the CPUs of a NUMA node from sysfs ("0-3,8-11" style lists)
+		static inline bool numa_cpus(i32 node, cpu_set_t& cpus)
+		{
+			char path[64];
+			snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+			FILE* file = fopen(path, "r");
+
+			if (file == nullptr)
+				return false;
+
+			bool found = false;
+			usize first = 0, last = 0;
+			i32 read = 0;
+
+			while ((read = fscanf(file, "%zu-%zu", &first, &last)) > 0)
+			{
+				if (read == 1)
+					last = first;
+
+				for (usize cpu = first; cpu <= last && cpu < CPU_SETSIZE; cpu++)
+					CPU_SET(cpu, &cpus);
+
+				found = true;
+
+				if (fgetc(file) != ',')
+					break;
+			}
+
+			fclose(file);
+			return found;
+		}
+
+		// Prefers memory of `node` for allocations made by the calling thread,
+		// false if the node doesn't fit the mask or the kernel refuses it
+		static inline bool prefer_node(i32 node)
+		{
+			constexpr i32 mpol_preferred = 1;
+			unsigned long mask[4]{};
+
+			if (node < 0 || static_cast<usize>(node) >= sizeof(mask) * 8)
+				return false;
+
+			mask[static_cast<usize>(node) / (8 * sizeof(unsigned long))] |=
+				1ul << (static_cast<usize>(node) % (8 * sizeof(unsigned long)));
+
+			return syscall(SYS_set_mempolicy, mpol_preferred, mask, 8 * sizeof(mask)) == 0;
+		}
+	} // namespace thread_detail
+
 	struct thread 
 	{
 		struct id 
@@ -30,6 +88,127 @@ namespace hsd
 		};
 	
 		using native_handle_type = pthread_t;
+
+		/// Builder for the attributes of a new thread, anything left unset
+		/// keeps the pthread default
+		class options
+		{
+		public:
+			options()
+			{
+				CPU_ZERO(&cpus_);
+			}
+
+			options& stack_size(usize size)
+			{
+				usize min_size = static_cast<usize>(PTHREAD_STACK_MIN);
+				stack_size_ = size < min_size ? min_size : size;
+				return *this;
+			}
+
+			options& guard_size(usize size)
+			{
+				guard_size_ = size;
+				has_guard_ = true;
+				return *this;
+			}
+
+			/// Adds `index` to the CPUs the thread may run on
+			options& cpu(usize index)
+			{
+				CPU_SET(index, &cpus_);
+				has_cpus_ = true;
+				return *this;
+			}
+
+			/// Runs the thread on the CPUs of `node` and prefers its memory
+			options& numa_node(i32 node)
+			{
+				numa_node_ = node;
+				return *this;
+			}
+
+			/// At most 15 characters are kept, the kernel's limit
+			options& name(const char* name)
+			{
+				usize index = 0;
+
+				for (; index < sizeof(name_) - 1 && name[index] != '\0'; index++)
+					name_[index] = name[index];
+
+				name_[index] = '\0';
+				return *this;
+			}
+
+			/// For SCHED_OTHER `value` is a nice value, for the real time
+			/// policies it's the static priority (needs CAP_SYS_NICE)
+			options& priority(i32 value, i32 policy = SCHED_OTHER)
+			{
+				priority_ = value;
+				policy_ = policy;
+				has_priority_ = true;
+				return *this;
+			}
+
+		private:
+			friend thread;
+
+			usize stack_size_ = 0;
+			usize guard_size_ = 0;
+			bool has_guard_ = false;
+			cpu_set_t cpus_;
+			bool has_cpus_ = false;
+			i32 numa_node_ = -1;
+			char name_[16]{};
+			i32 priority_ = 0;
+			i32 policy_ = SCHED_OTHER;
+			bool has_priority_ = false;
+
+			void apply(pthread_attr_t& attr) const
+			{
+				if (stack_size_ != 0)
+					pthread_attr_setstacksize(&attr, stack_size_);
+
+				if (has_guard_)
+					pthread_attr_setguardsize(&attr, guard_size_);
+
+				cpu_set_t cpus = cpus_;
+				bool has_cpus = has_cpus_;
+
+				if (numa_node_ >= 0)
+					has_cpus |= thread_detail::numa_cpus(numa_node_, cpus);
+
+				if (has_cpus)
+					pthread_attr_setaffinity_np(&attr, sizeof(cpus), &cpus);
+
+				if (has_priority_ && policy_ != SCHED_OTHER)
+				{
+					sched_param param{};
+					param.sched_priority = priority_;
+					pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+					pthread_attr_setschedpolicy(&attr, policy_);
+					pthread_attr_setschedparam(&attr, &param);
+				}
+			}
+
+			// The parts that can only be set from inside the new thread,
+			// returns whether the thread now prefers memory of `numa_node_`
+			bool apply_self() const
+			{
+				bool prefers_node = false;
+
+				if (name_[0] != '\0')
+					pthread_setname_np(pthread_self(), name_);
+
+				if (numa_node_ >= 0)
+					prefers_node = thread_detail::prefer_node(numa_node_);
+
+				if (has_priority_ && policy_ == SCHED_OTHER)
+					setpriority(PRIO_PROCESS, static_cast<id_t>(gettid()), priority_);
+
+				return prefers_node;
+			}
+		};
 	
 		thread() 
 			:id_{0} 
@@ -42,21 +221,30 @@ namespace hsd
 		}
 	
 		template <typename F, typename... Args>
+		requires (!is_same<decay_t<F>, options>::value)
 		thread(F&& func, Args&&... args) 
+			: thread(options{}, hsd::forward<F>(func), hsd::forward<Args>(args)...)
+		{}
+
+		template <typename F, typename... Args>
+		thread(const options& opts, F&& func, Args&&... args) 
 		{
 			pthread_attr_t attr;
 			pthread_attr_init(&attr);
+			opts.apply(attr);
 	
 			auto decay_copy = []<typename T>(T&& t) -> decay_t<T>
 			{
 				return hsd::forward<T>(t);
 			};
 	
-			hsd::i32 ready = 0;
+			hsd::latch ready{1};
 	
 			struct thread_data 
 			{
-				hsd::i32* ready;
+				hsd::latch* ready;
+				const options* opts;
+				bool* prefers_node;
 	
 				std::decay_t<F> func;
 				hsd::tuple<decay_t<Args>...> args;
@@ -64,23 +252,33 @@ namespace hsd
 				static void* enter_thread(void* arg) 
 				{
 					auto td = hsd::move(*reinterpret_cast<thread_data*>(arg));
+					*td.prefers_node = td.opts->apply_self();
 	
 					// Tell our parent we are ready and copied the data
-					__atomic_store_n(td.ready, 1, __ATOMIC_RELEASE);
-					hsd::apply(td.func, td.args);
+					td.ready->count_down();
+					hsd::apply(td.func, hsd::move(td.args));
 	
 					return nullptr;
 				}
 			} td {
 				&ready,
+				&opts,
+				&prefers_node_,
 				decay_copy(hsd::forward<F>(func)),
 				hsd::make_tuple(decay_copy(hsd::forward<Args>(args))...)
 			};
 	
-			pthread_create(&id_, &attr, thread_data::enter_thread, &td);
+			i32 result = pthread_create(&id_, &attr, thread_data::enter_thread, &td);
+			pthread_attr_destroy(&attr);
+
+			if (result != 0)
+			{
+				id_ = 0;
+				throw std::runtime_error("Cannot create thread");
+			}
 	
-			// Spinlock time
-			while (!__atomic_load_n(&ready, __ATOMIC_ACQUIRE));
+			// Sleeps on a futex instead of spinning while the child starts
+			ready.wait();
 		}
 	
 		thread(const thread &) = delete;
@@ -100,6 +298,7 @@ namespace hsd
 		void swap(thread &other) 
 		{ 
 			hsd::swap(id_, other.id_); 
+			hsd::swap(prefers_node_, other.prefers_node_);
 		}
 	
 		id get_id() 
@@ -110,6 +309,14 @@ namespace hsd
 		bool joinable() {
 			return get_id() != id{};
 		}
+
+		/// Whether the thread's allocations prefer the memory of the node
+		/// given to `options::numa_node`, false if none was given or the
+		/// kernel refused it (the thread still runs on the node's CPUs)
+		bool prefers_node() const
+		{
+			return prefers_node_;
+		}
 	
 		native_handle_type native_handle() 
 		{
@@ -118,7 +325,8 @@ namespace hsd
 	
 		static u32 hardware_concurrency() 
 		{
-			return 0;
+			i64 count = sysconf(_SC_NPROCESSORS_ONLN);
+			return count > 0 ? static_cast<u32>(count) : 0;
 		}
 	
 		void detach() 
@@ -135,5 +343,33 @@ namespace hsd
 	
 	private:
 		pthread_t id_;
+		bool prefers_node_ = false;
 	}; // struct thread
+
+	namespace this_thread
+	{
+		static inline bool pin_to(const cpu_set_t& cpus)
+		{
+			return pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) == 0;
+		}
+
+		/// Restricts the calling thread to a single CPU
+		static inline bool pin_to(usize cpu)
+		{
+			cpu_set_t cpus;
+			CPU_ZERO(&cpus);
+			CPU_SET(cpu, &cpus);
+			return pin_to(cpus);
+		}
+
+		static inline void set_name(const char* name)
+		{
+			pthread_setname_np(pthread_self(), name);
+		}
+
+		static inline void yield()
+		{
+			sched_yield();
+		}
+	} // namespace this_thread
 } // namespace hsd
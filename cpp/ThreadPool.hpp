@@ -0,0 +1,191 @@
+#pragma once
+
+#include "Thread.hpp"
+#include "Vector.hpp"
+
+namespace hsd
+{
+    /// Fork-join pool for data parallel work. `run(count, func)` calls
+    /// `func(index)` for every index below `count`, spread over the
+    /// workers and the calling thread, and returns once all are done.
+    /// Jobs live inside the pool, so submitting one doesn't allocate;
+    /// `func` must not throw. Calls made from inside a job run inline
+    class thread_pool
+    {
+    private:
+        static constexpr u64 _index_mask = 0xffffffffu;
+        static constexpr u32 _spin_limit = 256;
+
+        vector<thread> _workers;
+        mutex _submit;
+
+        // The generation of the current job, idle workers sleep on it
+        alignas(sync_detail::cache_line) u32 _epoch = 0;
+        u32 _sleepers = 0;
+        bool _stop = false;
+
+        // Generation in the high half, next unclaimed index in the low half
+        alignas(sync_detail::cache_line) u64 _next = 0;
+        alignas(sync_detail::cache_line) u32 _pending = 0;
+
+        u32 _count = 0;
+        void (*_invoke)(void*, usize) = nullptr;
+        void* _context = nullptr;
+
+        static bool& _inside()
+        {
+            static thread_local bool _flag = false;
+            return _flag;
+        }
+
+        template < typename Func >
+        static void _call(void* context, usize index) noexcept
+        {
+            (*static_cast<remove_reference_t<Func>*>(context))(index);
+        }
+
+        // Claims and runs one index of job `gen`, false once there are none left
+        bool _run_one(u32 gen)
+        {
+            u32 _job_count = __atomic_load_n(&_count, __ATOMIC_ACQUIRE);
+            auto _job_invoke = __atomic_load_n(&_invoke, __ATOMIC_ACQUIRE);
+            void* _job_context = __atomic_load_n(&_context, __ATOMIC_ACQUIRE);
+            u64 _current = __atomic_load_n(&_next, __ATOMIC_ACQUIRE);
+
+            // The generation check also rejects fields read while the
+            // next job was being published, `_next` is closed before them
+            do
+            {
+                if((_current >> 32) != gen || (_current & _index_mask) >= _job_count)
+                    return false;
+            } while(!__atomic_compare_exchange_n(&_next, &_current, _current + 1,
+                true, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE));
+
+            _job_invoke(_job_context, static_cast<usize>(_current & _index_mask));
+
+            if(__atomic_sub_fetch(&_pending, 1u, __ATOMIC_ACQ_REL) == 0)
+                sync_detail::futex_wake(&_pending, 1);
+
+            return true;
+        }
+
+        void _worker()
+        {
+            _inside() = true;
+            u32 _seen = 0;
+            u32 _spins = 0;
+
+            while(true)
+            {
+                u32 _gen = __atomic_load_n(&_epoch, __ATOMIC_ACQUIRE);
+
+                if(_gen != _seen)
+                {
+                    _seen = _gen;
+                    _spins = 0;
+
+                    while(_run_one(_gen)) {}
+
+                    continue;
+                }
+                if(__atomic_load_n(&_stop, __ATOMIC_ACQUIRE))
+                    return;
+
+                // Jobs often come in bursts (the rounds of a sort), so
+                // look for the next one briefly before going to sleep
+                if(++_spins < _spin_limit)
+                {
+                    sync_detail::cpu_relax();
+                    continue;
+                }
+
+                __atomic_fetch_add(&_sleepers, 1u, __ATOMIC_SEQ_CST);
+
+                if(__atomic_load_n(&_epoch, __ATOMIC_SEQ_CST) == _seen)
+                    sync_detail::futex_wait(&_epoch, _seen);
+
+                __atomic_fetch_sub(&_sleepers, 1u, __ATOMIC_RELAXED);
+            }
+        }
+
+        void _publish(u32 gen)
+        {
+            __atomic_store_n(&_epoch, gen, __ATOMIC_SEQ_CST);
+
+            if(__atomic_load_n(&_sleepers, __ATOMIC_SEQ_CST) != 0)
+                sync_detail::futex_wake(&_epoch, 0x7fffffff);
+        }
+
+    public:
+        /// Starts `workers` threads, the thread calling `run` is one more
+        explicit thread_pool(usize workers)
+        {
+            _workers.reserve(workers);
+
+            for(usize _index = 0; _index < workers; _index++)
+                _workers.emplace_back([this] { _worker(); });
+        }
+
+        thread_pool(const thread_pool&) = delete;
+        thread_pool& operator=(const thread_pool&) = delete;
+
+        ~thread_pool()
+        {
+            __atomic_store_n(&_stop, true, __ATOMIC_RELEASE);
+            _publish(_epoch + 1);
+
+            for(auto& _worker_thread : _workers)
+                _worker_thread.join();
+        }
+
+        /// Shared pool with one worker per online CPU besides the caller
+        static thread_pool& global()
+        {
+            static thread_pool _pool{max(thread::hardware_concurrency(), 1u) - 1};
+            return _pool;
+        }
+
+        /// Threads taking part in a job, the caller included
+        usize concurrency() const
+        {
+            return _workers.size() + 1;
+        }
+
+        template < typename Func >
+        void run(usize count, Func&& func)
+        {
+            if(count == 0)
+                return;
+
+            if(_workers.size() == 0 || count == 1 || _inside())
+            {
+                for(usize _index = 0; _index < count; _index++)
+                    func(_index);
+
+                return;
+            }
+            if(count > _index_mask)
+                throw std::runtime_error("Too many indices for one job");
+
+            lock_guard _guard{_submit};
+            _inside() = true;
+            u32 _gen = _epoch + 1;
+            u64 _base = static_cast<u64>(_gen) << 32;
+
+            __atomic_store_n(&_next, _base | _index_mask, __ATOMIC_SEQ_CST);
+            __atomic_store_n(&_count, static_cast<u32>(count), __ATOMIC_RELEASE);
+            __atomic_store_n(&_invoke, &_call<Func>, __ATOMIC_RELEASE);
+            __atomic_store_n(&_context, static_cast<void*>(addressof(func)), __ATOMIC_RELEASE);
+            __atomic_store_n(&_pending, static_cast<u32>(count), __ATOMIC_RELAXED);
+            __atomic_store_n(&_next, _base, __ATOMIC_RELEASE);
+            _publish(_gen);
+
+            while(_run_one(_gen)) {}
+
+            for(u32 _pending_now; (_pending_now = __atomic_load_n(&_pending, __ATOMIC_ACQUIRE)) != 0;)
+                sync_detail::futex_wait(&_pending, _pending_now);
+
+            _inside() = false;
+        }
+    };
+} // namespace hsd
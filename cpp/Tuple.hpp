@@ -5,136 +5,216 @@
 
 namespace hsd
 {
-    template < typename... T >
-    class tuple
+    template < typename... T > class tuple;
+
+    namespace tuple_detail
     {
-    public:
-        static constexpr usize size()
+        // Stores element `I`, empty classes become a base so they take no space
+        template < usize I, typename T, bool = std::is_empty_v<T> && !std::is_final_v<T> >
+        class tuple_leaf
         {
-            return sizeof...(T);
-        }
-    };
-
-    template < typename... Args > static constexpr auto make_tuple(Args&&... args);
+        private:
+            T _value;
 
-    template < typename Tuple1, typename Tuple2 >
-    using is_same_tuple = std::is_same<Tuple1, Tuple2>;
+        public:
+            constexpr tuple_leaf() = default;
 
-    template < typename T, typename... Rest >
-    class tuple<T, Rest...>
-    {   
-    public:   
-        T _first;
-        tuple<Rest...> _rest;        
+            template <typename U>
+            constexpr tuple_leaf(U&& value)
+                : _value(hsd::forward<U>(value))
+            {}
 
-    private:
-        template < usize N, typename U >
-        struct get_helper {};
+            constexpr T& get() noexcept
+            {
+                return _value;
+            }
 
-        template < typename U, typename... Args >
-        struct get_helper< 0, tuple<U, Args...> >
-        {
-            static constexpr U get(const tuple<U, Args...>& data)
+            constexpr const T& get() const noexcept
             {
-                return data._first;
+                return _value;
             }
         };
 
-        template < usize N, typename U, typename... Args >
-        struct get_helper< N, tuple<U, Args...> >
+        template < usize I, typename T >
+        class tuple_leaf<I, T, true> : private T
         {
-            static constexpr auto get(const tuple<U, Args...>& data)
+        public:
+            constexpr tuple_leaf() = default;
+
+            template <typename U>
+            constexpr tuple_leaf(U&& value)
+                : T(hsd::forward<U>(value))
+            {}
+
+            constexpr T& get() noexcept
             {
-                return get_helper<N - 1, tuple<Args...>>::get(data._rest);
+                return *this;
+            }
+
+            constexpr const T& get() const noexcept
+            {
+                return *this;
             }
         };
 
-        template < usize N, typename... U >
-        static constexpr auto _get(const tuple<U...>& tup) 
+        template < typename Seq, typename... T >
+        class tuple_impl;
+
+        // Every element is a direct base, so element lookup is a single
+        // base conversion instead of walking a recursive chain
+        template < usize... Ints, typename... T >
+        class tuple_impl< index_sequence<Ints...>, T... >
+            : public tuple_leaf<Ints, T>...
         {
-            return get_helper<N, tuple<U...>>::get(tup);
+        public:
+            constexpr tuple_impl() = default;
+
+            template < typename... U >
+            constexpr tuple_impl(U&&... values)
+                : tuple_leaf<Ints, T>(hsd::forward<U>(values))...
+            {}
+        };
+
+        template < usize I, typename T, bool B >
+        static constexpr tuple_leaf<I, T, B>& leaf(tuple_leaf<I, T, B>& value) noexcept
+        {
+            return value;
+        }
+
+        template < usize I, typename T, bool B >
+        static constexpr const tuple_leaf<I, T, B>& leaf(const tuple_leaf<I, T, B>& value) noexcept
+        {
+            return value;
         }
+
+        template < usize I, typename T, bool B >
+        static constexpr T leaf_type(const tuple_leaf<I, T, B>&);
+    } // namespace tuple_detail
+
+    template < usize I, typename Tuple >
+    struct tuple_element
+    {
+        using type = decltype(tuple_detail::leaf_type<I>(std::declval<Tuple&>()));
+    };
+
+    template < usize I, typename Tuple >
+    using tuple_element_t = typename tuple_element<I, Tuple>::type;
+
+    template < typename Tuple1, typename Tuple2 >
+    using is_same_tuple = std::is_same<Tuple1, Tuple2>;
+
+    template < typename... T >
+    class tuple
+        : public tuple_detail::tuple_impl< make_index_sequence<sizeof...(T)>, T... >
+    {
+    private:
+        using _base = tuple_detail::tuple_impl< make_index_sequence<sizeof...(T)>, T... >;
+
     public:
-        tuple() = default;
+        constexpr tuple() = default;
+        constexpr tuple(const tuple&) = default;
+        constexpr tuple(tuple&&) = default;
 
-        constexpr tuple(const T& first, const Rest&... rest) 
-            : _first(first), _rest(rest...)
+        constexpr tuple(const T&... values) requires (sizeof...(T) > 0)
+            : _base(values...)
         {}
 
-        constexpr tuple(const tuple& other)
-            : _first{other._first}, _rest{other._rest}
+        template < typename... U >
+        requires (sizeof...(U) == sizeof...(T) && sizeof...(T) > 0 &&
+            !(sizeof...(T) == 1 && (std::is_same_v<decay_t<U>, tuple> && ...)) &&
+            (std::is_constructible_v<T, U&&> && ...))
+        constexpr tuple(U&&... values)
+            : _base(hsd::forward<U>(values)...)
         {}
 
-        template < typename... Args >
-        constexpr tuple& operator=(const tuple<Args...>& other)
+        constexpr tuple& operator=(const tuple& other)
         {
-            _first = other._first;
-            _rest = other._rest;
+            [&]<usize... Ints>(index_sequence<Ints...>)
+            {
+                ((get<Ints>() = other.template get<Ints>()), ...);
+            }(make_index_sequence<sizeof...(T)>{});
 
             return *this;
         }
 
-        template <typename... Args>
-        constexpr auto operator+(const tuple<Args...>& rhs) 
+        constexpr tuple& operator=(tuple&& other)
         {
-            auto _add = [&]< usize... Ints1, usize... Ints2>(
-                index_sequence<Ints1...> int_seq1, 
-                index_sequence<Ints2...> int_seq2
-            ) -> tuple<T, Rest..., Args...> {
+            [&]<usize... Ints>(index_sequence<Ints...>)
+            {
+                ((get<Ints>() = hsd::move(other).template get<Ints>()), ...);
+            }(make_index_sequence<sizeof...(T)>{});
 
-                [](auto... args) {
-                    static_assert(is_same_tuple<tuple<T, Rest..., Args...>, tuple<decltype(args)...>>{});
-                }(get<Ints1>()..., rhs.template get<Ints2>()...);
+            return *this;
+        }
 
-                return make_tuple<T, Rest..., Args...>(
-                    get<Ints1>()..., rhs.template get<Ints2>()...
-                );
-            };
+        template < typename... Args > requires (sizeof...(Args) == sizeof...(T))
+        constexpr tuple& operator=(const tuple<Args...>& other)
+        {
+            [&]<usize... Ints>(index_sequence<Ints...>)
+            {
+                ((get<Ints>() = other.template get<Ints>()), ...);
+            }(make_index_sequence<sizeof...(T)>{});
 
-            return _add(index_sequence_for<T , Rest...>{}, index_sequence_for<Args...>{});
+            return *this;
         }
 
-        template <typename... Args>
+        template < typename... Args >
         constexpr auto operator+(const tuple<Args...>& rhs) const
         {
-            auto _add = [&]< usize... Ints1, usize... Ints2>(
-                index_sequence<Ints1...> int_seq1, 
-                index_sequence<Ints2...> int_seq2
-            ) -> tuple<T, Rest..., Args...> {
-
-                [](auto... args) {
-                    static_assert(is_same_tuple<tuple<T, Rest..., Args...>, tuple<decltype(args)...>>{});
-                }(get<Ints1>()..., rhs.template get<Ints2>()...);
-
-                return make_tuple<T, Rest..., Args...>(
+            return [&]<usize... Ints1, usize... Ints2>(
+                index_sequence<Ints1...>, index_sequence<Ints2...>)
+            {
+                return tuple<T..., Args...>(
                     get<Ints1>()..., rhs.template get<Ints2>()...
                 );
-            };
+            }(index_sequence_for<T...>{}, index_sequence_for<Args...>{});
+        }
 
-            return _add(index_sequence_for<T , Rest...>{}, index_sequence_for<Args...>{});
+        template <usize N>
+        constexpr auto& get() & noexcept
+        {
+            return tuple_detail::leaf<N>(*this).get();
         }
 
         template <usize N>
-        constexpr auto get() 
+        constexpr const auto& get() const& noexcept
         {
-            return _get<N, T, Rest...>(*this);
+            return tuple_detail::leaf<N>(*this).get();
         }
 
         template <usize N>
-        constexpr auto get() const
+        constexpr tuple_element_t<N, tuple>&& get() && noexcept
         {
-            return _get<N, T, Rest...>(*this);
+            return static_cast<tuple_element_t<N, tuple>&&>(tuple_detail::leaf<N>(*this).get());
         }
 
         static constexpr usize size()
         {
-            return 1 + sizeof...(Rest);
+            return sizeof...(T);
         }
     };
 
     template < typename... UTypes > tuple(UTypes...) -> tuple<UTypes...>;
     template < typename T1, typename T2 > tuple(pair<T1, T2>) -> tuple<T1, T2>;
 
+    template < usize N, typename... T >
+    static constexpr auto& get(tuple<T...>& value) noexcept
+    {
+        return value.template get<N>();
+    }
+
+    template < usize N, typename... T >
+    static constexpr const auto& get(const tuple<T...>& value) noexcept
+    {
+        return value.template get<N>();
+    }
+
+    template < usize N, typename... T >
+    static constexpr decltype(auto) get(tuple<T...>&& value) noexcept
+    {
+        return hsd::move(value).template get<N>();
+    }
+
     template <typename... Args>
     static constexpr auto make_tuple(Args&&... args)
     {
@@ -144,18 +224,65 @@ namespace hsd
     template <typename... Args>
     static constexpr auto tie(Args&... args)
     {
-        return tuple<decay_t<Args>&...>(args...);
+        return tuple<Args&...>(args...);
+    }
+
+    template <typename... Args>
+    static constexpr auto forward_as_tuple(Args&&... args)
+    {
+        return tuple<Args&&...>(hsd::forward<Args>(args)...);
+    }
+
+    template < typename Func, typename Tuple, usize... Ints >
+    static constexpr decltype(auto) apply_impl(Func&& func, Tuple&& args, index_sequence<Ints...>)
+    {
+        return hsd::forward<Func>(func)(hsd::get<Ints>(hsd::forward<Tuple>(args))...);
+    }
+
+    /// Calls `func` with the elements of `args`, elements of an rvalue
+    /// tuple are moved into the call instead of copied
+    template < typename Func, typename Tuple >
+    static constexpr decltype(auto) apply(Func&& func, Tuple&& args)
+    {
+        return apply_impl(hsd::forward<Func>(func), hsd::forward<Tuple>(args),
+            make_index_sequence<remove_reference_t<Tuple>::size()>{});
     }
 
-    template < typename Func, typename... Args, usize... Is >
-    static constexpr auto apply_impl(Func&& func, index_sequence<Is...>, const tuple<Args...>& args) 
+    namespace tuple_detail
     {
-        return func(args.template get<Is>()...);
+        template < typename Tuple1, typename Tuple2, usize... Ints1, usize... Ints2 >
+        static constexpr auto cat_two(Tuple1&& lhs, Tuple2&& rhs,
+            index_sequence<Ints1...>, index_sequence<Ints2...>)
+        {
+            using lhs_type = remove_reference_t<Tuple1>;
+            using rhs_type = remove_reference_t<Tuple2>;
+
+            return tuple< tuple_element_t<Ints1, lhs_type>..., tuple_element_t<Ints2, rhs_type>... >(
+                hsd::get<Ints1>(hsd::forward<Tuple1>(lhs))...,
+                hsd::get<Ints2>(hsd::forward<Tuple2>(rhs))...
+            );
+        }
+    } // namespace tuple_detail
+
+    static constexpr tuple<> tuple_cat()
+    {
+        return {};
     }
-    
-    template < typename Func, typename... Args >
-    static constexpr auto apply(Func&& func, const tuple<Args...>& args)
+
+    template < typename Tuple >
+    static constexpr auto tuple_cat(Tuple&& value)
+    {
+        return decay_t<Tuple>(hsd::forward<Tuple>(value));
+    }
+
+    template < typename Tuple1, typename Tuple2, typename... Rest >
+    static constexpr auto tuple_cat(Tuple1&& lhs, Tuple2&& rhs, Rest&&... rest)
     {
-      return apply_impl(hsd::forward<Func>(func), make_index_sequence<sizeof...(Args)>{}, args);
+        return tuple_cat(
+            tuple_detail::cat_two(hsd::forward<Tuple1>(lhs), hsd::forward<Tuple2>(rhs),
+                make_index_sequence<remove_reference_t<Tuple1>::size()>{},
+                make_index_sequence<remove_reference_t<Tuple2>::size()>{}),
+            hsd::forward<Rest>(rest)...
+        );
     }
-}
\ No newline at end of file
+}
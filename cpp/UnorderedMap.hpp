@@ -3,49 +3,292 @@
 #include "Pair.hpp"
 #include "Vector.hpp"
 #include "Hash.hpp"
-#include "Reference.hpp"
+#include "Limits.hpp"
 
 namespace hsd
 {
-    template< typename Key, typename T, typename Hasher = fnv1a<usize> >
+    template< typename Key, typename T, typename Hasher = hash<Key> >
     class unordered_map;
 
     namespace _detail
     {
-        template< typename Key, typename T, typename Hasher = fnv1a<usize> >
+        template< typename Key, typename T, typename Hasher = hash<Key> >
         class map_value
         {
         private:
-            usize _index = 0;
+            // Hash of the key, so moving the entry finds its slot without `Hasher`
+            usize _hash = 0;
             pair<Key, T> _data;
             friend class unordered_map< Key, T, Hasher >;
-        
+
         public:
             using value_type = T;
             using reference_type = T&;
 
             HSD_CONSTEXPR map_value() = default;
 
-            HSD_CONSTEXPR map_value(usize index, const Key& key, const value_type& val)
-                : _index{index}, _data{key, val}
+            template< typename NewKey, typename NewValue >
+            HSD_CONSTEXPR map_value(usize hash, NewKey&& key, NewValue&& val)
+                : _hash{hash}, _data{static_cast<Key>(forward<NewKey>(key)), static_cast<T>(forward<NewValue>(val))}
             {}
 
-            HSD_CONSTEXPR map_value(usize index, Key&& key, value_type&& val)
-                : _index{index}, _data{move(key), move(val)}
-            {}
+            constexpr pair<Key, T>& get() noexcept
+            {
+                return _data;
+            }
+        };
+
+        // Index table entry, `index` is the position in the data vector
+        // plus one so a zeroed slot is empty
+        struct map_slot
+        {
+            usize hash = 0;
+            usize index = 0;
+        };
+
+        /// Open addressing index shared by the unordered containers. It
+        /// maps each entry's hash to its position in the container's dense
+        /// entry vector and keeps the hash, so growing never calls `Hasher`
+        /// again and probes compare hashes before keys. What counts as a
+        /// matching entry is up to the container
+        class hash_index
+        {
+        private:
+            static constexpr usize _min_buckets = 16;
+            vector<map_slot> _slots;
+
+            static constexpr void _place(vector<map_slot>& slots, usize hash, usize index)
+            {
+                usize _mask = slots.size() - 1;
+                usize _pos = hash & _mask;
+
+                while(slots[_pos].index != 0)
+                    _pos = (_pos + 1) & _mask;
+
+                slots[_pos] = {hash, index + 1};
+            }
+
+            HSD_CONSTEXPR void _replace(usize buckets)
+            {
+                vector<map_slot> _new_slots(buckets);
+
+                for(usize _index = 0; _index < _slots.size(); _index++)
+                {
+                    if(_slots[_index].index != 0)
+                        _place(_new_slots, _slots[_index].hash, _slots[_index].index - 1);
+                }
+
+                _slots = move(_new_slots);
+            }
+
+        public:
+            static constexpr usize npos = static_cast<usize>(-1);
+
+            // Smallest power of two that keeps `count` entries at most 3/4 full
+            static constexpr usize buckets_for(usize count)
+            {
+                usize _buckets = _min_buckets;
+
+                while(_buckets * 3 < count * 4)
+                    _buckets <<= 1;
+
+                return _buckets;
+            }
+
+            /// Slot of the first entry with this hash that `matches`, or `npos`
+            template< typename Pred >
+            constexpr usize find(usize hash, Pred&& matches) const
+            {
+                if(_slots.size() == 0)
+                    return npos;
+
+                usize _mask = _slots.size() - 1;
+
+                for(usize _pos = hash & _mask; _slots[_pos].index != 0; _pos = (_pos + 1) & _mask)
+                {
+                    const map_slot& _slot = _slots[_pos];
+
+                    if(_slot.hash == hash && matches(_slot.index - 1))
+                        return _pos;
+                }
+
+                return npos;
+            }
+
+            /// Slot pointing at entry `index`, found without comparing keys
+            constexpr usize slot_of(usize hash, usize index) const
+            {
+                return find(hash, [index](usize other) { return other == index; });
+            }
+
+            constexpr usize entry(usize pos) const
+            {
+                return _slots[pos].index - 1;
+            }
+
+            constexpr void set_entry(usize pos, usize index)
+            {
+                _slots[pos].index = index + 1;
+            }
 
-            constexpr pair<Key, T>& get() noexcept 
-            { 
-                return _data; 
+            /// Adds entry `index`, growing first if the container is about
+            /// to hold more than `count` entries than the index allows
+            HSD_CONSTEXPR void insert(usize hash, usize index, usize count)
+            {
+                if(count * 4 > _slots.size() * 3)
+                    _replace(buckets_for(count));
+
+                _place(_slots, hash, index);
+            }
+
+            // Backward shift deletion, pulls later entries of the probe run
+            // into the hole so lookups never need tombstones
+            HSD_CONSTEXPR void erase(usize pos)
+            {
+                usize _mask = _slots.size() - 1;
+
+                for(usize _next = (pos + 1) & _mask; _slots[_next].index != 0; _next = (_next + 1) & _mask)
+                {
+                    usize _home = _slots[_next].hash & _mask;
+
+                    if(((_next - _home) & _mask) >= ((_next - pos) & _mask))
+                    {
+                        _slots[pos] = _slots[_next];
+                        pos = _next;
+                    }
+                }
+
+                _slots[pos] = {};
+            }
+
+            constexpr void prefetch(usize hash) const
+            {
+                if(_slots.size() != 0)
+                    __builtin_prefetch(&_slots[hash & (_slots.size() - 1)]);
+            }
+
+            HSD_CONSTEXPR void reserve(usize count)
+            {
+                if(buckets_for(count) > _slots.size())
+                    _replace(buckets_for(count));
+            }
+
+            /// Resizes to at least `buckets` (rounded up to a power of two)
+            /// and at least what `count` entries need, can also shrink
+            HSD_CONSTEXPR void rehash(usize buckets, usize count)
+            {
+                usize _buckets = buckets_for(count);
+
+                while(_buckets < buckets)
+                    _buckets <<= 1;
+
+                if(_buckets != _slots.size())
+                    _replace(_buckets);
+            }
+
+            HSD_CONSTEXPR void clear()
+            {
+                for(usize _index = 0; _index < _slots.size(); _index++)
+                    _slots[_index] = {};
+            }
+
+            constexpr usize bucket_count() const
+            {
+                return _slots.size();
             }
         };
 
-        template< typename Key, typename T, typename Hasher = fnv1a<usize> >
+        // Keys are hashed and their home buckets prefetched a block at a
+        // time before any of them is probed, so the cache misses of a block
+        // overlap instead of being paid one after the other
+        static constexpr usize insert_batch = 16;
+
+        template< typename It, typename HashFn, typename InsertFn >
+        HSD_CONSTEXPR void insert_batched(It first, It last, const hash_index& table, HashFn&& hash_of, InsertFn&& insert)
+        {
+            usize _hashes[insert_batch];
+
+            while(first != last)
+            {
+                It _block = first;
+                usize _count = 0;
+
+                for(; _count < insert_batch && first != last; ++first, ++_count)
+                {
+                    _hashes[_count] = hash_of(*first);
+                    table.prefetch(_hashes[_count]);
+                }
+
+                for(usize _index = 0; _index < _count; ++_index, ++_block)
+                    insert(*_block, _hashes[_index]);
+            }
+        }
+
+        /// Whether an arithmetic lookup key converts to `Key` and back
+        /// unchanged, one that doesn't can't equal any stored key and
+        /// converting it would narrow it onto one that might
+        template< typename Key, typename NewKey >
+        static constexpr bool holds_exactly(const NewKey& key)
+        {
+            if constexpr(!std::is_arithmetic_v<Key> || !std::is_arithmetic_v<NewKey> || is_same<Key, NewKey>::value)
+            {
+                return true;
+            }
+            else if constexpr(std::is_integral_v<Key> && std::is_floating_point_v<NewKey>)
+            {
+                // Both bounds are powers of two, so exact, and NaN fails them
+                constexpr NewKey _lower = static_cast<NewKey>(limits<Key>::min);
+                constexpr NewKey _upper = static_cast<NewKey>(limits<Key>::max / 2 + 1) * 2;
+
+                return key >= _lower && key < _upper && static_cast<NewKey>(static_cast<Key>(key)) == key;
+            }
+            else if constexpr(std::is_floating_point_v<Key> && std::is_integral_v<NewKey>)
+            {
+                // Converting back is only defined below the integer's bound
+                constexpr Key _upper = static_cast<Key>(limits<NewKey>::max / 2 + 1) * 2;
+                Key _key = static_cast<Key>(key);
+
+                return _key < _upper && static_cast<NewKey>(_key) == key;
+            }
+            else if constexpr(std::is_integral_v<Key>)
+            {
+                Key _key = static_cast<Key>(key);
+                return static_cast<NewKey>(_key) == key && (_key < Key{}) == (key < NewKey{});
+            }
+            else
+            {
+                return static_cast<NewKey>(static_cast<Key>(key)) == key;
+            }
+        }
+
+        template< typename Key, typename NewKey >
+        static constexpr bool key_equal(const Key& lhs, const NewKey& rhs)
+        {
+            if constexpr(is_char_pointer<decay_t<Key>>::value && is_char_pointer<decay_t<NewKey>>::value)
+            {
+                usize _index = 0;
+
+                for(; lhs[_index] != '\0' && lhs[_index] == rhs[_index]; _index++);
+
+                return lhs[_index] == rhs[_index];
+            }
+            else if constexpr(std::is_arithmetic_v<Key> && std::is_arithmetic_v<NewKey>)
+            {
+                return holds_exactly<Key>(rhs) && lhs == static_cast<Key>(rhs);
+            }
+            else
+            {
+                return lhs == rhs;
+            }
+        }
+
+        /// Walks a dense entry vector, `Value` is what an entry's `get` gives
+        template< typename Entry, typename Value >
         class iterator
         {
         private:
-            using value_type = map_value< Key, T, Hasher >;
-            map_value< Key, T, Hasher >* _it;
+            using value_type = Entry;
+            Entry* _it;
 
         public:
             HSD_CONSTEXPR iterator(value_type* iter) noexcept
@@ -94,129 +337,126 @@ namespace hsd
                 return tmp;
             }
 
-            constexpr pair<Key, T>& operator*() noexcept
+            constexpr Value& operator*() noexcept
             {
                 return _it->get();
             }
 
-            constexpr pair<Key, T>& operator*() const noexcept
+            constexpr Value& operator*() const noexcept
             {
                 return _it->get();
             }
 
-            constexpr pair<Key, T>* operator->() noexcept
+            constexpr Value* operator->() noexcept
             {
                 return &_it->get();
             }
 
-            constexpr pair<Key, T>* operator->() const noexcept
+            constexpr Value* operator->() const noexcept
             {
                 return &_it->get();
             }
         };
     } // namespace _detail
 
+    /// Entries live densely in insertion order, lookups go through an open
+    /// addressing index of power of two size that keeps each entry's hash,
+    /// so growing never calls `Hasher` again and probes compare hashes first
     template< typename Key, typename T, typename Hasher >
     class unordered_map
     {
     private:
         using map_value_type = _detail::map_value< Key, T, Hasher >;
-        vector< vector< reference<map_value_type> > > _buckets;
-        static constexpr f64 _limit_ratio = 0.75f;
+        static constexpr usize _npos = _detail::hash_index::npos;
+        _detail::hash_index _table;
         vector<map_value_type> _data;
 
-        HSD_CONSTEXPR void _replace()
+        template< typename NewKey >
+        constexpr usize _find_slot(const NewKey& key, usize key_hash) const
         {
-            usize _new_size = _buckets.size() * 2;
-            _buckets.clear();
-            _buckets.resize(_new_size);
-
-            for(map_value_type& _val : _data)
+            return _table.find(key_hash, [&](usize index)
             {
-                auto _hash_rez = Hasher::get_hash(_val._data.first);
-                usize _index = _hash_rez % _new_size;
-                _buckets[_index].emplace_back(_val);
-            }
+                return _detail::key_equal(_data[index]._data.first, key);
+            });
         }
 
-        constexpr usize _get(const Key& key)
+        // Lookups hash only keys that `Key` holds exactly
+        template< typename NewKey >
+        constexpr usize _find_slot(const NewKey& key) const
         {
-            auto _key_hash = Hasher::get_hash(key);
-            usize _index = _key_hash % _buckets.size();
+            if(!_detail::holds_exactly<Key>(key))
+                return _npos;
 
-            for(map_value_type& _val : _buckets[_index])
-            {
-                if(_key_hash == Hasher::get_hash(_val._data.first))
-                {
-                    return _val._index;
-                }
-            }
+            return _find_slot(key, static_cast<usize>(Hasher::get_hash(key)));
+        }
+
+        template< typename NewKey >
+        constexpr usize _get(const NewKey& key, usize key_hash) const
+        {
+            usize _pos = _find_slot(key, key_hash);
+            return _pos == _npos ? _npos : _table.entry(_pos);
+        }
 
-            return -1;
+        template< typename NewKey >
+        constexpr usize _get(const NewKey& key) const
+        {
+            usize _pos = _find_slot(key);
+            return _pos == _npos ? _npos : _table.entry(_pos);
         }
 
     public:
         using reference_type = T&;
-        using iterator = _detail::iterator< Key, T, Hasher >;
+        using iterator = _detail::iterator< map_value_type, pair<Key, T> >;
         using const_iterator = typename vector<map_value_type>::const_iterator;
 
         HSD_CONSTEXPR ~unordered_map() = default;
 
-        HSD_CONSTEXPR unordered_map()
-            : _buckets(10)
-        {}
+        HSD_CONSTEXPR unordered_map() = default;
 
         HSD_CONSTEXPR unordered_map(const unordered_map& other)
-            : _buckets{other._buckets.size()}, _data{other._data}
-        {
-            for(auto& _val : _data)
-            {
-                auto _hash_rez = Hasher::get_hash(_val._data.first);
-                usize _index = _hash_rez % _buckets.size();
-                _buckets[_index].emplace_back(_val);
-            }
-        }
+            : _table{other._table}, _data{other._data}
+        {}
 
         HSD_CONSTEXPR unordered_map(unordered_map&& other)
-            : _buckets{move(other._buckets)}, _data{move(other._data)}
+            : _table{move(other._table)}, _data{move(other._data)}
         {}
 
         HSD_CONSTEXPR unordered_map(const std::initializer_list<pair<Key, T>>& other)
-            : _buckets(10)
         {
+            reserve(other.size());
+
             for(auto& val : other)
                 emplace(val.first, val.second);
         }
 
         HSD_CONSTEXPR unordered_map(std::initializer_list<pair<Key, T>>&& other)
-            : _buckets(10)
         {
+            reserve(other.size());
+
             for(auto& val : other)
                 emplace(move(val.first), move(val.second));
         }
 
         HSD_CONSTEXPR unordered_map& operator=(unordered_map&& rhs)
         {
-            _buckets = move(rhs._buckets);
+            _table = move(rhs._table);
             _data = move(rhs._data);
             return *this;
         }
 
         HSD_CONSTEXPR unordered_map& operator=(const unordered_map& rhs)
         {
-            clear();
-
-            for(pair<Key, T>& val : rhs._data)
-                emplace(val.first, val.second);
-
+            _table = rhs._table;
+            _data = rhs._data;
             return *this;
         }
 
         HSD_CONSTEXPR unordered_map& operator=(const std::initializer_list<pair<Key, T>>& rhs)
         {
             clear();
+            reserve(rhs.size());
 
-            for(auto& val : rhs._data)
+            for(auto& val : rhs)
                 emplace(val.first, val.second);
 
             return *this;
@@ -225,8 +465,9 @@ namespace hsd
         HSD_CONSTEXPR unordered_map& operator=(std::initializer_list<pair<Key, T>>&& rhs)
         {
             clear();
+            reserve(rhs.size());
 
-            for(auto& val : rhs._data)
+            for(auto& val : rhs)
                 emplace(move(val.first), move(val.second));
 
             return *this;
@@ -237,16 +478,11 @@ namespace hsd
             return emplace(key).first->second;
         }
 
-        HSD_CONSTEXPR reference_type operator[](const Key& key) const noexcept
-        {
-            return emplace(key).first->second;
-        }
-
         HSD_CONSTEXPR reference_type at(const Key& key)
         {
             usize _data_index = _get(key);
 
-            if(_data_index == static_cast<usize>(-1))
+            if(_data_index == _npos)
             {
                 throw std::out_of_range("");
             }
@@ -254,11 +490,11 @@ namespace hsd
             return _data[_data_index]._data.second;
         }
 
-        HSD_CONSTEXPR reference_type at(const Key& key) const
+        HSD_CONSTEXPR const T& at(const Key& key) const
         {
             usize _data_index = _get(key);
 
-            if(_data_index == static_cast<usize>(-1))
+            if(_data_index == _npos)
             {
                 throw std::out_of_range("");
             }
@@ -266,50 +502,128 @@ namespace hsd
             return _data[_data_index]._data.second;
         }
 
-        template< typename NewKey, typename... Args >
-        HSD_CONSTEXPR pair<iterator, bool> emplace(const NewKey& key, const Args&... args)
+        template< typename NewKey >
+        constexpr iterator find(const NewKey& key)
         {
             usize _data_index = _get(key);
+            return _data_index == _npos ? end() : _data.begin() + _data_index;
+        }
 
-            if(_data_index != static_cast<usize>(-1))
+        template< typename NewKey >
+        constexpr bool contains(const NewKey& key) const
+        {
+            return _get(key) != _npos;
+        }
+
+        template< typename NewKey, typename... Args >
+        HSD_CONSTEXPR pair<iterator, bool> emplace(NewKey&& key, Args&&... args)
+        {
+            usize _key_hash = static_cast<usize>(Hasher::get_hash(key));
+            return emplace_hashed(_key_hash, forward<NewKey>(key), forward<Args>(args)...);
+        }
+
+        /// `emplace` with the hash of `key` already known
+        template< typename NewKey, typename... Args >
+        HSD_CONSTEXPR pair<iterator, bool> emplace_hashed(usize key_hash, NewKey&& key, Args&&... args)
+        {
+            // Compare the key as it will be stored, or it wouldn't match itself
+            if constexpr(std::is_arithmetic_v<Key> && !is_same<decay_t<NewKey>, Key>::value)
+                return emplace_hashed(key_hash, static_cast<Key>(key), forward<Args>(args)...);
+
+            usize _data_index = _get(key, key_hash);
+
+            if(_data_index != _npos)
             {
                 return {_data.begin() + _data_index, false};
             }
             else
             {
-                _data.emplace_back(_data.size(), key, T{forward<Args>(args)...});
-
-                if(static_cast<f64>(_data.size()) / _buckets.size() >= _limit_ratio)
-                    _replace();
+                _table.insert(key_hash, _data.size(), _data.size() + 1);
+                _data.emplace_back(key_hash, forward<NewKey>(key), T{forward<Args>(args)...});
 
                 return {_data.end() - 1, true};
             }
         }
 
-        template< typename NewKey, typename... Args >
-        HSD_CONSTEXPR pair<iterator, bool> emplace(NewKey&& key, Args&&... args)
+        /// Inserts every pair of the range, keys already present are kept
+        template< typename It >
+        HSD_CONSTEXPR void insert_many(It first, It last)
         {
-            usize _data_index = _get(key);
+            _detail::insert_batched(first, last, _table,
+                [](const auto& entry) { return static_cast<usize>(Hasher::get_hash(entry.first)); },
+                [this](const auto& entry, usize key_hash) { emplace_hashed(key_hash, entry.first, entry.second); }
+            );
+        }
+
+        /// Removes `key` if present, the last entry moves into its place
+        /// so iterators to it and to the end are invalidated
+        template< typename NewKey >
+        HSD_CONSTEXPR bool erase(const NewKey& key)
+        {
+            usize _pos = _find_slot(key);
 
-            if(_data_index != static_cast<usize>(-1))
+            if(_pos == _npos)
+                return false;
+
+            usize _data_index = _table.entry(_pos);
+            usize _last = _data.size() - 1;
+            _table.erase(_pos);
+
+            if(_data_index != _last)
             {
-                return {_data.begin() + _data_index, false};
+                // Re-point the slot of the last entry to the hole it fills
+                _table.set_entry(_table.slot_of(_data[_last]._hash, _last), _data_index);
+                _data[_data_index] = move(_data[_last]);
             }
-            else
-            {
-                _data.emplace_back(_data.size(), move(key), move(T{forward<Args>(args)...}));
 
-                if(static_cast<f64>(_data.size()) / _buckets.size() >= _limit_ratio)
-                    _replace();
+            _data.pop_back();
+            return true;
+        }
 
-                return {_data.end() - 1, true};
-            }
+        /// Makes room for `count` entries without any further rehash
+        HSD_CONSTEXPR void reserve(usize count)
+        {
+            _data.reserve(count);
+            _table.reserve(count);
+        }
+
+        /// Resizes the index to at least `buckets` (rounded up to a power of
+        /// two) and at least what the current entries need, can also shrink
+        HSD_CONSTEXPR void rehash(usize buckets)
+        {
+            _table.rehash(buckets, _data.size());
+        }
+
+        constexpr f64 load_factor() const
+        {
+            return _table.bucket_count() == 0 ? 0. :
+                static_cast<f64>(_data.size()) / static_cast<f64>(_table.bucket_count());
+        }
+
+        static constexpr f64 max_load_factor()
+        {
+            return 0.75;
+        }
+
+        constexpr usize bucket_count() const
+        {
+            return _table.bucket_count();
+        }
+
+        constexpr usize size() const
+        {
+            return _data.size();
+        }
+
+        constexpr bool empty() const
+        {
+            return _data.size() == 0;
         }
 
         HSD_CONSTEXPR void clear()
         {
             _data.clear();
-            _buckets.clear();
+            _table.clear();
         }
 
         constexpr iterator begin()
@@ -324,20 +638,20 @@ namespace hsd
 
         constexpr const_iterator cbegin() const
         {
-            return _data.begin();
+            return _data.cbegin();
         }
 
         constexpr const_iterator cend() const
         {
-            return _data.end();
+            return _data.cbegin() + _data.size();
         }
     };
 
     template< typename Key, typename T >
-    unordered_map(const std::initializer_list<pair<Key, T>>& other) 
-        -> unordered_map< Key, T, fnv1a<usize> >;
+    unordered_map(const std::initializer_list<pair<Key, T>>& other)
+        -> unordered_map< Key, T, hash<Key> >;
 
     template< typename Key, typename T >
-    unordered_map(std::initializer_list<pair<Key, T>>&& other) 
-        -> unordered_map< Key, T, fnv1a<usize> >;
-} // namespace hsd
\ No newline at end of file
+    unordered_map(std::initializer_list<pair<Key, T>>&& other)
+        -> unordered_map< Key, T, hash<Key> >;
+} // namespace hsd
@@ -0,0 +1,332 @@
+#pragma once
+
+#include "UnorderedMap.hpp"
+
+namespace hsd
+{
+    namespace _detail
+    {
+        // Ends a chain of equal keys, the top bit is left free so erase can
+        // mark entries without losing the links
+        static constexpr usize chain_end = hash_index::npos >> 1;
+
+        template< typename Key, typename T >
+        struct multimap_value
+        {
+            pair<Key, T> _data;
+            // Next older entry with the same key
+            usize _next = chain_end;
+            // Hash of the key, so relocating finds its slot without `Hasher`
+            usize _hash = 0;
+
+            constexpr pair<Key, T>& get() noexcept
+            {
+                return _data;
+            }
+        };
+
+        /// Follows the chain of entries that share one key
+        template< typename Key, typename T >
+        class chain_iterator
+        {
+        private:
+            multimap_value<Key, T>* _entries = nullptr;
+            usize _index = chain_end;
+
+        public:
+            constexpr chain_iterator() = default;
+
+            constexpr chain_iterator(multimap_value<Key, T>* entries, usize index)
+                : _entries{entries}, _index{index}
+            {}
+
+            constexpr friend bool operator==(const chain_iterator& lhs, const chain_iterator& rhs)
+            {
+                return lhs._index == rhs._index;
+            }
+
+            constexpr friend bool operator!=(const chain_iterator& lhs, const chain_iterator& rhs)
+            {
+                return lhs._index != rhs._index;
+            }
+
+            constexpr chain_iterator& operator++()
+            {
+                _index = _entries[_index]._next;
+                return *this;
+            }
+
+            constexpr chain_iterator operator++(i32)
+            {
+                chain_iterator _tmp = *this;
+                operator++();
+                return _tmp;
+            }
+
+            constexpr pair<Key, T>& operator*() const
+            {
+                return _entries[_index]._data;
+            }
+
+            constexpr pair<Key, T>* operator->() const
+            {
+                return &_entries[_index]._data;
+            }
+        };
+    } // namespace _detail
+
+    /// Multimap over the same index as `unordered_map`, with one slot per
+    /// distinct key no matter how many values it has, so duplicates never
+    /// lengthen a probe. Entries live densely in insertion order; the slot
+    /// points at a key's newest entry and each entry links to the next
+    /// older one, which is the order `equal_range` walks them in
+    template< typename Key, typename T, typename Hasher = hash<Key> >
+    class unordered_multimap
+    {
+    private:
+        using value_type = _detail::multimap_value<Key, T>;
+        static constexpr usize _npos = _detail::hash_index::npos;
+        static constexpr usize _end = _detail::chain_end;
+        static constexpr usize _removed = ~_end;
+        _detail::hash_index _table;
+        vector<value_type> _data;
+
+        template< typename NewKey >
+        constexpr usize _find_slot(const NewKey& key, usize key_hash) const
+        {
+            return _table.find(key_hash, [&](usize index)
+            {
+                return _detail::key_equal(_data[index]._data.first, key);
+            });
+        }
+
+        // Lookups hash only keys that `Key` holds exactly
+        template< typename NewKey >
+        constexpr usize _find_slot(const NewKey& key) const
+        {
+            if(!_detail::holds_exactly<Key>(key))
+                return _npos;
+
+            return _find_slot(key, static_cast<usize>(Hasher::get_hash(key)));
+        }
+
+        template< typename NewKey >
+        constexpr usize _head(const NewKey& key) const
+        {
+            usize _pos = _find_slot(key);
+            return _pos == _npos ? _end : _table.entry(_pos);
+        }
+
+        // Moves the entry at `from` to `to` and points whatever linked to
+        // it, its key's slot or an older entry's `_next`, at the new place
+        HSD_CONSTEXPR void _relocate(usize from, usize to)
+        {
+            usize _pos = _find_slot(_data[from]._data.first, _data[from]._hash);
+
+            if(_table.entry(_pos) == from)
+            {
+                _table.set_entry(_pos, to);
+            }
+            else
+            {
+                usize _prev = _table.entry(_pos);
+
+                while(_data[_prev]._next != from)
+                    _prev = _data[_prev]._next;
+
+                _data[_prev]._next = to;
+            }
+
+            _data[to] = hsd::move(_data[from]);
+        }
+
+    public:
+        using iterator = _detail::iterator< value_type, pair<Key, T> >;
+        using local_iterator = _detail::chain_iterator<Key, T>;
+
+        HSD_CONSTEXPR unordered_multimap() = default;
+
+        HSD_CONSTEXPR unordered_multimap(std::initializer_list<pair<Key, T>> list)
+        {
+            reserve(list.size());
+
+            for(auto& _entry : list)
+                emplace(_entry.first, _entry.second);
+        }
+
+        /// Always adds an entry, `key` is only looked up to chain it
+        template< typename NewKey, typename... Args >
+        HSD_CONSTEXPR iterator emplace(NewKey&& key, Args&&... args)
+        {
+            usize _key_hash = static_cast<usize>(Hasher::get_hash(key));
+            return emplace_hashed(_key_hash, forward<NewKey>(key), forward<Args>(args)...);
+        }
+
+        /// `emplace` with the hash of `key` already known
+        template< typename NewKey, typename... Args >
+        HSD_CONSTEXPR iterator emplace_hashed(usize key_hash, NewKey&& key, Args&&... args)
+        {
+            // Compare the key as it will be stored, or it wouldn't chain with itself
+            if constexpr(std::is_arithmetic_v<Key> && !is_same<decay_t<NewKey>, Key>::value)
+                return emplace_hashed(key_hash, static_cast<Key>(key), forward<Args>(args)...);
+
+            usize _pos = _find_slot(key, key_hash);
+            usize _index = _data.size();
+
+            _data.emplace_back(value_type{
+                {static_cast<Key>(forward<NewKey>(key)), T{forward<Args>(args)...}}, _end, key_hash
+            });
+
+            if(_pos == _npos)
+            {
+                _table.insert(key_hash, _index, _index + 1);
+            }
+            else
+            {
+                _data[_index]._next = _table.entry(_pos);
+                _table.set_entry(_pos, _index);
+            }
+
+            return _data.begin() + _index;
+        }
+
+        HSD_CONSTEXPR iterator insert(const pair<Key, T>& entry)
+        {
+            return emplace(entry.first, entry.second);
+        }
+
+        /// Inserts every pair of the range
+        template< typename It >
+        HSD_CONSTEXPR void insert_many(It first, It last)
+        {
+            _detail::insert_batched(first, last, _table,
+                [](const auto& entry) { return static_cast<usize>(Hasher::get_hash(entry.first)); },
+                [this](const auto& entry, usize key_hash) { emplace_hashed(key_hash, entry.first, entry.second); }
+            );
+        }
+
+        /// Every entry with `key`, newest first
+        template< typename NewKey >
+        constexpr pair<local_iterator, local_iterator> equal_range(const NewKey& key)
+        {
+            return {{_data.begin(), _head(key)}, {_data.begin(), _end}};
+        }
+
+        /// The newest entry with `key`
+        template< typename NewKey >
+        constexpr iterator find(const NewKey& key)
+        {
+            usize _index = _head(key);
+            return _index == _end ? end() : _data.begin() + _index;
+        }
+
+        template< typename NewKey >
+        constexpr bool contains(const NewKey& key) const
+        {
+            return _head(key) != _end;
+        }
+
+        template< typename NewKey >
+        constexpr usize count(const NewKey& key) const
+        {
+            usize _count = 0;
+
+            for(usize _index = _head(key); _index != _end; _index = _data[_index]._next)
+                _count++;
+
+            return _count;
+        }
+
+        /// Removes every entry with `key` and returns how many there were.
+        /// The survivors at the back move into the holes, so iterators to
+        /// them and to the end are invalidated
+        template< typename NewKey >
+        HSD_CONSTEXPR usize erase(const NewKey& key)
+        {
+            usize _pos = _find_slot(key);
+
+            if(_pos == _npos)
+                return 0;
+
+            usize _head_index = _table.entry(_pos);
+            usize _count = 0;
+            _table.erase(_pos);
+
+            // Mark the chain first so the refill below can skip its tail end
+            for(usize _index = _head_index; _index != _end; _index = _data[_index]._next & _end)
+            {
+                _data[_index]._next |= _removed;
+                _count++;
+            }
+
+            usize _new_size = _data.size() - _count;
+            usize _survivor = _data.size();
+
+            for(usize _index = _head_index; _index != _end;)
+            {
+                usize _next = _data[_index]._next & _end;
+
+                if(_index < _new_size)
+                {
+                    do
+                    {
+                        _survivor--;
+                    } while((_data[_survivor]._next & _removed) != 0);
+
+                    _relocate(_survivor, _index);
+                }
+
+                _index = _next;
+            }
+
+            while(_data.size() > _new_size)
+                _data.pop_back();
+
+            return _count;
+        }
+
+        HSD_CONSTEXPR void reserve(usize count)
+        {
+            _data.reserve(count);
+            _table.reserve(count);
+        }
+
+        /// Entries per bucket, keys with several values still use one slot
+        constexpr f64 load_factor() const
+        {
+            return _table.bucket_count() == 0 ? 0. :
+                static_cast<f64>(_data.size()) / static_cast<f64>(_table.bucket_count());
+        }
+
+        constexpr usize bucket_count() const
+        {
+            return _table.bucket_count();
+        }
+
+        constexpr usize size() const
+        {
+            return _data.size();
+        }
+
+        constexpr bool empty() const
+        {
+            return _data.size() == 0;
+        }
+
+        HSD_CONSTEXPR void clear()
+        {
+            _data.clear();
+            _table.clear();
+        }
+
+        constexpr iterator begin()
+        {
+            return _data.begin();
+        }
+
+        constexpr iterator end()
+        {
+            return _data.end();
+        }
+    };
+} // namespace hsd
@@ -0,0 +1,185 @@
+#pragma once
+
+#include "UnorderedMap.hpp"
+
+namespace hsd
+{
+    /// Keys live densely in insertion order behind the same open addressing
+    /// index as `unordered_map`. Lookups take any key `Hasher` can hash and
+    /// that compares equal to `Key`, so a set of `string` can be probed
+    /// with a `const char*` or a `string_view` without building a string
+    template< typename Key, typename Hasher = hash<Key> >
+    class unordered_set
+    {
+    private:
+        static constexpr usize _npos = _detail::hash_index::npos;
+        _detail::hash_index _table;
+        vector<Key> _data;
+
+        template< typename NewKey >
+        constexpr usize _find_slot(const NewKey& key, usize key_hash) const
+        {
+            return _table.find(key_hash, [&](usize index)
+            {
+                return _detail::key_equal(_data[index], key);
+            });
+        }
+
+        // Lookups hash only keys that `Key` holds exactly
+        template< typename NewKey >
+        constexpr usize _find_slot(const NewKey& key) const
+        {
+            if(!_detail::holds_exactly<Key>(key))
+                return _npos;
+
+            return _find_slot(key, static_cast<usize>(Hasher::get_hash(key)));
+        }
+
+    public:
+        using iterator = const Key*;
+
+        HSD_CONSTEXPR unordered_set() = default;
+
+        HSD_CONSTEXPR unordered_set(std::initializer_list<Key> list)
+        {
+            reserve(list.size());
+
+            for(auto& _key : list)
+                insert(_key);
+        }
+
+        template< typename NewKey >
+        HSD_CONSTEXPR pair<iterator, bool> insert(NewKey&& key)
+        {
+            usize _key_hash = static_cast<usize>(Hasher::get_hash(key));
+            return insert_hashed(_key_hash, forward<NewKey>(key));
+        }
+
+        /// `insert` with the hash of `key` already known
+        template< typename NewKey >
+        HSD_CONSTEXPR pair<iterator, bool> insert_hashed(usize key_hash, NewKey&& key)
+        {
+            // Compare the key as it will be stored, or it wouldn't match itself
+            if constexpr(std::is_arithmetic_v<Key> && !is_same<decay_t<NewKey>, Key>::value)
+                return insert_hashed(key_hash, static_cast<Key>(key));
+
+            usize _pos = _find_slot(key, key_hash);
+
+            if(_pos != _npos)
+                return {_data.cbegin() + _table.entry(_pos), false};
+
+            _table.insert(key_hash, _data.size(), _data.size() + 1);
+            _data.emplace_back(static_cast<Key>(forward<NewKey>(key)));
+            return {_data.cbegin() + _data.size() - 1, true};
+        }
+
+        /// Inserts every key of the range, duplicates are dropped and only
+        /// the first one seen is built into a `Key`
+        template< typename It >
+        HSD_CONSTEXPR void insert_many(It first, It last)
+        {
+            _detail::insert_batched(first, last, _table,
+                [](const auto& key) { return static_cast<usize>(Hasher::get_hash(key)); },
+                [this](const auto& key, usize key_hash) { insert_hashed(key_hash, key); }
+            );
+        }
+
+        template< typename NewKey >
+        constexpr iterator find(const NewKey& key) const
+        {
+            usize _pos = _find_slot(key);
+            return _pos == _npos ? end() : _data.cbegin() + _table.entry(_pos);
+        }
+
+        template< typename NewKey >
+        constexpr bool contains(const NewKey& key) const
+        {
+            return _find_slot(key) != _npos;
+        }
+
+        template< typename NewKey >
+        constexpr usize count(const NewKey& key) const
+        {
+            return contains(key) ? 1 : 0;
+        }
+
+        /// Removes `key` if present, the last key moves into its place
+        template< typename NewKey >
+        HSD_CONSTEXPR bool erase(const NewKey& key)
+        {
+            usize _pos = _find_slot(key);
+
+            if(_pos == _npos)
+                return false;
+
+            usize _data_index = _table.entry(_pos);
+            usize _last = _data.size() - 1;
+            _table.erase(_pos);
+
+            if(_data_index != _last)
+            {
+                usize _last_pos = _table.slot_of(
+                    static_cast<usize>(Hasher::get_hash(_data[_last])), _last
+                );
+
+                _table.set_entry(_last_pos, _data_index);
+                _data[_data_index] = hsd::move(_data[_last]);
+            }
+
+            _data.pop_back();
+            return true;
+        }
+
+        /// Makes room for `count` keys without any further rehash
+        HSD_CONSTEXPR void reserve(usize count)
+        {
+            _data.reserve(count);
+            _table.reserve(count);
+        }
+
+        HSD_CONSTEXPR void rehash(usize buckets)
+        {
+            _table.rehash(buckets, _data.size());
+        }
+
+        constexpr f64 load_factor() const
+        {
+            return _table.bucket_count() == 0 ? 0. :
+                static_cast<f64>(_data.size()) / static_cast<f64>(_table.bucket_count());
+        }
+
+        constexpr usize bucket_count() const
+        {
+            return _table.bucket_count();
+        }
+
+        constexpr usize size() const
+        {
+            return _data.size();
+        }
+
+        constexpr bool empty() const
+        {
+            return _data.size() == 0;
+        }
+
+        HSD_CONSTEXPR void clear()
+        {
+            _data.clear();
+            _table.clear();
+        }
+
+        constexpr iterator begin() const
+        {
+            return _data.cbegin();
+        }
+
+        constexpr iterator end() const
+        {
+            return _data.cbegin() + _data.size();
+        }
+    };
+
+    template< typename Key >
+    unordered_set(std::initializer_list<Key>) -> unordered_set< Key, hash<Key> >;
+} // namespace hsd
@@ -0,0 +1,561 @@
+#pragma once
+
+#include "Vector.hpp"
+#include "Functional.hpp"
+#include "Limits.hpp"
+#include "_Define.hpp"
+
+#ifdef HSD_PLATFORM_LINUX
+
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+
+namespace hsd
+{
+    namespace uring_detail
+    {
+        static inline i32 setup(u32 entries, io_uring_params* params)
+        {
+            return static_cast<i32>(syscall(__NR_io_uring_setup, entries, params));
+        }
+
+        static inline i32 enter(i32 ring_fd, u32 to_submit, u32 min_complete, u32 flags)
+        {
+            return static_cast<i32>(syscall(__NR_io_uring_enter,
+                ring_fd, to_submit, min_complete, flags, nullptr, 0));
+        }
+
+        static inline i32 register_op(i32 ring_fd, u32 opcode, void* arg, u32 nr_args)
+        {
+            return static_cast<i32>(syscall(__NR_io_uring_register, ring_fd, opcode, arg, nr_args));
+        }
+
+        // Opcodes `uring` submits, READ, RECV and SEND only came with 5.6
+        static constexpr u8 used_ops[] = {
+            IORING_OP_READ, IORING_OP_WRITE, IORING_OP_ACCEPT, IORING_OP_RECV, IORING_OP_SEND
+        };
+
+        /// Whether the kernel behind `ring_fd` knows every opcode in
+        /// `used_ops`. Kernels before 5.6 can't probe and don't have them
+        /// all either, so a failed probe counts as missing
+        static inline bool supports_used_ops(i32 ring_fd)
+        {
+            static constexpr u32 _max_ops = 256;
+            alignas(io_uring_probe) u8 _buf[sizeof(io_uring_probe) + _max_ops * sizeof(io_uring_probe_op)]{};
+            auto* _probe = reinterpret_cast<io_uring_probe*>(_buf);
+
+            if(register_op(ring_fd, IORING_REGISTER_PROBE, _probe, _max_ops) < 0)
+                return false;
+
+            for(u8 _op : used_ops)
+            {
+                if(_op >= _probe->ops_len || !(_probe->ops[_op].flags & IO_URING_OP_SUPPORTED))
+                    return false;
+            }
+
+            return true;
+        }
+
+        enum class op_type
+        {
+            read,
+            write,
+            accept,
+            recv,
+            send
+        };
+
+        struct request
+        {
+            op_type op = op_type::read;
+            i32 fd = -1;
+            // dup of `fd` registered with epoll, only used by the fallback
+            i32 watch_fd = -1;
+            void* buf = nullptr;
+            usize size = 0;
+            u64 offset = 0;
+            function<void(isize)> callback;
+        };
+    } // namespace uring_detail
+
+    /// Batched asynchronous I/O over io_uring, driven by raw syscalls.
+    /// Requests are queued by `read`/`write`/`accept`/`recv`/`send`,
+    /// handed to the kernel together by `submit` and their callbacks get
+    /// the result (a byte count or file descriptor, -errno on failure)
+    /// from `wait`. Kernels without io_uring, or whose io_uring lacks one
+    /// of those operations, fall back to epoll. Queueing returns false if
+    /// the ring is full and the kernel takes none of it.
+    class uring
+    {
+    private:
+        using request = uring_detail::request;
+        using op_type = uring_detail::op_type;
+
+        i32 _ring_fd = -1;
+        i32 _epoll_fd = -1;
+        u32 _entries = 0;
+
+        void* _sq_ptr = nullptr;
+        void* _cq_ptr = nullptr;
+        usize _sq_map_size = 0;
+        usize _cq_map_size = 0;
+        io_uring_sqe* _sqes = nullptr;
+        usize _sqes_map_size = 0;
+
+        u32* _sq_head = nullptr;
+        u32* _sq_tail = nullptr;
+        u32* _sq_mask = nullptr;
+        u32* _sq_array = nullptr;
+        u32* _cq_head = nullptr;
+        u32* _cq_tail = nullptr;
+        u32* _cq_mask = nullptr;
+        io_uring_cqe* _cqes = nullptr;
+        u32 _to_submit = 0;
+
+        vector<request> _requests;
+        vector<usize> _free_slots;
+        // Fallback completions that finished without waiting
+        vector< pair<usize, isize> > _ready;
+        usize _in_flight = 0;
+
+        bool _setup_ring(u32 entries)
+        {
+            io_uring_params _params{};
+            _ring_fd = uring_detail::setup(entries, &_params);
+
+            if(_ring_fd < 0)
+            {
+                _ring_fd = -1;
+                return false;
+            }
+
+            // Otherwise the missing operations would complete with -EINVAL
+            if(!uring_detail::supports_used_ops(_ring_fd))
+                return false;
+
+            _entries = _params.sq_entries;
+            _sq_map_size = _params.sq_off.array + _params.sq_entries * sizeof(u32);
+            _cq_map_size = _params.cq_off.cqes + _params.cq_entries * sizeof(io_uring_cqe);
+
+            if(_params.features & IORING_FEAT_SINGLE_MMAP)
+                _sq_map_size = _cq_map_size = hsd::max(_sq_map_size, _cq_map_size);
+
+            _sq_ptr = mmap(nullptr, _sq_map_size, PROT_READ | PROT_WRITE,
+                MAP_SHARED | MAP_POPULATE, _ring_fd, IORING_OFF_SQ_RING);
+
+            if(_sq_ptr == MAP_FAILED)
+            {
+                _sq_ptr = nullptr;
+                return false;
+            }
+            if(_params.features & IORING_FEAT_SINGLE_MMAP)
+            {
+                _cq_ptr = _sq_ptr;
+            }
+            else
+            {
+                _cq_ptr = mmap(nullptr, _cq_map_size, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE, _ring_fd, IORING_OFF_CQ_RING);
+
+                if(_cq_ptr == MAP_FAILED)
+                {
+                    _cq_ptr = nullptr;
+                    return false;
+                }
+            }
+
+            _sqes_map_size = _params.sq_entries * sizeof(io_uring_sqe);
+            void* _sqes_ptr = mmap(nullptr, _sqes_map_size, PROT_READ | PROT_WRITE,
+                MAP_SHARED | MAP_POPULATE, _ring_fd, IORING_OFF_SQES);
+
+            if(_sqes_ptr == MAP_FAILED)
+                return false;
+
+            auto* _sq_base = static_cast<char*>(_sq_ptr);
+            auto* _cq_base = static_cast<char*>(_cq_ptr);
+            _sqes = static_cast<io_uring_sqe*>(_sqes_ptr);
+            _sq_head = reinterpret_cast<u32*>(_sq_base + _params.sq_off.head);
+            _sq_tail = reinterpret_cast<u32*>(_sq_base + _params.sq_off.tail);
+            _sq_mask = reinterpret_cast<u32*>(_sq_base + _params.sq_off.ring_mask);
+            _sq_array = reinterpret_cast<u32*>(_sq_base + _params.sq_off.array);
+            _cq_head = reinterpret_cast<u32*>(_cq_base + _params.cq_off.head);
+            _cq_tail = reinterpret_cast<u32*>(_cq_base + _params.cq_off.tail);
+            _cq_mask = reinterpret_cast<u32*>(_cq_base + _params.cq_off.ring_mask);
+            _cqes = reinterpret_cast<io_uring_cqe*>(_cq_base + _params.cq_off.cqes);
+            return true;
+        }
+
+        void _release_ring()
+        {
+            if(_sqes != nullptr)
+                munmap(_sqes, _sqes_map_size);
+            if(_cq_ptr != nullptr && _cq_ptr != _sq_ptr)
+                munmap(_cq_ptr, _cq_map_size);
+            if(_sq_ptr != nullptr)
+                munmap(_sq_ptr, _sq_map_size);
+            if(_ring_fd != -1)
+                ::close(_ring_fd);
+
+            _sqes = nullptr;
+            _sq_ptr = _cq_ptr = nullptr;
+            _ring_fd = -1;
+        }
+
+        usize _acquire_slot()
+        {
+            if(_free_slots.size() != 0)
+            {
+                usize _slot = _free_slots.back();
+                _free_slots.pop_back();
+                return _slot;
+            }
+
+            _requests.emplace_back();
+            return _requests.size() - 1;
+        }
+
+        template <typename Func>
+        bool _queue(op_type op, i32 fd, void* buf, usize size, u64 offset, Func&& callback)
+        {
+            usize _slot = _acquire_slot();
+            request& _req = _requests[_slot];
+            _req.op = op;
+            _req.fd = fd;
+            _req.buf = buf;
+            _req.size = size;
+            _req.offset = offset;
+            _req.callback = function<void(isize)>(hsd::forward<Func>(callback));
+            _in_flight++;
+
+            if(_ring_fd == -1)
+            {
+                _watch(_slot);
+            }
+            else if(!_push_sqe(_slot))
+            {
+                _req.callback = function<void(isize)>();
+                _free_slots.push_back(_slot);
+                _in_flight--;
+                return false;
+            }
+
+            return true;
+        }
+
+        bool _push_sqe(usize slot)
+        {
+            u32 _tail = *_sq_tail;
+
+            // The ring is full, hand the batch over to make room, and give
+            // up if the kernel took none of it rather than overwrite an entry
+            if(_tail - __atomic_load_n(_sq_head, __ATOMIC_ACQUIRE) == _entries)
+            {
+                submit();
+
+                if(_tail - __atomic_load_n(_sq_head, __ATOMIC_ACQUIRE) == _entries)
+                    return false;
+            }
+
+            request& _req = _requests[slot];
+            u32 _index = _tail & *_sq_mask;
+            io_uring_sqe* _sqe = &_sqes[_index];
+            memset(_sqe, 0, sizeof(io_uring_sqe));
+
+            switch(_req.op)
+            {
+                case op_type::read:
+                    _sqe->opcode = IORING_OP_READ;
+                    break;
+                case op_type::write:
+                    _sqe->opcode = IORING_OP_WRITE;
+                    break;
+                case op_type::accept:
+                    _sqe->opcode = IORING_OP_ACCEPT;
+                    _sqe->accept_flags = SOCK_CLOEXEC;
+                    break;
+                case op_type::recv:
+                    _sqe->opcode = IORING_OP_RECV;
+                    break;
+                case op_type::send:
+                    _sqe->opcode = IORING_OP_SEND;
+                    _sqe->msg_flags = MSG_NOSIGNAL;
+                    break;
+            }
+
+            _sqe->fd = _req.fd;
+            _sqe->addr = reinterpret_cast<u64>(_req.buf);
+            // Lengths are 32 bits in the ring, a larger buffer completes
+            // short like any partial read or write
+            _sqe->len = static_cast<u32>(hsd::min(_req.size, static_cast<usize>(limits<u32>::max)));
+            _sqe->off = _req.offset;
+            _sqe->user_data = slot;
+            _sq_array[_index] = _index;
+            __atomic_store_n(_sq_tail, _tail + 1, __ATOMIC_RELEASE);
+            _to_submit++;
+            return true;
+        }
+
+        isize _perform(request& req)
+        {
+            isize _rez = -1;
+
+            switch(req.op)
+            {
+                case op_type::read:
+                    _rez = (req.offset == static_cast<u64>(-1)) ?
+                        ::read(req.fd, req.buf, req.size) :
+                        pread(req.fd, req.buf, req.size, static_cast<off_t>(req.offset));
+                    break;
+                case op_type::write:
+                    _rez = (req.offset == static_cast<u64>(-1)) ?
+                        ::write(req.fd, req.buf, req.size) :
+                        pwrite(req.fd, req.buf, req.size, static_cast<off_t>(req.offset));
+                    break;
+                case op_type::accept:
+                    _rez = accept4(req.fd, nullptr, nullptr, SOCK_CLOEXEC);
+                    break;
+                case op_type::recv:
+                    _rez = ::recv(req.fd, req.buf, req.size, 0);
+                    break;
+                case op_type::send:
+                    _rez = ::send(req.fd, req.buf, req.size, MSG_NOSIGNAL);
+                    break;
+            }
+
+            return _rez < 0 ? -errno : _rez;
+        }
+
+        bool _arm(usize slot, i32 ctl_op)
+        {
+            request& _req = _requests[slot];
+            bool _wants_write = _req.op == op_type::write || _req.op == op_type::send;
+
+            epoll_event _event{};
+            _event.events = (_wants_write ? EPOLLOUT : EPOLLIN) | EPOLLONESHOT;
+            _event.data.u64 = slot;
+            return epoll_ctl(_epoll_fd, ctl_op, _req.watch_fd, &_event) == 0;
+        }
+
+        void _watch(usize slot)
+        {
+            request& _req = _requests[slot];
+
+            // A duplicate descriptor gives every request its own epoll
+            // registration, so one fd may have several requests pending
+            _req.watch_fd = dup(_req.fd);
+
+            if(!_arm(slot, EPOLL_CTL_ADD))
+            {
+                // Regular files can't be polled, they are always "ready"
+                ::close(_req.watch_fd);
+                _req.watch_fd = -1;
+                _ready.emplace_back(slot, _perform(_req));
+            }
+        }
+
+        void _complete(usize slot, isize result)
+        {
+            request& _req = _requests[slot];
+
+            if(_req.watch_fd != -1)
+            {
+                epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, _req.watch_fd, nullptr);
+                ::close(_req.watch_fd);
+                _req.watch_fd = -1;
+            }
+
+            // The callback may queue new requests and grow `_requests`
+            auto _callback = move(_req.callback);
+            _free_slots.push_back(slot);
+            _in_flight--;
+            _callback(move(result));
+        }
+
+        usize _reap()
+        {
+            usize _count = 0;
+            u32 _head = *_cq_head;
+
+            while(_head != __atomic_load_n(_cq_tail, __ATOMIC_ACQUIRE))
+            {
+                io_uring_cqe& _cqe = _cqes[_head & *_cq_mask];
+                usize _slot = static_cast<usize>(_cqe.user_data);
+                isize _result = _cqe.res;
+                __atomic_store_n(_cq_head, ++_head, __ATOMIC_RELEASE);
+                _complete(_slot, _result);
+                _count++;
+            }
+
+            return _count;
+        }
+
+        usize _wait_fallback(u32 min_complete)
+        {
+            usize _count = 0;
+            epoll_event _events[64];
+
+            while(true)
+            {
+                while(_ready.size() != 0)
+                {
+                    auto _done = _ready.back();
+                    _ready.pop_back();
+                    _complete(_done.first, _done.second);
+                    _count++;
+                }
+                if(_count >= min_complete || _in_flight == 0)
+                    break;
+
+                i32 _num = epoll_wait(_epoll_fd, _events, 64, -1);
+
+                if(_num < 0)
+                {
+                    if(errno == EINTR)
+                        continue;
+
+                    break;
+                }
+                for(i32 _index = 0; _index < _num; _index++)
+                {
+                    usize _slot = static_cast<usize>(_events[_index].data.u64);
+                    isize _result = _perform(_requests[_slot]);
+
+                    // A spurious wakeup isn't a completion, wait for the next one
+                    if((_result == -EAGAIN || _result == -EWOULDBLOCK) && _arm(_slot, EPOLL_CTL_MOD))
+                        continue;
+
+                    _ready.emplace_back(_slot, _result);
+                }
+            }
+
+            return _count;
+        }
+
+    public:
+        static constexpr u64 current_offset = static_cast<u64>(-1);
+
+        uring(u32 entries = 256, bool force_epoll = false)
+        {
+            if(force_epoll || !_setup_ring(entries))
+            {
+                _release_ring();
+                _epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+
+                if(_epoll_fd == -1)
+                    throw std::runtime_error("Cannot create an I/O queue");
+            }
+        }
+
+        uring(const uring&) = delete;
+
+        ~uring()
+        {
+            _release_ring();
+
+            for(auto& _req : _requests)
+            {
+                if(_req.watch_fd != -1)
+                    ::close(_req.watch_fd);
+            }
+            if(_epoll_fd != -1)
+                ::close(_epoll_fd);
+        }
+
+        bool uses_io_uring()
+        {
+            return _ring_fd != -1;
+        }
+
+        usize in_flight()
+        {
+            return _in_flight;
+        }
+
+        template <typename Func>
+        bool read(i32 fd, void* buf, usize size, u64 offset, Func&& callback)
+        {
+            return _queue(op_type::read, fd, buf, size, offset, hsd::forward<Func>(callback));
+        }
+
+        template <typename Func>
+        bool write(i32 fd, const void* buf, usize size, u64 offset, Func&& callback)
+        {
+            return _queue(op_type::write, fd, const_cast<void*>(buf),
+                size, offset, hsd::forward<Func>(callback));
+        }
+
+        template <typename Func>
+        bool accept(i32 fd, Func&& callback)
+        {
+            return _queue(op_type::accept, fd, nullptr, 0, 0, hsd::forward<Func>(callback));
+        }
+
+        template <typename Func>
+        bool recv(i32 fd, void* buf, usize size, Func&& callback)
+        {
+            return _queue(op_type::recv, fd, buf, size, 0, hsd::forward<Func>(callback));
+        }
+
+        template <typename Func>
+        bool send(i32 fd, const void* buf, usize size, Func&& callback)
+        {
+            return _queue(op_type::send, fd, const_cast<void*>(buf),
+                size, 0, hsd::forward<Func>(callback));
+        }
+
+        /// Hands every queued request to the kernel with one syscall
+        u32 submit()
+        {
+            if(_ring_fd == -1 || _to_submit == 0)
+                return 0;
+
+            i32 _submitted = uring_detail::enter(_ring_fd, _to_submit, 0, 0);
+
+            if(_submitted < 0)
+                return 0;
+
+            _to_submit -= static_cast<u32>(_submitted);
+            return static_cast<u32>(_submitted);
+        }
+
+        /// Submits the pending batch, blocks until at least `min_complete`
+        /// requests finished and runs their callbacks
+        usize wait(u32 min_complete = 1)
+        {
+            if(_ring_fd == -1)
+                return _wait_fallback(min_complete);
+
+            usize _count = _reap();
+
+            while(_count < min_complete && _in_flight != 0)
+            {
+                i32 _rez = uring_detail::enter(_ring_fd, _to_submit,
+                    1, IORING_ENTER_GETEVENTS);
+
+                if(_rez < 0 && errno != EINTR)
+                    break;
+                if(_rez > 0)
+                    _to_submit -= static_cast<u32>(_rez);
+
+                _count += _reap();
+            }
+
+            return _count;
+        }
+
+        // Keeps waiting until every request, including ones queued by callbacks, is done
+        void run()
+        {
+            while(_in_flight != 0)
+                wait(1);
+        }
+    };
+} // namespace hsd
+
+#endif
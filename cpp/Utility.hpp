@@ -22,8 +22,8 @@ namespace hsd
     template <class T, class U = T>
     static constexpr T exchange(T& target, U&& new_val) noexcept
     {
-        T tmp = move(target);
-        target = forward<U>(new_val);
+        T tmp = hsd::move(target);
+        target = hsd::forward<U>(new_val);
         return tmp;
     }
 
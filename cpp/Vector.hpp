@@ -1,5 +1,6 @@
 #pragma once
 
+#include <new>
 #include <stdexcept>
 #include <cassert>
 #include <initializer_list>
@@ -8,16 +9,77 @@
 #include "Tuple.hpp"
 #include "AlignedStorage.hpp"
 
+#ifdef HSD_PLATFORM_LINUX
+#include <sys/mman.h>
+#endif
+
 namespace hsd
 {
-    template<typename T>
+    namespace vector_detail
+    {
+        inline constexpr usize cache_line = 64;
+        inline constexpr usize huge_page = 2 * 1024 * 1024;
+    } // namespace vector_detail
+
+    /// `Align` raises the alignment of the buffer (not of the elements,
+    /// they stay packed). At `vector_detail::huge_page` and above, buffers
+    /// of at least one huge page are also advised to be backed by huge
+    /// pages, smaller ones only get cache line alignment
+    template <typename T, usize Align = alignof(T)>
     class vector
     {
+        static_assert((Align & (Align - 1)) == 0, "Alignment must be a power of two");
+
         using storage_type = typename aligned_storage<sizeof(T), alignof(T)>::type;
         storage_type* _data = nullptr;
         usize _size = 0;
         usize _capacity = 0;
 
+        static constexpr usize _alignment(usize count)
+        {
+            if constexpr (Align >= vector_detail::huge_page)
+            {
+                if (count * sizeof(T) < vector_detail::huge_page)
+                    return vector_detail::cache_line;
+            }
+
+            return Align;
+        }
+
+        static HSD_CONSTEXPR storage_type* _allocate(usize count)
+        {
+            if constexpr (Align <= alignof(T))
+            {
+                return new storage_type[count];
+            }
+            else
+            {
+                usize _align = _alignment(count);
+                // Whole huge pages, so the tail can be backed by one too
+                usize _bytes = (count * sizeof(T) + _align - 1) & ~(_align - 1);
+                void* _buf = ::operator new(_bytes, std::align_val_t{_align});
+
+                #ifdef HSD_PLATFORM_LINUX
+                if (_align >= vector_detail::huge_page)
+                    madvise(_buf, _bytes, MADV_HUGEPAGE);
+                #endif
+
+                return static_cast<storage_type*>(_buf);
+            }
+        }
+
+        static HSD_CONSTEXPR void _deallocate(storage_type* buf, usize count)
+        {
+            if constexpr (Align <= alignof(T))
+            {
+                delete[] buf;
+            }
+            else
+            {
+                ::operator delete(buf, std::align_val_t{_alignment(count)});
+            }
+        }
+
     public:
         using value_type = T;
         using iterator = T*;
@@ -28,7 +90,7 @@ namespace hsd
             for (usize _index = _size; _index > 0; --_index)
                 at_unchecked(_index - 1).~T();
                 
-            delete[] _data;
+            _deallocate(_data, _capacity);
         }
 
         HSD_CONSTEXPR vector(usize size)
@@ -39,7 +101,7 @@ namespace hsd
         HSD_CONSTEXPR vector() noexcept = default;
 
         HSD_CONSTEXPR vector(const vector& rhs)
-            : _data(new storage_type[rhs._capacity]),
+            : _data(_allocate(rhs._capacity)),
               _size(rhs._size), _capacity(rhs._capacity)
         {
             for (usize _index = 0; _index < _size; ++_index)
@@ -54,7 +116,7 @@ namespace hsd
         }
 
         HSD_CONSTEXPR vector(const std::initializer_list<T>& list)
-            : _data(new storage_type[list.size()]),
+            : _data(_allocate(list.size())),
               _size(list.size()), _capacity(list.size())
         {
             auto _arr = list.begin();
@@ -64,13 +126,13 @@ namespace hsd
         }
 
         HSD_CONSTEXPR vector(std::initializer_list<T>&& list)
-            : _data(new storage_type[list.size()]),
+            : _data(_allocate(list.size())),
               _size(list.size()), _capacity(list.size())
         {
             auto _arr = list.begin();
             
             for (usize _index = 0; _index < _size; ++_index)
-                new(&_data[_index]) T(move(_arr[_index]));
+                new(&_data[_index]) T(hsd::move(_arr[_index]));
         }
 
         HSD_CONSTEXPR vector& operator=(const vector& rhs)
@@ -88,10 +150,10 @@ namespace hsd
             else
             {
                 usize _index;
-                usize min_size = _size > rhs._size ? _size : rhs._size;
+                usize min_size = _size < rhs._size ? _size : rhs._size;
                 
                 for (_index = 0; _index < min_size; ++_index)
-                    _data[_index] = rhs[_index];
+                    at_unchecked(_index) = rhs[_index];
                 
                 if (_size > rhs._size)
                 {
@@ -113,7 +175,7 @@ namespace hsd
         HSD_CONSTEXPR vector& operator=(vector&& rhs) noexcept
         {
             clear();
-            delete[] _data;
+            _deallocate(_data, _capacity);
 
             _data = exchange(rhs._data, nullptr);
             _size = exchange(rhs._size, 0);
@@ -172,7 +234,7 @@ namespace hsd
                 reserve(list.size());
                 
                 for (usize _index = 0; _index < list.size(); ++_index)
-                    new(&_data[_index]) T(move(_arr[_index]));
+                    new(&_data[_index]) T(hsd::move(_arr[_index]));
                 
                 _size = list.size();
             }
@@ -183,7 +245,7 @@ namespace hsd
                 
                 for (_index = 0; _index < min_size; ++_index)
                 {
-                    _data[_index] = move(_arr[_index]);
+                    _data[_index] = hsd::move(_arr[_index]);
                 }
                 if (_size > list.size())
                 {
@@ -193,7 +255,7 @@ namespace hsd
                 else if (list.size() > _size)
                 {
                     for (; _index < list.size(); ++_index)
-                        new(&_data[_index]) T(move(_arr[_index]));
+                        new(&_data[_index]) T(hsd::move(_arr[_index]));
                 }
 
                 _size = list.size();
@@ -275,17 +337,17 @@ namespace hsd
                 while (_new_capacity < new_cap)
                     _new_capacity += (_new_capacity + 1) / 2;
 
-                storage_type* _new_buf = new storage_type[_new_capacity];
+                storage_type* _new_buf = _allocate(_new_capacity);
                 
                 for (usize _index = 0; _index < _size; ++_index)
                 {
                     auto& _value = at_unchecked(_index);
-                    new(&_new_buf[_index]) T(move(_value));
+                    new(&_new_buf[_index]) T(hsd::move(_value));
                     _value.~T();
                 }
                 
+                _deallocate(_data, _capacity);
                 _capacity = _new_capacity;
-                delete[] _data;
                 _data = _new_buf;
             }
         }
@@ -295,15 +357,21 @@ namespace hsd
             if (_size == 0)
             {
                 storage_type* old_buf = exchange(_data, nullptr);
-                _capacity = 0;
-                delete[] old_buf;
+                _deallocate(old_buf, exchange(_capacity, 0));
             }
             else if (_size < _capacity)
             {
-                storage_type* _new_buf = new storage_type[_size];
-                move<T>(_data, _data + _size, _new_buf);
+                storage_type* _new_buf = _allocate(_size);
+
+                for (usize _index = 0; _index < _size; ++_index)
+                {
+                    auto& _value = at_unchecked(_index);
+                    new(&_new_buf[_index]) T(hsd::move(_value));
+                    _value.~T();
+                }
+
+                _deallocate(_data, _capacity);
                 _capacity = _size;
-                delete[] _data;
                 _data = _new_buf;
             }
         }
@@ -317,13 +385,13 @@ namespace hsd
                 while (_new_capacity < new_size)
                     _new_capacity += (_new_capacity + 1) / 2;
 
-                storage_type* _new_buf = new storage_type[_new_capacity];
+                storage_type* _new_buf = _allocate(_new_capacity);
                 usize _index = 0;
                 
                 for (; _index < _size; ++_index)
                 {
                     auto& _value = at_unchecked(_index);
-                    new(&_new_buf[_index]) T(move(_value));
+                    new(&_new_buf[_index]) T(hsd::move(_value));
                     _value.~T();
                 }
                 for (; _index < new_size; ++_index)
@@ -331,9 +399,9 @@ namespace hsd
                     new(&_new_buf[_index]) T();
                 }
                 
+                _deallocate(_data, _capacity);
                 _capacity = _new_capacity;
                 _size = new_size;
-                delete[] _data;
                 _data = _new_buf;
             }
             else if (new_size > _size)
@@ -359,14 +427,14 @@ namespace hsd
 
         HSD_CONSTEXPR void push_back(T&& val)
         {
-            emplace_back(move(val));
+            emplace_back(hsd::move(val));
         }
 
         template <typename... Args>
         HSD_CONSTEXPR void emplace_back(Args&&... args)
         {
             reserve(_size + 1);
-            new(&_data[_size]) T(forward<Args>(args)...);
+            new(&_data[_size]) T(hsd::forward<Args>(args)...);
             ++_size;
         }
 
@@ -431,4 +499,11 @@ namespace hsd
         
         return vec;
     }
+
+    template <typename T, usize Align>
+    using aligned_vector = vector<T, Align>;
+
+    /// Huge page backed once it holds 2 MiB or more
+    template <typename T>
+    using huge_vector = vector<T, vector_detail::huge_page>;
 }
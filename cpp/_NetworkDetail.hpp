@@ -10,7 +10,12 @@
 #include <sys/socket.h>
 #include <netdb.h>
 #include <arpa/inet.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <memory.h>
+#include <poll.h>
+#include <errno.h>
 
 namespace hsd
 {
@@ -41,7 +46,215 @@ namespace hsd
             static constexpr usize rdm = SOCK_RDM;
             static constexpr usize seq_packet = SOCK_SEQPACKET;
         };
+
+        struct endpoint
+        {
+            protocol_type protocol = protocol_type::ipv4;
+            u16 port = 0;
+            char ip_addr[INET6_ADDRSTRLEN]{};
+
+            endpoint() = default;
+
+            endpoint(protocol_type protocol, u16 port, const char* ip_addr)
+                : protocol{protocol}, port{port}
+            {
+                cstring<char>::copy(this->ip_addr, ip_addr, 
+                    hsd::min(cstring<char>::length(ip_addr), sizeof(this->ip_addr) - 1));
+            }
+
+            bool operator==(const endpoint& rhs) const
+            {
+                return protocol == rhs.protocol && port == rhs.port &&
+                    cstring<char>::compare(ip_addr, rhs.ip_addr) == 0;
+            }
+        };
+
+        // A view over a received length-prefixed message, valid until the next receive
+        struct frame
+        {
+            const char* data = nullptr;
+            usize size = 0;
+        };
     } // namespace net
+
+    namespace net_detail
+    {
+        // Scratch space for one rendered argument, big enough for any arithmetic value
+        struct arg_buffer
+        {
+            char data[64];
+        };
+
+        static inline iovec _render(const char* val, arg_buffer&)
+        {
+            return {const_cast<char*>(val), cstring<char>::length(val)};
+        }
+
+        static inline iovec _render(const u8string& val, arg_buffer&)
+        {
+            return {const_cast<char*>(val.c_str()), val.size()};
+        }
+
+        static inline iovec _render(char val, arg_buffer& buf)
+        {
+            buf.data[0] = val;
+            return {buf.data, 1};
+        }
+
+        static inline iovec _render(uchar val, arg_buffer& buf)
+        {
+            buf.data[0] = static_cast<char>(val);
+            return {buf.data, 1};
+        }
+
+        template <typename T> requires (std::is_integral_v<T>)
+        static inline iovec _render(T val, arg_buffer& buf)
+        {
+            // Digits are written backwards from the end of the buffer
+            char* _end = buf.data + sizeof(buf.data);
+            char* _iter = _end;
+            bool _negative = false;
+            auto _num = static_cast<std::make_unsigned_t<T>>(val);
+
+            if constexpr(std::is_signed_v<T>)
+            {
+                if(val < 0)
+                {
+                    _negative = true;
+                    _num = static_cast<std::make_unsigned_t<T>>(0) - _num;
+                }
+            }
+
+            do
+            {
+                *--_iter = static_cast<char>('0' + _num % 10);
+                _num /= 10;
+            } while(_num != 0);
+
+            if(_negative)
+                *--_iter = '-';
+
+            return {_iter, static_cast<usize>(_end - _iter)};
+        }
+
+        template <typename T> requires (std::is_floating_point_v<T>)
+        static inline iovec _render(T val, arg_buffer& buf)
+        {
+            auto _res = abs(floor(val) - val);
+            bool _sci = (_res < 0.0001 && _res != 0) || abs(val) > 1.e+10;
+            i32 _len = 0;
+
+            if constexpr(is_same<T, f128>::value)
+            {
+                _len = snprintf(buf.data, sizeof(buf.data), _sci ? "%Le" : "%Lf", val);
+            }
+            else
+            {
+                _len = snprintf(buf.data, sizeof(buf.data), _sci ? "%e" : "%f", static_cast<f64>(val));
+            }
+
+            return {buf.data, static_cast<usize>(hsd::min(_len, static_cast<i32>(sizeof(buf.data) - 1)))};
+        }
+
+        /// Keeps calling `sendmsg` until every byte of `iov` is sent, returns
+        /// -1 on error or the total number of bytes written. `MSG_NOSIGNAL`
+        /// turns a closed peer into `EPIPE` instead of a SIGPIPE, interrupted
+        /// calls are retried and a full non-blocking socket is waited on
+        static inline isize send_all(i32 sock, iovec* iov, usize count)
+        {
+            isize _total = 0;
+
+            while(count != 0)
+            {
+                msghdr _msg{};
+                _msg.msg_iov = iov;
+                _msg.msg_iovlen = count;
+
+                isize _written = sendmsg(sock, &_msg, MSG_NOSIGNAL);
+
+                if(_written < 0)
+                {
+                    if(errno == EINTR)
+                        continue;
+
+                    if(errno == EAGAIN || errno == EWOULDBLOCK)
+                    {
+                        pollfd _pfd{sock, POLLOUT, 0};
+
+                        if(poll(&_pfd, 1, -1) >= 0 || errno == EINTR)
+                            continue;
+                    }
+
+                    return -1;
+                }
+
+                _total += _written;
+
+                while(count != 0 && static_cast<usize>(_written) >= iov->iov_len)
+                {
+                    _written -= iov->iov_len;
+                    iov++;
+                    count--;
+                }
+                if(count != 0)
+                {
+                    iov->iov_base = static_cast<char*>(iov->iov_base) + _written;
+                    iov->iov_len -= _written;
+                }
+            }
+
+            return _total;
+        }
+
+        /// Sends the formatted message as one gather write, through `send_all`
+        /// on streams (no `addr`) so partial writes are finished. Literal
+        /// fragments are referenced straight from the compile-time split of
+        /// `fmt` and arguments are rendered into stack buffers, so nothing is
+        /// copied into an intermediate string and nothing touches the heap.
+        template < io_detail::string_literal fmt, typename... Args >
+        static isize send_formatted(i32 sock, sockaddr* addr, socklen_t addr_len, const Args&... args)
+        {
+            static_assert(is_same<typename decltype(fmt)::char_type, char>::value, 
+                "Network messages must be narrow strings");
+
+            constexpr auto _fmt_buf = io_detail::split<fmt, sizeof...(Args) + 1>();
+            static_assert(_fmt_buf.second == sizeof...(Args), "Arguments don\'t match");
+
+            // The last fragment's length accounts for the null terminator
+            constexpr auto _last = _fmt_buf.first[sizeof...(Args)];
+            arg_buffer _arg_bufs[sizeof...(Args) + 1];
+            iovec _iov[2 * sizeof...(Args) + 1];
+            usize _count = 0;
+
+            auto _push = [&](iovec vec)
+            {
+                if(vec.iov_len != 0)
+                    _iov[_count++] = vec;
+            };
+
+            [&]<usize... Ints>(index_sequence<Ints...>)
+            {
+                ((
+                    _push({const_cast<char*>(_fmt_buf.first[Ints].first), _fmt_buf.first[Ints].second}),
+                    _push(_render(args, _arg_bufs[Ints]))
+                ), ...);
+            }(make_index_sequence<sizeof...(Args)>{});
+
+            _push({const_cast<char*>(_last.first), _last.second - 1});
+
+            // A stream may take only part of the message, keep sending the rest
+            if(addr == nullptr)
+                return send_all(sock, _iov, _count);
+
+            msghdr _msg{};
+            _msg.msg_name = addr;
+            _msg.msg_namelen = addr_len;
+            _msg.msg_iov = _iov;
+            _msg.msg_iovlen = _count;
+
+            return sendmsg(sock, &_msg, MSG_NOSIGNAL);
+        }
+    } // namespace net_detail
 } // namespace hsd
 
 #endif
\ No newline at end of file
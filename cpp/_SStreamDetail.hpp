@@ -1,189 +1,311 @@
 #pragma once
 
 #include <wchar.h>
+#include <stdlib.h>
 #include "Vector.hpp"
 #include "String.hpp"
 #include "Pair.hpp"
+#include "Limits.hpp"
 
 namespace hsd
 {
     namespace sstream_detail
     {
+        template <typename T>
+        struct is_string : false_type {};
+
         template <typename CharT>
-        static vector< string<CharT> > split(const CharT* str, usize size)
-        {
-            vector< string<CharT> > _buf;
-            const CharT* _iter_f = str;
-            const CharT* _iter_s = cstring<CharT>::find(_iter_f, ' ');
+        struct is_string< string<CharT> > : true_type {};
 
-            while (_iter_s != nullptr && *_iter_s != '\0')
-            {
-                _buf.emplace_back(_iter_f, _iter_s - _iter_f);
-                _iter_f = _iter_s + 1;
-                _iter_s = cstring<CharT>::find(_iter_f, ' ');
-            }
-            
-            _buf.emplace_back(_iter_f, (str + size) - _iter_f);
-            return _buf;
-        }
+        // Types read by the built-in scanners, everything else goes through `_parse`
+        template <typename T>
+        concept scannable = (std::is_arithmetic_v<T> && !is_same<T, bool>::value) || is_string<T>::value;
 
-		template <typename CharT>
-        void _parse(string<CharT>&, auto&);
-    
-        template <>
-        void _parse<char>(u8string& str, char& val)
+        template <typename CharT>
+        static constexpr bool _is_space(CharT letter)
         {
-            sscanf(str.c_str(), "%c", &val);
+            return letter == ' ' || letter == '\t' || letter == '\n' ||
+                letter == '\r' || letter == '\v' || letter == '\f';
         }
 
-        template <>
-        void _parse<char>(u8string& str, uchar& val)
+        template <typename CharT>
+        static constexpr bool _is_digit(CharT letter)
         {
-            sscanf(str.c_str(), "%c", &val);
+            return letter >= '0' && letter <= '9';
         }
 
-        template <>
-        void _parse<char>(u8string& str, i16& val)
+        template <typename CharT>
+        static constexpr const CharT* skip_space(const CharT* iter)
         {
-            sscanf(str.c_str(), "%hd", &val);
-        }
+            while(_is_space(*iter))
+                iter++;
 
-        template <>
-        void _parse<char>(u8string& str, u16& val)
-        {
-            sscanf(str.c_str(), "%hu", &val);
+            return iter;
         }
 
-        template <>
-        void _parse<char>(u8string& str, i32& val)
+        template <typename CharT>
+        static constexpr const CharT* token_end(const CharT* iter)
         {
-            sscanf(str.c_str(), "%d", &val);
-        }
+            while(*iter != '\0' && !_is_space(*iter))
+                iter++;
 
-        template <>
-        void _parse<char>(u8string& str, u32& val)
-        {
-            sscanf(str.c_str(), "%u", &val);
+            return iter;
         }
 
-        template <>
-        void _parse<char>(u8string& str, i64& val)
-        {
-            sscanf(str.c_str(), "%lld", &val);
-        }
+        // Every `_scan` reads one value at `iter` and returns the position
+        // right after it, or nullptr if the text doesn't hold such a value
 
-        template <>
-        void _parse<char>(u8string& str, u64& val)
+        // Values that don't fit `T` and digits running into other
+        // characters ("12abc") are rejected rather than wrapped or cut short
+        template <typename CharT, typename T> requires (std::is_integral_v<T> && !is_char<T>::value)
+        static constexpr const CharT* _scan(const CharT* iter, T& val)
         {
-            sscanf(str.c_str(), "%llu", &val);
-        }
+            using unsigned_type = std::make_unsigned_t<T>;
+            bool _negative = false;
 
-        template <>
-        void _parse<char>(u8string& str, f32& val)
-        {
-            sscanf(str.c_str(), "%f", &val);
-        }
+            if(*iter == '-' || *iter == '+')
+            {
+                _negative = (*iter == '-');
+                iter++;
+            }
+            if(!_is_digit(*iter))
+                return nullptr;
 
-        template <>
-        void _parse<char>(u8string& str, f64& val)
-        {
-            sscanf(str.c_str(), "%lf", &val);
-        }
+            // Magnitude allowed for the sign, an unsigned type only takes "-0"
+            unsigned_type _limit = static_cast<unsigned_type>(limits<T>::max);
 
-        template <>
-        void _parse<char>(u8string& str, f128& val)
-        {
-            sscanf(str.c_str(), "%Lf", &val);
-        }
+            if(_negative)
+                _limit = std::is_signed_v<T> ? static_cast<unsigned_type>(_limit + 1) : 0;
 
-        template <>
-        void _parse<char>(u8string& str, u8string& val)
-        {
-            val = move(str);
-        }
+            unsigned_type _num = 0;
 
-        template <>
-        void _parse<wchar>(wstring& str, char& val)
-        {
-            swscanf(str.c_str(), L"%c", &val);
-        }
+            for(; _is_digit(*iter); iter++)
+            {
+                auto _digit = static_cast<unsigned_type>(*iter - '0');
 
-        template <>
-        void _parse<wchar>(wstring& str, uchar& val)
-        {
-            swscanf(str.c_str(), L"%c", &val);
-        }
+                if(_digit > _limit || _num > (_limit - _digit) / 10)
+                    return nullptr;
 
-        template <>
-        void _parse<wchar>(wstring& str, wchar& val)
-        {
-            swscanf(str.c_str(), L"%lc", &val);
-        }
+                _num = static_cast<unsigned_type>(_num * 10 + _digit);
+            }
+            if(*iter != '\0' && !_is_space(*iter))
+                return nullptr;
 
-        template <>
-        void _parse<wchar>(wstring& str, i16& val)
-        {
-            swscanf(str.c_str(), L"%hd", &val);
+            val = static_cast<T>(_negative ? static_cast<unsigned_type>(0) - _num : _num);
+            return iter;
         }
 
-        template <>
-        void _parse<wchar>(wstring& str, u16& val)
+        template <typename CharT, typename T> requires (is_char<T>::value)
+        static constexpr const CharT* _scan(const CharT* iter, T& val)
         {
-            swscanf(str.c_str(), L"%hu", &val);
-        }
+            if(*iter == '\0')
+                return nullptr;
 
-        template <>
-        void _parse<wchar>(wstring& str, i32& val)
-        {
-            swscanf(str.c_str(), L"%d", &val);
+            val = static_cast<T>(*iter);
+            return iter + 1;
         }
 
-        template <>
-        void _parse<wchar>(wstring& str, u32& val)
+        // The converter of the exact width, a wider one and a cast would
+        // round twice
+        template <typename T, typename CharT>
+        static T _convert_float(const CharT* str, CharT** end)
         {
-            swscanf(str.c_str(), L"%u", &val);
+            if constexpr(is_same<CharT, wchar>::value)
+            {
+                if constexpr(is_same<T, f32>::value)
+                    return wcstof(str, end);
+                else if constexpr(is_same<T, f64>::value)
+                    return wcstod(str, end);
+                else
+                    return static_cast<T>(wcstold(str, end));
+            }
+            else
+            {
+                if constexpr(is_same<T, f32>::value)
+                    return strtof(str, end);
+                else if constexpr(is_same<T, f64>::value)
+                    return strtod(str, end);
+                else
+                    return static_cast<T>(strtold(str, end));
+            }
         }
 
-        template <>
-        void _parse<wchar>(wstring& str, i64& val)
+        template <typename CharT, typename T>
+        static const CharT* _scan_float_slow(const CharT* iter, T& val)
         {
-            swscanf(str.c_str(), L"%lld", &val);
-        }
+            CharT* _end = nullptr;
 
-        template <>
-        void _parse<wchar>(wstring& str, u64& val)
-        {
-            swscanf(str.c_str(), L"%llu", &val);
-        }
+            if constexpr(is_same<CharT, wchar>::value)
+            {
+                val = _convert_float<T>(iter, &_end);
+            }
+            else
+            {
+                // Copy just the token, the narrow converter needs a char string
+                char _buf[128]{};
+                usize _len = 0;
 
-        template <>
-        void _parse<wchar>(wstring& str, f32& val)
-        {
-            swscanf(str.c_str(), L"%f", &val);
+                for(; iter[_len] != '\0' && !_is_space(iter[_len]) && _len < sizeof(_buf) - 1; _len++)
+                    _buf[_len] = static_cast<char>(iter[_len]);
+
+                char* _buf_end = nullptr;
+                val = _convert_float<T>(_buf, &_buf_end);
+                _end = const_cast<CharT*>(iter + (_buf_end - _buf));
+            }
+
+            return _end == iter ? nullptr : _end;
         }
 
-        template <>
-        void _parse<wchar>(wstring& str, f64& val)
+        template <typename CharT, typename T> requires (std::is_floating_point_v<T>)
+        static const CharT* _scan(const CharT* iter, T& val)
         {
-            swscanf(str.c_str(), L"%lf", &val);
+            // Exact powers of ten, a mantissa that fits the significand scaled
+            // by one of them is rounded once, so the result is exact too
+            static constexpr f64 _pow10[] = {
+                1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+            };
+            static constexpr f32 _pow10f[] = {
+                1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+            };
+
+            const CharT* _begin = iter;
+            bool _negative = false;
+            bool _exact = true;
+            bool _has_digits = false;
+            u64 _mantissa = 0;
+            i32 _exponent = 0;
+
+            if(*iter == '-' || *iter == '+')
+            {
+                _negative = (*iter == '-');
+                iter++;
+            }
+            for(; _is_digit(*iter); iter++)
+            {
+                _has_digits = true;
+
+                if(_mantissa < (1ull << 53) / 10)
+                    _mantissa = _mantissa * 10 + static_cast<u64>(*iter - '0');
+                else
+                    _exact = false;
+            }
+            if(*iter == '.')
+            {
+                for(iter++; _is_digit(*iter); iter++)
+                {
+                    _has_digits = true;
+
+                    if(_mantissa < (1ull << 53) / 10)
+                    {
+                        _mantissa = _mantissa * 10 + static_cast<u64>(*iter - '0');
+                        _exponent--;
+                    }
+                    else
+                    {
+                        _exact = false;
+                    }
+                }
+            }
+            if(!_has_digits)
+                return _scan_float_slow(_begin, val);
+
+            // An exponent marker needs digits, "1e" is malformed rather than 1
+            if(*iter == 'e' || *iter == 'E')
+            {
+                bool _exp_negative = false;
+                i32 _exp_value = 0;
+                iter++;
+
+                if(*iter == '-' || *iter == '+')
+                {
+                    _exp_negative = (*iter == '-');
+                    iter++;
+                }
+                if(!_is_digit(*iter))
+                    return nullptr;
+
+                // Saturates, anything this large goes to the slow path anyway
+                for(; _is_digit(*iter); iter++)
+                {
+                    if(_exp_value < 100000)
+                        _exp_value = _exp_value * 10 + (*iter - '0');
+                }
+
+                _exponent += _exp_negative ? -_exp_value : _exp_value;
+            }
+            if constexpr(is_same<T, f32>::value)
+            {
+                if(_exact && _mantissa < (1ull << 24) && _exponent >= -10 && _exponent <= 10)
+                {
+                    f32 _value = static_cast<f32>(_mantissa);
+                    _value = (_exponent < 0) ? _value / _pow10f[-_exponent] : _value * _pow10f[_exponent];
+                    val = _negative ? -_value : _value;
+                    return iter;
+                }
+            }
+            else if constexpr(is_same<T, f64>::value)
+            {
+                if(_exact && _exponent >= -22 && _exponent <= 22)
+                {
+                    f64 _value = static_cast<f64>(_mantissa);
+                    _value = (_exponent < 0) ? _value / _pow10[-_exponent] : _value * _pow10[_exponent];
+                    val = _negative ? -_value : _value;
+                    return iter;
+                }
+            }
+
+            // Wider types have no exact fast path, the converter rounds once
+            return _scan_float_slow(_begin, val);
         }
 
-        template <>
-        void _parse<wchar>(wstring& str, f128& val)
+        template <typename CharT, typename StrCharT>
+        static HSD_CONSTEXPR const CharT* _scan(const CharT* iter, string<StrCharT>& val)
         {
-            swscanf(str.c_str(), L"%Lf", &val);
+            const CharT* _end = token_end(iter);
+
+            if(_end == iter)
+                return nullptr;
+
+            // Converts through the assignment when the character types differ
+            val = string<CharT>(iter, static_cast<usize>(_end - iter));
+            return _end;
         }
 
-        template <>
-        void _parse<wchar>(wstring& str, u8string& val)
+        /// Kept as the default of the `_parse` customization point, user
+        /// types provide their own `_parse(string<CharT>&, T&)` overload
+        template <typename CharT, scannable T>
+        static HSD_CONSTEXPR void _parse(string<CharT>& str, T& val)
         {
-            val = str;
+            _scan(skip_space(str.c_str()), val);
         }
 
-        template <>
-        void _parse<wchar>(wstring& str, wstring& val)
+        // Renders `val` backwards ending at `end`, returns the first character
+        template <typename CharT, typename T> requires (std::is_integral_v<T>)
+        static constexpr CharT* _format(CharT* end, T val)
         {
-            val = move(str);
+            bool _negative = false;
+            auto _num = static_cast<std::make_unsigned_t<T>>(val);
+
+            if constexpr(std::is_signed_v<T>)
+            {
+                if(val < 0)
+                {
+                    _negative = true;
+                    _num = static_cast<std::make_unsigned_t<T>>(0) - _num;
+                }
+            }
+
+            do
+            {
+                *--end = static_cast<CharT>('0' + _num % 10);
+                _num /= 10;
+            } while(_num != 0);
+
+            if(_negative)
+                *--end = '-';
+
+            return end;
         }
     } // namespace sstream_detail
 } // namespace hsd
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <stdexcept>
+
+#include "Vector.hpp"
+#include "Hash.hpp"
+
+namespace hsd
+{
+    // Shared by bloom_filter, count_min_sketch and hyperloglog. Merging two
+    // of the same shape gives what one would hold after seeing both inputs,
+    // so threads can each fill their own and combine them at the end
+    namespace sketch_detail
+    {
+        static constexpr u8 version = 1;
+
+        /// Maps a hash onto [0, range) with a multiply instead of a modulo,
+        /// which uses the high bits of the hash
+        static constexpr u64 reduce(u64 hash, u64 range)
+        {
+            return static_cast<u64>((static_cast<unsigned __int128>(hash) * range) >> 64);
+        }
+
+        /// Second hash derived from the first, for the positions that must
+        /// not correlate with the bits `reduce` already used
+        static constexpr u64 remix(u64 hash)
+        {
+            return wyhash::get_hash(hash);
+        }
+
+        /// Appends little endian fields, so buffers move between hosts
+        class byte_writer
+        {
+        private:
+            vector<u8>& _out;
+
+        public:
+            byte_writer(vector<u8>& out)
+                : _out{out}
+            {}
+
+            void put(u64 value, usize bytes)
+            {
+                for (usize _index = 0; _index < bytes; _index++)
+                    _out.push_back(static_cast<u8>(value >> (_index * 8)));
+            }
+
+            /// 7 bits per byte, small values take a single byte
+            void put_varint(u64 value)
+            {
+                for (; value >= 0x80; value >>= 7)
+                    _out.push_back(static_cast<u8>(value | 0x80));
+
+                _out.push_back(static_cast<u8>(value));
+            }
+
+            /// Four character type tag and the format version
+            void put_header(const char (&tag)[5])
+            {
+                for (usize _index = 0; _index < 4; _index++)
+                    _out.push_back(static_cast<u8>(tag[_index]));
+
+                _out.push_back(version);
+            }
+        };
+
+        class byte_reader
+        {
+        private:
+            const u8* _data;
+            usize _size;
+            usize _pos = 0;
+
+            void _need(usize bytes) const
+            {
+                if (_size - _pos < bytes)
+                    throw std::runtime_error("Sketch buffer is truncated");
+            }
+
+        public:
+            byte_reader(const u8* data, usize size)
+                : _data{data}, _size{size}
+            {}
+
+            u64 get(usize bytes)
+            {
+                _need(bytes);
+                u64 _value = 0;
+
+                for (usize _index = 0; _index < bytes; _index++)
+                    _value |= static_cast<u64>(_data[_pos++]) << (_index * 8);
+
+                return _value;
+            }
+
+            u64 get_varint()
+            {
+                u64 _value = 0;
+
+                for (usize _shift = 0; _shift < 64; _shift += 7)
+                {
+                    _need(1);
+                    u8 _byte = _data[_pos++];
+                    _value |= static_cast<u64>(_byte & 0x7f) << _shift;
+
+                    if ((_byte & 0x80) == 0)
+                        return _value;
+                }
+
+                throw std::runtime_error("Sketch buffer has a malformed varint");
+            }
+
+            void get_header(const char (&tag)[5])
+            {
+                _need(5);
+
+                for (usize _index = 0; _index < 4; _index++)
+                {
+                    if (_data[_pos++] != static_cast<u8>(tag[_index]))
+                        throw std::runtime_error("Sketch buffer holds another type");
+                }
+
+                if (_data[_pos++] != version)
+                    throw std::runtime_error("Sketch buffer has an unknown version");
+            }
+
+            usize remaining() const
+            {
+                return _size - _pos;
+            }
+
+            /// Trailing bytes mean the buffer isn't what its header claims
+            void finish() const
+            {
+                if (_pos != _size)
+                    throw std::runtime_error("Sketch buffer has trailing bytes");
+            }
+        };
+    } // namespace sketch_detail
+} // namespace hsd
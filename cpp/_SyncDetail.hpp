@@ -0,0 +1,108 @@
+#pragma once
+
+#include "Types.hpp"
+#include "_Define.hpp"
+
+#include <sched.h>
+
+#ifdef HSD_PLATFORM_LINUX
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <time.h>
+#endif
+
+namespace hsd
+{
+    namespace sync_detail
+    {
+        static constexpr usize cache_line = 64;
+
+        static inline void cpu_relax()
+        {
+            #if defined(__x86_64__) || defined(__i386__)
+            __builtin_ia32_pause();
+            #elif defined(__aarch64__)
+            asm volatile("yield");
+            #endif
+        }
+
+        /// Sleeps while `*addr == expected`, may return spuriously. A
+        /// negative `timeout_ns` waits without a deadline
+        static inline void futex_wait(u32* addr, u32 expected, i64 timeout_ns = -1)
+        {
+            #ifdef HSD_PLATFORM_LINUX
+            timespec _timeout{
+                static_cast<time_t>(timeout_ns / 1'000'000'000),
+                static_cast<long>(timeout_ns % 1'000'000'000)
+            };
+
+            syscall(SYS_futex, addr, FUTEX_WAIT_PRIVATE, expected,
+                timeout_ns < 0 ? nullptr : &_timeout, nullptr, 0);
+            #else
+            if(__atomic_load_n(addr, __ATOMIC_ACQUIRE) == expected)
+                sched_yield();
+            #endif
+        }
+
+        static inline void futex_wake(u32* addr, i32 count)
+        {
+            #ifdef HSD_PLATFORM_LINUX
+            syscall(SYS_futex, addr, FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0);
+            #else
+            (void)addr;
+            (void)count;
+            #endif
+        }
+
+        /// Lets threads sleep until a condition they poll may have changed.
+        /// Waiters call `prepare_wait`, re-check the condition and then
+        /// `wait` or `cancel_wait`; notifiers skip the syscall when no one
+        /// is registered, so the uncontended path costs one fence and a load
+        class event_count
+        {
+        private:
+            u32 _epoch = 0;
+            u32 _waiters = 0;
+
+        public:
+            u32 prepare_wait()
+            {
+                __atomic_fetch_add(&_waiters, 1u, __ATOMIC_SEQ_CST);
+                return __atomic_load_n(&_epoch, __ATOMIC_SEQ_CST);
+            }
+
+            void cancel_wait()
+            {
+                __atomic_fetch_sub(&_waiters, 1u, __ATOMIC_RELAXED);
+            }
+
+            void wait(u32 key)
+            {
+                futex_wait(&_epoch, key);
+                __atomic_fetch_sub(&_waiters, 1u, __ATOMIC_RELAXED);
+            }
+
+            void notify(i32 count)
+            {
+                __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+                if(__atomic_load_n(&_waiters, __ATOMIC_RELAXED) != 0)
+                {
+                    __atomic_fetch_add(&_epoch, 1u, __ATOMIC_SEQ_CST);
+                    futex_wake(&_epoch, count);
+                }
+            }
+
+            void notify_one()
+            {
+                notify(1);
+            }
+
+            void notify_all()
+            {
+                notify(0x7fffffff);
+            }
+        };
+    } // namespace sync_detail
+} // namespace hsd